@@ -0,0 +1,18 @@
+#ifndef __BARRIER_H__
+#define __BARRIER_H__
+
+/*
+ * Compiler barrier for data shared between an interrupt and the main
+ * loop (event queues, sample rings, sequence-counted copies). The
+ * compiler may not move memory accesses across it, so an entry is
+ * complete before the index that publishes it is written, and read
+ * before the index that frees it.
+ *
+ * That is all the Cortex-M0 needs: one core, and loads and stores in
+ * program order. It is not a CPU fence. The PC harnesses that run a
+ * producer and a consumer on separate threads (tools/ring_stress.c)
+ * rely on x86 ordering for the rest.
+ */
+#define COMPILER_BARRIER()  __asm volatile ("" ::: "memory")
+
+#endif /* __BARRIER_H__ */
@@ -0,0 +1,84 @@
+#ifndef __EEPROM24_H__
+#define __EEPROM24_H__
+
+#include <stdint.h>
+
+/*
+ * 24AA16 I2C EEPROM (2 KB, 16-byte pages), used by Settings.c.
+ *
+ * Exactly one implementation is compiled, chosen by EEPROM24_BACKEND:
+ *   Eeprom24_I2C.c : the chip on I2C1 at 400 kHz, PB8 = SCL, PB9 = SDA
+ *                    (AF1, open drain, 2.2k..4.7k pull-ups to 3.3 V).
+ *                    A0..A2 and WP to GND. Every transfer runs from the
+ *                    I2C1 interrupt, including the acknowledge polling
+ *                    that waits out the write cycle (5 ms max).
+ *   Eeprom24_Ram.c : the same device in RAM, for a board without the
+ *                    chip and for tools/settings_sim.c on a PC. It counts
+ *                    writes and can cut one short.
+ *
+ * Eeprom24_Read() and Eeprom24_Write() only start a transfer and return
+ * 0 if one is still running; Eeprom24_Busy() says when it is done. The
+ * 11-bit address is split the 24AA16 way: bits 10..8 go in the device
+ * address (the "block"), bits 7..0 in the word address.
+ */
+
+#define EEPROM24_BACKEND_I2C  0
+#define EEPROM24_BACKEND_RAM  1
+
+#ifndef EEPROM24_BACKEND
+#define EEPROM24_BACKEND      EEPROM24_BACKEND_I2C
+#endif
+
+#define EEPROM24_SIZE         2048u
+#define EEPROM24_PAGE         16u
+
+void    Eeprom24_Init(void);
+
+/*
+ * Sequential read of n bytes into buf. With more = 1 the transfer stays
+ * open after them (the clock is held low) and the next call carries on
+ * at the following address, ignoring 'addr'; the last call passes
+ * more = 0. So the whole device can be read as one transfer through a
+ * small buffer. The address wraps from the top of the device to 0.
+ */
+uint8_t Eeprom24_Read(uint16_t addr, uint8_t *buf, uint8_t n, uint8_t more);
+
+/*
+ * Writes n bytes (1..EEPROM24_PAGE) at addr, all inside one page. 'data'
+ * is copied. Busy until the write cycle has finished.
+ */
+uint8_t Eeprom24_Write(uint16_t addr, const uint8_t *data, uint8_t n);
+
+/* 1 while a transfer or write cycle is running */
+uint8_t Eeprom24_Busy(void);
+
+/* 1 if the last transfer failed (no acknowledge, bus error) */
+uint8_t Eeprom24_Failed(void);
+
+#if EEPROM24_BACKEND == EEPROM24_BACKEND_I2C
+/* stm32f0xx_it.c: call from I2C1_IRQHandler() */
+void    Eeprom24_IRQHandler(void);
+#endif
+
+#if EEPROM24_BACKEND == EEPROM24_BACKEND_RAM
+typedef struct {
+  uint32_t reads;          // read transfers (a 'more' chain counts once)
+  uint32_t readBytes;
+  uint32_t writes;         // page writes, completed or cut short
+  uint32_t writeBytes;
+  uint32_t pageCycles[EEPROM24_SIZE / EEPROM24_PAGE];   // writes per page
+} Eeprom24RamStats;
+
+/* The array itself, erased (0xFF) by Eeprom24_Init() */
+uint8_t *Eeprom24_RamImage(void);
+
+/*
+ * Power fails during the write in progress: only its first 'keep'
+ * bytes reach the array. Nothing happens when no write is in progress.
+ */
+void    Eeprom24_RamPowerFail(uint8_t keep);
+
+void    Eeprom24_RamGetStats(Eeprom24RamStats *stats);
+#endif
+
+#endif /* __EEPROM24_H__ */
@@ -0,0 +1,194 @@
+#include "Eeprom24.h"
+
+#if EEPROM24_BACKEND == EEPROM24_BACKEND_I2C
+
+#include "main.h"
+
+/*
+ * 24AA16 on I2C1, driven from the I2C1 interrupt. I2C1 runs from HSI
+ * (8 MHz); TIMINGR is the RM0091 value for 400 kHz at that clock.
+ *
+ * States, moved along by Eeprom24_IRQHandler():
+ *   S_WADDR  read: word address sent, then a repeated START for reading
+ *   S_READ   bytes to buf. With 'more' the transfer uses RELOAD, and the
+ *            TCR interrupt is masked until the next Eeprom24_Read()
+ *            hands over a buffer, so the clock is held low meanwhile.
+ *   S_WRITE  word address and data, then STOP, which starts the write
+ *            cycle
+ *   S_POLL   acknowledge polling: an empty write to the device, again
+ *            and again until it answers, at most POLL_MAX times
+ * Each one ends on STOPF, except a 'more' read, which waits in S_READ.
+ */
+
+#define DEV_ADDR    0xA0u                      // 1010 b2 b1 b0 R/W#
+#define DEV(addr)   ((uint32_t)(DEV_ADDR | (((addr) >> 7) & 0x0Eu)))
+#define TIMING_400K 0x00310309u
+#define POLL_MAX    400u                       // ~30 us each: 12 ms
+
+#define S_IDLE      0u
+#define S_WADDR     1u
+#define S_READ      2u
+#define S_WRITE     3u
+#define S_POLL      4u
+
+#define IRQ_ALL     (I2C_CR1_TXIE | I2C_CR1_RXIE | I2C_CR1_NACKIE | \
+                     I2C_CR1_STOPIE | I2C_CR1_TCIE | I2C_CR1_ERRIE)
+
+static volatile uint8_t state = S_IDLE;
+static volatile uint8_t failed;
+static volatile uint8_t nacked;
+static volatile uint8_t held;                  // S_READ stopped at TCR
+static uint8_t  keepOpen;                      // this chunk ends in RELOAD
+static uint16_t start;                         // selects the block
+static uint8_t  wordAddr;
+static uint8_t *rxBuf;
+static uint8_t  rxLeft;
+static uint8_t  txBuf[EEPROM24_PAGE];
+static uint8_t  txPos;
+static uint16_t polls;
+
+void Eeprom24_Init(void){
+  GPIO_InitTypeDef GPIO_InitStruct = {0};
+
+  __HAL_RCC_GPIOB_CLK_ENABLE();
+  __HAL_RCC_I2C1_CONFIG(RCC_I2C1CLKSOURCE_HSI);
+  __HAL_RCC_I2C1_CLK_ENABLE();
+
+  /* PB8 = I2C1_SCL, PB9 = I2C1_SDA */
+  GPIO_InitStruct.Pin = GPIO_PIN_8 | GPIO_PIN_9;
+  GPIO_InitStruct.Mode = GPIO_MODE_AF_OD;
+  GPIO_InitStruct.Pull = GPIO_NOPULL;
+  GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH;
+  GPIO_InitStruct.Alternate = GPIO_AF1_I2C1;
+  HAL_GPIO_Init(GPIOB, &GPIO_InitStruct);
+
+  I2C1->CR1 = 0;
+  I2C1->TIMINGR = TIMING_400K;
+  I2C1->CR1 = I2C_CR1_PE | IRQ_ALL;
+
+  HAL_NVIC_SetPriority(I2C1_IRQn, 3, 0);        // lowest: scans and sampling go first
+  HAL_NVIC_EnableIRQ(I2C1_IRQn);
+
+  state = S_IDLE;
+  failed = 0;
+  held = 0;
+}
+
+/* START of a transfer to the block holding 'start' */
+static void begin(uint32_t rw, uint8_t n, uint32_t end){
+  I2C1->CR2 = DEV(start) | rw | ((uint32_t)n << I2C_CR2_NBYTES_Pos) | end |
+              I2C_CR2_START;
+}
+
+uint8_t Eeprom24_Read(uint16_t addr, uint8_t *buf, uint8_t n, uint8_t more){
+  if (state == S_READ && held) {
+    /* Carry on with the open transfer; writing NBYTES releases SCL */
+    rxBuf = buf;
+    rxLeft = n;
+    keepOpen = more;
+    held = 0;
+    I2C1->CR2 = (I2C1->CR2 & ~(I2C_CR2_NBYTES | I2C_CR2_RELOAD | I2C_CR2_AUTOEND)) |
+                ((uint32_t)n << I2C_CR2_NBYTES_Pos) |
+                (more ? I2C_CR2_RELOAD : I2C_CR2_AUTOEND);
+    I2C1->CR1 |= I2C_CR1_TCIE;
+    return 1;
+  }
+  if (state != S_IDLE) {
+    return 0;
+  }
+  start = addr & (EEPROM24_SIZE - 1u);
+  wordAddr = (uint8_t)addr;
+  rxBuf = buf;
+  rxLeft = n;
+  keepOpen = more;
+  txPos = 0;
+  failed = 0;
+  nacked = 0;
+  state = S_WADDR;
+  begin(0, 1, 0);                              // word address, then TC
+  return 1;
+}
+
+uint8_t Eeprom24_Write(uint16_t addr, const uint8_t *data, uint8_t n){
+  if (state != S_IDLE) {
+    return 0;
+  }
+  for (uint8_t i = 0; i < n; i++) {
+    txBuf[i] = data[i];
+  }
+  start = addr & (EEPROM24_SIZE - 1u);
+  wordAddr = (uint8_t)addr;
+  txPos = 0;
+  failed = 0;
+  nacked = 0;
+  polls = 0;
+  state = S_WRITE;
+  begin(0, (uint8_t)(n + 1u), I2C_CR2_AUTOEND);
+  return 1;
+}
+
+uint8_t Eeprom24_Busy(void){
+  return state != S_IDLE && !held;
+}
+
+uint8_t Eeprom24_Failed(void){
+  return failed;
+}
+
+void Eeprom24_IRQHandler(void){
+  uint32_t isr = I2C1->ISR;
+
+  if (isr & (I2C_ISR_BERR | I2C_ISR_ARLO)) {
+    I2C1->ICR = I2C_ICR_BERRCF | I2C_ICR_ARLOCF;
+    I2C1->CR1 &= ~I2C_CR1_PE;                  // reset the peripheral
+    I2C1->CR1 |= I2C_CR1_PE;
+    failed = 1;
+    held = 0;
+    state = S_IDLE;
+    return;
+  }
+  if (isr & I2C_ISR_NACKF) {
+    I2C1->ICR = I2C_ICR_NACKCF;
+    nacked = 1;
+    if (!(I2C1->CR2 & I2C_CR2_AUTOEND)) {
+      I2C1->CR2 |= I2C_CR2_STOP;
+    }
+  }
+
+  if (isr & I2C_ISR_TXIS) {
+    I2C1->TXDR = (txPos == 0u) ? wordAddr : txBuf[txPos - 1u];
+    txPos++;
+  }
+  if (isr & I2C_ISR_RXNE) {
+    uint8_t b = (uint8_t)I2C1->RXDR;
+    if (rxLeft != 0u) {
+      *rxBuf++ = b;
+      rxLeft--;
+    }
+  }
+  if (isr & I2C_ISR_TC) {
+    /* Word address sent: repeated START for the read */
+    state = S_READ;
+    begin(I2C_CR2_RD_WRN, rxLeft, keepOpen ? I2C_CR2_RELOAD : I2C_CR2_AUTOEND);
+  }
+  if (isr & I2C_ISR_TCR) {
+    I2C1->CR1 &= ~I2C_CR1_TCIE;                // SCL stays low until the next buffer
+    held = 1;
+  }
+
+  if (isr & I2C_ISR_STOPF) {
+    I2C1->ICR = I2C_ICR_STOPCF;
+    if (state == S_WRITE && !nacked) {
+      state = S_POLL;                          // write cycle has started
+      begin(0, 0, I2C_CR2_AUTOEND);
+    } else if (state == S_POLL && nacked && ++polls < POLL_MAX) {
+      nacked = 0;
+      begin(0, 0, I2C_CR2_AUTOEND);            // still writing: ask again
+    } else {
+      failed = nacked;
+      state = S_IDLE;
+    }
+  }
+}
+
+#endif /* EEPROM24_BACKEND == EEPROM24_BACKEND_I2C */
@@ -0,0 +1,111 @@
+#include "Eeprom24.h"
+
+#if EEPROM24_BACKEND == EEPROM24_BACKEND_RAM
+
+/*
+ * 24AA16 stand-in. A transfer is done EEPROM24_RAM_CYCLE calls of
+ * Eeprom24_Busy() after it was started; a write only lands in the array
+ * then, so callers that forget to poll hang just like on the real part.
+ */
+
+#ifndef EEPROM24_RAM_CYCLE
+#define EEPROM24_RAM_CYCLE  3u
+#endif
+
+static uint8_t  mem[EEPROM24_SIZE];
+static uint8_t  pending[EEPROM24_PAGE];
+static uint16_t pendingAddr;
+static uint8_t  pendingLen;            // 0 = the transfer is a read
+static uint16_t readAddr;
+static uint8_t  readOpen;              // a 'more' read is waiting
+static uint8_t  cycle;                 // polls until done, 0 = idle
+static Eeprom24RamStats stats;
+
+void Eeprom24_Init(void){
+  for (uint16_t i = 0; i < EEPROM24_SIZE; i++) {
+    mem[i] = 0xFFu;
+  }
+  cycle = 0;
+  readOpen = 0;
+  stats.reads = 0;
+  stats.readBytes = 0;
+  stats.writes = 0;
+  stats.writeBytes = 0;
+  for (uint8_t p = 0; p < EEPROM24_SIZE / EEPROM24_PAGE; p++) {
+    stats.pageCycles[p] = 0;
+  }
+}
+
+uint8_t Eeprom24_Read(uint16_t addr, uint8_t *buf, uint8_t n, uint8_t more){
+  if (cycle != 0u) {
+    return 0;
+  }
+  if (!readOpen) {
+    readAddr = addr;
+    stats.reads++;
+  }
+  for (uint8_t i = 0; i < n; i++) {
+    buf[i] = mem[readAddr++ & (EEPROM24_SIZE - 1u)];
+  }
+  stats.readBytes += n;
+  readOpen = more;
+  pendingLen = 0;
+  cycle = EEPROM24_RAM_CYCLE;
+  return 1;
+}
+
+/* Like the chip, bytes past the end of the page wrap to its start */
+static void land(uint8_t keep){
+  uint16_t page = (uint16_t)(pendingAddr & ~(EEPROM24_PAGE - 1u));
+
+  for (uint8_t i = 0; i < keep; i++) {
+    mem[page | ((pendingAddr + i) & (EEPROM24_PAGE - 1u))] = pending[i];
+  }
+  stats.writes++;
+  stats.writeBytes += pendingLen;
+  stats.pageCycles[page / EEPROM24_PAGE]++;
+  pendingLen = 0;
+  cycle = 0;
+}
+
+uint8_t Eeprom24_Write(uint16_t addr, const uint8_t *data, uint8_t n){
+  if (cycle != 0u || readOpen) {
+    return 0;
+  }
+  pendingAddr = (uint16_t)(addr & (EEPROM24_SIZE - 1u));
+  pendingLen = n;
+  for (uint8_t i = 0; i < n; i++) {
+    pending[i] = data[i];
+  }
+  cycle = EEPROM24_RAM_CYCLE;
+  return 1;
+}
+
+uint8_t Eeprom24_Busy(void){
+  if (cycle != 0u && --cycle == 0u && pendingLen != 0u) {
+    land(pendingLen);
+  }
+  return cycle != 0u;
+}
+
+uint8_t Eeprom24_Failed(void){
+  return 0;
+}
+
+uint8_t *Eeprom24_RamImage(void){
+  return mem;
+}
+
+void Eeprom24_RamPowerFail(uint8_t keep){
+  if (cycle != 0u && pendingLen != 0u) {
+    land(keep < pendingLen ? keep : pendingLen);
+  }
+  cycle = 0;
+  readOpen = 0;
+}
+
+void Eeprom24_RamGetStats(Eeprom24RamStats *s){
+  *s = stats;
+}
+
+#endif /* EEPROM24_BACKEND == EEPROM24_BACKEND_RAM */
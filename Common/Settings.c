@@ -0,0 +1,342 @@
+#include "Settings.h"
+
+#define AREA_SIZE    (EEPROM24_SIZE / 2u)
+#define REC_SIZE     8u
+#define AREA_SLOTS   (AREA_SIZE / REC_SIZE)     // slot 0 = header
+#define PAGE_SLOTS   (EEPROM24_PAGE / REC_SIZE)
+#define KEY_HDR      0xFEu
+#define BIT(key)     (1ul << (key))
+
+#define J_NONE       0u
+#define J_APPEND     1u
+#define J_COMPACT    2u          // records into the other area
+#define J_HEADER     3u          // then its header
+
+/* The table */
+static uint32_t value[SETTINGS_KEYS];
+static uint32_t present;
+static uint32_t dirty;
+
+/* Area in use */
+static uint8_t  area;
+static uint8_t  valid;                  // 0 until the first area is written
+static uint32_t gen;
+static uint8_t  nextSlot;
+
+static uint8_t  offline;
+static uint32_t hold;
+static uint32_t dirtySince;
+static uint8_t  timing;
+static uint8_t  flushNow;
+
+/* Write in progress */
+static uint8_t  job = J_NONE;
+static uint8_t  jobArea;
+static uint8_t  jobSlot;                // next slot to write
+static uint32_t jobGen;
+static uint32_t jobKeys;                // still to write
+static uint32_t jobDirty;               // marked when the job started
+static uint8_t  inFlight;
+static uint8_t  page[EEPROM24_PAGE];
+
+static SettingsStats stats;
+
+static uint16_t crc16(const uint8_t *p, uint8_t n){
+  uint16_t crc = 0xFFFFu;
+
+  while (n--) {
+    crc ^= (uint16_t)(*p++ << 8);
+    for (uint8_t b = 0; b < 8u; b++) {
+      crc = (crc & 0x8000u) ? (uint16_t)((crc << 1) ^ 0x1021u) : (uint16_t)(crc << 1);
+    }
+  }
+  return crc;
+}
+
+/* CRC of bytes 0..5 and the upper 24 bits of the generation, which are
+   not stored: a record left over from generation g - 256 has the same
+   byte [1], but fails the CRC */
+static uint16_t recCrc(const uint8_t *r, uint32_t g){
+  uint8_t b[9];
+
+  for (uint8_t i = 0; i < 6u; i++) {
+    b[i] = r[i];
+  }
+  b[6] = (uint8_t)(g >> 8);
+  b[7] = (uint8_t)(g >> 16);
+  b[8] = (uint8_t)(g >> 24);
+  return crc16(b, 9u);
+}
+
+static void putRec(uint8_t *r, uint8_t key, uint32_t g, uint32_t v){
+  r[0] = key;
+  r[1] = (uint8_t)g;
+  r[2] = (uint8_t)v;
+  r[3] = (uint8_t)(v >> 8);
+  r[4] = (uint8_t)(v >> 16);
+  r[5] = (uint8_t)(v >> 24);
+  uint16_t crc = recCrc(r, g);
+  r[6] = (uint8_t)crc;
+  r[7] = (uint8_t)(crc >> 8);
+}
+
+static uint8_t recOk(const uint8_t *r, uint32_t g){
+  return r[1] == (uint8_t)g && recCrc(r, g) == (uint16_t)(r[6] | (r[7] << 8));
+}
+
+static uint32_t recValue(const uint8_t *r){
+  return (uint32_t)r[2] | ((uint32_t)r[3] << 8) | ((uint32_t)r[4] << 16) |
+         ((uint32_t)r[5] << 24);
+}
+
+static uint16_t slotAddr(uint8_t a, uint8_t slot){
+  return (uint16_t)(a * AREA_SIZE + slot * REC_SIZE);
+}
+
+static uint8_t count(uint32_t mask){
+  uint8_t n = 0;
+
+  for (; mask != 0u; mask &= mask - 1u) {
+    n++;
+  }
+  return n;
+}
+
+/* One area while it is being read */
+typedef struct {
+  uint32_t value[SETTINGS_KEYS];
+  uint32_t present;
+  uint32_t gen;
+  uint8_t  header;               // header valid
+  uint8_t  last;                 // last valid slot, 0 = none
+  uint16_t loaded;
+  uint16_t skipped;
+  uint16_t bad;                  // bad slots since the last valid one
+} Replay;
+
+static void replay(Replay *r, uint8_t slot, const uint8_t *rec){
+  if (slot == 0u) {
+    r->gen = recValue(rec);
+    r->header = rec[0] == KEY_HDR && recOk(rec, r->gen);
+    return;
+  }
+  if (!r->header) {
+    return;
+  }
+  if (rec[0] < SETTINGS_KEYS && recOk(rec, r->gen)) {
+    r->value[rec[0]] = recValue(rec);
+    r->present |= BIT(rec[0]);
+    r->last = slot;
+    r->loaded++;
+    r->skipped += r->bad;        // a bad slot with good ones after it
+    r->bad = 0;
+  } else {
+    r->bad++;                    // or the end of the journal
+  }
+}
+
+uint8_t Settings_Init(uint32_t holdMs){
+  Replay rp[2];
+  uint8_t buf[EEPROM24_PAGE];
+
+  hold = holdMs;
+  present = 0;
+  dirty = 0;
+  timing = 0;
+  flushNow = 0;
+  job = J_NONE;
+  inFlight = 0;
+  valid = 0;
+  area = 0;
+  gen = 0;
+  nextSlot = 1;
+  offline = 0;
+  stats = (SettingsStats){0};
+
+  for (uint8_t a = 0; a < 2u; a++) {
+    rp[a].present = 0;
+    rp[a].header = 0;
+    rp[a].last = 0;
+    rp[a].loaded = 0;
+    rp[a].skipped = 0;
+    rp[a].bad = 0;
+  }
+
+  /* One sequential read of the whole device, a page at a time */
+  for (uint16_t p = 0; p < EEPROM24_SIZE / EEPROM24_PAGE; p++) {
+    uint8_t last = (p == EEPROM24_SIZE / EEPROM24_PAGE - 1u);
+    Eeprom24_Read(0, buf, EEPROM24_PAGE, !last);
+    while (Eeprom24_Busy()) {}
+    if (Eeprom24_Failed()) {
+      offline = 1;
+      return 0;
+    }
+    for (uint8_t k = 0; k < PAGE_SLOTS; k++) {
+      uint16_t s = (uint16_t)(p * PAGE_SLOTS + k);
+      replay(&rp[s / AREA_SLOTS], (uint8_t)(s % AREA_SLOTS), buf + k * REC_SIZE);
+    }
+  }
+
+  int8_t best = -1;
+  for (uint8_t a = 0; a < 2u; a++) {
+    if (rp[a].header && (best < 0 || rp[a].gen > rp[best].gen)) {
+      best = (int8_t)a;
+    }
+  }
+  if (best >= 0) {
+    Replay *r = &rp[best];
+    for (uint8_t k = 0; k < SETTINGS_KEYS; k++) {
+      value[k] = r->value[k];
+    }
+    present = r->present;
+    area = (uint8_t)best;
+    valid = 1;
+    gen = r->gen;
+    nextSlot = (uint8_t)(r->last + 1u);
+    stats.loaded = r->loaded;
+    stats.skipped = r->skipped;
+  }
+  stats.generation = gen;
+  return 1;
+}
+
+uint8_t Settings_Get(uint8_t key, uint32_t *v){
+  if (key >= SETTINGS_KEYS || !(present & BIT(key))) {
+    return 0;
+  }
+  *v = value[key];
+  return 1;
+}
+
+uint32_t Settings_GetOr(uint8_t key, uint32_t def){
+  uint32_t v;
+
+  return Settings_Get(key, &v) ? v : def;
+}
+
+void Settings_Set(uint8_t key, uint32_t v){
+  if (key >= SETTINGS_KEYS || ((present & BIT(key)) && value[key] == v)) {
+    return;
+  }
+  if (dirty & BIT(key)) {
+    stats.coalesced++;
+  }
+  value[key] = v;
+  present |= BIT(key);
+  dirty |= BIT(key);
+  stats.sets++;
+}
+
+void Settings_Flush(void){
+  flushNow = 1;
+}
+
+uint8_t Settings_Pending(void){
+  return dirty != 0u || job != J_NONE;
+}
+
+/* Marked keys go into a new job: appended, or the area is compacted */
+static void startJob(void){
+  jobDirty = dirty;
+  dirty = 0;
+  if (!valid || nextSlot + count(jobDirty) > AREA_SLOTS) {
+    job = J_COMPACT;
+    jobArea = valid ? (uint8_t)(area ^ 1u) : 0u;
+    jobGen = gen + 1u;
+    jobSlot = 1;
+    jobKeys = present;
+    stats.compactions++;
+  } else {
+    job = J_APPEND;
+    jobArea = area;
+    jobGen = gen;
+    jobSlot = nextSlot;
+    jobKeys = jobDirty;
+  }
+}
+
+/* Starts the next page write of the job, or finishes it */
+static void step(void){
+  if (jobKeys != 0u) {
+    uint8_t first = jobSlot;
+    uint8_t n = 0;
+    do {
+      uint8_t key = 0;
+      while (!(jobKeys & BIT(key))) {
+        key++;
+      }
+      jobKeys &= ~BIT(key);
+      putRec(page + n * REC_SIZE, key, jobGen, value[key]);
+      n++;
+      jobSlot++;
+    } while (jobKeys != 0u && jobSlot % PAGE_SLOTS != 0u);
+    Eeprom24_Write(slotAddr(jobArea, first), page, (uint8_t)(n * REC_SIZE));
+    stats.records += n;
+    inFlight = 1;
+    return;
+  }
+  if (job == J_COMPACT) {
+    putRec(page, KEY_HDR, jobGen, jobGen);
+    Eeprom24_Write(slotAddr(jobArea, 0), page, REC_SIZE);
+    job = J_HEADER;
+    inFlight = 1;
+    return;
+  }
+  if (job == J_HEADER) {
+    area = jobArea;
+    gen = jobGen;
+    valid = 1;
+    stats.generation = gen;
+  }
+  nextSlot = jobSlot;
+  job = J_NONE;
+}
+
+void Settings_Poll(uint32_t now){
+  if (offline || Eeprom24_Busy()) {
+    return;
+  }
+
+  if (inFlight) {
+    inFlight = 0;
+    if (Eeprom24_Failed()) {
+      /* Try again after another hold time; an append carries on at
+         the first slot it could not write */
+      stats.failures++;
+      dirty |= jobDirty;
+      job = J_NONE;
+      timing = 1;
+      dirtySince = now;
+      return;
+    }
+    stats.pageWrites++;
+    if (job == J_APPEND) {
+      nextSlot = jobSlot;
+    }
+  }
+  if (job != J_NONE) {
+    step();
+    return;
+  }
+
+  if (dirty == 0u) {
+    timing = 0;
+    flushNow = 0;
+    return;
+  }
+  if (!timing) {
+    timing = 1;
+    dirtySince = now;
+  }
+  if (!flushNow && now - dirtySince < hold) {
+    return;
+  }
+  timing = 0;
+  flushNow = 0;
+  startJob();
+  step();
+}
+
+void Settings_GetStats(SettingsStats *s){
+  *s = stats;
+}
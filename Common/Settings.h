@@ -0,0 +1,95 @@
+#ifndef __SETTINGS_H__
+#define __SETTINGS_H__
+
+#include <stdint.h>
+#include "Eeprom24.h"
+
+/*
+ * Key/value settings in the 24AA16 (Eeprom24.h). No HAL in here, so
+ * with Eeprom24_Ram.c it also runs on a PC (tools/settings_sim.c).
+ *
+ * A setting is a 32-bit value under a key 0..SETTINGS_KEYS-1. All of
+ * them live in a RAM table, so Settings_Get() is one array access and
+ * never touches the EEPROM.
+ *
+ * Layout: the device is two areas of 1 KB, each 128 slots of 8 bytes:
+ *   [0]     key (SETTINGS_KEYS..0xFD), or 0xFE for the area header
+ *   [1]     low byte of the area's generation
+ *   [2..5]  value, little-endian (the generation itself for the header)
+ *   [6..7]  CRC-16/CCITT of bytes 0..5 and then bits 8..31 of the
+ *           generation (not stored), little-endian
+ * Slot 0 is the header, the rest is a journal: a change is appended in
+ * the next free slot, and the newest record of a key wins. When the
+ * journal is full the live values are written to the other area from
+ * slot 1 on, and its header last, with generation + 1. Until that
+ * header is written the old area stays the valid one, so a power
+ * failure during the copy loses nothing that was already stored.
+ *
+ * Loading: Settings_Init() reads the whole device in one sequential
+ * read, 16 bytes at a time, and replays both journals on the way. A
+ * slot counts if its CRC and generation match; anything else (erased,
+ * torn, corrupted, left over from an older generation) is skipped. The
+ * CRC covers the whole generation, so a record left from a generation
+ * with the same low byte, 256 compactions back, is skipped as well. The
+ * area with the newest valid header wins.
+ *
+ * Coalescing: Settings_Set() only changes the RAM table and marks the
+ * key. Settings_Poll() writes the marked keys 'holdMs' after the first
+ * change, so a burst of changes costs one record per key, and packs two
+ * records into each page write. Settings_Set(), Settings_Poll() and
+ * Settings_Flush() are for the main loop only.
+ */
+
+#define SETTINGS_KEYS     16u
+
+/* Keys, one list for all the projects so a chip moved between boards
+   is never misread */
+#define SET_TL_T_G        0u     // Traffic_Lights dwell times, 10 ms units
+#define SET_TL_T_Y        1u
+#define SET_TL_T_AR       2u
+#define SET_TL_T_WALK     3u
+#define SET_TL_T_HURRY    4u
+#define SET_TL_T_DONT     5u
+#define SET_TL_T_CF       6u
+#define SET_SSEG_NUM      7u     // Seven_Seg_Display_Driver g_num
+
+typedef struct {
+  uint32_t sets;             // changes taken by Settings_Set()
+  uint32_t coalesced;        // of those, overwritten before being stored
+  uint32_t records;          // records written
+  uint32_t pageWrites;
+  uint32_t compactions;
+  uint32_t failures;         // EEPROM transfers that failed
+  uint32_t generation;       // of the area in use
+  uint16_t loaded;           // records replayed by Settings_Init()
+  uint16_t skipped;          // bad slots inside the journal in use
+} SettingsStats;
+
+/*
+ * Loads the table. Eeprom24_Init() first. Blocking (about 50 ms at
+ * 400 kHz). Returns 0 if the EEPROM did not answer; the settings then
+ * only live in RAM.
+ */
+uint8_t  Settings_Init(uint32_t holdMs);
+
+/* Returns 0 if the key was never set */
+uint8_t  Settings_Get(uint8_t key, uint32_t *value);
+
+/* The value, or 'def' if the key was never set */
+uint32_t Settings_GetOr(uint8_t key, uint32_t def);
+
+void     Settings_Set(uint8_t key, uint32_t value);
+
+/* Writes the changed keys at the next Settings_Poll(), without waiting
+   for holdMs */
+void     Settings_Flush(void);
+
+/* Moves the EEPROM along; 'now' in ms */
+void     Settings_Poll(uint32_t now);
+
+/* 1 while changes are not stored yet */
+uint8_t  Settings_Pending(void);
+
+void     Settings_GetStats(SettingsStats *stats);
+
+#endif /* __SETTINGS_H__ */
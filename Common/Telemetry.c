@@ -0,0 +1,270 @@
+#include "Telemetry.h"
+
+#define SLOT_MASK      (TELEMETRY_SLOTS - 1u)
+#define DROP_EVERY_MS  100u       // at most one TLM_DROP per 100 ms
+
+#if (TELEMETRY_SLOTS & SLOT_MASK) != 0u || TELEMETRY_SLOTS > 128u
+#error "TELEMETRY_SLOTS must be a power of two, at most 128"
+#endif
+
+#if TELEMETRY_RESERVE + 2u > TELEMETRY_SLOTS
+#error "TELEMETRY_RESERVE leaves no room for ADC frames"
+#endif
+
+/* Slots in wire form; a transfer sends a run of them */
+static uint8_t  ring[TELEMETRY_SLOTS][TELEMETRY_WIRE];
+static volatile uint8_t ready[TELEMETRY_SLOTS];   // encoded, may be sent
+static volatile uint32_t head;                    // next slot to take
+static volatile uint32_t tail;                    // oldest slot not sent
+static volatile uint16_t inFlight;                // slots in the transfer
+static volatile uint8_t  suspended;
+static volatile uint8_t  rawBusy;                 // Telemetry_SendRaw()
+static uint8_t  seq;
+static uint8_t  dropPending;                      // TLM_DROP owed
+static uint32_t dropTime;                         // of the last TLM_DROP
+
+static TelemetryStats stats;
+
+static uint16_t crc16(const uint8_t *p, uint8_t n){
+  uint16_t crc = 0xFFFFu;
+
+  while (n--) {
+    crc ^= (uint16_t)(*p++ << 8);
+    for (uint8_t b = 0; b < 8u; b++) {
+      crc = (crc & 0x8000u) ? (uint16_t)((crc << 1) ^ 0x1021u) : (uint16_t)(crc << 1);
+    }
+  }
+  return crc;
+}
+
+static void put16(uint8_t *p, uint16_t v){
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+}
+
+static void put32(uint8_t *p, uint32_t v){
+  put16(p, (uint16_t)v);
+  put16(p + 2, (uint16_t)(v >> 16));
+}
+
+/* Frame -> 17 bytes without a 0x00, then the 0x00. Each code byte is
+   the distance to the next 0x00 of the frame (or to the end). */
+static void cobs(const uint8_t *in, uint8_t *out){
+  uint8_t *code = out;
+  uint8_t *o = out + 1;
+  uint8_t c = 1;
+
+  for (uint8_t i = 0; i < TELEMETRY_FRAME; i++) {
+    if (in[i] == 0u) {
+      *code = c;
+      code = o++;
+      c = 1;
+    } else {
+      *o++ = in[i];
+      c++;
+    }
+  }
+  *code = c;
+  *o = 0u;
+}
+
+static void encode(uint8_t slot, uint8_t type, uint8_t sq, uint32_t time,
+                   const uint8_t *payload){
+  uint8_t f[TELEMETRY_FRAME];
+
+  f[0] = type;
+  f[1] = sq;
+  put32(f + 2, time);
+  for (uint8_t i = 0; i < 8u; i++) {
+    f[6 + i] = payload[i];
+  }
+  put16(f + 14, crc16(f, 14u));
+  cobs(f, ring[slot]);
+}
+
+/* Sends the finished slots from the oldest on, up to the end of the
+   array; interrupts off */
+static void kick(void){
+  if (inFlight != 0u || suspended || rawBusy) {
+    return;
+  }
+  uint32_t first = tail & SLOT_MASK;
+  uint16_t n = 0;
+  while (tail + n != head && first + n < TELEMETRY_SLOTS && ready[first + n]) {
+    n++;
+  }
+  if (n == 0u) {
+    return;
+  }
+  inFlight = n;
+  stats.transfers++;
+  TelemetryPort_Start(ring[first], (uint16_t)(n * TELEMETRY_WIRE));
+}
+
+/* Takes a slot (and one for TLM_DROP if one is owed), encodes the
+   frame into it and hands it to kick() */
+static uint8_t queue(uint8_t type, const uint8_t *payload){
+  uint8_t  drop[8];
+  uint8_t  dropSlot = 0, dropSeq = 0, owed;
+  uint32_t time = TelemetryPort_Now();
+
+  /* ADC frames leave the last slots to the rarer events */
+  uint32_t room = type == TLM_ADC ? TELEMETRY_SLOTS - TELEMETRY_RESERVE : TELEMETRY_SLOTS;
+
+  uint32_t s = TelemetryPort_Lock();
+  uint32_t used = head - tail;
+  owed = dropPending && time - dropTime >= DROP_EVERY_MS;
+  if (used + 1u + owed > room) {
+    stats.dropped++;
+    seq++;
+    dropPending = 1;
+    TelemetryPort_Unlock(s);
+    return 0;
+  }
+  if (owed) {
+    dropTime = time;
+    dropSlot = (uint8_t)(head++ & SLOT_MASK);
+    dropSeq = seq++;
+    dropPending = 0;
+    put32(drop, stats.dropped);
+    put16(drop + 4, stats.maxUsed);
+    put16(drop + 6, TELEMETRY_SLOTS);
+  }
+  uint8_t slot = (uint8_t)(head++ & SLOT_MASK);
+  uint8_t sq = seq++;
+  stats.queued += 1u + owed;
+  used += 1u + owed;
+  if (used > stats.maxUsed) {
+    stats.maxUsed = (uint16_t)used;
+  }
+  TelemetryPort_Unlock(s);
+
+  if (owed) {
+    encode(dropSlot, TLM_DROP, dropSeq, time, drop);
+  }
+  encode(slot, type, sq, time, payload);
+
+  s = TelemetryPort_Lock();
+  if (owed) {
+    ready[dropSlot] = 1;
+  }
+  ready[slot] = 1;
+  kick();
+  TelemetryPort_Unlock(s);
+  return 1;
+}
+
+void Telemetry_Init(uint8_t app, uint32_t baud){
+  uint8_t p[8] = {0};
+
+  head = 0;
+  tail = 0;
+  inFlight = 0;
+  suspended = 0;
+  rawBusy = 0;
+  seq = 0;
+  dropPending = 0;
+  dropTime = 0u - DROP_EVERY_MS;
+  stats = (TelemetryStats){0};
+  for (uint16_t i = 0; i < TELEMETRY_SLOTS; i++) {
+    ready[i] = 0;
+  }
+  TelemetryPort_Init(baud);
+
+  p[0] = app;
+  p[1] = (uint8_t)TELEMETRY_SLOTS;
+  put32(p + 2, baud);
+  queue(TLM_BOOT, p);
+}
+
+uint8_t Telemetry_Adc(uint8_t ch, const uint16_t *samples, uint8_t n){
+  uint8_t p[8] = {0};
+
+  n = n > 3u ? 3u : n;
+  p[0] = ch;
+  p[1] = n;
+  for (uint8_t i = 0; i < n; i++) {
+    put16(p + 2 + 2 * i, samples[i]);
+  }
+  return queue(TLM_ADC, p);
+}
+
+uint8_t Telemetry_State(uint8_t machine, uint8_t from, uint8_t to,
+                        uint8_t inputs, uint32_t arg){
+  uint8_t p[8];
+
+  p[0] = machine;
+  p[1] = from;
+  p[2] = to;
+  p[3] = inputs;
+  put32(p + 4, arg);
+  return queue(TLM_STATE, p);
+}
+
+uint8_t Telemetry_Key(uint8_t source, uint8_t key, uint8_t down, uint32_t held){
+  uint8_t p[8];
+
+  p[0] = source;
+  p[1] = key;
+  p[2] = down ? 1u : 0u;
+  p[3] = 0;
+  put32(p + 4, held);
+  return queue(TLM_KEY, p);
+}
+
+uint8_t Telemetry_Counter(uint16_t id, uint32_t value){
+  uint8_t p[8];
+
+  put16(p, id);
+  put16(p + 2, 0);
+  put32(p + 4, value);
+  return queue(TLM_COUNTER, p);
+}
+
+void Telemetry_Suspend(void){
+  suspended = 1;
+  while (inFlight != 0u) {}
+}
+
+void Telemetry_Resume(void){
+  uint32_t s = TelemetryPort_Lock();
+  suspended = 0;
+  kick();
+  TelemetryPort_Unlock(s);
+}
+
+void Telemetry_SendRaw(const uint8_t *data, uint16_t n){
+  if (!suspended || n == 0u) {
+    return;
+  }
+  rawBusy = 1;
+  TelemetryPort_Start(data, n);
+  while (rawBusy) {}
+}
+
+uint8_t Telemetry_Pending(void){
+  return head != tail;
+}
+
+void Telemetry_GetStats(TelemetryStats *s){
+  uint32_t st = TelemetryPort_Lock();
+  *s = stats;
+  TelemetryPort_Unlock(st);
+}
+
+void Telemetry_TxDone(void){
+  uint32_t s = TelemetryPort_Lock();
+
+  if (rawBusy) {
+    rawBusy = 0;
+  } else {
+    for (uint16_t i = 0; i < inFlight; i++) {
+      ready[(tail + i) & SLOT_MASK] = 0;
+    }
+    tail += inFlight;
+    stats.sent += inFlight;
+    inFlight = 0;
+  }
+  kick();
+  TelemetryPort_Unlock(s);
+}
@@ -0,0 +1,168 @@
+#ifndef __TELEMETRY_H__
+#define __TELEMETRY_H__
+
+#include <stdint.h>
+
+/*
+ * Binary telemetry: fixed-size frames queued in RAM and sent by DMA.
+ * No HAL in here, so with Telemetry_Host.c it also runs on a PC
+ * (tools/telemetry_sim.c).
+ *
+ * Frame, 16 bytes before encoding:
+ *   [0]      type (TLM_...)
+ *   [1]      sequence number, +1 for every frame made, sent or not
+ *   [2..5]   time in ms, little-endian (TelemetryPort_Now())
+ *   [6..13]  payload, see the TLM_... types
+ *   [14..15] CRC-16/CCITT of bytes 0..13, little-endian
+ * On the wire it is COBS-encoded (17 bytes, no 0x00 in them) and ends
+ * with a 0x00, so every frame is exactly TELEMETRY_WIRE bytes and a
+ * receiver finds the next frame after any error at the next 0x00.
+ *
+ * Queueing: a frame goes into the next of TELEMETRY_SLOTS slots, in its
+ * wire form. The slot is taken with interrupts off, the frame encoded
+ * with them on, and the DMA then sends every finished slot from the
+ * oldest on in one transfer. So Telemetry_...() can be called from the
+ * main loop and from any interrupt, and never waits for the UART.
+ *
+ * Saturation: when all slots are taken the frame is dropped and
+ * counted, and its sequence number is skipped. TLM_ADC frames, which
+ * come in streams, already go when only TELEMETRY_RESERVE slots are
+ * left, so a saturated link still carries the states, keys and
+ * counters. After a drop, the next frame queued is preceded by a
+ * TLM_DROP frame with the total (at most one every 100 ms), so the
+ * receiver sees both that frames are missing and how many the device
+ * dropped; a gap the drop count does not explain was lost on the wire.
+ *
+ * Payloads (little-endian):
+ *   TLM_BOOT     [0] app (TLM_APP_...), [1] slots, [2..5] baud
+ *   TLM_ADC      [0] channel, [1] n (1..3), [2..7] n samples of 16 bits
+ *   TLM_STATE    [0] machine, [1] from, [2] to, [3] inputs, [4..7] arg
+ *   TLM_KEY      [0] source, [1] key, [2] 1 = down, [3] 0, [4..7] keys held
+ *   TLM_COUNTER  [0..1] id, [2..3] 0, [4..7] value
+ *   TLM_DROP     [0..3] frames dropped since Telemetry_Init(), [4..5]
+ *                most slots ever in use, [6..7] TELEMETRY_SLOTS
+ */
+
+#define TELEMETRY_BACKEND_USART  0
+#define TELEMETRY_BACKEND_HOST   1
+
+#ifndef TELEMETRY_BACKEND
+#define TELEMETRY_BACKEND        TELEMETRY_BACKEND_USART
+#endif
+
+/* Slots in the queue, a power of two; 18 bytes each */
+#ifndef TELEMETRY_SLOTS
+#define TELEMETRY_SLOTS          16u
+#endif
+
+/* Slots that TLM_ADC frames leave free */
+#ifndef TELEMETRY_RESERVE
+#define TELEMETRY_RESERVE        4u
+#endif
+
+#define TELEMETRY_FRAME          16u     // before encoding
+#define TELEMETRY_WIRE           18u     // COBS + 0x00
+
+#define TLM_BOOT                 0u
+#define TLM_ADC                  1u
+#define TLM_STATE                2u
+#define TLM_KEY                  3u
+#define TLM_COUNTER              4u
+#define TLM_DROP                 5u
+
+#define TLM_APP_POSITION         1u
+#define TLM_APP_TRAFFIC          2u
+#define TLM_APP_SSEG             3u
+#define TLM_APP_PIANO            4u
+#define TLM_APP_SIM              0x7Fu
+
+typedef struct {
+  uint32_t queued;           // frames taken into a slot, TLM_DROP too
+  uint32_t dropped;          // frames lost to a full queue
+  uint32_t sent;             // frames whose DMA transfer has completed
+  uint32_t transfers;        // DMA transfers
+  uint16_t maxUsed;          // most slots in use at once
+} TelemetryStats;
+
+/*
+ * Sets up the port at 'baud' (8N1) and queues a TLM_BOOT frame. With
+ * the USART port at 8 MHz, 250000 and 500000 are exact and 115200 is
+ * 0.6% off.
+ */
+void Telemetry_Init(uint8_t app, uint32_t baud);
+
+/* Each returns 0 if the frame was dropped */
+uint8_t Telemetry_Adc(uint8_t ch, const uint16_t *samples, uint8_t n);
+uint8_t Telemetry_State(uint8_t machine, uint8_t from, uint8_t to,
+                        uint8_t inputs, uint32_t arg);
+uint8_t Telemetry_Key(uint8_t source, uint8_t key, uint8_t down, uint32_t held);
+uint8_t Telemetry_Counter(uint16_t id, uint32_t value);
+
+/*
+ * Stops sending after the transfer in progress and waits for it, so
+ * the port can be used for something else (a scope dump). Frames are
+ * still queued, or dropped once the queue is full; Telemetry_Resume()
+ * sends them.
+ */
+void    Telemetry_Suspend(void);
+void    Telemetry_Resume(void);
+
+/* Sends n bytes as they are and waits; only while suspended */
+void    Telemetry_SendRaw(const uint8_t *data, uint16_t n);
+
+/* 1 while frames are queued or being sent */
+uint8_t Telemetry_Pending(void);
+
+void    Telemetry_GetStats(TelemetryStats *stats);
+
+/* The port calls this, from its interrupt, when a transfer is done */
+void    Telemetry_TxDone(void);
+
+/*
+ * Port, one per backend:
+ *   Telemetry_Usart.c : USART TX by DMA, see TELEMETRY_PORT below
+ *   Telemetry_Host.c  : a file descriptor on a PC, paced like a UART
+ * TelemetryPort_Start() returns at once; the port calls
+ * Telemetry_TxDone() when the n bytes have gone out.
+ */
+void     TelemetryPort_Init(uint32_t baud);
+void     TelemetryPort_Start(const uint8_t *data, uint16_t n);
+uint32_t TelemetryPort_Lock(void);         // interrupts off, returns the old state
+void     TelemetryPort_Unlock(uint32_t state);
+uint32_t TelemetryPort_Now(void);          // ms
+
+#if TELEMETRY_BACKEND == TELEMETRY_BACKEND_USART
+/*
+ * TX pin, USART and DMA channel (F051):
+ *   TELEMETRY_PORT_USART2_PA2 : PA2 (AF1), DMA1 channel 4. The default.
+ *   TELEMETRY_PORT_USART1_PA9 : PA9 (AF1), DMA1 channel 2
+ *   TELEMETRY_PORT_USART1_PB6 : PB6 (AF0), DMA1 channel 2
+ * stm32f0xx_it.c: call Telemetry_IRQHandler() from
+ * DMA1_Channel4_5_IRQHandler() (USART2) or DMA1_Channel2_3_IRQHandler()
+ * (USART1). It only looks at its own channel, so it can share the
+ * handler with another driver's channel.
+ */
+#define TELEMETRY_PORT_USART2_PA2  0
+#define TELEMETRY_PORT_USART1_PA9  1
+#define TELEMETRY_PORT_USART1_PB6  2
+
+#ifndef TELEMETRY_PORT
+#define TELEMETRY_PORT             TELEMETRY_PORT_USART2_PA2
+#endif
+
+void     Telemetry_IRQHandler(void);
+#endif
+
+#if TELEMETRY_BACKEND == TELEMETRY_BACKEND_HOST
+/*
+ * Bytes go to 'fd' (a pty, a pipe, a file) at 'baud' 8N1 speed: a
+ * transfer of n bytes finishes n * 10 / baud seconds after it started.
+ * TelemetryHost_Run() moves the simulated time on; 'errorRate' is the
+ * chance of a flipped bit per byte on the wire.
+ */
+void     TelemetryHost_Open(int fd, double errorRate);
+void     TelemetryHost_Run(uint32_t us);
+uint32_t TelemetryHost_WireBytes(void);
+#endif
+
+#endif /* __TELEMETRY_H__ */
@@ -0,0 +1,102 @@
+#include "Telemetry.h"
+
+#if TELEMETRY_BACKEND == TELEMETRY_BACKEND_HOST
+
+#include <stdlib.h>
+#include <unistd.h>
+
+/*
+ * Telemetry port on a PC, for tools/telemetry_sim.c. A transfer is
+ * copied, then written to the file descriptor byte by byte as the
+ * simulated time reaches the end of each byte's 10 bit times; the last
+ * byte calls Telemetry_TxDone(), as the DMA interrupt does. One thread,
+ * so the lock does nothing.
+ */
+
+#define MAX_TRANSFER  (TELEMETRY_SLOTS * TELEMETRY_WIRE)
+
+static int      out = -1;
+static double   flipRate;
+static double   byteUs;                 // 10 bit times
+static uint64_t nowUs;
+static uint8_t  buf[MAX_TRANSFER];
+static uint16_t len;
+static uint16_t pos;
+static uint64_t startUs;
+static uint32_t wireBytes;
+
+void TelemetryHost_Open(int fd, double errorRate){
+  out = fd;
+  flipRate = errorRate;
+}
+
+void TelemetryPort_Init(uint32_t baud){
+  byteUs = 10.0e6 / baud;
+  nowUs = 0;
+  len = 0;
+  pos = 0;
+  wireBytes = 0;
+}
+
+void TelemetryPort_Start(const uint8_t *data, uint16_t n){
+  for (uint16_t i = 0; i < n && i < MAX_TRANSFER; i++) {
+    buf[i] = data[i];
+  }
+  len = n;
+  pos = 0;
+  startUs = nowUs;
+}
+
+uint32_t TelemetryPort_Lock(void){
+  return 0;
+}
+
+void TelemetryPort_Unlock(uint32_t state){
+  (void)state;
+}
+
+uint32_t TelemetryPort_Now(void){
+  return (uint32_t)(nowUs / 1000u);
+}
+
+/* Writes the bytes whose stop bit has gone out by nowUs */
+static void drain(void){
+  uint16_t from = pos;
+
+  while (pos < len && startUs + (uint64_t)((pos + 1u) * byteUs) <= nowUs) {
+    if (flipRate > 0.0 && rand() < flipRate * RAND_MAX) {
+      buf[pos] ^= (uint8_t)(1u << (rand() % 8));
+    }
+    pos++;
+  }
+  if (pos > from && out >= 0) {
+    ssize_t r = write(out, buf + from, pos - from);
+    (void)r;
+  }
+  wireBytes += pos - from;
+  if (len != 0u && pos == len) {
+    len = 0;
+    Telemetry_TxDone();               // may start the next transfer at nowUs
+  }
+}
+
+void TelemetryHost_Run(uint32_t us){
+  uint64_t end = nowUs + us;
+
+  while (nowUs < end) {
+    if (len == 0u) {
+      nowUs = end;
+      break;
+    }
+    uint64_t next = startUs + (uint64_t)(len * byteUs);   // transfer end
+    nowUs = next < end ? next : end;
+    drain();
+  }
+  drain();
+}
+
+uint32_t TelemetryHost_WireBytes(void){
+  return wireBytes;
+}
+
+#endif /* TELEMETRY_BACKEND_HOST */
@@ -0,0 +1,112 @@
+#include "Telemetry.h"
+
+#if TELEMETRY_BACKEND == TELEMETRY_BACKEND_USART
+
+#include "main.h"
+
+/*
+ * Telemetry on a USART TX pin, fed by a DMA1 channel. TX only; the
+ * USART runs from PCLK (8 MHz HSI). Each TelemetryPort_Start() is one
+ * memory-to-USART transfer, and its transfer-complete interrupt calls
+ * Telemetry_TxDone(), which starts the next one. TC fires when the last
+ * byte has gone into TDR, so the next transfer follows without a gap.
+ */
+
+#if TELEMETRY_PORT == TELEMETRY_PORT_USART2_PA2
+#define TLM_USART     USART2
+#define TLM_DMA       DMA1_Channel4
+#define TLM_TCIF      DMA_ISR_TCIF4
+#define TLM_CLEAR     DMA_IFCR_CGIF4
+#define TLM_IRQn      DMA1_Channel4_5_IRQn
+#define TLM_GPIO      GPIOA
+#define TLM_PIN       GPIO_PIN_2
+#define TLM_AF        GPIO_AF1_USART2
+#elif TELEMETRY_PORT == TELEMETRY_PORT_USART1_PA9 || TELEMETRY_PORT == TELEMETRY_PORT_USART1_PB6
+#define TLM_USART     USART1
+#define TLM_DMA       DMA1_Channel2            // USART1_TX without the remap
+#define TLM_TCIF      DMA_ISR_TCIF2
+#define TLM_CLEAR     DMA_IFCR_CGIF2
+#define TLM_IRQn      DMA1_Channel2_3_IRQn
+#if TELEMETRY_PORT == TELEMETRY_PORT_USART1_PA9
+#define TLM_GPIO      GPIOA
+#define TLM_PIN       GPIO_PIN_9
+#define TLM_AF        GPIO_AF1_USART1
+#else
+#define TLM_GPIO      GPIOB
+#define TLM_PIN       GPIO_PIN_6
+#define TLM_AF        GPIO_AF0_USART1
+#endif
+#else
+#error "Unknown TELEMETRY_PORT"
+#endif
+
+void TelemetryPort_Init(uint32_t baud){
+  GPIO_InitTypeDef GPIO_InitStruct = {0};
+
+#if TELEMETRY_PORT == TELEMETRY_PORT_USART2_PA2
+  __HAL_RCC_USART2_CLK_ENABLE();
+#else
+  __HAL_RCC_USART1_CLK_ENABLE();
+  SYSCFG->CFGR1 &= ~SYSCFG_CFGR1_USART1TX_DMA_RMP;
+#endif
+  if (TLM_GPIO == GPIOA) {
+    __HAL_RCC_GPIOA_CLK_ENABLE();
+  } else {
+    __HAL_RCC_GPIOB_CLK_ENABLE();
+  }
+  __HAL_RCC_DMA1_CLK_ENABLE();
+
+  GPIO_InitStruct.Pin = TLM_PIN;
+  GPIO_InitStruct.Mode = GPIO_MODE_AF_PP;
+  GPIO_InitStruct.Pull = GPIO_NOPULL;
+  GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH;
+  GPIO_InitStruct.Alternate = TLM_AF;
+  HAL_GPIO_Init(TLM_GPIO, &GPIO_InitStruct);
+
+  TLM_USART->CR1 = 0;
+  TLM_USART->BRR = (HAL_RCC_GetPCLK1Freq() + baud / 2u) / baud;
+  TLM_USART->CR3 = USART_CR3_DMAT;
+  TLM_USART->CR1 = USART_CR1_TE | USART_CR1_UE;
+
+  /* Bytes, memory to peripheral, interrupt on transfer complete */
+  TLM_DMA->CCR = 0;
+  TLM_DMA->CPAR = (uint32_t)&TLM_USART->TDR;
+  TLM_DMA->CCR = DMA_CCR_MINC | DMA_CCR_DIR | DMA_CCR_TCIE;
+  DMA1->IFCR = TLM_CLEAR;
+
+  HAL_NVIC_SetPriority(TLM_IRQn, 3, 0);        // lowest, like the EEPROM
+  HAL_NVIC_EnableIRQ(TLM_IRQn);
+}
+
+void TelemetryPort_Start(const uint8_t *data, uint16_t n){
+  TLM_DMA->CCR  &= ~DMA_CCR_EN;
+  TLM_DMA->CMAR  = (uint32_t)data;
+  TLM_DMA->CNDTR = n;
+  TLM_DMA->CCR  |= DMA_CCR_EN;
+}
+
+uint32_t TelemetryPort_Lock(void){
+  uint32_t s = __get_PRIMASK();
+
+  __disable_irq();
+  return s;
+}
+
+void TelemetryPort_Unlock(uint32_t state){
+  __set_PRIMASK(state);
+}
+
+/* A project whose SysTick stops while it sleeps brings its own clock */
+__weak uint32_t TelemetryPort_Now(void){
+  return HAL_GetTick();
+}
+
+void Telemetry_IRQHandler(void){
+  if (DMA1->ISR & TLM_TCIF) {
+    DMA1->IFCR = TLM_CLEAR;
+    TLM_DMA->CCR &= ~DMA_CCR_EN;
+    Telemetry_TxDone();
+  }
+}
+
+#endif /* TELEMETRY_BACKEND_USART */
@@ -0,0 +1,24 @@
+#include "Timebase.h"
+#include "main.h"   // HAL tick, SysTick and SCB registers
+
+uint32_t Timebase_Us(void){
+  uint32_t primask = __get_PRIMASK();
+  uint32_t ms;
+  uint32_t val;
+  uint32_t wrapped;
+
+  // Read the tick and the counter without the SysTick ISR in between
+  __disable_irq();
+  ms      = HAL_GetTick();
+  val     = SysTick->VAL;
+  wrapped = SCB->ICSR & SCB_ICSR_PENDSTSET_Msk;
+  __set_PRIMASK(primask);
+
+  // The counter reloaded but its interrupt has not run yet (we may be
+  // in a higher-priority ISR): the tick is one behind.
+  if (wrapped && val > (SysTick->LOAD >> 1)) {
+    ms++;
+  }
+
+  return ms * 1000u + (SysTick->LOAD - val) / TIMEBASE_CPU_MHZ;
+}
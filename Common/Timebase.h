@@ -0,0 +1,21 @@
+#ifndef __TIMEBASE_H__
+#define __TIMEBASE_H__
+
+#include <stdint.h>
+
+/*
+ * Microsecond timestamps, used by the digital piano's key events and
+ * the Seven_Seg_Display_Driver button debounce.
+ *
+ * Built from the HAL 1 ms tick plus the SysTick down-counter, so it needs
+ * no extra timer. Safe to call from any interrupt or the main loop.
+ * The count wraps after ~71 minutes; compare timestamps by subtraction.
+ */
+
+#ifndef TIMEBASE_CPU_MHZ
+#define TIMEBASE_CPU_MHZ  8u   // SysTick runs from HCLK = HSI 8 MHz
+#endif
+
+uint32_t Timebase_Us(void);
+
+#endif /* __TIMEBASE_H__ */
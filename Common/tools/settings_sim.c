@@ -0,0 +1,243 @@
+/*
+ * Run the settings store (Settings.c) against the RAM 24AA16
+ * (Eeprom24_Ram.c) on a PC:
+ *   1. a counter that a hand on the buttons changes in bursts, as g_num
+ *      in Seven_Seg_Display_Driver: EEPROM writes and wear
+ *   2. restarts, checking every key against what was set
+ *   3. power failures at random points of a write
+ *   4. corrupted bytes in the EEPROM
+ *   5. more than 256 compactions, so the generation byte in the records
+ *      wraps while old records are still in the areas
+ *
+ * Build from the Common folder:
+ *   gcc -O2 -Wall -Wextra -I. -DEEPROM24_BACKEND=EEPROM24_BACKEND_RAM -o settings_sim \
+ *       tools/settings_sim.c Settings.c Eeprom24_Ram.c
+ *   ./settings_sim [seed]
+ *
+ * Time is in ms and Settings_Poll() runs every ms, as in the main loops.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include "Settings.h"
+
+#define HOLD_MS      2000u
+#define KEYS         8u              // the ones the projects use
+#define PRESSES      20000u
+#define FAILURES     2000u
+#define CORRUPTIONS  2000u
+#define WRAP_GENS    1200u           // compactions for test 5
+
+/* Value k << 24 | serial, so a loaded value shows which Set() it came from */
+static uint32_t serial[KEYS];        // newest one made
+static uint32_t current[KEYS];       // in the RAM table
+static uint32_t stored[KEYS];        // known to be in the EEPROM
+static uint32_t now;
+
+static void set(uint8_t k){
+  current[k] = ((uint32_t)k << 24) | ++serial[k];
+  Settings_Set(k, current[k]);
+}
+
+static void committed(void){
+  for (uint8_t k = 0; k < KEYS; k++) {
+    stored[k] = current[k];
+  }
+}
+
+/* After a restart the table holds what the EEPROM had */
+static void reloaded(void){
+  for (uint8_t k = 0; k < KEYS; k++) {
+    current[k] = 0;
+    Settings_Get(k, &current[k]);
+    stored[k] = current[k];
+  }
+}
+
+static void run(uint32_t ms){
+  while (ms--) {
+    Settings_Poll(now++);
+  }
+}
+
+static void settle(void){
+  Settings_Flush();
+  while (Settings_Pending()) {
+    Settings_Poll(now++);
+  }
+  committed();
+}
+
+/* Restart: the RAM table is lost, the EEPROM is not */
+static void restart(void){
+  Settings_Init(HOLD_MS);
+}
+
+/* 0: every key as stored, or newer; 1: some key older than stored;
+   2: a value that was never set for its key */
+static int check(void){
+  int r = 0;
+
+  for (uint8_t k = 0; k < KEYS; k++) {
+    uint32_t v = 0;
+    Settings_Get(k, &v);
+    if (v == stored[k]) {
+      continue;
+    }
+    if (v != 0u && ((v >> 24) != k || (v & 0xFFFFFFu) > serial[k])) {
+      return 2;
+    }
+    if ((v & 0xFFFFFFu) < (stored[k] & 0xFFFFFFu)) {
+      r = 1;
+    }
+  }
+  return r;
+}
+
+static void burstDay(void){
+  SettingsStats ss;
+  Eeprom24RamStats es;
+  uint32_t presses = 0;
+
+  Eeprom24_Init();
+  restart();
+  while (presses < PRESSES) {
+    /* 1..30 presses (auto-repeat) 150 ms apart, then 1..60 s off */
+    uint32_t n = 1u + (uint32_t)(rand() % 30);
+    for (uint32_t i = 0; i < n; i++) {
+      set(SET_SSEG_NUM);
+      presses++;
+      run(150);
+    }
+    if (rand() % 50 == 0) {
+      set((uint8_t)(SET_TL_T_G + rand() % 7));
+    }
+    run(1000u + (uint32_t)(rand() % 59000));
+  }
+  settle();
+  Settings_GetStats(&ss);
+  Eeprom24_RamGetStats(&es);
+
+  uint32_t minC = 0xFFFFFFFFu, maxC = 0;
+  for (uint32_t p = 0; p < EEPROM24_SIZE / EEPROM24_PAGE; p++) {
+    minC = es.pageCycles[p] < minC ? es.pageCycles[p] : minC;
+    maxC = es.pageCycles[p] > maxC ? es.pageCycles[p] : maxC;
+  }
+  printf("%u presses: %u changes, %u coalesced, %u records, %u page writes "
+         "(%.1f%% of one write per change), %u compactions\n",
+         presses, ss.sets, ss.coalesced, ss.records, es.writes,
+         100.0 * es.writes / ss.sets, ss.compactions);
+  printf("  wear per page %u..%u cycles, %.0fM changes until a page has 1M\n",
+         minC, maxC, (double)ss.sets / maxC);
+
+  uint32_t reads = es.reads, readBytes = es.readBytes;
+  restart();
+  Eeprom24_RamGetStats(&es);
+  Settings_GetStats(&ss);
+  printf("  restart: %u records replayed, %u read transfer of %u bytes, %s\n",
+         ss.loaded, es.reads - reads, es.readBytes - readBytes,
+         check() == 0 ? "all keys match" : "MISMATCH");
+}
+
+static int failures(void){
+  uint32_t bad = 0, lost = 0, cut = 0;
+
+  for (uint32_t f = 0; f < FAILURES; f++) {
+    /* Change some keys, then fail somewhere in the write */
+    uint32_t n = 1u + (uint32_t)(rand() % KEYS);
+    for (uint32_t i = 0; i < n; i++) {
+      set((uint8_t)(rand() % KEYS));
+    }
+    Settings_Flush();
+    uint32_t polls = (uint32_t)(rand() % 40);
+    while (polls-- && Settings_Pending()) {
+      Settings_Poll(now++);
+    }
+    if (Settings_Pending()) {
+      cut++;
+    } else {
+      committed();
+    }
+    Eeprom24_RamPowerFail((uint8_t)(rand() % (EEPROM24_PAGE + 1u)));
+    restart();
+
+    int r = check();
+    bad += (r == 2);
+    lost += (r == 1);
+    reloaded();
+  }
+  SettingsStats ss;
+  Settings_GetStats(&ss);
+  printf("%u power failures (%u during a write): %u bad values, %u stored "
+         "values lost, generation %u\n", FAILURES, cut, bad, lost, ss.generation);
+  return bad != 0u || lost != 0u;
+}
+
+static int corruption(void){
+  uint32_t bad = 0, stale = 0, skipped = 0;
+  uint8_t *mem = Eeprom24_RamImage();
+
+  for (uint32_t c = 0; c < CORRUPTIONS; c++) {
+    for (uint32_t i = 0; i < 3u; i++) {
+      set((uint8_t)(rand() % KEYS));
+    }
+    settle();
+
+    mem[rand() % EEPROM24_SIZE] ^= (uint8_t)(1u << (rand() % 8));
+    restart();
+
+    SettingsStats ss;
+    Settings_GetStats(&ss);
+    skipped += ss.skipped;
+    int r = check();
+    bad += (r == 2);
+    stale += (r == 1);
+
+    reloaded();
+  }
+  printf("%u flipped bits: %u bad values, %u restarts with an older value, "
+         "%u bad slots skipped (summed over the restarts)\n", CORRUPTIONS, bad, stale, skipped);
+  return bad != 0u;
+}
+
+static int wrap(void){
+  uint32_t restarts = 0, bad = 0, lost = 0, settles = 0;
+  SettingsStats ss;
+
+  /* Fill both areas to the last slot with one key per record... */
+  Settings_GetStats(&ss);
+  uint32_t until = ss.generation + 3u;
+  while (ss.generation < until) {
+    set((uint8_t)(rand() % KEYS));
+    settle();
+    Settings_GetStats(&ss);
+  }
+  /* ...then write every key at once, so each journal ends a few slots
+     short and those slots keep their old records for good */
+  until = ss.generation + WRAP_GENS;
+  while (ss.generation < until) {
+    for (uint8_t k = 0; k < KEYS; k++) {
+      set(k);
+    }
+    settle();
+    if (++settles % 5u == 0u) {
+      restart();
+      restarts++;
+      int r = check();
+      bad += (r == 2);
+      lost += (r == 1);
+      reloaded();
+    }
+    Settings_GetStats(&ss);
+  }
+  printf("%u compactions (generation %u), %u restarts: %u bad values, "
+         "%u stored values lost\n", WRAP_GENS, ss.generation, restarts, bad, lost);
+  return bad != 0u || lost != 0u;
+}
+
+int main(int argc, char **argv){
+  srand(argc > 1 ? (unsigned)atoi(argv[1]) : 1u);
+  burstDay();
+  int r = failures();
+  r |= corruption();
+  return wrap() | r;
+}
@@ -0,0 +1,181 @@
+/*
+ * Run the telemetry queue (Telemetry.c) on a PC. Telemetry_Host.c sends
+ * the frames at UART speed to a pty, so tools/tlm_record.py reads them
+ * just as it reads the board, or to a file:
+ *   ./telemetry_sim -p -r 500 -t 10      (prints the pty, then waits 2 s)
+ *   python3 tools/tlm_record.py /dev/pts/N
+ *
+ *   ./telemetry_sim -o tlm.bin -r 800    (as fast as it can)
+ *   python3 tools/tlm_record.py tlm.bin
+ *
+ * Build from the Common folder:
+ *   gcc -O2 -Wall -Wextra -I. -DTELEMETRY_BACKEND=TELEMETRY_BACKEND_HOST -o telemetry_sim \
+ *       tools/telemetry_sim.c Telemetry.c Telemetry_Host.c -lm
+ *
+ * Load, every ms of simulated time as in the projects' interrupts and
+ * main loops: ADC frames of 3 samples at -r frames/s, an FSM transition
+ * every 0.5..3 s, key bursts, and one counter per second.
+ *
+ * Options: -b baud (115200), -r ADC frames/s (300), -t seconds (10),
+ * -e bit errors per byte on the wire (0), -s seed, -w ms to wait for
+ * the reader (2000, with -p).
+ */
+#define _DEFAULT_SOURCE
+#define _XOPEN_SOURCE 600
+#include <fcntl.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include "Telemetry.h"
+
+static uint32_t ms;
+
+static void sleepUntil(const struct timespec *t0, uint32_t at){
+  struct timespec t = *t0;
+
+  t.tv_sec += at / 1000u;
+  t.tv_nsec += (long)(at % 1000u) * 1000000L;
+  if (t.tv_nsec >= 1000000000L) {
+    t.tv_sec++;
+    t.tv_nsec -= 1000000000L;
+  }
+  clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &t, NULL);
+}
+
+static int openPty(int *slave){
+  int m = posix_openpt(O_RDWR | O_NOCTTY);
+  struct termios tio;
+
+  if (m < 0 || grantpt(m) != 0 || unlockpt(m) != 0) {
+    return -1;
+  }
+  /* Keep the slave open and raw, so nothing is translated or lost
+     before the reader opens it */
+  *slave = open(ptsname(m), O_RDWR | O_NOCTTY);
+  if (*slave < 0 || tcgetattr(*slave, &tio) != 0) {
+    return -1;
+  }
+  cfmakeraw(&tio);
+  tcsetattr(*slave, TCSANOW, &tio);
+  printf("%s\n", ptsname(m));
+  fflush(stdout);
+  return m;
+}
+
+int main(int argc, char **argv){
+  uint32_t baud = 115200, rate = 300, seconds = 10, waitMs = 2000;
+  double err = 0.0;
+  const char *file = NULL;
+  int pty = 0, opt, fd, slave = -1;
+
+  while ((opt = getopt(argc, argv, "b:r:t:e:s:w:o:p")) != -1) {
+    switch (opt) {
+      case 'b': baud = (uint32_t)atol(optarg); break;
+      case 'r': rate = (uint32_t)atol(optarg); break;
+      case 't': seconds = (uint32_t)atol(optarg); break;
+      case 'e': err = atof(optarg); break;
+      case 's': srand((unsigned)atoi(optarg)); break;
+      case 'w': waitMs = (uint32_t)atol(optarg); break;
+      case 'o': file = optarg; break;
+      case 'p': pty = 1; break;
+      default:
+        fprintf(stderr, "usage: %s [-p | -o file] [-b baud] [-r frames/s] "
+                "[-t s] [-e rate] [-s seed] [-w ms]\n", argv[0]);
+        return 2;
+    }
+  }
+  if (pty) {
+    fd = openPty(&slave);
+  } else if (file) {
+    fd = open(file, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  } else {
+    fd = -1;                             // count only
+  }
+  if ((pty || file) && fd < 0) {
+    perror("telemetry_sim");
+    return 1;
+  }
+
+  struct timespec t0;
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  if (pty) {
+    sleepUntil(&t0, waitMs);
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+  }
+
+  TelemetryHost_Open(fd, err);
+  Telemetry_Init(TLM_APP_SIM, baud);
+
+  uint32_t adcAcc = 0, nextState = 500, nextBurst = 300;
+  uint8_t  state = 0, keys = 0, burst = 0;
+  uint32_t adcOk = 0, adcFrames = 0;
+  uint16_t s[3];
+
+  for (ms = 0; ms < seconds * 1000u; ms++) {
+    /* ADC interrupt: rate frames/s, 3 samples each (a 1 Hz sine) */
+    for (adcAcc += rate; adcAcc >= 1000u; adcAcc -= 1000u) {
+      for (uint8_t i = 0; i < 3u; i++) {
+        s[i] = (uint16_t)(2048.0 + 1800.0 * sin(6.2831853 * (ms + i / 3.0) / 1000.0));
+      }
+      adcOk += Telemetry_Adc(0, s, 3);
+      adcFrames++;
+    }
+    /* Main loop: FSM, keys, counters */
+    if (ms == nextState) {
+      uint8_t to = (uint8_t)(rand() % 30);
+      Telemetry_State(0, state, to, (uint8_t)(rand() % 8), 50u + (uint32_t)(rand() % 250));
+      state = to;
+      nextState = ms + 500u + (uint32_t)(rand() % 2500);
+    }
+    if (ms == nextBurst) {
+      burst = (uint8_t)(1 + rand() % 8);
+      nextBurst = ms + 200u + (uint32_t)(rand() % 3000);
+    }
+    if (burst != 0u && ms % 20u == 0u) {
+      uint8_t k = (uint8_t)(rand() % 3);
+      keys ^= (uint8_t)(1u << k);
+      Telemetry_Key(0, k, (keys >> k) & 1u, keys);
+      burst--;
+    }
+    if (ms % 1000u == 999u) {
+      Telemetry_Counter(1, ms + 1u);
+    }
+
+    TelemetryHost_Run(1000);
+    if (pty) {
+      sleepUntil(&t0, ms + 1u);
+    }
+  }
+  /* Let the queue empty */
+  while (Telemetry_Pending()) {
+    TelemetryHost_Run(1000);
+    if (pty) {
+      sleepUntil(&t0, ms + 1u);
+    }
+    ms++;
+  }
+
+  TelemetryStats st;
+  Telemetry_GetStats(&st);
+  double wire = (double)TelemetryHost_WireBytes();
+  printf("%u s at %u baud, %u ADC frames/s offered: %u queued, %u dropped "
+         "(%u of %u ADC frames), %u sent in %u transfers (%.1f frames each), "
+         "most slots in use %u of %u\n",
+         seconds, baud, rate, st.queued, st.dropped, adcFrames - adcOk, adcFrames,
+         st.sent, st.transfers, st.transfers ? (double)st.sent / st.transfers : 0.0,
+         st.maxUsed, TELEMETRY_SLOTS);
+  printf("  %.0f bytes on the wire, %.0f bytes/s, link %.1f%% busy\n",
+         wire, wire * 1000.0 / ms, 100.0 * wire * 10.0 / baud * 1000.0 / ms);
+
+  if (pty) {
+    usleep(500000);                      // let the reader catch up
+    close(slave);
+  }
+  if (fd >= 0) {
+    close(fd);
+  }
+  return 0;
+}
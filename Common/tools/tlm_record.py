@@ -0,0 +1,257 @@
+#!/usr/bin/env python3
+"""Record and decode the telemetry stream (Telemetry.h).
+
+Reads from a serial port, a pty (tools/telemetry_sim.c -p) or a file,
+checks every frame (COBS, length, CRC, sequence) and prints how much
+got through: frames/s, bytes/s, link use, frames lost in the device
+queue (TLM_DROP) and on the wire. Decoded frames go to a CSV with -o.
+
+    python3 tools/tlm_record.py /dev/ttyUSB0 --baud 115200 -o run.csv
+    python3 tools/tlm_record.py /dev/pts/3            # telemetry_sim -p
+    python3 tools/tlm_record.py tlm.bin               # a saved stream
+
+A tty is set to raw mode at --baud with termios, so no pyserial is
+needed. It stops at the end of a file, when a pty closes, after
+--seconds, or after --idle seconds without data once data came.
+"""
+import argparse
+import os
+import select
+import struct
+import sys
+import time
+
+FRAME = 16
+TYPES = ["boot", "adc", "state", "key", "counter", "drop"]
+APPS = {1: "position", 2: "traffic", 3: "sseg", 4: "piano", 0x7F: "sim"}
+
+
+def crc16(data, crc=0xFFFF):
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) & 0xFFFF if crc & 0x8000 else (crc << 1) & 0xFFFF
+    return crc
+
+
+def cobs_decode(data):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        if code == 0 or i + code > len(data):
+            return None
+        out += data[i + 1:i + code]
+        i += code
+        if code < 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def fields(kind, p):
+    """Payload -> list of values, in the order of Telemetry.h"""
+    if kind == 0:
+        app, slots, baud = struct.unpack_from("<BBI", p)
+        return [APPS.get(app, app), slots, baud]
+    if kind == 1:
+        ch, n = p[0], min(p[1], 3)
+        return [ch, n] + list(struct.unpack_from("<%dH" % n, p, 2))
+    if kind == 2:
+        return list(struct.unpack_from("<BBBBI", p))
+    if kind == 3:
+        source, key, down, _, held = struct.unpack_from("<BBBBI", p)
+        return [source, key, down, held]
+    if kind == 4:
+        ident, _, value = struct.unpack_from("<HHI", p)
+        return [ident, value]
+    if kind == 5:
+        return list(struct.unpack_from("<IHH", p))
+    return [p.hex()]
+
+
+class Recorder:
+    def __init__(self, baud, csv):
+        self.baud = baud
+        self.csv = csv
+        self.buf = bytearray()
+        self.synced = False
+        self.bytes = 0
+        self.first = None
+        self.last = None
+        self.frames = 0
+        self.by_type = [0] * len(TYPES)
+        self.crc_errors = 0
+        self.bad_frames = 0            # not 16 bytes after COBS, or bad COBS
+        self.seq = None
+        self.lost = 0                  # from sequence gaps
+        self.gaps = 0                  # since the last TLM_DROP
+        self.dev_drops = 0             # from TLM_DROP, since the last boot
+        self.dev_drops_total = 0
+        self.boots = 0
+        self.t_first = None            # device clock, ms
+        self.t_last = None
+
+    def feed(self, data, now):
+        if self.first is None:
+            self.first = now
+        self.last = now
+        self.bytes += len(data)
+        self.buf += data
+        while True:
+            end = self.buf.find(b"\0")
+            if end < 0:
+                return
+            chunk = bytes(self.buf[:end])
+            del self.buf[:end + 1]
+            if chunk:
+                self.frame(chunk, now)
+            self.synced = True
+
+    def frame(self, chunk, now):
+        f = cobs_decode(chunk)
+        ok = f is not None and len(f) == FRAME
+        if ok and crc16(f[:14]) != struct.unpack_from("<H", f, 14)[0]:
+            ok = False
+            if self.synced:
+                self.crc_errors += 1
+        elif not ok and self.synced:
+            self.bad_frames += 1
+        if not ok:
+            return                     # or the tail of a frame sent before we listened
+        kind, seq, t = f[0], f[1], struct.unpack_from("<I", f, 2)[0]
+        p = f[6:14]
+        vals = fields(kind, p)
+        if kind == 0:
+            self.boots += 1
+            self.seq = None
+            self.dev_drops = 0
+            if self.baud is None:
+                self.baud = vals[2]
+        if kind == 0:
+            self.lost += self.gaps
+            self.gaps = 0
+        elif self.seq is not None:
+            self.gaps += (seq - self.seq - 1) & 0xFF
+        if kind == 5:
+            # More than 255 lost between two TLM_DROP frames wraps the
+            # 8-bit sequence; the drop count says by how much
+            delta = vals[0] - self.dev_drops
+            while self.gaps < delta:
+                self.gaps += 256
+            self.lost += self.gaps
+            self.gaps = 0
+        self.seq = seq
+        if self.t_first is None:
+            self.t_first = t
+        self.t_last = t
+        if kind == 5:
+            self.dev_drops_total += vals[0] - self.dev_drops
+            self.dev_drops = vals[0]
+        self.frames += 1
+        if kind < len(TYPES):
+            self.by_type[kind] += 1
+        if self.csv:
+            name = TYPES[kind] if kind < len(TYPES) else str(kind)
+            self.csv.write("%.6f,%s,%d,%d,%s\n" % (now - self.first, name, seq, t,
+                                                  ",".join(str(v) for v in vals)))
+
+    def summary(self, live):
+        """Rates over the host clock when reading a live port, else over
+        the device clock (a file reads in no time)"""
+        span = (self.last - self.first) if self.first is not None else 0.0
+        if not live:
+            span = (self.t_last - self.t_first) / 1000.0 if self.t_first is not None else 0.0
+        lines = []
+        rate = ""
+        if span > 0:
+            rate = ", %.0f frames/s, %.0f bytes/s" % (self.frames / span, self.bytes / span)
+            if self.baud:
+                rate += ", link %.1f%% of %d baud" % (100.0 * self.bytes * 10 / self.baud / span,
+                                                    self.baud)
+        lines.append("%d bytes in %.2f s (%s clock): %d frames%s"
+                     % (self.bytes, span, "host" if live else "device", self.frames, rate))
+        lines.append("  " + ", ".join("%s %d" % (n, c) for n, c in zip(TYPES, self.by_type)))
+        lines.append("  lost %d (sequence gaps): %d dropped by the device queue, "
+                     "%d on the wire, %d since the last drop report; "
+                     "%d CRC errors, %d bad frames, %d boots"
+                     % (self.lost + self.gaps, self.dev_drops_total,
+                        max(self.lost - self.dev_drops_total, 0), self.gaps,
+                        self.crc_errors, self.bad_frames, self.boots))
+        return "\n".join(lines)
+
+
+def open_input(path, baud):
+    fd = os.open(path, os.O_RDONLY | os.O_NOCTTY)
+    if os.isatty(fd):
+        import termios
+        attr = termios.tcgetattr(fd)
+        attr[0] = 0                                     # iflag: no translation
+        attr[1] = 0                                     # oflag
+        attr[2] = termios.CS8 | termios.CREAD | termios.CLOCAL
+        attr[3] = 0                                     # lflag: raw
+        speed = getattr(termios, "B%d" % baud, None)
+        if speed is not None:
+            attr[4] = attr[5] = speed
+        attr[6][termios.VMIN] = 0
+        attr[6][termios.VTIME] = 0
+        termios.tcsetattr(fd, termios.TCSANOW, attr)
+        termios.tcflush(fd, termios.TCIFLUSH)
+    return fd
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("input", help="serial port, pty or file")
+    ap.add_argument("--baud", type=int, default=None,
+                    help="tty speed and link use; default the TLM_BOOT baud (115200 for a tty)")
+    ap.add_argument("-o", "--output", help="CSV of the decoded frames, '-' for stdout")
+    ap.add_argument("--seconds", type=float, default=0, help="stop after this long")
+    ap.add_argument("--idle", type=float, default=2.0,
+                    help="stop after this many idle seconds once data came")
+    ap.add_argument("--every", type=float, default=0,
+                    help="print the totals this often while recording")
+    args = ap.parse_args()
+
+    fd = open_input(args.input, args.baud or 115200)
+    csv = None
+    if args.output == "-":
+        csv = sys.stdout
+    elif args.output:
+        csv = open(args.output, "w")
+    if csv:
+        csv.write("t_host,type,seq,t_ms,fields...\n")
+
+    rec = Recorder(args.baud, csv)
+    live = os.isatty(fd)
+    start = time.monotonic()
+    report = start + args.every
+    try:
+        while True:
+            now = time.monotonic()
+            if args.seconds and now - start >= args.seconds:
+                break
+            ready, _, _ = select.select([fd], [], [], 0.1)
+            if ready:
+                try:
+                    data = os.read(fd, 4096)
+                except OSError:
+                    break                               # pty closed
+                if not data:
+                    break                               # end of file, hangup
+                rec.feed(data, time.monotonic())
+            elif rec.first is not None and now - rec.last >= args.idle:
+                break
+            if args.every and now >= report:
+                print(rec.summary(live), file=sys.stderr)
+                report += args.every
+    except KeyboardInterrupt:
+        pass
+    os.close(fd)
+    if csv and csv is not sys.stdout:
+        csv.close()
+    print(rec.summary(live))
+    return 1 if rec.crc_errors or rec.bad_frames else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,78 @@
+#include "Adpcm.h"
+
+static const int8_t indexTable[16] = {
+    -1, -1, -1, -1, 2, 4, 6, 8,
+    -1, -1, -1, -1, 2, 4, 6, 8,
+};
+
+static const uint16_t stepTable[ADPCM_INDEX_MAX + 1u] = {
+        7,     8,     9,    10,    11,    12,    13,    14,    16,    17,
+       19,    21,    23,    25,    28,    31,    34,    37,    41,    45,
+       50,    55,    60,    66,    73,    80,    88,    97,   107,   118,
+      130,   143,   157,   173,   190,   209,   230,   253,   279,   307,
+      337,   371,   408,   449,   494,   544,   598,   658,   724,   796,
+      876,   963,  1060,  1166,  1282,  1411,  1552,  1707,  1878,  2066,
+     2272,  2499,  2749,  3024,  3327,  3660,  4026,  4428,  4871,  5358,
+     5894,  6484,  7132,  7845,  8630,  9493, 10442, 11487, 12635, 13899,
+    15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767,
+};
+
+static inline int16_t decodeNibble(int32_t *pred, int32_t *index, uint8_t code)
+{
+    int32_t step = stepTable[*index];
+
+    // diff = (code + 0.5) * step / 4, the reference shift-and-add form
+    int32_t diff = step >> 3;
+    if (code & 4u)
+    {
+        diff += step;
+    }
+    if (code & 2u)
+    {
+        diff += step >> 1;
+    }
+    if (code & 1u)
+    {
+        diff += step >> 2;
+    }
+
+    int32_t p = (code & 8u) ? *pred - diff : *pred + diff;
+    if (p > 32767)
+    {
+        p = 32767;
+    }
+    else if (p < -32768)
+    {
+        p = -32768;
+    }
+    *pred = p;
+
+    int32_t i = *index + indexTable[code];
+    if (i < 0)
+    {
+        i = 0;
+    }
+    else if (i > (int32_t)ADPCM_INDEX_MAX)
+    {
+        i = ADPCM_INDEX_MAX;
+    }
+    *index = i;
+
+    return (int16_t)p;
+}
+
+void Adpcm_Decode(AdpcmState *st, const uint8_t *in, uint16_t bytes, int16_t *out)
+{
+    int32_t pred  = st->predictor;
+    int32_t index = st->index > ADPCM_INDEX_MAX ? ADPCM_INDEX_MAX : st->index;
+
+    while (bytes--)
+    {
+        uint8_t b = *in++;
+        *out++ = decodeNibble(&pred, &index, b & 0x0Fu);
+        *out++ = decodeNibble(&pred, &index, b >> 4);
+    }
+
+    st->predictor = (int16_t)pred;
+    st->index     = (uint8_t)index;
+}
@@ -0,0 +1,26 @@
+#ifndef __ADPCM_H__
+#define __ADPCM_H__
+
+#include <stdint.h>
+
+/*
+ * IMA ADPCM decoder (4 bits per sample, 16-bit output).
+ *
+ * Each byte holds two samples, low nibble first, as in IMA ADPCM WAV
+ * files. The state is the predictor and step index; a stream frame
+ * carries both so decoding can resync after a lost frame.
+ *
+ * Only adds, shifts and one table lookup per sample; no HAL.
+ */
+
+#define ADPCM_INDEX_MAX  88u
+
+typedef struct {
+    int16_t predictor;
+    uint8_t index;     // 0..ADPCM_INDEX_MAX
+} AdpcmState;
+
+/* Decode 'bytes' bytes from 'in' into 2 * 'bytes' samples at 'out'. */
+void Adpcm_Decode(AdpcmState *st, const uint8_t *in, uint16_t bytes, int16_t *out);
+
+#endif /* __ADPCM_H__ */
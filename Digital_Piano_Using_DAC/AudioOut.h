@@ -0,0 +1,75 @@
+#ifndef __AUDIO_OUT_H__
+#define __AUDIO_OUT_H__
+
+#include <stdint.h>
+#include "SoundConfig.h"
+
+/*
+ * Sample output backend used by Sound.c.
+ *
+ * Exactly one implementation is compiled, chosen by SOUND_BACKEND:
+ *   AudioOut_Ladder.c : 4-bit ladder on PC0..PC3 (wraps DAC_Init/DAC_Out).
+ *                       DMA mode: TIM3_UP request -> GPIOC->BSRR.
+ *   AudioOut_DAC1.c   : on-chip 12-bit DAC channel 1 on PA4.
+ *                       DMA mode: TIM3 TRGO triggers DAC1, whose DMA
+ *                       request refills DHR12R1.
+ * Both use DMA1 Channel 3. stm32f0xx_it.c should call
+ * AudioOut_DMA_IRQHandler() from DMA1_Channel2_3_IRQHandler().
+ *
+ * Samples are 12-bit unsigned (0..4095, mid-scale = silence). The ladder
+ * keeps the top 4 bits, or with SOUND_LADDER_SHAPING runs NoiseShaper.c
+ * and emits SOUND_OVERSAMPLE words per sample. AudioOut_Pack() and
+ * AudioOut_PackBlock() are inline so the plain ladder path costs the
+ * same as writing DAC_PortWord() directly.
+ */
+
+#define AUDIO_OUT_MID   2048u   // 12-bit mid-scale (silence)
+
+#if SOUND_BACKEND == SOUND_BACKEND_DAC1
+static inline uint32_t AudioOut_Pack(uint16_t sample)
+{
+    return sample;                          // DHR12R1 takes it as-is
+}
+#else
+#include "DAC.h"
+static inline uint32_t AudioOut_Pack(uint16_t sample)
+{
+    return DAC_PortWord((uint8_t)(sample >> 8));
+}
+#endif
+
+/* 'count' 12-bit samples -> count * SOUND_OVERSAMPLE DMA words */
+#if SOUND_OVERSAMPLE > 1u
+#include "NoiseShaper.h"
+static inline void AudioOut_PackBlock(const uint16_t *in, uint32_t *out, uint16_t count)
+{
+    NoiseShaper_Run(in, out, count);
+}
+#else
+static inline void AudioOut_PackBlock(const uint16_t *in, uint32_t *out, uint16_t count)
+{
+    while (count--)
+    {
+        *out++ = AudioOut_Pack(*in++);
+    }
+}
+#endif
+
+/* Set up the output and park it at mid-scale */
+void AudioOut_Init(void);
+
+/* Per-sample mode: output one sample now */
+void AudioOut_Write(uint16_t sample);
+
+/* DMA mode: stream 'len' packed words from 'buf' in a circle, one per
+   TIM3 update. TIM3 must already run at SOUND_SAMPLE_RATE * SOUND_OVERSAMPLE. */
+void AudioOut_StartDMA(uint32_t *buf, uint16_t len);
+
+/* Call from DMA1_Channel2_3_IRQHandler() */
+void AudioOut_DMA_IRQHandler(void);
+
+/* Implemented by Sound.c, called from the DMA interrupt */
+void AudioOut_HalfDone(void);   // first half played, refill it
+void AudioOut_FullDone(void);   // second half played, refill it
+
+#endif /* __AUDIO_OUT_H__ */
@@ -0,0 +1,113 @@
+#include "AudioOut.h"
+
+#if SOUND_BACKEND == SOUND_BACKEND_DAC1
+
+#include "main.h"
+
+/*
+ * On-chip 12-bit DAC, channel 1 on PA4.
+ *
+ * Per-sample mode: software trigger, the TIM3 ISR writes DHR12R1.
+ * DMA mode: TIM3 TRGO (update) triggers a conversion; each trigger makes
+ * the DAC request the next sample from DMA1 Channel 3.
+ */
+
+extern TIM_HandleTypeDef htim3;   // sample-rate timer (main.c)
+
+DAC_HandleTypeDef hdac;
+static DMA_HandleTypeDef hdma_dac1_ch1;
+
+static void dacConfig(uint32_t trigger)
+{
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+    DAC_ChannelConfTypeDef sConfig = {0};
+
+    __HAL_RCC_GPIOA_CLK_ENABLE();
+    __HAL_RCC_DAC1_CLK_ENABLE();
+
+    /* PA4 = DAC_OUT1, analog mode */
+    GPIO_InitStruct.Pin  = GPIO_PIN_4;
+    GPIO_InitStruct.Mode = GPIO_MODE_ANALOG;
+    GPIO_InitStruct.Pull = GPIO_NOPULL;
+    HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
+
+    hdac.Instance = DAC1;
+    if (HAL_DAC_Init(&hdac) != HAL_OK)
+    {
+        Error_Handler();
+    }
+
+    sConfig.DAC_Trigger      = trigger;
+    sConfig.DAC_OutputBuffer = DAC_OUTPUTBUFFER_ENABLE;
+    if (HAL_DAC_ConfigChannel(&hdac, &sConfig, DAC_CHANNEL_1) != HAL_OK)
+    {
+        Error_Handler();
+    }
+}
+
+void AudioOut_Init(void)
+{
+    dacConfig(DAC_TRIGGER_NONE);
+    HAL_DAC_SetValue(&hdac, DAC_CHANNEL_1, DAC_ALIGN_12B_R, AUDIO_OUT_MID);
+    HAL_DAC_Start(&hdac, DAC_CHANNEL_1);
+}
+
+void AudioOut_Write(uint16_t sample)
+{
+    hdac.Instance->DHR12R1 = sample;   // no trigger: output updates now
+}
+
+void AudioOut_StartDMA(uint32_t *buf, uint16_t len)
+{
+    TIM_MasterConfigTypeDef sMasterConfig = {0};
+
+    // TIM3 update -> TRGO -> DAC1 trigger
+    sMasterConfig.MasterOutputTrigger = TIM_TRGO_UPDATE;
+    sMasterConfig.MasterSlaveMode = TIM_MASTERSLAVEMODE_DISABLE;
+    if (HAL_TIMEx_MasterConfigSynchronization(&htim3, &sMasterConfig) != HAL_OK)
+    {
+        Error_Handler();
+    }
+
+    dacConfig(DAC_TRIGGER_T3_TRGO);
+
+    hdma_dac1_ch1.Instance = DMA1_Channel3;
+    hdma_dac1_ch1.Init.Direction = DMA_MEMORY_TO_PERIPH;
+    hdma_dac1_ch1.Init.PeriphInc = DMA_PINC_DISABLE;
+    hdma_dac1_ch1.Init.MemInc = DMA_MINC_ENABLE;
+    hdma_dac1_ch1.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+    hdma_dac1_ch1.Init.MemDataAlignment = DMA_MDATAALIGN_WORD;
+    hdma_dac1_ch1.Init.Mode = DMA_CIRCULAR;
+    hdma_dac1_ch1.Init.Priority = DMA_PRIORITY_HIGH;
+    if (HAL_DMA_Init(&hdma_dac1_ch1) != HAL_OK)
+    {
+        Error_Handler();
+    }
+    __HAL_LINKDMA(&hdac, DMA_Handle1, hdma_dac1_ch1);
+
+    if (HAL_DAC_Start_DMA(&hdac, DAC_CHANNEL_1, buf, len, DAC_ALIGN_12B_R) != HAL_OK)
+    {
+        Error_Handler();
+    }
+    HAL_TIM_Base_Start(&htim3);     // no update interrupt in this mode
+}
+
+void AudioOut_DMA_IRQHandler(void)
+{
+    HAL_DMA_IRQHandler(&hdma_dac1_ch1);
+}
+
+// ===== HAL DAC DMA callbacks =====
+void HAL_DAC_ConvHalfCpltCallbackCh1(DAC_HandleTypeDef *h)
+{
+    (void)h;
+    AudioOut_HalfDone();
+}
+
+void HAL_DAC_ConvCpltCallbackCh1(DAC_HandleTypeDef *h)
+{
+    (void)h;
+    AudioOut_FullDone();
+}
+
+#endif /* SOUND_BACKEND == SOUND_BACKEND_DAC1 */
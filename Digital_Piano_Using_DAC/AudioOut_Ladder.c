@@ -0,0 +1,70 @@
+#include "AudioOut.h"
+
+#if SOUND_BACKEND == SOUND_BACKEND_LADDER
+
+#include "DAC.h"
+#include "main.h"
+
+extern TIM_HandleTypeDef htim3;   // sample-rate timer (main.c)
+
+static DMA_HandleTypeDef hdma_tim3_up;   // TIM3_UP -> DMA1 Channel 3
+
+static void dmaHalfCplt(DMA_HandleTypeDef *hdma)
+{
+    (void)hdma;
+    AudioOut_HalfDone();
+}
+
+static void dmaCplt(DMA_HandleTypeDef *hdma)
+{
+    (void)hdma;
+    AudioOut_FullDone();
+}
+
+void AudioOut_Init(void)
+{
+#if SOUND_OVERSAMPLE > 1u
+    NoiseShaper_Init();
+#endif
+    DAC_Init();
+    AudioOut_Write(AUDIO_OUT_MID);
+}
+
+void AudioOut_Write(uint16_t sample)
+{
+    DAC_Out((uint8_t)(sample >> 8));
+}
+
+void AudioOut_StartDMA(uint32_t *buf, uint16_t len)
+{
+    // Sample words from memory to GPIOC->BSRR, one per TIM3 update
+    hdma_tim3_up.Instance = DMA1_Channel3;
+    hdma_tim3_up.Init.Direction = DMA_MEMORY_TO_PERIPH;
+    hdma_tim3_up.Init.PeriphInc = DMA_PINC_DISABLE;
+    hdma_tim3_up.Init.MemInc = DMA_MINC_ENABLE;
+    hdma_tim3_up.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+    hdma_tim3_up.Init.MemDataAlignment = DMA_MDATAALIGN_WORD;
+    hdma_tim3_up.Init.Mode = DMA_CIRCULAR;
+    hdma_tim3_up.Init.Priority = DMA_PRIORITY_HIGH;
+    if (HAL_DMA_Init(&hdma_tim3_up) != HAL_OK)
+    {
+        Error_Handler();
+    }
+    __HAL_LINKDMA(&htim3, hdma[TIM_DMA_ID_UPDATE], hdma_tim3_up);
+
+    hdma_tim3_up.XferHalfCpltCallback = dmaHalfCplt;
+    hdma_tim3_up.XferCpltCallback     = dmaCplt;
+    if (HAL_DMA_Start_IT(&hdma_tim3_up, (uint32_t)buf, DAC_PortAddress(), len) != HAL_OK)
+    {
+        Error_Handler();
+    }
+    __HAL_TIM_ENABLE_DMA(&htim3, TIM_DMA_UPDATE);
+    HAL_TIM_Base_Start(&htim3);     // no update interrupt in this mode
+}
+
+void AudioOut_DMA_IRQHandler(void)
+{
+    HAL_DMA_IRQHandler(&hdma_tim3_up);
+}
+
+#endif /* SOUND_BACKEND == SOUND_BACKEND_LADDER */
@@ -8,19 +8,20 @@
 void DAC_Init(void)
 {
     // Start with output value 0
-    GPIOC->ODR &= ~(0x0F);   // clear bits PC0..PC3
+    GPIOC->BSRR = DAC_PortWord(0);   // clear bits PC0..PC3
 }
 
 /*
  * Output a 4-bit value (0..15) on PC0..PC3.
+ * One BSRR write: no read-modify-write, and no glitch through 0
+ * between clearing and setting the bits.
  */
 void DAC_Out(uint8_t value)
 {
-    value &= 0x0F;                   // only lower 4 bits used
-
-    // Clear PC0..PC3
-    GPIOC->ODR &= ~(0x0F);
+    GPIOC->BSRR = DAC_PortWord(value);
+}
 
-    // Write new value to PC0..PC3
-    GPIOC->ODR |= value;
+uint32_t DAC_PortAddress(void)
+{
+    return (uint32_t)&GPIOC->BSRR;
 }
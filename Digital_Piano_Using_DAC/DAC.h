@@ -19,7 +19,21 @@
 
 #define DAC_MAX_VALUE   15u
 
+/*
+ * GPIOC->BSRR word that drives PC0..PC3 to 'value' in one write:
+ * the upper half resets PC0..PC3, the lower half sets the wanted bits
+ * (set wins over reset). Other PORTC pins are left alone, so the same
+ * word can be written by the CPU or by DMA.
+ */
+static inline uint32_t DAC_PortWord(uint8_t value)
+{
+    return (0x0Fu << 16) | (value & 0x0Fu);
+}
+
 void DAC_Init(void);
 void DAC_Out(uint8_t value);
 
+/* Address DMA should write DAC_PortWord() values to */
+uint32_t DAC_PortAddress(void);
+
 #endif /* __DAC_H__ */
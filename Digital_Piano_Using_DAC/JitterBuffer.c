@@ -0,0 +1,205 @@
+#include "JitterBuffer.h"
+#include "SoundConfig.h"
+#include "Barrier.h"
+
+#define JB_MASK    (JB_SIZE - 1u)
+
+// Read step in Q16 input samples per output sample
+#define STEP_NOMINAL  ((int32_t)(((uint32_t)SOUND_STREAM_RATE << 16) / SOUND_SAMPLE_RATE))
+
+// Rate correction limit, in 1/65536 of the nominal step (~2 %)
+#define ADJ_MAX       1311
+#define SUM_MAX       (ADJ_MAX << 12)
+
+static int16_t ring[JB_SIZE];
+static volatile uint16_t head = 0;    // written by writer
+static volatile uint16_t tail = 0;    // written by reader
+static volatile uint8_t  ending = 0;  // written by writer only
+
+// ===== Reader state (audio ISR) =====
+static volatile uint8_t state = JB_IDLE;
+static uint32_t pos;                  // Q16 position between s0 and s1
+static int32_t  s0, s1;               // interpolation end points
+static int32_t  step;
+static int32_t  errAvg;               // smoothed fill error, Q8 samples
+static int32_t  errSum;               // integral of errAvg
+static int32_t  rateAdj;              // last correction, 1/65536 of the step
+
+// ===== Statistics (overruns by the writer, the rest by the reader) =====
+static volatile uint16_t minFill;
+static volatile uint16_t maxFill;
+static volatile uint32_t underruns;
+static volatile uint32_t overruns;
+
+void JitterBuffer_Init(void)
+{
+    head = 0;
+    tail = 0;
+    ending = 0;
+    state = JB_IDLE;
+    pos = 0;
+    s0 = s1 = 0;
+    step = STEP_NOMINAL;
+    errAvg = 0;
+    errSum = 0;
+    rateAdj = 0;
+    minFill = JB_SIZE;
+    maxFill = 0;
+    underruns = 0;
+    overruns = 0;
+}
+
+uint16_t JitterBuffer_Write(const int16_t *samples, uint16_t count)
+{
+    uint16_t h    = head;
+    uint16_t room = (uint16_t)(JB_SIZE - (uint16_t)(h - tail));
+    uint16_t n    = (count < room) ? count : room;
+
+    for (uint16_t i = 0; i < n; i++)
+    {
+        ring[(uint16_t)(h + i) & JB_MASK] = samples[i];
+    }
+    ending = 0;   // before the samples show, or they could skip the prefill
+    COMPILER_BARRIER();
+    head = (uint16_t)(h + n);   // publish after the samples are written
+
+    overruns += (uint32_t)(count - n);
+    return n;
+}
+
+void JitterBuffer_End(void)
+{
+    ending = 1;
+}
+
+// Next input sample, or 0 when there is none
+static int32_t pop(void)
+{
+    uint16_t t = tail;
+
+    if (t == head)
+    {
+        if (state == JB_PLAYING)
+        {
+            if (ending)
+            {
+                state = JB_IDLE;
+            }
+            else
+            {
+                underruns++;
+                state = JB_PREFILL;
+            }
+        }
+        return 0;
+    }
+
+    COMPILER_BARRIER();
+    int32_t s = ring[t & JB_MASK];
+    COMPILER_BARRIER();
+    tail = (uint16_t)(t + 1u);   // free the slot after the read
+    return s;
+}
+
+void JitterBuffer_Mix(uint16_t *out, uint16_t count)
+{
+    uint16_t fill = (uint16_t)(head - tail);
+
+    if (fill > maxFill)
+    {
+        maxFill = fill;
+    }
+
+    if (state != JB_PLAYING)
+    {
+        if (fill == 0u || (fill < JB_TARGET && !ending))
+        {
+            if (fill == 0u)
+            {
+                state = JB_IDLE;
+            }
+            else
+            {
+                state = JB_PREFILL;
+            }
+            return;
+        }
+        // Enough buffered (or the whole, short stream is in): start clean
+        state = JB_PLAYING;
+        pos = 0;
+        s0 = 0;
+        s1 = pop();
+        errAvg = 0;   // errSum is kept: the clocks haven't changed
+    }
+
+    if (fill < minFill)
+    {
+        minFill = fill;
+    }
+
+    // Rate correction (PI). The fill level is averaged over ~256 calls
+    // to ride out the frame-sized steps made by the writer. The integral
+    // term learns the clock ratio, so the fill settles on JB_TARGET.
+    errAvg += ((((int32_t)fill - (int32_t)JB_TARGET) << 8) - errAvg) >> 8;
+    errSum += errAvg >> 8;
+    if (errSum > SUM_MAX)
+    {
+        errSum = SUM_MAX;
+    }
+    else if (errSum < -SUM_MAX)
+    {
+        errSum = -SUM_MAX;
+    }
+    int32_t adj = (errAvg >> 6) + (errSum >> 12);
+    if (adj > ADJ_MAX)
+    {
+        adj = ADJ_MAX;
+    }
+    else if (adj < -ADJ_MAX)
+    {
+        adj = -ADJ_MAX;
+    }
+    step = STEP_NOMINAL + ((STEP_NOMINAL * adj) >> 16);
+    rateAdj = adj;
+
+    while (count--)
+    {
+        pos += (uint32_t)step;
+        while (pos >= 0x10000u)
+        {
+            pos -= 0x10000u;
+            s0 = s1;
+            s1 = pop();
+        }
+
+        int32_t v = s0 + (((s1 - s0) * (int32_t)pos) >> 16);
+        v += *out;
+        if (v < 0)
+        {
+            v = 0;
+        }
+        else if (v > 4095)
+        {
+            v = 4095;
+        }
+        *out++ = (uint16_t)v;
+
+        if (state != JB_PLAYING)
+        {
+            return;   // ran dry: the rest of the block stays synth-only
+        }
+    }
+}
+
+void JitterBuffer_GetStats(JitterStats *stats)
+{
+    stats->state     = state;
+    stats->fill      = (uint16_t)(head - tail);
+    stats->minFill   = minFill;
+    stats->maxFill   = maxFill;
+    stats->underruns = underruns;
+    stats->overruns  = overruns;
+    stats->ratePpm   = (rateAdj * 15625) >> 10;   // * 1000000 / 65536
+    minFill = JB_SIZE;
+    maxFill = 0;
+}
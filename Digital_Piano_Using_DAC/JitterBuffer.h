@@ -0,0 +1,66 @@
+#ifndef __JITTER_BUFFER_H__
+#define __JITTER_BUFFER_H__
+
+#include <stdint.h>
+
+/*
+ * Jitter buffer and rate matcher for streamed audio (Stream.c).
+ *
+ * The main loop writes decoded stream samples (signed 12-bit, at
+ * SOUND_STREAM_RATE) into a ring of JB_SIZE samples. The audio ISR reads
+ * them at SOUND_SAMPLE_RATE with linear interpolation and adds them to
+ * the synth output. One writer, one reader, no locks: every variable is
+ * written by one side only, apart from the statistics below.
+ *
+ * States (changed by the reader only):
+ *   IDLE      nothing to play
+ *   PREFILL   data arrived; wait until JB_TARGET samples are buffered
+ *   PLAYING   draining; running dry is an underrun -> PREFILL
+ * After JitterBuffer_End() the buffer plays out and goes IDLE without
+ * counting an underrun.
+ *
+ * Rate correction: the sender's clock is never exactly ours (the HSI
+ * alone is only good to about 1 %). Once per JitterBuffer_Mix() call a
+ * PI loop on the smoothed fill level trims the read step by up to
+ * +/-2 %, so the fill settles on JB_TARGET instead of slowly running
+ * dry or overflowing.
+ *
+ * No HAL in here, so it also builds on a PC.
+ */
+
+#define JB_SIZE    512u            // samples, power of two
+#define JB_TARGET  (JB_SIZE / 2u)  // prefill and steady-state fill level
+
+#define JB_IDLE     0u
+#define JB_PREFILL  1u
+#define JB_PLAYING  2u
+
+typedef struct {
+    uint8_t  state;       // JB_xxx
+    uint16_t fill;        // samples buffered now
+    uint16_t minFill;     // lowest fill while playing, since the last read
+    uint16_t maxFill;     // highest fill, since the last read
+    uint32_t underruns;   // ran dry while playing
+    uint32_t overruns;    // samples dropped because the ring was full
+    int32_t  ratePpm;     // current read-rate correction
+} JitterStats;
+
+void     JitterBuffer_Init(void);
+
+/* Writer: queue 'count' samples; returns how many fitted. */
+uint16_t JitterBuffer_Write(const int16_t *samples, uint16_t count);
+
+/* Writer: the sender has finished; play out what is left. */
+void     JitterBuffer_End(void);
+
+/* Reader (audio ISR): add 'count' output samples into 'out' (0..4095). */
+void     JitterBuffer_Mix(uint16_t *out, uint16_t count);
+
+/*
+ * Snapshot; also restarts the min/max window. Call it with the reader
+ * held off (Stream_GetStats() masks interrupts around it), so the fields
+ * belong together and the restart doesn't race the reader's min/max.
+ */
+void     JitterBuffer_GetStats(JitterStats *stats);
+
+#endif /* __JITTER_BUFFER_H__ */
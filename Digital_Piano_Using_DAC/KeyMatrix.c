@@ -0,0 +1,176 @@
+#include "KeyMatrix.h"
+#include "Timebase.h"
+#include "main.h"
+#include "Barrier.h"
+
+extern TIM_HandleTypeDef htim14;  // TIM14 handle created in main.c
+
+// Rows on PB8..PB15, columns on PC4..PC7
+#define ROW_SHIFT   8u
+#define ROW_PINS    (0xFFu << ROW_SHIFT)
+#define COL_SHIFT   4u
+#define COL_MASK    ((1u << KEYMATRIX_COLS) - 1u)
+#define ROW_KEYS    COL_MASK                 // key bits of row 0
+
+#define READ_COLS() ((uint32_t)(~GPIOC->IDR >> COL_SHIFT) & COL_MASK)
+
+// ===== ISR -> main loop event queue =====
+#define EVENT_QUEUE_SIZE  8u   // power of two
+
+static KeyMatrixEvent eventQueue[EVENT_QUEUE_SIZE];
+static volatile uint8_t eventHead = 0;   // written by TIM14 ISR
+static volatile uint8_t eventTail = 0;   // written by main loop
+static volatile uint32_t overruns = 0;
+static volatile uint32_t ghostScans = 0;
+
+// ===== Scan state (TIM14 ISR only) =====
+// One bit per key in each word (bit = row * KEYMATRIX_COLS + column)
+static uint32_t debounced;          // debounced matrix, ghosts included
+static uint32_t cnt0, cnt1;         // vertical counter bits
+static uint32_t ghostKeys;          // rows with ghosting in this scan
+static volatile uint32_t reported;  // last mask given to the main loop
+static uint8_t  row;                // row driven since the last tick
+
+// Drive 'r' low and release every other row, in one BSRR write
+static inline void driveRow(uint8_t r)
+{
+    uint32_t pin = 1u << (ROW_SHIFT + r);
+    GPIOB->BSRR = (ROW_PINS & ~pin) | (pin << 16);
+}
+
+static void postEvent(uint32_t keys, uint32_t changed)
+{
+    uint8_t head = eventHead;
+
+    if ((uint8_t)(head - eventTail) >= EVENT_QUEUE_SIZE)
+    {
+        overruns++;   // main loop too slow; the next event has the full mask
+        return;
+    }
+
+    eventQueue[head & (EVENT_QUEUE_SIZE - 1u)].time    = Timebase_Us();
+    eventQueue[head & (EVENT_QUEUE_SIZE - 1u)].keys    = keys;
+    eventQueue[head & (EVENT_QUEUE_SIZE - 1u)].changed = changed;
+    COMPILER_BARRIER();
+    eventHead = (uint8_t)(head + 1u);   // publish after the entry is written
+}
+
+void KeyMatrix_Init(void)
+{
+    // Pins are set up by CubeMX: rows open-drain, columns pulled up
+    debounced = 0;
+    cnt0      = 0;
+    cnt1      = 0;
+    ghostKeys = 0;
+    reported  = 0;
+    eventHead = 0;
+    eventTail = 0;
+    overruns  = 0;
+    ghostScans = 0;
+
+    row = 0;
+    driveRow(0);
+
+    if (HAL_TIM_Base_Start_IT(&htim14) != HAL_OK)
+    {
+        Error_Handler();
+    }
+}
+
+void KeyMatrix_IRQHandler(void)
+{
+    TIM14->SR = ~TIM_SR_UIF;
+
+    // Columns of the row driven on the previous tick
+    uint8_t  shift  = (uint8_t)(row * KEYMATRIX_COLS);
+    uint32_t keys   = ROW_KEYS << shift;
+    uint32_t sample = READ_COLS() << shift;
+
+    // Start the next row now so it settles until the next tick
+    uint8_t next = (uint8_t)((row + 1u) & (KEYMATRIX_ROWS - 1u));
+    driveRow(next);
+
+    // Vertical counter: keys that agree with 'debounced' reset to 0, the
+    // others count 1, 2, 3, 0 and toggle on the fourth disagreeing scan.
+    // Only this row's bits are touched.
+    uint32_t delta = (sample ^ debounced) & keys;
+    cnt1 = (cnt1 & ~keys) | ((cnt1 ^ cnt0) & delta);
+    cnt0 = (cnt0 & ~keys) | (~cnt0 & delta);
+    debounced ^= delta & ~(cnt0 | cnt1);
+
+    // Ghost check of this row against the others: 2+ keys here and a
+    // shared column are three corners of a rectangle, and the fourth
+    // can't be trusted. Checked on three, not four, because the ghost
+    // and the real fourth key bounce apart and may debounce a scan apart.
+    uint32_t mine = (debounced >> shift) & COL_MASK;
+    if (mine & (mine - 1u))   // only rows with 2+ keys can form one
+    {
+        for (uint8_t r = 0; r < KEYMATRIX_ROWS; r++)
+        {
+            uint32_t common = mine & (debounced >> (r * KEYMATRIX_COLS));
+            common &= COL_MASK;
+            if (r != row && common)
+            {
+                ghostKeys |= keys | (ROW_KEYS << (r * KEYMATRIX_COLS));
+            }
+        }
+    }
+
+    row = next;
+    if (next != 0u)
+    {
+        return;
+    }
+
+    // End of a full scan: hold back new presses in ghosted rows
+    uint32_t out = debounced;
+    if (ghostKeys)
+    {
+        out = (out & ~ghostKeys) | (out & reported & ghostKeys);
+        ghostScans++;
+        ghostKeys = 0;
+    }
+
+    uint32_t changed = out ^ reported;
+    if (changed)
+    {
+        reported = out;
+        postEvent(out, changed);
+    }
+}
+
+uint32_t KeyMatrix_Keys(void)
+{
+    return reported;
+}
+
+uint8_t KeyMatrix_GetEvent(KeyMatrixEvent *ev)
+{
+    uint8_t tail = eventTail;
+
+    if (tail == eventHead)
+    {
+        return 0;
+    }
+
+    COMPILER_BARRIER();
+    *ev = eventQueue[tail & (EVENT_QUEUE_SIZE - 1u)];
+    COMPILER_BARRIER();
+    eventTail = (uint8_t)(tail + 1u);   // free the entry after the copy
+    return 1;
+}
+
+uint8_t KeyMatrix_HasEvent(void)
+{
+    return eventTail != eventHead;
+}
+
+uint32_t KeyMatrix_GhostScans(void)
+{
+    return ghostScans;
+}
+
+uint32_t KeyMatrix_Overruns(void)
+{
+    return overruns;
+}
@@ -0,0 +1,69 @@
+#ifndef __KEY_MATRIX_H__
+#define __KEY_MATRIX_H__
+
+#include <stdint.h>
+
+/*
+ * Scanned key matrix for the digital piano (alongside Piano.c).
+ *
+ * 8 rows x 4 columns = 32 keys, no diodes:
+ *   rows    PB8..PB15, open-drain outputs, one driven low at a time
+ *   columns PC4..PC7,  inputs with pull-ups (low = key pressed)
+ * Key number = row * 4 + column, bit 'key' of a 32-bit key mask.
+ *
+ * TIM14 interrupts at KEYMATRIX_ROW_RATE. Each tick reads the columns of
+ * the row driven on the previous tick (so the lines have settled) and
+ * drives the next row, so every tick does the same, fixed amount of
+ * work. A full scan takes KEYMATRIX_ROWS ticks.
+ *
+ * Debounce: every key has a 2-bit vertical counter, stored packed in two
+ * 32-bit words (one bit per key each). A key changes state only after
+ * 4 scans in a row disagree with it.
+ *
+ * Ghosting: without diodes, three keys on the corners of a rectangle
+ * make the fourth corner read as pressed too. When a row with two or
+ * more pressed keys shares a column with another row (three corners),
+ * new presses in those rows are held back until the pattern clears.
+ * Releases still go through, except that a released key other held keys
+ * still connect reads as pressed until one of them lifts.
+ *
+ * After each full scan, if the reported mask changed, one
+ * KeyMatrixEvent (new mask + changed bits) is queued for the main loop.
+ *
+ * Needs, in stm32f0xx_it.c: TIM14_IRQHandler -> KeyMatrix_IRQHandler()
+ */
+
+#define KEYMATRIX_ROWS      8u
+#define KEYMATRIX_COLS      4u
+#define KEYMATRIX_KEYS      (KEYMATRIX_ROWS * KEYMATRIX_COLS)
+#define KEYMATRIX_ROW_RATE  4000u   // Hz: full scan every 2 ms, 8 ms debounce
+
+#define KEYMATRIX_BASE_NOTE 48u     // key 0 = C3 (MIDI), key 31 = G5
+
+typedef struct {
+    uint32_t time;     // end of the scan that saw the change, Timebase_Us()
+    uint32_t keys;     // reported key mask after the change
+    uint32_t changed;  // keys that changed in this event
+} KeyMatrixEvent;
+
+void     KeyMatrix_Init(void);
+
+/* TIM14 update interrupt: scan one row */
+void     KeyMatrix_IRQHandler(void);
+
+/* Reported key mask right now */
+uint32_t KeyMatrix_Keys(void);
+
+/* Pop the oldest event into 'ev'. Returns 0 when the queue is empty. */
+uint8_t  KeyMatrix_GetEvent(KeyMatrixEvent *ev);
+
+/* Non-zero while events are waiting */
+uint8_t  KeyMatrix_HasEvent(void);
+
+/* Full scans in which ghosting held keys back */
+uint32_t KeyMatrix_GhostScans(void);
+
+/* Events dropped because the queue was full */
+uint32_t KeyMatrix_Overruns(void);
+
+#endif /* __KEY_MATRIX_H__ */
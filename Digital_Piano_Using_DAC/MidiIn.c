@@ -0,0 +1,103 @@
+#include "SoundConfig.h"
+
+#if !SOUND_STREAM  // USART1 RX belongs to Stream.c otherwise
+
+#include "MidiIn.h"
+#include "MidiParser.h"
+#include "RxRing.h"
+#include "Sound.h"
+#include "Wavetables.h"
+
+static uint8_t rxBuf[MIDI_IN_BUF_SIZE];
+static uint32_t messages = 0;
+static MidiParser parser;
+
+void MidiIn_Init(void)
+{
+    messages = 0;
+    MidiParser_Init(&parser);
+    RxRing_Init(MIDI_IN_BAUD, rxBuf, MIDI_IN_BUF_SIZE);
+}
+
+static void dispatch(const MidiMsg *m)
+{
+    uint8_t type = m->status & 0xF0u;
+
+    if (m->status == MIDI_STOP || m->status == MIDI_RESET)
+    {
+        Sound_NoteOff(SOUND_SRC_MIDI, NOTE_OFF);
+        return;
+    }
+    if (type >= 0xF0u)
+    {
+        return;   // clock, active sensing, ...
+    }
+#if MIDI_IN_CHANNEL != MIDI_IN_OMNI
+    if ((m->status & 0x0Fu) != MIDI_IN_CHANNEL)
+    {
+        return;
+    }
+#endif
+
+    switch (type)
+    {
+    case MIDI_NOTE_ON:
+        Sound_NoteOn(SOUND_SRC_MIDI, m->data1);   // keys outside 21..108 are ignored
+        break;
+    case MIDI_NOTE_OFF:
+        if (m->data1 != NOTE_OFF)   // NOTE_OFF would mean all notes
+        {
+            Sound_NoteOff(SOUND_SRC_MIDI, m->data1);
+        }
+        break;
+    case MIDI_CONTROL_CHANGE:
+        if (m->data1 == MIDI_CC_ALL_SOUND_OFF || m->data1 == MIDI_CC_ALL_NOTES_OFF)
+        {
+            Sound_NoteOff(SOUND_SRC_MIDI, NOTE_OFF);
+        }
+        break;
+    case MIDI_PROGRAM_CHANGE:
+        Sound_SetWave((uint8_t)(m->data1 % WAVE_COUNT));
+        break;
+    default:
+        break;
+    }
+}
+
+static void feed(uint8_t b)
+{
+    MidiMsg msg;
+
+    if (MidiParser_Feed(&parser, b, &msg))
+    {
+        messages++;
+        dispatch(&msg);
+    }
+}
+
+void MidiIn_Poll(void)
+{
+    if (RxRing_Read(feed))
+    {
+        // Bytes were lost: the running status and any half-built
+        // message may belong to them. Restart at the next status byte.
+        MidiParser_Init(&parser);
+    }
+}
+
+uint8_t MidiIn_Pending(void)
+{
+    return RxRing_Pending();
+}
+
+uint32_t MidiIn_Messages(void)
+{
+    return messages;
+}
+
+uint32_t MidiIn_Errors(void)
+{
+    return RxRing_Errors();
+}
+
+#endif /* !SOUND_STREAM */
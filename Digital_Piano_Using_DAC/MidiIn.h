@@ -0,0 +1,46 @@
+#ifndef __MIDI_IN_H__
+#define __MIDI_IN_H__
+
+#include <stdint.h>
+
+/*
+ * MIDI input on USART1 RX (PA10), 31250 baud 8N1.
+ *
+ * Bytes go into a circular DMA buffer (RxRing.c). No bytes are handled
+ * in an interrupt.
+ *
+ * MidiIn_Poll() runs in the main loop. It reads everything the DMA has
+ * written since the last call, parses it (MidiParser.c) and queues the
+ * results to the Sound module:
+ *   note on/off          -> Sound_NoteOn()/Sound_NoteOff()
+ *   CC 120/123, stop, reset -> all MIDI notes off
+ *   program change       -> Sound_SetWave(program % WAVE_COUNT)
+ *
+ * MIDI_IN_CHANNEL picks one channel (0..15); MIDI_IN_OMNI takes all.
+ * The buffer holds MIDI_IN_BUF_SIZE bytes, about 20 ms of continuous
+ * MIDI, and the main loop wakes at least every 1 ms (SysTick). If bytes
+ * are lost anyway, the parser drops its running status and waits for
+ * the next status byte.
+ */
+
+#define MIDI_IN_OMNI      0xFFu
+#ifndef MIDI_IN_CHANNEL
+#define MIDI_IN_CHANNEL   MIDI_IN_OMNI
+#endif
+
+#define MIDI_IN_BAUD      31250u
+#define MIDI_IN_BUF_SIZE  64u
+
+void     MidiIn_Init(void);
+
+/* Parse new bytes and queue the notes. Main loop only. */
+void     MidiIn_Poll(void);
+
+/* Non-zero if the DMA has written bytes that MidiIn_Poll() hasn't read */
+uint8_t  MidiIn_Pending(void);
+
+/* Complete messages parsed, and UART errors plus buffer laps */
+uint32_t MidiIn_Messages(void);
+uint32_t MidiIn_Errors(void);
+
+#endif /* __MIDI_IN_H__ */
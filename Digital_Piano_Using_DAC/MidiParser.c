@@ -0,0 +1,84 @@
+#include "MidiParser.h"
+
+#define SYSEX_START  0xF0u
+#define SYSEX_END    0xF7u
+
+// Data bytes that follow a status byte
+static uint8_t dataLength(uint8_t status)
+{
+    switch (status & 0xF0u)
+    {
+    case 0xC0u:                 // program change
+    case 0xD0u:                 // channel pressure
+        return 1;
+    case 0xF0u:
+        switch (status)
+        {
+        case 0xF1u:             // MTC quarter frame
+        case 0xF3u:             // song select
+            return 1;
+        case 0xF2u:             // song position
+            return 2;
+        default:                // SysEx, tune request, undefined
+            return 0;
+        }
+    default:                    // note off/on, poly pressure, CC, bend
+        return 2;
+    }
+}
+
+void MidiParser_Init(MidiParser *p)
+{
+    p->status = 0;
+    p->needed = 0;
+    p->count  = 0;
+}
+
+uint8_t MidiParser_Feed(MidiParser *p, uint8_t byte, MidiMsg *msg)
+{
+    if (byte >= 0xF8u)
+    {
+        // Real-time: a message of its own, whatever is in progress
+        msg->status = byte;
+        msg->data1  = 0;
+        msg->data2  = 0;
+        return 1;
+    }
+
+    if (byte & 0x80u)
+    {
+        // New status. SysEx/system common keep it only to skip their data.
+        p->status = (byte == SYSEX_END) ? 0u : byte;
+        p->needed = dataLength(byte);
+        p->count  = 0;
+        return 0;
+    }
+
+    if (p->status == 0u || p->status == SYSEX_START)
+    {
+        return 0;   // no status yet, or inside SysEx
+    }
+
+    p->data[p->count++] = byte;
+    if (p->count < p->needed)
+    {
+        return 0;
+    }
+    p->count = 0;
+
+    if (p->status >= 0xF0u)
+    {
+        p->status = 0;   // system common done; no running status
+        return 0;
+    }
+
+    msg->status = p->status;
+    msg->data1  = p->data[0];
+    msg->data2  = (p->needed == 2u) ? p->data[1] : 0u;
+
+    if ((msg->status & 0xF0u) == MIDI_NOTE_ON && msg->data2 == 0u)
+    {
+        msg->status = (uint8_t)(MIDI_NOTE_OFF | (msg->status & 0x0Fu));
+    }
+    return 1;
+}
@@ -0,0 +1,51 @@
+#ifndef __MIDI_PARSER_H__
+#define __MIDI_PARSER_H__
+
+#include <stdint.h>
+
+/*
+ * Incremental MIDI 1.0 byte-stream parser.
+ *
+ * Feed one byte at a time; a call returns 1 when it completes a message.
+ *   - Running status: data bytes after a complete channel message reuse
+ *     its status byte.
+ *   - Real-time bytes (0xF8..0xFF) may appear anywhere, even inside
+ *     another message. They are returned on their own and do not disturb
+ *     the message being assembled.
+ *   - System common and SysEx are consumed and dropped; they cancel
+ *     running status.
+ *   - Note on with velocity 0 is returned as note off.
+ *   - Stray data bytes with no status are dropped.
+ *
+ * No HAL in here, so the parser also builds on a PC.
+ */
+
+#define MIDI_NOTE_OFF        0x80u
+#define MIDI_NOTE_ON         0x90u
+#define MIDI_CONTROL_CHANGE  0xB0u
+#define MIDI_PROGRAM_CHANGE  0xC0u
+#define MIDI_STOP            0xFCu
+#define MIDI_RESET           0xFFu
+
+#define MIDI_CC_ALL_SOUND_OFF  120u
+#define MIDI_CC_ALL_NOTES_OFF  123u
+
+typedef struct {
+    uint8_t status;    // status byte, channel in the low nibble
+    uint8_t data1;     // key / controller / program
+    uint8_t data2;     // velocity / value (0 if unused)
+} MidiMsg;
+
+typedef struct {
+    uint8_t status;    // running status, 0 = none
+    uint8_t needed;    // data bytes in a message with this status
+    uint8_t count;     // data bytes collected so far
+    uint8_t data[2];
+} MidiParser;
+
+void    MidiParser_Init(MidiParser *p);
+
+/* Add one byte; returns 1 and fills 'msg' when a message is complete. */
+uint8_t MidiParser_Feed(MidiParser *p, uint8_t byte, MidiMsg *msg);
+
+#endif /* __MIDI_PARSER_H__ */
@@ -0,0 +1,74 @@
+#include "NoiseShaper.h"
+#include "SoundConfig.h"
+#include "DAC.h"
+
+#if SOUND_LADDER_SHAPING
+
+#define LEVEL_SHIFT   8        // 12-bit value -> 4-bit ladder level
+#define ERR_LIMIT     512      // keeps the loop stable if the ladder clips
+
+static uint16_t prevSample;    // last input sample, for interpolation
+static int32_t  err1;          // e[n-1]
+static int32_t  err2;          // e[n-2]
+
+void NoiseShaper_Init(void)
+{
+    prevSample = 2048u;
+    err1 = 0;
+    err2 = 0;
+}
+
+/* Quantize one tick to a ladder level and update the error history */
+static inline uint8_t shapeTick(int32_t x)
+{
+#if SOUND_LADDER_SHAPING >= 2
+    int32_t v = x - 2 * err1 + err2;
+#else
+    int32_t v = x - err1;
+#endif
+
+    int32_t q = (v + (1 << (LEVEL_SHIFT - 1))) >> LEVEL_SHIFT;
+    if (q < 0)
+    {
+        q = 0;
+    }
+    else if (q > (int32_t)DAC_MAX_VALUE)
+    {
+        q = (int32_t)DAC_MAX_VALUE;
+    }
+
+    int32_t e = (q << LEVEL_SHIFT) - v;
+    if (e > ERR_LIMIT)
+    {
+        e = ERR_LIMIT;
+    }
+    else if (e < -ERR_LIMIT)
+    {
+        e = -ERR_LIMIT;
+    }
+    err2 = err1;
+    err1 = e;
+
+    return (uint8_t)q;
+}
+
+void NoiseShaper_Run(const uint16_t *in, uint32_t *out, uint16_t count)
+{
+    while (count--)
+    {
+        // The ladder tops out at 15 << 8 = 3840: scale 0..4095 by 15/16
+        int32_t cur  = ((int32_t)*in++ * 15) >> 4;
+        int32_t prev = ((int32_t)prevSample * 15) >> 4;
+        int32_t step = cur - prev;
+
+        prevSample = in[-1];
+
+        for (uint8_t k = 1; k <= SOUND_OVERSAMPLE; k++)
+        {
+            int32_t x = prev + ((step * k) >> SOUND_OVERSAMPLE_SHIFT);
+            *out++ = DAC_PortWord(shapeTick(x));
+        }
+    }
+}
+
+#endif /* SOUND_LADDER_SHAPING */
@@ -0,0 +1,30 @@
+#ifndef __NOISE_SHAPER_H__
+#define __NOISE_SHAPER_H__
+
+#include <stdint.h>
+
+/*
+ * Oversampling error-feedback noise shaper for the 4-bit ladder DAC.
+ *
+ * Each 12-bit audio sample is linearly interpolated up to
+ * SOUND_OVERSAMPLE output ticks. Each tick is quantized to a ladder
+ * level 0..15, and the quantization error is fed back into the next
+ * ticks:
+ *
+ *   1st order:  v = x - e[n-1]             -> noise shaped by (1 - z^-1)
+ *   2nd order:  v = x - 2e[n-1] + e[n-2]   -> noise shaped by (1 - z^-1)^2
+ *
+ * This moves most of the quantization noise above the audio band, where
+ * the headphones and the ear filter it out.
+ *
+ * Integer add/shift/compare only (Cortex-M0: no FPU, no divider).
+ * No HAL: output words are DAC_PortWord() values, ready for DMA.
+ * The order comes from SOUND_LADDER_SHAPING in SoundConfig.h.
+ */
+
+void NoiseShaper_Init(void);
+
+/* 'count' 12-bit samples in -> count * SOUND_OVERSAMPLE port words out */
+void NoiseShaper_Run(const uint16_t *in, uint32_t *out, uint16_t count);
+
+#endif /* __NOISE_SHAPER_H__ */
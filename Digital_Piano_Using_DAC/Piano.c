@@ -1,24 +1,134 @@
 #include "Piano.h"
+#include "Timebase.h"
 #include "main.h"   // includes GPIO definitions
+#include "Barrier.h"
+
+// Key k is on PBk, so the pin mask and the key mask are the same bits
+#define READ_KEYS()  ((uint8_t)(~GPIOB->IDR & PIANO_KEY_MASK))
+
+// ===== ISR -> main loop event queue =====
+#define EVENT_QUEUE_SIZE  16u   // power of two
+
+static PianoEvent eventQueue[EVENT_QUEUE_SIZE];
+static volatile uint8_t eventHead = 0;   // written by EXTI/SysTick
+static volatile uint8_t eventTail = 0;   // written by main loop
+static volatile uint32_t overruns = 0;
+
+// ===== Debounce state (EXTI/SysTick only) =====
+static volatile uint8_t stableKeys = 0;   // last reported key mask
+static uint8_t lockout[PIANO_KEYS];       // ms left before the pin is re-armed
+
+static void postEvent(uint32_t time, uint8_t changed)
+{
+    uint8_t head = eventHead;
+
+    stableKeys ^= changed;
+
+    if ((uint8_t)(head - eventTail) >= EVENT_QUEUE_SIZE)
+    {
+        overruns++;   // main loop too slow; Piano_Keys() is still right
+        return;
+    }
+
+    eventQueue[head & (EVENT_QUEUE_SIZE - 1u)].time    = time;
+    eventQueue[head & (EVENT_QUEUE_SIZE - 1u)].keys    = stableKeys;
+    eventQueue[head & (EVENT_QUEUE_SIZE - 1u)].changed = changed;
+    COMPILER_BARRIER();
+    eventHead = (uint8_t)(head + 1u);   // publish after the entry is written
+}
+
+// Report a change on key k and ignore its pin for PIANO_DEBOUNCE_MS
+static void keyChanged(uint8_t k, uint32_t time)
+{
+    EXTI->IMR &= ~(1u << k);
+    lockout[k] = PIANO_DEBOUNCE_MS;
+    postEvent(time, (uint8_t)(1u << k));
+}
 
 void Piano_Init(void)
 {
-    //PB0/PB1/PB2 as input with pull-ups, taken care of by CubeMx
+    // PB0/PB1/PB2 as EXTI inputs with pull-ups, taken care of by CubeMx
+    eventHead = 0;
+    eventTail = 0;
+    overruns  = 0;
+    for (uint8_t k = 0; k < PIANO_KEYS; k++)
+    {
+        lockout[k] = 0;
+    }
+
+    EXTI->PR = PIANO_KEY_MASK;   // drop edges seen before now
+    stableKeys = READ_KEYS();
 }
 
-uint8_t Piano_In(void)
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
 {
-    uint8_t result = 0;
+    uint32_t now = Timebase_Us();
+    uint8_t  raw = READ_KEYS();
 
-    if ((GPIOB->IDR & GPIO_PIN_0) == 0) {
-        result = 1;  // key 1 pressed
+    for (uint8_t k = 0; k < PIANO_KEYS; k++)
+    {
+        uint8_t bit = (uint8_t)(1u << k);
+
+        // Only act if the level really differs from what was reported;
+        // a glitch that is already gone is ignored.
+        if ((GPIO_Pin & bit) && lockout[k] == 0u &&
+            ((raw ^ stableKeys) & bit))
+        {
+            keyChanged(k, now);
+        }
     }
-    else if ((GPIOB->IDR & GPIO_PIN_1) == 0) {
-        result = 2;  // key 2 pressed
+}
+
+// 1 ms SysTick: end the lockouts
+void HAL_SYSTICK_Callback(void)
+{
+    for (uint8_t k = 0; k < PIANO_KEYS; k++)
+    {
+        if (lockout[k] == 0u || --lockout[k] != 0u)
+        {
+            continue;
+        }
+
+        uint8_t bit = (uint8_t)(1u << k);
+
+        // Re-arm first, then read: an edge after the read still interrupts
+        EXTI->PR   = bit;
+        EXTI->IMR |= bit;
+
+        if ((READ_KEYS() ^ stableKeys) & bit)
+        {
+            keyChanged(k, Timebase_Us());   // changed during the lockout
+        }
     }
-    else if ((GPIOB->IDR & GPIO_PIN_2) == 0) {
-        result = 3;  // key 3 pressed
+}
+
+uint8_t Piano_Keys(void)
+{
+    return stableKeys;
+}
+
+uint8_t Piano_GetEvent(PianoEvent *ev)
+{
+    uint8_t tail = eventTail;
+
+    if (tail == eventHead)
+    {
+        return 0;
     }
 
-    return result;
+    COMPILER_BARRIER();
+    *ev = eventQueue[tail & (EVENT_QUEUE_SIZE - 1u)];
+    COMPILER_BARRIER();
+    eventTail = (uint8_t)(tail + 1u);   // free the entry after the copy
+    return 1;
+}
+
+uint8_t Piano_HasEvent(void)
+{
+    return eventTail != eventHead;
+}
+
+uint32_t Piano_Overruns(void)
+{
+    return overruns;
 }
@@ -5,19 +5,49 @@
 
 /*
  * Piano driver for 3 digital inputs.
- * Uses PB0, PB1, PB2 as active-low keys.
+ * Uses PB0, PB1, PB2 as active-low keys (internal pull-ups).
  *
- * PBx = 1 → not pressed
- * PBx = 0 → pressed
+ * Keys are reported as a bitmask, so chords work:
+ *   bit 0 = key 1 (PB0)
+ *   bit 1 = key 2 (PB1)
+ *   bit 2 = key 3 (PB2)
  *
- * Returns:
- *   0 = no key
- *   1 = key 1
- *   2 = key 2
- *   3 = key 3
+ * Each pin has an EXTI interrupt on both edges. The first edge is
+ * reported straight away (leading-edge debounce), then that pin's EXTI
+ * line is masked for PIANO_DEBOUNCE_MS. When the SysTick lockout ends the
+ * pin is read again, so a release during the lockout is not lost.
+ *
+ * Every change is queued as a PianoEvent with a Timebase_Us() timestamp
+ * of the edge. The queue has one producer context (EXTI and SysTick run
+ * at the same priority) and one consumer (the main loop).
+ *
+ * Needs, in stm32f0xx_it.c:
+ *   EXTI0_1_IRQHandler / EXTI2_3_IRQHandler -> HAL_GPIO_EXTI_IRQHandler()
+ *   SysTick_Handler -> HAL_IncTick() and HAL_SYSTICK_IRQHandler()
  */
 
-void Piano_Init(void);
-uint8_t Piano_In(void);
+#define PIANO_KEYS         3u
+#define PIANO_KEY_MASK     ((1u << PIANO_KEYS) - 1u)
+#define PIANO_DEBOUNCE_MS  20u
+
+typedef struct {
+    uint32_t time;     // edge timestamp, Timebase_Us()
+    uint8_t  keys;     // debounced key bitmask after the change
+    uint8_t  changed;  // keys that changed in this event
+} PianoEvent;
+
+void    Piano_Init(void);
+
+/* Debounced key bitmask right now */
+uint8_t Piano_Keys(void);
+
+/* Pop the oldest event into 'ev'. Returns 0 when the queue is empty. */
+uint8_t Piano_GetEvent(PianoEvent *ev);
+
+/* Non-zero while events are waiting */
+uint8_t Piano_HasEvent(void);
+
+/* Events dropped because the queue was full */
+uint32_t Piano_Overruns(void);
 
 #endif
@@ -0,0 +1,200 @@
+#include "RxRing.h"
+#include "main.h"
+
+UART_HandleTypeDef huart1;
+static DMA_HandleTypeDef hdma_usart1_rx;
+
+static uint8_t *rxBuf;
+static uint16_t rxSize;
+static volatile uint32_t halves = 0;   // half and full marks since the start (DMA ISR)
+static volatile uint8_t failed = 0;    // a UART error stopped reception (UART ISR)
+static volatile uint32_t errors = 0;   // UART errors (UART ISR)
+static uint32_t readPos = 0;           // bytes read since the start (main loop)
+static uint32_t laps = 0;              // times the DMA overtook readPos (main loop)
+
+static void startReceive(void)
+{
+    halves = 0;
+    readPos = 0;
+    if (HAL_UARTEx_ReceiveToIdle_DMA(&huart1, rxBuf, rxSize) != HAL_OK)
+    {
+        Error_Handler();
+    }
+}
+
+// Bytes the DMA has written since reception started. The DMA is in the
+// first half after an even number of marks: if it is not, it has just
+// crossed one and the interrupt that counts it has not run yet.
+static uint32_t written(void)
+{
+    uint16_t half = (uint16_t)(rxSize / 2u);
+    uint32_t h    = halves;
+    uint16_t at   = (uint16_t)(rxSize - __HAL_DMA_GET_COUNTER(&hdma_usart1_rx));
+
+    at = (at >= rxSize) ? 0u : at;
+    if ((at >= half) != ((h & 1u) != 0u))
+    {
+        h++;
+    }
+    return h * half + at % half;
+}
+
+void RxRing_Init(uint32_t baud, uint8_t *buf, uint16_t size)
+{
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+
+    __HAL_RCC_GPIOA_CLK_ENABLE();
+    __HAL_RCC_USART1_CLK_ENABLE();
+    __HAL_RCC_SYSCFG_CLK_ENABLE();
+
+    /* PA10 = USART1_RX */
+    GPIO_InitStruct.Pin = GPIO_PIN_10;
+    GPIO_InitStruct.Mode = GPIO_MODE_AF_PP;
+    GPIO_InitStruct.Pull = GPIO_PULLUP;   // idle high if the cable is out
+    GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH;
+    GPIO_InitStruct.Alternate = GPIO_AF1_USART1;
+    HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
+
+    huart1.Instance = USART1;
+    huart1.Init.BaudRate = baud;
+    huart1.Init.WordLength = UART_WORDLENGTH_8B;
+    huart1.Init.StopBits = UART_STOPBITS_1;
+    huart1.Init.Parity = UART_PARITY_NONE;
+    huart1.Init.Mode = UART_MODE_RX;
+    huart1.Init.HwFlowCtl = UART_HWCONTROL_NONE;
+    huart1.Init.OverSampling = UART_OVERSAMPLING_16;
+    huart1.Init.OneBitSampling = UART_ONE_BIT_SAMPLE_DISABLE;
+    huart1.AdvancedInit.AdvFeatureInit = UART_ADVFEATURE_NO_INIT;
+    if (HAL_UART_Init(&huart1) != HAL_OK)
+    {
+        Error_Handler();
+    }
+
+    // USART1_RX: DMA1 Channel 3 -> Channel 5 (Channel 3 is the audio)
+    SYSCFG->CFGR1 |= SYSCFG_CFGR1_USART1RX_DMA_RMP;
+
+    hdma_usart1_rx.Instance = DMA1_Channel5;
+    hdma_usart1_rx.Init.Direction = DMA_PERIPH_TO_MEMORY;
+    hdma_usart1_rx.Init.PeriphInc = DMA_PINC_DISABLE;
+    hdma_usart1_rx.Init.MemInc = DMA_MINC_ENABLE;
+    hdma_usart1_rx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    hdma_usart1_rx.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+    hdma_usart1_rx.Init.Mode = DMA_CIRCULAR;
+    hdma_usart1_rx.Init.Priority = DMA_PRIORITY_LOW;
+    if (HAL_DMA_Init(&hdma_usart1_rx) != HAL_OK)
+    {
+        Error_Handler();
+    }
+    __HAL_LINKDMA(&huart1, hdmarx, hdma_usart1_rx);
+
+    // Below the audio DMA; these only wake the main loop
+    HAL_NVIC_SetPriority(DMA1_Channel4_5_IRQn, TICK_INT_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(DMA1_Channel4_5_IRQn);
+    HAL_NVIC_SetPriority(USART1_IRQn, TICK_INT_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(USART1_IRQn);
+
+    rxBuf = buf;
+    rxSize = size;
+    failed = 0;
+    errors = 0;
+    laps = 0;
+    startReceive();
+}
+
+uint8_t RxRing_Read(void (*fn)(uint8_t b))
+{
+    if (failed)
+    {
+        // HAL stopped the DMA on the error. Start again from the top of
+        // the buffer; no interrupt of ours can run until it is going.
+        failed = 0;
+        startReceive();
+        return 1;
+    }
+
+    uint32_t head = written();
+    if (head - readPos > rxSize)
+    {
+        laps++;
+        readPos = head;
+        return 1;
+    }
+
+    uint32_t first = readPos;
+    uint16_t i = (uint16_t)(readPos % rxSize);
+    while (readPos != head)
+    {
+        fn(rxBuf[i]);
+        i = (uint16_t)((i + 1u == rxSize) ? 0u : i + 1u);
+        readPos++;
+    }
+
+    // The DMA may have come round again while 'fn' ran
+    head = written();
+    if (head - first > rxSize)
+    {
+        laps++;
+        readPos = head;
+        return 1;
+    }
+    return 0;
+}
+
+uint8_t RxRing_Pending(void)
+{
+    return failed || written() != readPos;
+}
+
+uint32_t RxRing_Errors(void)
+{
+    return errors + laps;
+}
+
+uint32_t RxRing_Laps(void)
+{
+    return laps;
+}
+
+void RxRing_UART_IRQHandler(void)
+{
+    HAL_UART_IRQHandler(&huart1);
+}
+
+void RxRing_DMA_IRQHandler(void)
+{
+    // Count the half and full marks and clear them, so the HAL handler
+    // below only sees transfer errors: its half/full callbacks would just
+    // wake the main loop, which this interrupt has done already.
+    if (DMA1->ISR & DMA_ISR_HTIF5)
+    {
+        DMA1->IFCR = DMA_IFCR_CHTIF5;
+        halves++;
+    }
+    if (DMA1->ISR & DMA_ISR_TCIF5)
+    {
+        DMA1->IFCR = DMA_IFCR_CTCIF5;
+        halves++;
+    }
+    HAL_DMA_IRQHandler(&hdma_usart1_rx);
+}
+
+// ===== HAL UART callbacks =====
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size)
+{
+    // Idle line: the interrupt has already woken the main loop, which
+    // reads the DMA position itself.
+    (void)huart;
+    (void)Size;
+}
+
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
+{
+    // Noise, framing or overrun: HAL has stopped the DMA. The next
+    // RxRing_Read() restarts it, so the main loop (woken by this
+    // interrupt) is the only one that touches the counts.
+    if (huart == &huart1)
+    {
+        errors++;
+        failed = 1;
+    }
+}
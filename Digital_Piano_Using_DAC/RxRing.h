@@ -0,0 +1,48 @@
+#ifndef __RX_RING_H__
+#define __RX_RING_H__
+
+#include <stdint.h>
+
+/*
+ * USART1 RX (PA10) into a circular DMA buffer, shared by MidiIn.c and
+ * Stream.c (only one of them is built, see SOUND_STREAM).
+ *
+ * USART1_RX is remapped to DMA1 Channel 5, because Channel 3 carries the
+ * audio. The idle-line, half and full interrupts only wake the main
+ * loop; no bytes are handled in an interrupt.
+ *
+ * The half and full interrupts also count how far the DMA has gone, so
+ * RxRing_Read() knows when the main loop has fallen a whole buffer
+ * behind and the DMA has written over bytes it had not read yet (a lap).
+ * The unread bytes are dropped and the call returns non-zero, the same
+ * as after a UART error, which restarts reception at the top of the
+ * buffer. Either way the caller resyncs its parser. Laps are counted
+ * with the UART errors.
+ *
+ * Needs, in stm32f0xx_it.c:
+ *   USART1_IRQHandler          -> RxRing_UART_IRQHandler()
+ *   DMA1_Channel4_5_IRQHandler -> RxRing_DMA_IRQHandler()
+ */
+
+/* 'size' must be even: the DMA interrupts at each half. */
+void     RxRing_Init(uint32_t baud, uint8_t *buf, uint16_t size);
+
+/*
+ * Pass every new byte to 'fn', oldest first. Returns non-zero if bytes
+ * were lost: found before reading, the call passes nothing and the
+ * bytes after the gap come on the next call, so the caller can drop
+ * its partial message first. Main loop only.
+ */
+uint8_t  RxRing_Read(void (*fn)(uint8_t b));
+
+/* Non-zero if the DMA has written bytes that RxRing_Read() hasn't read */
+uint8_t  RxRing_Pending(void);
+
+/* UART errors plus laps, and the laps alone */
+uint32_t RxRing_Errors(void);
+uint32_t RxRing_Laps(void);
+
+void     RxRing_UART_IRQHandler(void);
+void     RxRing_DMA_IRQHandler(void);
+
+#endif /* __RX_RING_H__ */
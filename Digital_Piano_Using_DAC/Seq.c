@@ -0,0 +1,167 @@
+#include "Seq.h"
+#include "SoundConfig.h"
+#include "Synth.h"
+#include "Tuning.h"
+
+static const uint8_t *pos = 0;   // next event's delta; 0 = stopped
+static uint16_t ppq;
+static uint32_t tickQ16;         // samples per tick, Q16
+static uint32_t wait;            // whole samples until the event at 'pos'
+static uint32_t frac;            // Q16 sample remainder, carried forward
+static uint32_t eventCount;
+static uint32_t keysOn[4];       // notes started by the sequence
+static const uint32_t *otherKeys;  // held by someone else, 0 = nobody
+
+// Release 'key' unless another source still holds it
+static void release(uint8_t key)
+{
+    if (otherKeys == 0 || (otherKeys[key >> 5] & (1uL << (key & 31u))) == 0u)
+    {
+        Synth_NoteOff(key);
+    }
+}
+
+static uint32_t readU24(const uint8_t *p)
+{
+    return ((uint32_t)p[0] << 16) | ((uint32_t)p[1] << 8) | p[2];
+}
+
+// Only on a tempo change, so the 64-bit divide is rare. Rounded, so the
+// drift is at most 1/2^17 sample per tick either way.
+static void setTempo(uint32_t usPerQuarter)
+{
+    uint64_t den = 1000000u * (uint64_t)ppq;
+    tickQ16 = (uint32_t)(((((uint64_t)SOUND_SAMPLE_RATE * usPerQuarter) << 16) +
+                          den / 2u) / den);
+}
+
+// Read the next delta and turn it into samples. The fraction is carried
+// so rounding never accumulates over a long sequence.
+static void scheduleNext(void)
+{
+    uint32_t delta = 0;
+    uint8_t  b;
+
+    do
+    {
+        b = *pos++;
+        delta = (delta << 7) | (b & 0x7Fu);
+    } while (b & 0x80u);
+
+    uint64_t span = (uint64_t)delta * tickQ16 + frac;
+    wait = (span >> 16) > 0xFFFFFFFFu ? 0xFFFFFFFFu : (uint32_t)(span >> 16);
+    frac = (uint32_t)span & 0xFFFFu;
+}
+
+static void doEvent(void)
+{
+    uint8_t op = *pos++;
+
+    eventCount++;
+
+    if (op >= (SEQ_OP_NOTE_OFF | SEQ_OP_NOTE_ON))
+    {
+        uint8_t key = op & 0x7Fu;
+        release(key);
+        keysOn[key >> 5] &= ~(1uL << (key & 31u));
+    }
+    else if (op >= SEQ_OP_NOTE_ON && op < SEQ_OP_NOTE_OFF)
+    {
+        uint32_t inc = Tuning_Inc(op);
+        if (inc != 0u)
+        {
+            Synth_NoteOn(op, inc);
+            keysOn[op >> 5] |= 1uL << (op & 31u);
+        }
+    }
+    else if (op == SEQ_OP_TEMPO)
+    {
+        setTempo(readU24(pos));
+        pos += 3;
+    }
+    else if (op == SEQ_OP_WAVE)
+    {
+        Synth_SetWave(*pos++);
+    }
+    else
+    {
+        Seq_Stop();   // SEQ_OP_END or an unknown op
+    }
+}
+
+uint8_t Seq_Start(const uint8_t *data)
+{
+    Seq_Stop();
+
+    if (data[0] != 'S' || data[1] != 'Q' || data[2] != SEQ_VERSION)
+    {
+        return 0;
+    }
+    ppq = (uint16_t)((data[3] << 8) | data[4]);
+    if (ppq == 0u)
+    {
+        return 0;
+    }
+
+    setTempo(readU24(&data[5]));
+    frac = 0x8000u;   // half a sample: events land on the nearest sample
+    eventCount = 0;
+    pos = &data[SEQ_HEADER_LEN];
+    scheduleNext();
+    return 1;
+}
+
+void Seq_Stop(void)
+{
+    pos = 0;
+
+    for (uint8_t key = 0; key < 128u; key++)
+    {
+        if (keysOn[key >> 5] & (1uL << (key & 31u)))
+        {
+            release(key);
+        }
+    }
+    keysOn[0] = keysOn[1] = keysOn[2] = keysOn[3] = 0;
+}
+
+void Seq_SetOtherKeys(const uint32_t *keys)
+{
+    otherKeys = keys;
+}
+
+uint8_t Seq_Holds(uint8_t key)
+{
+    return (keysOn[key >> 5] & (1uL << (key & 31u))) != 0u;
+}
+
+uint8_t Seq_IsPlaying(void)
+{
+    return pos != 0;
+}
+
+uint16_t Seq_Run(uint16_t maxSamples)
+{
+    while (pos != 0 && wait == 0u)
+    {
+        doEvent();
+        if (pos != 0)
+        {
+            scheduleNext();
+        }
+    }
+
+    if (pos == 0)
+    {
+        return maxSamples;
+    }
+
+    uint16_t n = (wait < maxSamples) ? (uint16_t)wait : maxSamples;
+    wait -= n;
+    return n;
+}
+
+uint32_t Seq_EventCount(void)
+{
+    return eventCount;
+}
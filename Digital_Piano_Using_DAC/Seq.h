@@ -0,0 +1,75 @@
+#ifndef __SEQ_H__
+#define __SEQ_H__
+
+#include <stdint.h>
+
+/*
+ * Sequence player for the digital piano.
+ *
+ * Plays a compact, MIDI-like event stream straight from flash (no copy)
+ * with sample-accurate timing. Like Synth.c it has no HAL, so the same
+ * code renders sequences on a PC (tools/seq2wav.c).
+ *
+ * Format (big-endian, like MIDI):
+ *   header  'S' 'Q' SEQ_VERSION  ppq:u16  tempo:u24
+ *           ppq   = ticks per quarter note
+ *           tempo = microseconds per quarter note at the start
+ *   events  delta:varint  op  [args]
+ *           delta = ticks since the previous event, 7 bits per byte,
+ *                   most significant first, bit 7 set on all but the last
+ *
+ *   op 0x00        end of sequence
+ *   op 0x01 t:u24  set tempo (microseconds per quarter note)
+ *   op 0x02 w:u8   wavetable for following notes (WAVE_xxx)
+ *   op 0x10..0x7F  note on, key = op
+ *   op 0x90..0xFF  note off, key = op & 0x7F
+ *   anything else stops playback
+ *
+ * Keys 0..15 are never used (the piano starts at A0 = 21), which leaves
+ * room for the one-byte control ops. A note costs 2 bytes for the on and
+ * 2 for the off when the delta fits in 7 bits.
+ *
+ * tools/midi2seq.py converts standard MIDI files to this format.
+ *
+ * All functions run in the sample/block ISR (Sound.c queues requests
+ * from the foreground), the same context as the Synth functions.
+ */
+
+#define SEQ_VERSION     1u
+#define SEQ_HEADER_LEN  8u
+
+#define SEQ_OP_END      0x00u
+#define SEQ_OP_TEMPO    0x01u
+#define SEQ_OP_WAVE     0x02u
+#define SEQ_OP_NOTE_ON  0x10u   // lowest note-on op
+#define SEQ_OP_NOTE_OFF 0x80u   // note off = SEQ_OP_NOTE_OFF | key
+
+/* Start playing 'data'. Returns 0 (and stays stopped) on a bad header. */
+uint8_t  Seq_Start(const uint8_t *data);
+
+/* Stop and release every note the sequence started. */
+void     Seq_Stop(void);
+
+uint8_t  Seq_IsPlaying(void);
+
+/*
+ * Keys held by the other note sources, as a 128-bit mask (bit key & 31
+ * of word key >> 5), or 0 for none. The sequence's note offs leave
+ * those keys sounding; the mask is read, never written.
+ */
+void     Seq_SetOtherKeys(const uint32_t *keys);
+
+/* Non-zero if the sequence has 'key' down */
+uint8_t  Seq_Holds(uint8_t key);
+
+/*
+ * Apply every event due at the current sample, then return how many
+ * samples (1..maxSamples) can be rendered before the next one and move
+ * the sequence clock on by that much. Returns maxSamples when stopped.
+ */
+uint16_t Seq_Run(uint16_t maxSamples);
+
+/* Events applied since the last Seq_Start() */
+uint32_t Seq_EventCount(void);
+
+#endif /* __SEQ_H__ */
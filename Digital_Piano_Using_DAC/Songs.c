@@ -0,0 +1,24 @@
+#include "Songs.h"
+#include "Seq.h"
+
+// Each note: delta, note on; delta (length in ticks), note off.
+// 2 ticks per quarter note at 120 bpm.
+const uint8_t Song_Demo[] = {
+    'S', 'Q', SEQ_VERSION, 0x00, 0x02, 0x07, 0xA1, 0x20,   // ppq 2, 500000 us
+    0, 64, 2, 0xC0,     // E4
+    0, 64, 2, 0xC0,     // E4
+    0, 65, 2, 0xC1,     // F4
+    0, 67, 2, 0xC3,     // G4
+    0, 67, 2, 0xC3,     // G4
+    0, 65, 2, 0xC1,     // F4
+    0, 64, 2, 0xC0,     // E4
+    0, 62, 2, 0xBE,     // D4
+    0, 60, 2, 0xBC,     // C4
+    0, 60, 2, 0xBC,     // C4
+    0, 62, 2, 0xBE,     // D4
+    0, 64, 2, 0xC0,     // E4
+    0, 64, 3, 0xC0,     // E4, dotted
+    0, 62, 1, 0xBE,     // D4, eighth
+    0, 62, 4, 0xBE,     // D4, half
+    0, SEQ_OP_END,
+};
@@ -0,0 +1,13 @@
+#ifndef __SONGS_H__
+#define __SONGS_H__
+
+#include <stdint.h>
+
+/*
+ * Sequences stored in flash for Sound_PlaySequence() (format in Seq.h).
+ * New songs can be made with tools/midi2seq.py.
+ */
+
+extern const uint8_t Song_Demo[];   // Ode to Joy, first phrase
+
+#endif /* __SONGS_H__ */
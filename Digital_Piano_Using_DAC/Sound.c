@@ -1,87 +1,441 @@
 #include "Sound.h"
-#include "DAC.h"
+#include "Synth.h"
+#include "Seq.h"
+#include "JitterBuffer.h"
+#include "Tuning.h"
+#include "AudioOut.h"
+#include "Timebase.h"
 #include "main.h"      // for htim3
+#include "Barrier.h"
 
 extern TIM_HandleTypeDef htim3;  // TIM3 handle created in main.c
 
-// ===== Waveform table =====
-// 32-sample 4-bit-ish sine wave (values 0..15)
-#define WAVE_SIZE 32
+// Notes are MIDI key numbers; only the 88 piano keys have a tuning entry
+#define NOTE_VALID(n)  (Tuning_Inc(n) != 0u)
 
-static const uint8_t SineWave[WAVE_SIZE] = {
-    8, 10, 12, 13, 14, 15, 15, 15,
-    14, 13, 12, 10, 8, 6, 4, 3,
-    2, 1, 0, 0, 0, 1, 2, 3,
-    4, 6, 8, 10, 12, 13, 14, 15
-};
+// ===== Foreground -> ISR command queue =====
+// Single producer (main loop), single consumer (sample/block ISR).
+#define CMD_ON      0u
+#define CMD_OFF     1u
+#define CMD_RETUNE  2u
+#define CMD_ALL_OFF 3u
+#define CMD_WAVE    4u
+#define CMD_ON_AT   5u   // CMD_ON with a key-edge timestamp for latency
+#define CMD_SEQ_PLAY 6u  // start seqRequest
+#define CMD_SEQ_STOP 7u
 
-static volatile uint8_t waveIndex = 0;
-static volatile uint8_t currentNote = NOTE_OFF;
+#define CMD_QUEUE_SIZE  8u   // power of two
 
-// Precomputed ARR values for TIM3 (PSC = 47, tick = 1MHz)
-#define ARR_NOTE_LOW   118u   // ~262 Hz
-#define ARR_NOTE_MED    94u   // ~329 Hz
-#define ARR_NOTE_HIGH   79u   // ~391 Hz
+typedef struct {
+    uint8_t cmd;
+    uint8_t src;       // SOUND_SRC_xxx, for the note commands
+    uint8_t note;
+    uint8_t oldNote;   // CMD_RETUNE only
+    uint32_t time;     // CMD_ON_AT only
+} SoundCmd;
+
+static SoundCmd cmdQueue[CMD_QUEUE_SIZE];
+static volatile uint8_t cmdHead = 0;   // written by foreground
+static volatile uint8_t cmdTail = 0;   // written by ISR
+
+static uint8_t currentNote = NOTE_OFF; // last Sound_Play() note (foreground)
+static const uint8_t * volatile seqRequest;  // for CMD_SEQ_PLAY
+
+// ===== Audio ISR load =====
+// A render is one block (DMA) or one sample. Both take at most 1 ms,
+// one SysTick period (SoundConfig.h), so the SysTick down-counter times them
+// without DWT, as ../Seven_Seg_Display_Driver/Buttons.c does. A render
+// that runs past the next one's start is counted as an overrun instead,
+// since its count would wrap.
+#if SOUND_USE_DMA
+#define RENDER_SAMPLES  SOUND_BLOCK_SIZE
+// Both backends stream on DMA1 Channel 3, and HAL clears its half/full
+// flag before calling back: set again means the next refill is due.
+#define RENDER_LATE()   ((DMA1->ISR & (DMA_ISR_HTIF3 | DMA_ISR_TCIF3)) != 0u)
+#else
+#define RENDER_SAMPLES  1u
+#define RENDER_LATE()   (__HAL_TIM_GET_FLAG(&htim3, TIM_FLAG_UPDATE) != 0u)
+#endif
+#define RENDER_BUDGET   (RENDER_SAMPLES * (SOUND_TIMER_CLOCK / SOUND_SAMPLE_RATE))
+
+static SoundLoad load;            // written by ISR
+
+static void measureLoad(uint32_t start)
+{
+    uint32_t now = SysTick->VAL;
+    uint32_t cycles = (start >= now) ? start - now : start + SysTick->LOAD + 1u - now;
+
+    if (RENDER_LATE())
+    {
+        load.overruns++;
+        if (cycles < RENDER_BUDGET)
+        {
+            cycles = RENDER_BUDGET;
+        }
+    }
+    load.lastCycles = cycles;
+    if (cycles > load.maxCycles)
+    {
+        load.maxCycles = cycles;
+    }
+}
+
+// ===== Key-to-sound latency =====
+#if SOUND_USE_DMA
+// A block is rendered into the half that just finished, so its first
+// sample plays once the other half has been sent: one block from now.
+#define OUTPUT_DELAY_US  (SOUND_BLOCK_SIZE * 1000000u / SOUND_SAMPLE_RATE)
+#else
+#define OUTPUT_DELAY_US  0u   // written to the output in the same ISR
+#endif
+
+static SoundLatency latency;      // written by ISR
+static uint8_t  edgePending = 0;  // ISR only
+static uint32_t edgeTime;
+
+// ===== Held keys per source (ISR only) =====
+// A key is released only once no source holds it, the sequence
+// included, so one source's note off can't cut another's note short.
+// Masks are 128 bits: bit key & 31 of word key >> 5, as in Seq.c.
+static uint32_t held[SOUND_SOURCES][4];
+static uint32_t liveKeys[4];      // all of held[] together, read by Seq.c
+
+static void hold(uint8_t src, uint8_t key)
+{
+    uint32_t bit = 1uL << (key & 31u);
+
+    held[src][key >> 5] |= bit;
+    liveKeys[key >> 5] |= bit;
+}
+
+// 'src' lets go of 'key'; returns 1 if nothing holds it any more
+static uint8_t letGo(uint8_t src, uint8_t key)
+{
+    uint8_t  w   = key >> 5;
+    uint32_t any = 0;
+
+    held[src][w] &= ~(1uL << (key & 31u));
+    for (uint8_t s = 0; s < SOUND_SOURCES; s++)
+    {
+        any |= held[s][w];
+    }
+    liveKeys[w] = any;
+    return (any & (1uL << (key & 31u))) == 0u && !Seq_Holds(key);
+}
+
+static void releaseAll(uint8_t src)
+{
+    for (uint8_t w = 0; w < 4u; w++)
+    {
+        uint32_t keys = held[src][w];
+
+        for (uint8_t k = 0; keys != 0u; k++, keys >>= 1)
+        {
+            if ((keys & 1u) && letGo(src, (uint8_t)(w * 32u + k)))
+            {
+                Synth_NoteOff((uint8_t)(w * 32u + k));
+            }
+        }
+    }
+}
+
+static void postCmd(uint8_t cmd, uint8_t src, uint8_t note, uint8_t oldNote, uint32_t time)
+{
+    uint8_t head = cmdHead;
+
+    // Wait for room; the ISR drains the queue every sample/block
+    while ((uint8_t)(head - cmdTail) >= CMD_QUEUE_SIZE)
+    {
+    }
+
+    cmdQueue[head & (CMD_QUEUE_SIZE - 1u)].cmd     = cmd;
+    cmdQueue[head & (CMD_QUEUE_SIZE - 1u)].src     = src;
+    cmdQueue[head & (CMD_QUEUE_SIZE - 1u)].note    = note;
+    cmdQueue[head & (CMD_QUEUE_SIZE - 1u)].oldNote = oldNote;
+    cmdQueue[head & (CMD_QUEUE_SIZE - 1u)].time    = time;
+    COMPILER_BARRIER();
+    cmdHead = (uint8_t)(head + 1u);   // publish after the entry is written
+}
+
+static void applyCmds(void)
+{
+    while (cmdTail != cmdHead)
+    {
+        COMPILER_BARRIER();
+        const SoundCmd *c = &cmdQueue[cmdTail & (CMD_QUEUE_SIZE - 1u)];
+
+        switch (c->cmd)
+        {
+        case CMD_ON:
+            hold(c->src, c->note);
+            Synth_NoteOn(c->note, Tuning_Inc(c->note));
+            break;
+        case CMD_ON_AT:
+            hold(c->src, c->note);
+            Synth_NoteOn(c->note, Tuning_Inc(c->note));
+            edgeTime    = c->time;
+            edgePending = 1;
+            break;
+        case CMD_OFF:
+            if (letGo(c->src, c->note))
+            {
+                Synth_NoteOff(c->note);
+            }
+            break;
+        case CMD_RETUNE:
+            // Glide only a voice nobody else holds; otherwise leave it
+            // sounding and start the new note on its own.
+            if (letGo(c->src, c->oldNote))
+            {
+                Synth_Retune(c->oldNote, c->note, Tuning_Inc(c->note));
+            }
+            else
+            {
+                Synth_NoteOn(c->note, Tuning_Inc(c->note));
+            }
+            hold(c->src, c->note);
+            break;
+        case CMD_WAVE:
+            Synth_SetWave(c->note);
+            break;
+        case CMD_SEQ_PLAY:
+            Seq_Start(seqRequest);
+            break;
+        case CMD_SEQ_STOP:
+            Seq_Stop();
+            break;
+        case CMD_ALL_OFF:
+        default:
+            releaseAll(c->src);
+            break;
+        }
+        COMPILER_BARRIER();
+        cmdTail = (uint8_t)(cmdTail + 1u);   // free the entry after use
+    }
+}
+
+// Called right after applyCmds(): a note started by CMD_ON_AT is in the
+// next sample rendered, which reaches the output OUTPUT_DELAY_US from now.
+static void measureLatency(void)
+{
+    if (!edgePending)
+    {
+        return;
+    }
+    edgePending = 0;
+
+    uint32_t us = Timebase_Us() + OUTPUT_DELAY_US - edgeTime;
+    latency.lastUs = us;
+    if (us > latency.maxUs)
+    {
+        latency.maxUs = us;
+    }
+    latency.count++;
+}
+
+#if SOUND_USE_DMA
+// ===== DMA ping-pong buffer =====
+// Each half holds one block of SOUND_BLOCK_SIZE audio samples, i.e.
+// SOUND_BLOCK_SIZE * SOUND_OVERSAMPLE backend words (AudioOut_PackBlock).
+#define DMA_HALF_WORDS  (SOUND_BLOCK_SIZE * SOUND_OVERSAMPLE)
+
+static uint32_t dmaBuf[2u * DMA_HALF_WORDS];
+
+static void renderBlock(uint32_t *dst)
+{
+    uint16_t block[SOUND_BLOCK_SIZE];
+    uint16_t done = 0;
+
+    applyCmds();
+    measureLatency();
+
+    // Split the block at sequence events so they land on their sample
+    while (done < SOUND_BLOCK_SIZE)
+    {
+        uint16_t n = Seq_Run((uint16_t)(SOUND_BLOCK_SIZE - done));
+        Synth_RenderBlock(&block[done], n);
+        done = (uint16_t)(done + n);
+    }
+#if SOUND_STREAM
+    JitterBuffer_Mix(block, SOUND_BLOCK_SIZE);
+#endif
+    AudioOut_PackBlock(block, dst, SOUND_BLOCK_SIZE);
+}
+
+// DMA has finished reading half 0 and is now playing half 1
+void AudioOut_HalfDone(void)
+{
+    uint32_t start = SysTick->VAL;
+    renderBlock(&dmaBuf[0]);
+    measureLoad(start);
+}
+
+// DMA has finished reading half 1 and wrapped back to half 0
+void AudioOut_FullDone(void)
+{
+    uint32_t start = SysTick->VAL;
+    renderBlock(&dmaBuf[DMA_HALF_WORDS]);
+    measureLoad(start);
+}
+#endif
 
 void Sound_Init(void)
 {
-    waveIndex = 0;
     currentNote = NOTE_OFF;
+    cmdHead = 0;
+    cmdTail = 0;
+    load.lastCycles   = 0;
+    load.maxCycles    = 0;
+    load.budgetCycles = RENDER_BUDGET;
+    load.overruns     = 0;
+    edgePending = 0;
+    latency.lastUs = 0;
+    latency.maxUs  = 0;
+    latency.count  = 0;
+    for (uint8_t s = 0; s < SOUND_SOURCES; s++)
+    {
+        held[s][0] = held[s][1] = held[s][2] = held[s][3] = 0;
+    }
+    liveKeys[0] = liveKeys[1] = liveKeys[2] = liveKeys[3] = 0;
 
-    DAC_Init();  // ensure DAC is ready
+    Synth_Init();
+    Seq_SetOtherKeys(liveKeys);
+    Seq_Stop();
+    AudioOut_Init();  // output ready, parked at mid-scale (silence)
 
-    // Start with timer stopped; Sound_Play() will start it when needed
+    // One fixed sample rate for every note: pitch comes from the phase
+    // increment, not from TIM3.
     HAL_TIM_Base_Stop_IT(&htim3);
-    DAC_Out(0);  // silence
+    __HAL_TIM_SET_PRESCALER(&htim3, 0);
+    __HAL_TIM_SET_AUTORELOAD(&htim3,
+        SOUND_TIMER_CLOCK / (SOUND_SAMPLE_RATE * SOUND_OVERSAMPLE) - 1u);
+    htim3.Instance->EGR = TIM_EGR_UG;   // load PSC/ARR now
+
+#if SOUND_USE_DMA
+    // Prime both halves, then let TIM3 update events pace the DMA
+    renderBlock(&dmaBuf[0]);
+    renderBlock(&dmaBuf[DMA_HALF_WORDS]);
+
+    AudioOut_StartDMA(dmaBuf, 2u * DMA_HALF_WORDS);
+#else
+    HAL_TIM_Base_Start_IT(&htim3);
+#endif
 }
 
 void Sound_Play(uint8_t note)
 {
-    currentNote = note;
-    waveIndex = 0;
+    if (!NOTE_VALID(note))
+    {
+        note = NOTE_OFF;
+    }
 
-    switch (note)
+    if (note == NOTE_OFF)
     {
-    case NOTE_LOW:
-        __HAL_TIM_SET_AUTORELOAD(&htim3, ARR_NOTE_LOW);
-        HAL_TIM_Base_Start_IT(&htim3);
-        break;
+        if (currentNote != NOTE_OFF)
+        {
+            postCmd(CMD_OFF, SOUND_SRC_PLAY, currentNote, 0, 0);
+        }
+    }
+    else if (currentNote != NOTE_OFF)
+    {
+        // Glide the sounding voice to the new pitch, phase-continuous
+        postCmd(CMD_RETUNE, SOUND_SRC_PLAY, note, currentNote, 0);
+    }
+    else
+    {
+        postCmd(CMD_ON, SOUND_SRC_PLAY, note, 0, 0);
+    }
 
-    case NOTE_MED:
-        __HAL_TIM_SET_AUTORELOAD(&htim3, ARR_NOTE_MED);
-        HAL_TIM_Base_Start_IT(&htim3);
-        break;
+    currentNote = note;
+}
 
-    case NOTE_HIGH:
-        __HAL_TIM_SET_AUTORELOAD(&htim3, ARR_NOTE_HIGH);
-        HAL_TIM_Base_Start_IT(&htim3);
-        break;
+void Sound_NoteOn(uint8_t src, uint8_t note)
+{
+    if (NOTE_VALID(note) && src < SOUND_SOURCES)
+    {
+        postCmd(CMD_ON, src, note, 0, 0);
+    }
+}
 
-    case NOTE_OFF:
-    default:
-        HAL_TIM_Base_Stop_IT(&htim3);
-        DAC_Out(0);   // force output to 0
-        break;
+void Sound_NoteOnAt(uint8_t src, uint8_t note, uint32_t edgeUs)
+{
+    if (NOTE_VALID(note) && src < SOUND_SOURCES)
+    {
+        postCmd(CMD_ON_AT, src, note, 0, edgeUs);
     }
 }
 
+void Sound_NoteOff(uint8_t src, uint8_t note)
+{
+    if (src >= SOUND_SOURCES)
+    {
+        return;
+    }
+    if (note == NOTE_OFF)
+    {
+        postCmd(CMD_ALL_OFF, src, 0, 0, 0);
+    }
+    else if (NOTE_VALID(note))
+    {
+        postCmd(CMD_OFF, src, note, 0, 0);
+    }
+}
+
+void Sound_SetWave(uint8_t wave)
+{
+    postCmd(CMD_WAVE, 0, wave, 0, 0);
+}
+
+void Sound_PlaySequence(const uint8_t *seq)
+{
+    // Publish the pointer before the command that uses it
+    seqRequest = seq;
+    postCmd(CMD_SEQ_PLAY, 0, 0, 0, 0);
+}
+
+void Sound_StopSequence(void)
+{
+    postCmd(CMD_SEQ_STOP, 0, 0, 0, 0);
+}
+
+uint8_t Sound_SequencePlaying(void)
+{
+    return Seq_IsPlaying();
+}
+
+void Sound_GetLatency(SoundLatency *out)
+{
+    // Copy with the audio ISR held off so the fields match
+    __disable_irq();
+    *out = latency;
+    __enable_irq();
+}
+
+void Sound_GetLoad(SoundLoad *out)
+{
+    __disable_irq();
+    *out = load;
+    __enable_irq();
+}
+
+#if !SOUND_USE_DMA
 // ===== Timer ISR callback =====
 void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
 {
     if (htim->Instance == TIM3)
     {
-        // Only output wave if a note is active
-        if (currentNote == NOTE_OFF)
-        {
-            DAC_Out(0);
-            return;
-        }
-
-        DAC_Out(SineWave[waveIndex]);
-        waveIndex++;
-        if (waveIndex >= WAVE_SIZE)
-        {
-            waveIndex = 0;
-        }
+        uint32_t start = SysTick->VAL;
+        applyCmds();
+        measureLatency();
+        Seq_Run(1);
+#if SOUND_STREAM
+        uint16_t sample = Synth_RenderSample();
+        JitterBuffer_Mix(&sample, 1);
+        AudioOut_Write(sample);
+#else
+        AudioOut_Write(Synth_RenderSample());
+#endif
+        measureLoad(start);
     }
 }
+#endif
@@ -2,29 +2,83 @@
 #define __SOUND_H__
 
 #include <stdint.h>
+#include "SoundConfig.h"
 
 /*
- * Sound driver for 3-note digital piano.
+ * Sound driver for the digital piano.
  *
  * Uses:
- *   - TIM3 as the sample-rate timer (update interrupt)
- *   - DAC driver on PC0..PC3
+ *   - TIM3 as a fixed sample-rate timer
+ *   - Synth engine (Synth.c) to mix up to SYNTH_VOICES notes
+ *   - An output backend (AudioOut.h): PC0..PC3 ladder or DAC1 on PA4
+ *
+ * Output mode and backend are picked in SoundConfig.h.
  *
  * API:
- *   Sound_Init() must be called once at startup.
- *   Sound_Play(note) selects which tone to play:
+ *   Sound_Init() must be called once at startup. It sets TIM3 to
+ *   SOUND_SAMPLE_RATE and leaves it running; silence is mid-scale.
+ *   Notes are MIDI key numbers; the 88 piano keys A0 (21) .. C8 (108)
+ *   are tuned (Tuning.h).
+ *   Sound_Play(note) plays one note at a time (monophonic):
  *      NOTE_OFF  = silence
  *      NOTE_LOW  = first note
  *      NOTE_MED  = second note
  *      NOTE_HIGH = third note
+ *   Sound_NoteOn(src, note)/Sound_NoteOff(src, note) start and stop
+ *   notes independently, so several can sound at once. 'src' says who
+ *   holds the key (SOUND_SRC_xxx). A note keeps sounding until every
+ *   source holding it, the sequence included, has let go of it.
+ *   Sound_NoteOff(src, NOTE_OFF) lets go of all of src's notes.
+ *   Sound_NoteOnAt(src, note, edgeUs) is Sound_NoteOn() for a key
+ *   pressed at Timebase_Us() time 'edgeUs'. The time from that edge to the note's
+ *   first sample at the output is recorded; read it with
+ *   Sound_GetLatency().
+ *   Sound_SetWave(WAVE_xxx) picks the timbre for notes started later.
+ *   Sound_PlaySequence(seq) plays a sequence from flash (Seq.h) alongside
+ *   the live keys; its events are applied on their exact sample.
+ *   Sound_SequencePlaying() turns non-zero once the ISR has started it.
+ *   Sound_GetLoad() reports the CPU cycles the audio ISR spends per
+ *   block (per sample without DMA) against the cycles available.
+ *
+ * Note requests are queued and applied by the sample/block ISR, so they
+ * are safe to call from the main loop.
  */
 
 #define NOTE_OFF   0
-#define NOTE_LOW   1   // e.g., C4
-#define NOTE_MED   2   // e.g., E4
-#define NOTE_HIGH  3   // e.g., G4
+#define NOTE_LOW   60  // C4
+#define NOTE_MED   64  // E4
+#define NOTE_HIGH  67  // G4
+
+// Note sources
+#define SOUND_SRC_KEYS    0u   // PB0..PB2 buttons (Piano.c)
+#define SOUND_SRC_MATRIX  1u   // key matrix (KeyMatrix.c)
+#define SOUND_SRC_MIDI    2u   // MIDI input (MidiIn.c)
+#define SOUND_SRC_PLAY    3u   // Sound_Play()
+#define SOUND_SOURCES     4u
+
+typedef struct {
+    uint32_t lastCycles;   // CPU cycles of the most recent render
+    uint32_t maxCycles;    // worst case since Sound_Init()
+    uint32_t budgetCycles; // cycles from one render to the next
+    uint32_t overruns;     // renders still running when the next was due
+} SoundLoad;
+
+typedef struct {
+    uint32_t lastUs;   // latency of the most recent Sound_NoteOnAt()
+    uint32_t maxUs;    // worst case since Sound_Init()
+    uint32_t count;    // notes measured
+} SoundLatency;
 
 void Sound_Init(void);
 void Sound_Play(uint8_t note);
+void Sound_NoteOn(uint8_t src, uint8_t note);
+void Sound_NoteOnAt(uint8_t src, uint8_t note, uint32_t edgeUs);
+void Sound_NoteOff(uint8_t src, uint8_t note);
+void Sound_SetWave(uint8_t wave);
+void Sound_PlaySequence(const uint8_t *seq);
+void Sound_StopSequence(void);
+uint8_t Sound_SequencePlaying(void);
+void Sound_GetLoad(SoundLoad *out);
+void Sound_GetLatency(SoundLatency *out);
 
 #endif /* __SOUND_H__ */
@@ -0,0 +1,118 @@
+#ifndef __SOUND_CONFIG_H__
+#define __SOUND_CONFIG_H__
+
+/*
+ * Compile-time options for the sound path. No HAL in here, so the synth
+ * sources that include it still build on a PC.
+ *
+ * SOUND_BACKEND selects the output hardware (see AudioOut.h):
+ *   SOUND_BACKEND_LADDER = 4-bit resistor ladder on PC0..PC3 (DAC.c)
+ *   SOUND_BACKEND_DAC1   = on-chip 12-bit DAC channel 1 on PA4
+ *
+ * SOUND_USE_DMA selects how samples reach the backend:
+ *   0 = TIM3 update interrupt writes one sample per interrupt.
+ *   1 = TIM3 paces a circular DMA transfer from a ping-pong buffer of
+ *       2 x SOUND_BLOCK_SIZE words. The half/full transfer interrupts
+ *       render the half that was just played, so there is one interrupt
+ *       per block and the sample timing comes from hardware only.
+ *
+ * SOUND_LADDER_SHAPING (ladder backend with SOUND_USE_DMA = 1 only):
+ *   0 = truncate each 12-bit sample to the top 4 bits.
+ *   1 = 1st-order error-feedback noise shaper.
+ *   2 = 2nd-order error-feedback noise shaper.
+ *   With shaping on, TIM3/DMA run at SOUND_OVERSAMPLE x the audio rate
+ *   and NoiseShaper.c pushes the 4-bit quantization noise up out of the
+ *   audio band, so the ladder gives more than 4 effective bits.
+ */
+
+#define SOUND_BACKEND_LADDER  0
+#define SOUND_BACKEND_DAC1    1
+
+#ifndef SOUND_BACKEND
+#define SOUND_BACKEND       SOUND_BACKEND_LADDER
+#endif
+
+#ifndef SOUND_USE_DMA
+#define SOUND_USE_DMA       1
+#endif
+
+#ifndef SOUND_LADDER_SHAPING
+#define SOUND_LADDER_SHAPING  0
+#endif
+
+#if SOUND_LADDER_SHAPING && !SOUND_USE_DMA
+#error "SOUND_LADDER_SHAPING needs SOUND_USE_DMA = 1"
+#endif
+
+/* DMA words per audio sample (TIM3 runs this much faster than audio) */
+#if SOUND_LADDER_SHAPING && SOUND_BACKEND == SOUND_BACKEND_LADDER
+#define SOUND_OVERSAMPLE_SHIFT  3u     // 8x
+#else
+#define SOUND_OVERSAMPLE_SHIFT  0u
+#endif
+#define SOUND_OVERSAMPLE    (1u << SOUND_OVERSAMPLE_SHIFT)
+
+/*
+ * TIM3 input clock (HSI, no PLL, APB1 /1) and the fixed sample rate.
+ * The CPU runs from the same 8 MHz, so a sample has
+ * SOUND_TIMER_CLOCK / SOUND_SAMPLE_RATE cycles for everything. Four
+ * enveloped voices take about 230 of the 500 at 16 kHz (README).
+ * Check Sound_GetLoad() on the board before raising the rate.
+ */
+#define SOUND_TIMER_CLOCK   8000000u
+#ifndef SOUND_SAMPLE_RATE
+#if SOUND_USE_DMA && SOUND_OVERSAMPLE == 1u
+#define SOUND_SAMPLE_RATE   16000u
+#else
+#define SOUND_SAMPLE_RATE   8000u      // x8 oversampled = 64 kHz DMA rate
+#endif
+#endif
+
+/* Samples rendered per DMA half-buffer (SOUND_USE_DMA = 1): 1 ms, one
+   SysTick period, which Sound_GetLoad() relies on */
+#define SOUND_BLOCK_SIZE    (SOUND_SAMPLE_RATE / 1000u)
+
+#if SOUND_SAMPLE_RATE % 1000u != 0u
+#error "SOUND_SAMPLE_RATE must be a multiple of 1 kHz (1 ms blocks)"
+#endif
+
+/*
+ * ADSR envelope, applied per voice by Synth.c.
+ *   SYNTH_ATTACK_MS   linear rise from the current level to full scale
+ *   SYNTH_DECAY_MS    time constant of the fall towards the sustain level
+ *   SYNTH_SUSTAIN     level held while the key is down (0.0 .. 1.0)
+ *   SYNTH_RELEASE_MS  time constant of the fall to silence after note off
+ * The times are folded into Q15 steps and coefficients at compile time.
+ */
+#ifndef SYNTH_ATTACK_MS
+#define SYNTH_ATTACK_MS     5.0f
+#endif
+#ifndef SYNTH_DECAY_MS
+#define SYNTH_DECAY_MS      300.0f
+#endif
+#ifndef SYNTH_SUSTAIN
+#define SYNTH_SUSTAIN       0.5f
+#endif
+#ifndef SYNTH_RELEASE_MS
+#define SYNTH_RELEASE_MS    60.0f
+#endif
+
+/*
+ * SOUND_STREAM = 1 builds the UART PCM/ADPCM stream receiver (Stream.c)
+ * instead of MIDI input (MidiIn.c): both need USART1_RX on DMA1 Channel 5.
+ * Streamed audio is mixed on top of the synth.
+ *   SOUND_STREAM_RATE  sample rate of the incoming stream
+ *   SOUND_STREAM_BAUD  USART1 baud rate; must carry the stream with some
+ *                      margin (8 kHz PCM8 ~ 82 kbit/s, ADPCM ~ 42 kbit/s)
+ */
+#ifndef SOUND_STREAM
+#define SOUND_STREAM        0
+#endif
+#ifndef SOUND_STREAM_RATE
+#define SOUND_STREAM_RATE   8000u
+#endif
+#ifndef SOUND_STREAM_BAUD
+#define SOUND_STREAM_BAUD   115200u
+#endif
+
+#endif /* __SOUND_CONFIG_H__ */
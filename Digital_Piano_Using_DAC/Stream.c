@@ -0,0 +1,188 @@
+#include "SoundConfig.h"
+
+#if SOUND_STREAM
+
+#include "Stream.h"
+#include "Adpcm.h"
+#include "RxRing.h"
+#include "main.h"
+
+static uint8_t rxBuf[STREAM_BUF_SIZE];
+
+// ===== Frame parser (main loop) =====
+#define ST_SYNC1    0u
+#define ST_SYNC2    1u
+#define ST_TYPE     2u
+#define ST_SEQ      3u
+#define ST_LEN      4u
+#define ST_PAYLOAD  5u
+#define ST_CRC      6u
+
+#define DECODE_CHUNK  16u   // payload bytes decoded per step (32 samples)
+
+static uint8_t  parseState;
+static uint8_t  frameType;
+static uint8_t  frameSeq;
+static uint8_t  frameLen;
+static uint8_t  frameCrc;
+static uint8_t  payload[255];
+static uint8_t  payloadLen;
+static uint8_t  lastSeq;
+static uint8_t  haveSeq;
+
+static uint32_t frames;
+static uint32_t crcErrors;
+static uint32_t lostFrames;
+
+static uint8_t crc8(uint8_t crc, uint8_t byte)
+{
+    crc ^= byte;
+    for (uint8_t i = 0; i < 8u; i++)
+    {
+        crc = (crc & 0x80u) ? (uint8_t)((crc << 1) ^ 0x07u) : (uint8_t)(crc << 1);
+    }
+    return crc;
+}
+
+void Stream_Init(void)
+{
+    parseState = ST_SYNC1;
+    haveSeq = 0;
+    frames = 0;
+    crcErrors = 0;
+    lostFrames = 0;
+    JitterBuffer_Init();
+    RxRing_Init(SOUND_STREAM_BAUD, rxBuf, STREAM_BUF_SIZE);
+}
+
+// A checked frame: decode it into the jitter buffer
+static void handleFrame(void)
+{
+    int16_t pcm[2u * DECODE_CHUNK];
+
+    if (haveSeq && frameSeq != (uint8_t)(lastSeq + 1u))
+    {
+        lostFrames += (uint8_t)(frameSeq - lastSeq - 1u);
+    }
+    lastSeq = frameSeq;
+    haveSeq = 1;
+    frames++;
+
+    if (frameType == STREAM_PCM8)
+    {
+        for (uint16_t i = 0; i < payloadLen; i += DECODE_CHUNK)
+        {
+            uint16_t n = (uint16_t)(payloadLen - i);
+            n = (n > DECODE_CHUNK) ? DECODE_CHUNK : n;
+            for (uint16_t k = 0; k < n; k++)
+            {
+                pcm[k] = (int16_t)(((int16_t)payload[i + k] - 128) << 4);
+            }
+            JitterBuffer_Write(pcm, n);
+        }
+    }
+    else if (frameType == STREAM_ADPCM)
+    {
+        // Each frame restarts the decoder, so a lost frame can't
+        // corrupt the ones after it.
+        AdpcmState st;
+        st.predictor = (int16_t)(payload[0] | (payload[1] << 8));
+        st.index     = payload[2];
+
+        for (uint16_t i = 4; i < payloadLen; i += DECODE_CHUNK)
+        {
+            uint16_t n = (uint16_t)(payloadLen - i);
+            n = (n > DECODE_CHUNK) ? DECODE_CHUNK : n;
+            Adpcm_Decode(&st, &payload[i], n, pcm);
+            for (uint16_t k = 0; k < 2u * n; k++)
+            {
+                pcm[k] = (int16_t)(pcm[k] >> 4);   // 16-bit -> 12-bit
+            }
+            JitterBuffer_Write(pcm, (uint16_t)(2u * n));
+        }
+    }
+    else
+    {
+        JitterBuffer_End();
+    }
+}
+
+static void parseByte(uint8_t b)
+{
+    switch (parseState)
+    {
+    case ST_SYNC1:
+        parseState = (b == STREAM_SYNC1) ? ST_SYNC2 : ST_SYNC1;
+        break;
+    case ST_SYNC2:
+        parseState = (b == STREAM_SYNC2) ? ST_TYPE :
+                     (b == STREAM_SYNC1) ? ST_SYNC2 : ST_SYNC1;
+        break;
+    case ST_TYPE:
+        frameType  = b;
+        frameCrc   = crc8(0, b);
+        parseState = ST_SEQ;
+        break;
+    case ST_SEQ:
+        frameSeq   = b;
+        frameCrc   = crc8(frameCrc, b);
+        parseState = ST_LEN;
+        break;
+    case ST_LEN:
+        frameLen   = b;
+        frameCrc   = crc8(frameCrc, b);
+        payloadLen = 0;
+        parseState = (b != 0u) ? ST_PAYLOAD : ST_CRC;
+        break;
+    case ST_PAYLOAD:
+        payload[payloadLen++] = b;
+        frameCrc = crc8(frameCrc, b);
+        if (payloadLen == frameLen)
+        {
+            parseState = ST_CRC;
+        }
+        break;
+    case ST_CRC:
+    default:
+        parseState = ST_SYNC1;
+        if (b != frameCrc || frameType > STREAM_END ||
+            (frameType == STREAM_ADPCM && frameLen < 4u))
+        {
+            crcErrors++;   // resync on the next 0xA5 0x5A
+            break;
+        }
+        handleFrame();
+        break;
+    }
+}
+
+void Stream_Poll(void)
+{
+    if (RxRing_Read(parseByte))
+    {
+        // Bytes were lost: drop the frame in progress and resync. The
+        // frames that went with them show up as a sequence gap.
+        parseState = ST_SYNC1;
+    }
+}
+
+uint8_t Stream_Pending(void)
+{
+    return RxRing_Pending();
+}
+
+void Stream_GetStats(StreamStats *stats)
+{
+    stats->frames     = frames;
+    stats->crcErrors  = crcErrors;
+    stats->lostFrames = lostFrames;
+    stats->uartErrors = RxRing_Errors();
+    stats->rxLaps     = RxRing_Laps();
+
+    // A few loads and stores: short enough to hold off the audio ISR
+    __disable_irq();
+    JitterBuffer_GetStats(&stats->jitter);
+    __enable_irq();
+}
+
+#endif /* SOUND_STREAM */
@@ -0,0 +1,58 @@
+#ifndef __STREAM_H__
+#define __STREAM_H__
+
+#include <stdint.h>
+#include "JitterBuffer.h"
+
+/*
+ * PCM / IMA ADPCM audio stream over USART1 RX (PA10), built when
+ * SOUND_STREAM = 1 in SoundConfig.h. It replaces MIDI input (MidiIn.c)
+ * because both need USART1_RX on DMA1 Channel 5.
+ *
+ * Bytes arrive at SOUND_STREAM_BAUD into a circular DMA buffer
+ * (RxRing.c), the same as for MIDI. Stream_Poll() runs in the main loop.
+ * It finds the frames, checks them, decodes them and writes the samples
+ * to the jitter buffer. The audio ISR mixes them into the output. If
+ * bytes are lost, the frame in progress is dropped.
+ *
+ * Frame:
+ *   0xA5 0x5A type seq len payload[len] crc
+ *   type  STREAM_PCM8   unsigned 8-bit samples
+ *         STREAM_ADPCM  predictor:i16 (little-endian) index:u8 reserved:u8,
+ *                       then IMA ADPCM, 2 samples per byte
+ *         STREAM_END    no payload: play out the buffer and stop
+ *   seq   +1 per frame; a gap counts as lost frames
+ *   crc   CRC-8 (poly 0x07, init 0) over type..payload
+ * Samples are at SOUND_STREAM_RATE, mono. tools/stream_pcm.py sends WAV
+ * files in this format.
+ */
+
+#define STREAM_SYNC1      0xA5u
+#define STREAM_SYNC2      0x5Au
+#define STREAM_PCM8       0x00u
+#define STREAM_ADPCM      0x01u
+#define STREAM_END        0x02u
+
+#define STREAM_BUF_SIZE   256u   // DMA ring: ~22 ms at 115200 baud
+
+typedef struct {
+    uint32_t frames;      // good frames
+    uint32_t crcErrors;   // frames dropped for a bad CRC or type
+    uint32_t lostFrames;  // sequence-number gaps
+    uint32_t uartErrors;  // framing/noise/overrun, plus rxLaps
+    uint32_t rxLaps;      // Stream_Poll() fell a whole DMA buffer behind
+    JitterStats jitter;
+} StreamStats;
+
+void    Stream_Init(void);
+
+/* Parse new bytes into the jitter buffer. Main loop only. */
+void    Stream_Poll(void);
+
+/* Non-zero if the DMA has written bytes that Stream_Poll() hasn't read */
+uint8_t Stream_Pending(void);
+
+/* Snapshot; also restarts the jitter buffer's min/max window. */
+void    Stream_GetStats(StreamStats *stats);
+
+#endif /* __STREAM_H__ */
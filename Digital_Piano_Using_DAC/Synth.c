@@ -0,0 +1,314 @@
+#include "Synth.h"
+#include "SoundConfig.h"
+#include "Wavetables.h"
+
+// ===== Waveform tables =====
+// WAVE_LEN entries; the top WAVE_BITS of the phase pick the entry and
+// the next 16 bits interpolate towards the following one.
+#define WAVE_SHIFT  (32u - WAVE_BITS)
+#define FRAC_SHIFT  (WAVE_SHIFT - 16u)
+#define WAVE_MASK   (WAVE_LEN - 1u)
+
+// ===== Envelope =====
+// Levels are Q15 (0..ENV_MAX). The envelope advances once every ENV_TICK
+// samples; in between, each voice's gain ramps linearly to the new level
+// so the steps are not audible. Only adds, shifts and 16x16 multiplies.
+#define ENV_TICK          (1u << SYNTH_ENV_SHIFT)
+#define ENV_MAX           32767
+#define ENV_TICKS(ms)     ((ms) * (float)SOUND_SAMPLE_RATE / (1000.0f * ENV_TICK))
+
+// Attack: fixed step per tick, at least 1
+#define ENV_ATTACK_STEP   ((int32_t)(ENV_MAX / (ENV_TICKS(SYNTH_ATTACK_MS) + 1.0f)) + 1)
+// Decay/release: level -= level / (ticks + 1) each tick, i.e. an
+// exponential with the given time constant (coefficient in Q15)
+#define ENV_COEF(ms)      ((int32_t)(32768.0f * ENV_TICKS(ms) / (ENV_TICKS(ms) + 1.0f)))
+#define ENV_DECAY_COEF    ENV_COEF(SYNTH_DECAY_MS)
+#define ENV_RELEASE_COEF  ENV_COEF(SYNTH_RELEASE_MS)
+#define ENV_SUSTAIN_LEVEL ((int32_t)(SYNTH_SUSTAIN * ENV_MAX))
+// Below this a voice is under 1 LSB of the 12-bit output: free it
+#define ENV_FLOOR         16
+
+// Envelope stages
+#define ENV_OFF      0u
+#define ENV_ATTACK   1u
+#define ENV_DECAY    2u
+#define ENV_SUSTAIN  3u
+#define ENV_RELEASE  4u
+
+// ===== Voice state =====
+typedef struct {
+    uint32_t phase;      // phase accumulator
+    uint32_t inc;        // phase increment per sample (0 = free)
+    const int16_t *wave; // wavetable for the timbre and pitch
+    int32_t  level;      // envelope level at the last tick (Q15)
+    int32_t  gain;       // gain applied to the current sample (Q15)
+    int32_t  gainStep;   // per-sample ramp from gain towards level
+    uint8_t  timbre;     // WAVE_xxx
+    uint8_t  key;        // note id, SYNTH_NO_KEY when free
+    uint8_t  stage;      // ENV_xxx
+    uint8_t  age;        // allocation order, for voice stealing
+} Voice;
+
+static Voice voices[SYNTH_VOICES];
+static uint8_t ageCounter = 0;
+static uint8_t newVoiceWave;          // timbre for the next Synth_NoteOn()
+static uint8_t tickCount = 0;         // samples since the last envelope tick
+
+void Synth_Init(void)
+{
+    for (uint8_t v = 0; v < SYNTH_VOICES; v++)
+    {
+        voices[v].phase    = 0;
+        voices[v].inc      = 0;
+        voices[v].level    = 0;
+        voices[v].gain     = 0;
+        voices[v].gainStep = 0;
+        voices[v].key      = SYNTH_NO_KEY;
+        voices[v].stage    = ENV_OFF;
+        voices[v].age      = 0;
+        voices[v].timbre   = WAVE_SINE;
+        voices[v].wave     = Wavetable[WAVE_SINE][0];
+    }
+    ageCounter = 0;
+    tickCount = 0;
+    newVoiceWave = WAVE_SINE;
+}
+
+void Synth_SetWave(uint8_t wave)
+{
+    if (wave < WAVE_COUNT)
+    {
+        newVoiceWave = wave;
+    }
+}
+
+static Voice *findVoice(uint8_t key)
+{
+    for (uint8_t v = 0; v < SYNTH_VOICES; v++)
+    {
+        if (voices[v].key == key)
+        {
+            return &voices[v];
+        }
+    }
+    return 0;
+}
+
+static uint16_t stealRank(const Voice *voice)
+{
+    uint16_t rank = (uint8_t)(ageCounter - voice->age);
+    if (voice->stage == ENV_RELEASE)
+    {
+        rank += 0x100u;
+    }
+    return rank;
+}
+
+void Synth_NoteOn(uint8_t key, uint32_t phaseInc)
+{
+    Voice *voice = findVoice(key);
+
+    if (voice == 0)
+    {
+        voice = findVoice(SYNTH_NO_KEY);
+    }
+
+    if (voice == 0)
+    {
+        // All busy: steal the oldest voice, preferring ones already in
+        // release. Its phase and level are kept, so the waveform just
+        // changes pitch and the attack starts from where it was.
+        voice = &voices[0];
+        for (uint8_t v = 1; v < SYNTH_VOICES; v++)
+        {
+            if (stealRank(&voices[v]) > stealRank(voice))
+            {
+                voice = &voices[v];
+            }
+        }
+    }
+    else if (voice->key == SYNTH_NO_KEY)
+    {
+        voice->phase    = 0;   // table[0] is mid-scale
+        voice->level    = 0;   // attack from silence
+        voice->gain     = 0;
+        voice->gainStep = 0;
+    }
+
+    voice->inc      = phaseInc;
+    voice->timbre   = newVoiceWave;
+    voice->wave     = Wavetable[newVoiceWave][Wave_Level(phaseInc)];
+    voice->key      = key;
+    voice->stage    = ENV_ATTACK;
+    voice->age      = ageCounter++;
+}
+
+void Synth_NoteOff(uint8_t key)
+{
+    Voice *voice = findVoice(key);
+    if (voice != 0)
+    {
+        voice->stage = ENV_RELEASE;
+    }
+}
+
+void Synth_Retune(uint8_t oldKey, uint8_t newKey, uint32_t phaseInc)
+{
+    Voice *voice = findVoice(oldKey);
+    Voice *taken = findVoice(newKey);
+
+    if (taken != 0 && taken != voice)
+    {
+        // newKey sounds already: merge into that voice. Retuning this
+        // one as well would leave newKey on two voices, and its note off
+        // would only release the first.
+        if (voice != 0)
+        {
+            voice->stage = ENV_RELEASE;
+        }
+        if (taken->stage == ENV_RELEASE)
+        {
+            taken->stage = ENV_ATTACK;
+        }
+        return;
+    }
+    if (voice == 0)
+    {
+        Synth_NoteOn(newKey, phaseInc);
+        return;
+    }
+
+    // Only the increment changes: the next sample continues from the
+    // current phase, so there is no discontinuity.
+    // The table may change level, which only drops or adds harmonics.
+    voice->inc  = phaseInc;
+    voice->wave = Wavetable[voice->timbre][Wave_Level(phaseInc)];
+    voice->key  = newKey;
+    if (voice->stage == ENV_RELEASE)
+    {
+        voice->stage = ENV_ATTACK;   // re-attack from the current level
+    }
+}
+
+void Synth_AllOff(void)
+{
+    for (uint8_t v = 0; v < SYNTH_VOICES; v++)
+    {
+        if (voices[v].key != SYNTH_NO_KEY)
+        {
+            voices[v].stage = ENV_RELEASE;
+        }
+    }
+}
+
+// Advance every active envelope by one tick and set up the gain ramps
+static void envelopeTick(void)
+{
+    for (uint8_t v = 0; v < SYNTH_VOICES; v++)
+    {
+        Voice *voice = &voices[v];
+        int32_t level = voice->level;
+
+        switch (voice->stage)
+        {
+        case ENV_ATTACK:
+            level += ENV_ATTACK_STEP;
+            if (level >= ENV_MAX)
+            {
+                level = ENV_MAX;
+                voice->stage = ENV_DECAY;
+            }
+            break;
+        case ENV_DECAY:
+            level = ENV_SUSTAIN_LEVEL +
+                (((level - ENV_SUSTAIN_LEVEL) * ENV_DECAY_COEF) >> 15);
+            if (level <= ENV_SUSTAIN_LEVEL)
+            {
+                level = ENV_SUSTAIN_LEVEL;
+                voice->stage = ENV_SUSTAIN;
+            }
+            break;
+        case ENV_RELEASE:
+            level = (level * ENV_RELEASE_COEF) >> 15;
+            if (level < ENV_FLOOR)
+            {
+                // Inaudible: free the voice
+                voice->phase    = 0;
+                voice->inc      = 0;
+                voice->key      = SYNTH_NO_KEY;
+                voice->stage    = ENV_OFF;
+                voice->level    = 0;
+                voice->gain     = 0;
+                voice->gainStep = 0;
+                continue;
+            }
+            break;
+        case ENV_SUSTAIN:
+        case ENV_OFF:
+        default:
+            break;
+        }
+
+        voice->level    = level;
+        voice->gainStep = (level - voice->gain) >> SYNTH_ENV_SHIFT;
+    }
+}
+
+static inline uint16_t renderSample(void)
+{
+    int32_t mix = 0;
+
+    if (tickCount == 0u)
+    {
+        envelopeTick();
+    }
+    tickCount = (uint8_t)((tickCount + 1u) & (ENV_TICK - 1u));
+
+    for (uint8_t v = 0; v < SYNTH_VOICES; v++)
+    {
+        Voice *voice = &voices[v];
+        if (voice->inc == 0)
+        {
+            continue;
+        }
+
+        uint32_t next = voice->phase + voice->inc;
+        voice->phase = next;
+
+        // Linear interpolation between neighbouring table entries
+        uint32_t idx  = next >> WAVE_SHIFT;
+        int32_t  frac = (int32_t)((next >> FRAC_SHIFT) & 0xFFFFu);
+        int32_t  a    = voice->wave[idx];
+        int32_t  b    = voice->wave[(idx + 1u) & WAVE_MASK];
+        int32_t  s    = a + (((b - a) * frac) >> 16);
+
+        // Envelope gain, ramped once per sample
+        voice->gain += voice->gainStep;
+        mix += (s * voice->gain) >> 15;
+    }
+
+    // Saturate to the 12-bit range
+    mix += (int32_t)SYNTH_OUT_MID;
+    if (mix < 0)
+    {
+        mix = 0;
+    }
+    else if (mix > (int32_t)SYNTH_OUT_MAX)
+    {
+        mix = (int32_t)SYNTH_OUT_MAX;
+    }
+    return (uint16_t)mix;
+}
+
+uint16_t Synth_RenderSample(void)
+{
+    return renderSample();
+}
+
+void Synth_RenderBlock(uint16_t *out, uint16_t count)
+{
+    while (count--)
+    {
+        *out++ = renderSample();
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef __SYNTH_H__
+#define __SYNTH_H__
+
+#include <stdint.h>
+
+/*
+ * Phase-accumulator (DDS) synth engine for the digital piano.
+ *
+ * The sample clock never changes. Each voice keeps a 32-bit phase
+ * accumulator and adds its phase increment once per sample:
+ *
+ *   phaseInc = f_note * 2^32 / f_sample
+ *
+ * The top 8 bits of the phase index a 256-entry wavetable (Wavetables.h,
+ * one band-limited level per octave, picked at note on)
+ * and the next 16 bits interpolate linearly between entries. Pitch
+ * resolution is SOUND_SAMPLE_RATE / 2^32 (~3.7 uHz at the default
+ * 16 kHz, ~1.9 uHz at 8 kHz) instead of one whole TIM3 ARR step.
+ *
+ * Each voice has an attack/decay/sustain/release envelope (times in
+ * SoundConfig.h). The envelope is advanced in Q15 once every
+ * 2^SYNTH_ENV_SHIFT samples and ramped linearly in between, then used as
+ * the voice's gain. Note off starts the release; the voice is only freed
+ * once the envelope has decayed to silence, so notes never click.
+ *
+ * Samples are mixed as signed values, saturated, and returned as a
+ * 12-bit unsigned sample (0..4095, silence = SYNTH_OUT_MID).
+ *
+ * No HAL in here: the engine only touches its own state, so it also
+ * builds on a PC. All functions must be called from the same context
+ * (the sample ISR); Sound.c queues note requests from the foreground.
+ */
+
+#define SYNTH_VOICES     4u      // simultaneous notes
+#define SYNTH_OUT_MID    2048u   // 12-bit mid-scale (silence)
+#define SYNTH_OUT_MAX    4095u   // 12-bit full-scale
+
+#define SYNTH_NO_KEY     0xFFu   // voice is free (keys are MIDI 0..127)
+
+#define SYNTH_ENV_SHIFT  4u      // envelope tick = 16 samples
+
+void     Synth_Init(void);
+
+/* Wavetable (WAVE_SINE, ...) used by notes started after this call */
+void     Synth_SetWave(uint8_t wave);
+
+/* Start 'key' at 'phaseInc' and (re)start its attack. Steals the oldest
+   voice, preferring released ones, if all are busy. */
+void     Synth_NoteOn(uint8_t key, uint32_t phaseInc);
+
+/* Move 'key' to its release stage; it is freed once silent. */
+void     Synth_NoteOff(uint8_t key);
+
+/* Move the voice playing 'oldKey' to 'newKey' without resetting phase.
+   If 'newKey' already has a voice, that one keeps the key (re-attacked
+   if it was releasing) and 'oldKey' is released, so no key ever sits
+   on two voices. */
+void     Synth_Retune(uint8_t oldKey, uint8_t newKey, uint32_t phaseInc);
+
+/* Release every voice. */
+void     Synth_AllOff(void);
+
+/* Mix one sample from all active voices (0..4095). */
+uint16_t Synth_RenderSample(void);
+
+/* Mix 'count' samples into 'out'; identical to calling
+   Synth_RenderSample() 'count' times. */
+void     Synth_RenderBlock(uint16_t *out, uint16_t count);
+
+#endif /* __SYNTH_H__ */
@@ -0,0 +1,47 @@
+#include "Tuning.h"
+#include "SoundConfig.h"
+
+/* Equal-temperament ratios 2^(n/12), n = 0..11 */
+#define SEMI_0    1.0
+#define SEMI_1    1.0594630943592953
+#define SEMI_2    1.1224620483093730
+#define SEMI_3    1.1892071150027210
+#define SEMI_4    1.2599210498948732
+#define SEMI_5    1.3348398541700344
+#define SEMI_6    1.4142135623730951
+#define SEMI_7    1.4983070768766815
+#define SEMI_8    1.5874010519681994
+#define SEMI_9    1.6817928305074290
+#define SEMI_10   1.7817974362806785
+#define SEMI_11   1.8877486253633868
+
+/* Frequency of the key 'semi' semitones above A in octave 'oct'
+   (A0 = 27.5 Hz) */
+#define KEY_HZ(oct, semi) \
+    (TUNING_A4_HZ / 16.0 * (double)(1u << (oct)) * SEMI_##semi)
+
+/* The same key as a phase increment, or 0 (silent) at or above half
+   the sample rate, where it would alias to a wrong note. Folded to an
+   integer constant by the compiler. */
+#define KEY_INC(oct, semi) \
+    (KEY_HZ(oct, semi) >= SOUND_SAMPLE_RATE / 2.0 ? 0u : \
+     (uint32_t)(KEY_HZ(oct, semi) * (4294967296.0 / SOUND_SAMPLE_RATE) + 0.5))
+
+#define OCTAVE(oct) \
+    KEY_INC(oct, 0), KEY_INC(oct, 1), KEY_INC(oct, 2),  KEY_INC(oct, 3), \
+    KEY_INC(oct, 4), KEY_INC(oct, 5), KEY_INC(oct, 6),  KEY_INC(oct, 7), \
+    KEY_INC(oct, 8), KEY_INC(oct, 9), KEY_INC(oct, 10), KEY_INC(oct, 11)
+
+const uint32_t Tuning_PhaseInc[TUNING_KEYS] = {
+    OCTAVE(0),   // A0 ..G#1
+    OCTAVE(1),   // A1 ..G#2
+    OCTAVE(2),   // A2 ..G#3
+    OCTAVE(3),   // A3 ..G#4
+    OCTAVE(4),   // A4 ..G#5
+    OCTAVE(5),   // A5 ..G#6
+    OCTAVE(6),   // A6 ..G#7
+    KEY_INC(7, 0), KEY_INC(7, 1), KEY_INC(7, 2), KEY_INC(7, 3),   // A7..C8
+};
+
+/* Every key up to B7 (3951 Hz) must play; at 8 kHz only C8 is silent */
+_Static_assert(SOUND_SAMPLE_RATE > 2u * 3952u, "sample rate too low for the 88-key table");
@@ -0,0 +1,37 @@
+#ifndef __TUNING_H__
+#define __TUNING_H__
+
+#include <stdint.h>
+
+/*
+ * 88-key equal-temperament tuning table (A0..C8, MIDI keys 21..108).
+ *
+ * Each entry is the DDS phase increment f * 2^32 / SOUND_SAMPLE_RATE.
+ * The compiler computes the table from TUNING_A4_HZ and the
+ * configured sample rate (SoundConfig.h). It lives in flash and costs
+ * nothing at runtime. With a 32-bit phase accumulator, rounding error is
+ * far below 0.01 cent for every key. Keys at or above half the sample
+ * rate are 0, like keys off the keyboard, so every increment is below
+ * 2^31 (Wavetables.h relies on that).
+ */
+
+#define TUNING_A4_HZ       440.0
+
+#define TUNING_FIRST_KEY   21u    // A0
+#define TUNING_LAST_KEY    108u   // C8
+#define TUNING_KEYS        (TUNING_LAST_KEY - TUNING_FIRST_KEY + 1u)
+
+extern const uint32_t Tuning_PhaseInc[TUNING_KEYS];
+
+/* Phase increment for a MIDI key, 0 if the key is off the keyboard or
+   above half the sample rate */
+static inline uint32_t Tuning_Inc(uint8_t key)
+{
+    if (key < TUNING_FIRST_KEY || key > TUNING_LAST_KEY)
+    {
+        return 0;
+    }
+    return Tuning_PhaseInc[key - TUNING_FIRST_KEY];
+}
+
+#endif /* __TUNING_H__ */
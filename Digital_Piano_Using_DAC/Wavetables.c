@@ -0,0 +1,625 @@
+/* Generated by tools/gen_wavetables.py -- do not edit by hand. */
+#include "Wavetables.h"
+
+/* 256 entries, signed 12-bit, level l keeps harmonics 1..32 >> l (Lanczos sigma).
+   All levels of a wave share one scale, so a note keeps its loudness when
+   it moves to another level. Identical levels share a table. */
+
+// sine, harmonics 1..32
+static const int16_t WaveSine0[WAVE_LEN] = {
+        0,    50,   100,   151,   201,   251,   300,   350,
+      399,   449,   497,   546,   594,   642,   690,   737,
+      783,   830,   875,   920,   965,  1009,  1052,  1095,
+     1137,  1179,  1219,  1259,  1299,  1337,  1375,  1411,
+     1447,  1483,  1517,  1550,  1582,  1614,  1644,  1674,
+     1702,  1729,  1756,  1781,  1805,  1828,  1850,  1871,
+     1891,  1910,  1927,  1944,  1959,  1973,  1986,  1997,
+     2008,  2017,  2025,  2032,  2037,  2041,  2045,  2046,
+     2047,  2046,  2045,  2041,  2037,  2032,  2025,  2017,
+     2008,  1997,  1986,  1973,  1959,  1944,  1927,  1910,
+     1891,  1871,  1850,  1828,  1805,  1781,  1756,  1729,
+     1702,  1674,  1644,  1614,  1582,  1550,  1517,  1483,
+     1447,  1411,  1375,  1337,  1299,  1259,  1219,  1179,
+     1137,  1095,  1052,  1009,   965,   920,   875,   830,
+      783,   737,   690,   642,   594,   546,   497,   449,
+      399,   350,   300,   251,   201,   151,   100,    50,
+        0,   -50,  -100,  -151,  -201,  -251,  -300,  -350,
+     -399,  -449,  -497,  -546,  -594,  -642,  -690,  -737,
+     -783,  -830,  -875,  -920,  -965, -1009, -1052, -1095,
+    -1137, -1179, -1219, -1259, -1299, -1337, -1375, -1411,
+    -1447, -1483, -1517, -1550, -1582, -1614, -1644, -1674,
+    -1702, -1729, -1756, -1781, -1805, -1828, -1850, -1871,
+    -1891, -1910, -1927, -1944, -1959, -1973, -1986, -1997,
+    -2008, -2017, -2025, -2032, -2037, -2041, -2045, -2046,
+    -2047, -2046, -2045, -2041, -2037, -2032, -2025, -2017,
+    -2008, -1997, -1986, -1973, -1959, -1944, -1927, -1910,
+    -1891, -1871, -1850, -1828, -1805, -1781, -1756, -1729,
+    -1702, -1674, -1644, -1614, -1582, -1550, -1517, -1483,
+    -1447, -1411, -1375, -1337, -1299, -1259, -1219, -1179,
+    -1137, -1095, -1052, -1009,  -965,  -920,  -875,  -830,
+     -783,  -737,  -690,  -642,  -594,  -546,  -497,  -449,
+     -399,  -350,  -300,  -251,  -201,  -151,  -100,   -50,
+};
+
+// triangle, harmonics 1..32
+static const int16_t WaveTriangle0[WAVE_LEN] = {
+        0,    33,    66,    99,   132,   165,   198,   231,
+      264,   297,   330,   363,   396,   429,   462,   495,
+      528,   561,   594,   627,   660,   693,   726,   758,
+      791,   824,   857,   890,   923,   956,   989,  1022,
+     1055,  1088,  1121,  1154,  1187,  1220,  1253,  1286,
+     1319,  1352,  1385,  1418,  1451,  1484,  1517,  1549,
+     1582,  1615,  1648,  1681,  1714,  1747,  1780,  1813,
+     1846,  1879,  1913,  1946,  1977,  2006,  2028,  2042,
+     2047,  2042,  2028,  2006,  1977,  1946,  1913,  1879,
+     1846,  1813,  1780,  1747,  1714,  1681,  1648,  1615,
+     1582,  1549,  1517,  1484,  1451,  1418,  1385,  1352,
+     1319,  1286,  1253,  1220,  1187,  1154,  1121,  1088,
+     1055,  1022,   989,   956,   923,   890,   857,   824,
+      791,   758,   726,   693,   660,   627,   594,   561,
+      528,   495,   462,   429,   396,   363,   330,   297,
+      264,   231,   198,   165,   132,    99,    66,    33,
+        0,   -33,   -66,   -99,  -132,  -165,  -198,  -231,
+     -264,  -297,  -330,  -363,  -396,  -429,  -462,  -495,
+     -528,  -561,  -594,  -627,  -660,  -693,  -726,  -758,
+     -791,  -824,  -857,  -890,  -923,  -956,  -989, -1022,
+    -1055, -1088, -1121, -1154, -1187, -1220, -1253, -1286,
+    -1319, -1352, -1385, -1418, -1451, -1484, -1517, -1549,
+    -1582, -1615, -1648, -1681, -1714, -1747, -1780, -1813,
+    -1846, -1879, -1913, -1946, -1977, -2006, -2028, -2042,
+    -2047, -2042, -2028, -2006, -1977, -1946, -1913, -1879,
+    -1846, -1813, -1780, -1747, -1714, -1681, -1648, -1615,
+    -1582, -1549, -1517, -1484, -1451, -1418, -1385, -1352,
+    -1319, -1286, -1253, -1220, -1187, -1154, -1121, -1088,
+    -1055, -1022,  -989,  -956,  -923,  -890,  -857,  -824,
+     -791,  -758,  -726,  -693,  -660,  -627,  -594,  -561,
+     -528,  -495,  -462,  -429,  -396,  -363,  -330,  -297,
+     -264,  -231,  -198,  -165,  -132,   -99,   -66,   -33,
+};
+
+// triangle, harmonics 1..16
+static const int16_t WaveTriangle1[WAVE_LEN] = {
+        0,    33,    66,    99,   132,   166,   199,   232,
+      265,   299,   332,   365,   398,   431,   464,   497,
+      530,   563,   596,   630,   663,   696,   729,   762,
+      796,   829,   862,   895,   928,   961,   994,  1027,
+     1060,  1093,  1126,  1159,  1192,  1226,  1259,  1292,
+     1325,  1358,  1391,  1424,  1457,  1490,  1522,  1555,
+     1588,  1621,  1655,  1688,  1722,  1756,  1789,  1822,
+     1853,  1883,  1910,  1935,  1956,  1973,  1985,  1993,
+     1995,  1993,  1985,  1973,  1956,  1935,  1910,  1883,
+     1853,  1822,  1789,  1756,  1722,  1688,  1655,  1621,
+     1588,  1555,  1522,  1490,  1457,  1424,  1391,  1358,
+     1325,  1292,  1259,  1226,  1192,  1159,  1126,  1093,
+     1060,  1027,   994,   961,   928,   895,   862,   829,
+      796,   762,   729,   696,   663,   630,   596,   563,
+      530,   497,   464,   431,   398,   365,   332,   299,
+      265,   232,   199,   166,   132,    99,    66,    33,
+        0,   -33,   -66,   -99,  -132,  -166,  -199,  -232,
+     -265,  -299,  -332,  -365,  -398,  -431,  -464,  -497,
+     -530,  -563,  -596,  -630,  -663,  -696,  -729,  -762,
+     -796,  -829,  -862,  -895,  -928,  -961,  -994, -1027,
+    -1060, -1093, -1126, -1159, -1192, -1226, -1259, -1292,
+    -1325, -1358, -1391, -1424, -1457, -1490, -1522, -1555,
+    -1588, -1621, -1655, -1688, -1722, -1756, -1789, -1822,
+    -1853, -1883, -1910, -1935, -1956, -1973, -1985, -1993,
+    -1995, -1993, -1985, -1973, -1956, -1935, -1910, -1883,
+    -1853, -1822, -1789, -1756, -1722, -1688, -1655, -1621,
+    -1588, -1555, -1522, -1490, -1457, -1424, -1391, -1358,
+    -1325, -1292, -1259, -1226, -1192, -1159, -1126, -1093,
+    -1060, -1027,  -994,  -961,  -928,  -895,  -862,  -829,
+     -796,  -762,  -729,  -696,  -663,  -630,  -596,  -563,
+     -530,  -497,  -464,  -431,  -398,  -365,  -332,  -299,
+     -265,  -232,  -199,  -166,  -132,   -99,   -66,   -33,
+};
+
+// triangle, harmonics 1..8
+static const int16_t WaveTriangle2[WAVE_LEN] = {
+        0,    34,    67,   101,   134,   168,   201,   235,
+      269,   303,   337,   371,   405,   439,   473,   507,
+      541,   575,   608,   642,   676,   710,   743,   777,
+      810,   843,   877,   910,   943,   976,  1009,  1042,
+     1076,  1109,  1143,  1176,  1210,  1244,  1278,  1312,
+     1346,  1381,  1415,  1449,  1483,  1516,  1550,  1582,
+     1615,  1646,  1676,  1705,  1733,  1760,  1784,  1807,
+     1829,  1848,  1864,  1879,  1891,  1900,  1907,  1911,
+     1912,  1911,  1907,  1900,  1891,  1879,  1864,  1848,
+     1829,  1807,  1784,  1760,  1733,  1705,  1676,  1646,
+     1615,  1582,  1550,  1516,  1483,  1449,  1415,  1381,
+     1346,  1312,  1278,  1244,  1210,  1176,  1143,  1109,
+     1076,  1042,  1009,   976,   943,   910,   877,   843,
+      810,   777,   743,   710,   676,   642,   608,   575,
+      541,   507,   473,   439,   405,   371,   337,   303,
+      269,   235,   201,   168,   134,   101,    67,    34,
+        0,   -34,   -67,  -101,  -134,  -168,  -201,  -235,
+     -269,  -303,  -337,  -371,  -405,  -439,  -473,  -507,
+     -541,  -575,  -608,  -642,  -676,  -710,  -743,  -777,
+     -810,  -843,  -877,  -910,  -943,  -976, -1009, -1042,
+    -1076, -1109, -1143, -1176, -1210, -1244, -1278, -1312,
+    -1346, -1381, -1415, -1449, -1483, -1516, -1550, -1582,
+    -1615, -1646, -1676, -1705, -1733, -1760, -1784, -1807,
+    -1829, -1848, -1864, -1879, -1891, -1900, -1907, -1911,
+    -1912, -1911, -1907, -1900, -1891, -1879, -1864, -1848,
+    -1829, -1807, -1784, -1760, -1733, -1705, -1676, -1646,
+    -1615, -1582, -1550, -1516, -1483, -1449, -1415, -1381,
+    -1346, -1312, -1278, -1244, -1210, -1176, -1143, -1109,
+    -1076, -1042, -1009,  -976,  -943,  -910,  -877,  -843,
+     -810,  -777,  -743,  -710,  -676,  -642,  -608,  -575,
+     -541,  -507,  -473,  -439,  -405,  -371,  -337,  -303,
+     -269,  -235,  -201,  -168,  -134,  -101,   -67,   -34,
+};
+
+// triangle, harmonics 1..4
+static const int16_t WaveTriangle3[WAVE_LEN] = {
+        0,    35,    70,   105,   140,   175,   210,   245,
+      280,   315,   351,   386,   422,   457,   493,   529,
+      565,   601,   637,   673,   710,   746,   782,   819,
+      855,   891,   927,   963,   999,  1035,  1070,  1105,
+     1140,  1174,  1208,  1242,  1275,  1307,  1339,  1371,
+     1401,  1431,  1460,  1488,  1515,  1542,  1567,  1591,
+     1614,  1636,  1657,  1677,  1695,  1712,  1727,  1742,
+     1754,  1766,  1776,  1784,  1791,  1796,  1800,  1803,
+     1803,  1803,  1800,  1796,  1791,  1784,  1776,  1766,
+     1754,  1742,  1727,  1712,  1695,  1677,  1657,  1636,
+     1614,  1591,  1567,  1542,  1515,  1488,  1460,  1431,
+     1401,  1371,  1339,  1307,  1275,  1242,  1208,  1174,
+     1140,  1105,  1070,  1035,   999,   963,   927,   891,
+      855,   819,   782,   746,   710,   673,   637,   601,
+      565,   529,   493,   457,   422,   386,   351,   315,
+      280,   245,   210,   175,   140,   105,    70,    35,
+        0,   -35,   -70,  -105,  -140,  -175,  -210,  -245,
+     -280,  -315,  -351,  -386,  -422,  -457,  -493,  -529,
+     -565,  -601,  -637,  -673,  -710,  -746,  -782,  -819,
+     -855,  -891,  -927,  -963,  -999, -1035, -1070, -1105,
+    -1140, -1174, -1208, -1242, -1275, -1307, -1339, -1371,
+    -1401, -1431, -1460, -1488, -1515, -1542, -1567, -1591,
+    -1614, -1636, -1657, -1677, -1695, -1712, -1727, -1742,
+    -1754, -1766, -1776, -1784, -1791, -1796, -1800, -1803,
+    -1803, -1803, -1800, -1796, -1791, -1784, -1776, -1766,
+    -1754, -1742, -1727, -1712, -1695, -1677, -1657, -1636,
+    -1614, -1591, -1567, -1542, -1515, -1488, -1460, -1431,
+    -1401, -1371, -1339, -1307, -1275, -1242, -1208, -1174,
+    -1140, -1105, -1070, -1035,  -999,  -963,  -927,  -891,
+     -855,  -819,  -782,  -746,  -710,  -673,  -637,  -601,
+     -565,  -529,  -493,  -457,  -422,  -386,  -351,  -315,
+     -280,  -245,  -210,  -175,  -140,  -105,   -70,   -35,
+};
+
+// triangle, harmonics 1..2
+static const int16_t WaveTriangle4[WAVE_LEN] = {
+        0,    42,    84,   126,   167,   209,   251,   292,
+      333,   374,   415,   455,   496,   536,   575,   615,
+      653,   692,   730,   768,   805,   842,   878,   914,
+      949,   983,  1017,  1051,  1083,  1115,  1147,  1178,
+     1208,  1237,  1265,  1293,  1320,  1346,  1372,  1396,
+     1420,  1443,  1465,  1486,  1506,  1525,  1544,  1561,
+     1578,  1593,  1608,  1621,  1634,  1646,  1656,  1666,
+     1675,  1683,  1689,  1695,  1699,  1703,  1706,  1707,
+     1708,  1707,  1706,  1703,  1699,  1695,  1689,  1683,
+     1675,  1666,  1656,  1646,  1634,  1621,  1608,  1593,
+     1578,  1561,  1544,  1525,  1506,  1486,  1465,  1443,
+     1420,  1396,  1372,  1346,  1320,  1293,  1265,  1237,
+     1208,  1178,  1147,  1115,  1083,  1051,  1017,   983,
+      949,   914,   878,   842,   805,   768,   730,   692,
+      653,   615,   575,   536,   496,   455,   415,   374,
+      333,   292,   251,   209,   167,   126,    84,    42,
+        0,   -42,   -84,  -126,  -167,  -209,  -251,  -292,
+     -333,  -374,  -415,  -455,  -496,  -536,  -575,  -615,
+     -653,  -692,  -730,  -768,  -805,  -842,  -878,  -914,
+     -949,  -983, -1017, -1051, -1083, -1115, -1147, -1178,
+    -1208, -1237, -1265, -1293, -1320, -1346, -1372, -1396,
+    -1420, -1443, -1465, -1486, -1506, -1525, -1544, -1561,
+    -1578, -1593, -1608, -1621, -1634, -1646, -1656, -1666,
+    -1675, -1683, -1689, -1695, -1699, -1703, -1706, -1707,
+    -1708, -1707, -1706, -1703, -1699, -1695, -1689, -1683,
+    -1675, -1666, -1656, -1646, -1634, -1621, -1608, -1593,
+    -1578, -1561, -1544, -1525, -1506, -1486, -1465, -1443,
+    -1420, -1396, -1372, -1346, -1320, -1293, -1265, -1237,
+    -1208, -1178, -1147, -1115, -1083, -1051, -1017,  -983,
+     -949,  -914,  -878,  -842,  -805,  -768,  -730,  -692,
+     -653,  -615,  -575,  -536,  -496,  -455,  -415,  -374,
+     -333,  -292,  -251,  -209,  -167,  -126,   -84,   -42,
+};
+
+// square, harmonics 1..32
+static const int16_t WaveSquare0[WAVE_LEN] = {
+        0,   479,   907,  1245,  1474,  1599,  1644,  1640,
+     1618,  1599,  1593,  1598,  1607,  1615,  1617,  1614,
+     1608,  1604,  1604,  1607,  1610,  1613,  1613,  1611,
+     1608,  1607,  1607,  1609,  1611,  1612,  1611,  1610,
+     1609,  1608,  1609,  1610,  1611,  1612,  1611,  1610,
+     1609,  1609,  1610,  1611,  1611,  1612,  1611,  1610,
+     1610,  1610,  1610,  1611,  1612,  1612,  1611,  1610,
+     1610,  1610,  1611,  1611,  1612,  1612,  1611,  1610,
+     1610,  1610,  1611,  1612,  1612,  1611,  1611,  1610,
+     1610,  1610,  1611,  1612,  1612,  1611,  1610,  1610,
+     1610,  1610,  1611,  1612,  1611,  1611,  1610,  1609,
+     1609,  1610,  1611,  1612,  1611,  1610,  1609,  1608,
+     1609,  1610,  1611,  1612,  1611,  1609,  1607,  1607,
+     1608,  1611,  1613,  1613,  1610,  1607,  1604,  1604,
+     1608,  1614,  1617,  1615,  1607,  1598,  1593,  1599,
+     1618,  1640,  1644,  1599,  1474,  1245,   907,   479,
+        0,  -479,  -907, -1245, -1474, -1599, -1644, -1640,
+    -1618, -1599, -1593, -1598, -1607, -1615, -1617, -1614,
+    -1608, -1604, -1604, -1607, -1610, -1613, -1613, -1611,
+    -1608, -1607, -1607, -1609, -1611, -1612, -1611, -1610,
+    -1609, -1608, -1609, -1610, -1611, -1612, -1611, -1610,
+    -1609, -1609, -1610, -1611, -1611, -1612, -1611, -1610,
+    -1610, -1610, -1610, -1611, -1612, -1612, -1611, -1610,
+    -1610, -1610, -1611, -1611, -1612, -1612, -1611, -1610,
+    -1610, -1610, -1611, -1612, -1612, -1611, -1611, -1610,
+    -1610, -1610, -1611, -1612, -1612, -1611, -1610, -1610,
+    -1610, -1610, -1611, -1612, -1611, -1611, -1610, -1609,
+    -1609, -1610, -1611, -1612, -1611, -1610, -1609, -1608,
+    -1609, -1610, -1611, -1612, -1611, -1609, -1607, -1607,
+    -1608, -1611, -1613, -1613, -1610, -1607, -1604, -1604,
+    -1608, -1614, -1617, -1615, -1607, -1598, -1593, -1599,
+    -1618, -1640, -1644, -1599, -1474, -1245,  -907,  -479,
+};
+
+// square, harmonics 1..16
+static const int16_t WaveSquare1[WAVE_LEN] = {
+        0,   250,   493,   722,   931,  1115,  1271,  1398,
+     1496,  1567,  1614,  1640,  1650,  1648,  1640,  1628,
+     1616,  1606,  1600,  1597,  1597,  1601,  1606,  1612,
+     1617,  1621,  1624,  1624,  1623,  1621,  1618,  1615,
+     1612,  1611,  1610,  1611,  1612,  1614,  1617,  1619,
+     1621,  1622,  1622,  1622,  1621,  1619,  1617,  1616,
+     1615,  1615,  1615,  1616,  1617,  1619,  1621,  1622,
+     1623,  1623,  1622,  1621,  1620,  1618,  1617,  1616,
+     1616,  1616,  1617,  1618,  1620,  1621,  1622,  1623,
+     1623,  1622,  1621,  1619,  1617,  1616,  1615,  1615,
+     1615,  1616,  1617,  1619,  1621,  1622,  1622,  1622,
+     1621,  1619,  1617,  1614,  1612,  1611,  1610,  1611,
+     1612,  1615,  1618,  1621,  1623,  1624,  1624,  1621,
+     1617,  1612,  1606,  1601,  1597,  1597,  1600,  1606,
+     1616,  1628,  1640,  1648,  1650,  1640,  1614,  1567,
+     1496,  1398,  1271,  1115,   931,   722,   493,   250,
+        0,  -250,  -493,  -722,  -931, -1115, -1271, -1398,
+    -1496, -1567, -1614, -1640, -1650, -1648, -1640, -1628,
+    -1616, -1606, -1600, -1597, -1597, -1601, -1606, -1612,
+    -1617, -1621, -1624, -1624, -1623, -1621, -1618, -1615,
+    -1612, -1611, -1610, -1611, -1612, -1614, -1617, -1619,
+    -1621, -1622, -1622, -1622, -1621, -1619, -1617, -1616,
+    -1615, -1615, -1615, -1616, -1617, -1619, -1621, -1622,
+    -1623, -1623, -1622, -1621, -1620, -1618, -1617, -1616,
+    -1616, -1616, -1617, -1618, -1620, -1621, -1622, -1623,
+    -1623, -1622, -1621, -1619, -1617, -1616, -1615, -1615,
+    -1615, -1616, -1617, -1619, -1621, -1622, -1622, -1622,
+    -1621, -1619, -1617, -1614, -1612, -1611, -1610, -1611,
+    -1612, -1615, -1618, -1621, -1623, -1624, -1624, -1621,
+    -1617, -1612, -1606, -1601, -1597, -1597, -1600, -1606,
+    -1616, -1628, -1640, -1648, -1650, -1640, -1614, -1567,
+    -1496, -1398, -1271, -1115,  -931,  -722,  -493,  -250,
+};
+
+// square, harmonics 1..8
+static const int16_t WaveSquare2[WAVE_LEN] = {
+        0,   133,   265,   395,   522,   645,   763,   875,
+      980,  1079,  1170,  1253,  1328,  1395,  1454,  1505,
+     1548,  1583,  1612,  1634,  1651,  1662,  1669,  1672,
+     1672,  1669,  1665,  1659,  1653,  1646,  1640,  1634,
+     1629,  1625,  1622,  1620,  1620,  1620,  1622,  1625,
+     1628,  1632,  1636,  1641,  1645,  1649,  1653,  1656,
+     1658,  1660,  1660,  1660,  1660,  1658,  1657,  1654,
+     1652,  1649,  1646,  1644,  1641,  1639,  1638,  1637,
+     1637,  1637,  1638,  1639,  1641,  1644,  1646,  1649,
+     1652,  1654,  1657,  1658,  1660,  1660,  1660,  1660,
+     1658,  1656,  1653,  1649,  1645,  1641,  1636,  1632,
+     1628,  1625,  1622,  1620,  1620,  1620,  1622,  1625,
+     1629,  1634,  1640,  1646,  1653,  1659,  1665,  1669,
+     1672,  1672,  1669,  1662,  1651,  1634,  1612,  1583,
+     1548,  1505,  1454,  1395,  1328,  1253,  1170,  1079,
+      980,   875,   763,   645,   522,   395,   265,   133,
+        0,  -133,  -265,  -395,  -522,  -645,  -763,  -875,
+     -980, -1079, -1170, -1253, -1328, -1395, -1454, -1505,
+    -1548, -1583, -1612, -1634, -1651, -1662, -1669, -1672,
+    -1672, -1669, -1665, -1659, -1653, -1646, -1640, -1634,
+    -1629, -1625, -1622, -1620, -1620, -1620, -1622, -1625,
+    -1628, -1632, -1636, -1641, -1645, -1649, -1653, -1656,
+    -1658, -1660, -1660, -1660, -1660, -1658, -1657, -1654,
+    -1652, -1649, -1646, -1644, -1641, -1639, -1638, -1637,
+    -1637, -1637, -1638, -1639, -1641, -1644, -1646, -1649,
+    -1652, -1654, -1657, -1658, -1660, -1660, -1660, -1660,
+    -1658, -1656, -1653, -1649, -1645, -1641, -1636, -1632,
+    -1628, -1625, -1622, -1620, -1620, -1620, -1622, -1625,
+    -1629, -1634, -1640, -1646, -1653, -1659, -1665, -1669,
+    -1672, -1672, -1669, -1662, -1651, -1634, -1612, -1583,
+    -1548, -1505, -1454, -1395, -1328, -1253, -1170, -1079,
+     -980,  -875,  -763,  -645,  -522,  -395,  -265,  -133,
+};
+
+// square, harmonics 1..4
+static const int16_t WaveSquare3[WAVE_LEN] = {
+        0,    76,   151,   226,   301,   374,   448,   520,
+      591,   660,   729,   795,   860,   924,   985,  1044,
+     1101,  1156,  1209,  1260,  1308,  1353,  1396,  1437,
+     1475,  1510,  1544,  1574,  1602,  1628,  1651,  1672,
+     1691,  1707,  1722,  1734,  1745,  1753,  1760,  1765,
+     1769,  1772,  1773,  1773,  1772,  1770,  1767,  1763,
+     1759,  1755,  1750,  1745,  1740,  1735,  1731,  1726,
+     1721,  1717,  1714,  1710,  1708,  1706,  1704,  1703,
+     1703,  1703,  1704,  1706,  1708,  1710,  1714,  1717,
+     1721,  1726,  1731,  1735,  1740,  1745,  1750,  1755,
+     1759,  1763,  1767,  1770,  1772,  1773,  1773,  1772,
+     1769,  1765,  1760,  1753,  1745,  1734,  1722,  1707,
+     1691,  1672,  1651,  1628,  1602,  1574,  1544,  1510,
+     1475,  1437,  1396,  1353,  1308,  1260,  1209,  1156,
+     1101,  1044,   985,   924,   860,   795,   729,   660,
+      591,   520,   448,   374,   301,   226,   151,    76,
+        0,   -76,  -151,  -226,  -301,  -374,  -448,  -520,
+     -591,  -660,  -729,  -795,  -860,  -924,  -985, -1044,
+    -1101, -1156, -1209, -1260, -1308, -1353, -1396, -1437,
+    -1475, -1510, -1544, -1574, -1602, -1628, -1651, -1672,
+    -1691, -1707, -1722, -1734, -1745, -1753, -1760, -1765,
+    -1769, -1772, -1773, -1773, -1772, -1770, -1767, -1763,
+    -1759, -1755, -1750, -1745, -1740, -1735, -1731, -1726,
+    -1721, -1717, -1714, -1710, -1708, -1706, -1704, -1703,
+    -1703, -1703, -1704, -1706, -1708, -1710, -1714, -1717,
+    -1721, -1726, -1731, -1735, -1740, -1745, -1750, -1755,
+    -1759, -1763, -1767, -1770, -1772, -1773, -1773, -1772,
+    -1769, -1765, -1760, -1753, -1745, -1734, -1722, -1707,
+    -1691, -1672, -1651, -1628, -1602, -1574, -1544, -1510,
+    -1475, -1437, -1396, -1353, -1308, -1260, -1209, -1156,
+    -1101, -1044,  -985,  -924,  -860,  -795,  -729,  -660,
+     -591,  -520,  -448,  -374,  -301,  -226,  -151,   -76,
+};
+
+// square, harmonics 1..2
+static const int16_t WaveSquare4[WAVE_LEN] = {
+        0,    50,   100,   151,   201,   251,   300,   350,
+      399,   449,   497,   546,   594,   642,   690,   737,
+      783,   830,   875,   920,   965,  1009,  1052,  1095,
+     1137,  1179,  1219,  1259,  1299,  1337,  1375,  1411,
+     1447,  1483,  1517,  1550,  1582,  1614,  1644,  1674,
+     1702,  1729,  1756,  1781,  1805,  1828,  1850,  1871,
+     1891,  1910,  1927,  1944,  1959,  1973,  1986,  1997,
+     2008,  2017,  2025,  2032,  2037,  2041,  2045,  2046,
+     2047,  2046,  2045,  2041,  2037,  2032,  2025,  2017,
+     2008,  1997,  1986,  1973,  1959,  1944,  1927,  1910,
+     1891,  1871,  1850,  1828,  1805,  1781,  1756,  1729,
+     1702,  1674,  1644,  1614,  1582,  1550,  1517,  1483,
+     1447,  1411,  1375,  1337,  1299,  1259,  1219,  1179,
+     1137,  1095,  1052,  1009,   965,   920,   875,   830,
+      783,   737,   690,   642,   594,   546,   497,   449,
+      399,   350,   300,   251,   201,   151,   100,    50,
+        0,   -50,  -100,  -151,  -201,  -251,  -300,  -350,
+     -399,  -449,  -497,  -546,  -594,  -642,  -690,  -737,
+     -783,  -830,  -875,  -920,  -965, -1009, -1052, -1095,
+    -1137, -1179, -1219, -1259, -1299, -1337, -1375, -1411,
+    -1447, -1483, -1517, -1550, -1582, -1614, -1644, -1674,
+    -1702, -1729, -1756, -1781, -1805, -1828, -1850, -1871,
+    -1891, -1910, -1927, -1944, -1959, -1973, -1986, -1997,
+    -2008, -2017, -2025, -2032, -2037, -2041, -2045, -2046,
+    -2047, -2046, -2045, -2041, -2037, -2032, -2025, -2017,
+    -2008, -1997, -1986, -1973, -1959, -1944, -1927, -1910,
+    -1891, -1871, -1850, -1828, -1805, -1781, -1756, -1729,
+    -1702, -1674, -1644, -1614, -1582, -1550, -1517, -1483,
+    -1447, -1411, -1375, -1337, -1299, -1259, -1219, -1179,
+    -1137, -1095, -1052, -1009,  -965,  -920,  -875,  -830,
+     -783,  -737,  -690,  -642,  -594,  -546,  -497,  -449,
+     -399,  -350,  -300,  -251,  -201,  -151,  -100,   -50,
+};
+
+// sawtooth, harmonics 1..32
+static const int16_t WaveSaw0[WAVE_LEN] = {
+        0,    16,    33,    49,    66,    82,    99,   115,
+      131,   148,   164,   181,   197,   214,   230,   247,
+      263,   279,   296,   312,   329,   346,   362,   378,
+      394,   411,   427,   444,   461,   477,   493,   510,
+      526,   542,   559,   575,   592,   609,   625,   641,
+      657,   673,   690,   707,   724,   740,   756,   772,
+      788,   805,   821,   838,   855,   871,   887,   903,
+      920,   936,   953,   970,   986,  1002,  1018,  1034,
+     1051,  1067,  1084,  1101,  1117,  1134,  1149,  1165,
+     1182,  1198,  1215,  1232,  1249,  1265,  1280,  1296,
+     1313,  1330,  1347,  1364,  1380,  1395,  1411,  1427,
+     1443,  1461,  1478,  1495,  1511,  1526,  1541,  1557,
+     1574,  1592,  1610,  1627,  1642,  1656,  1671,  1687,
+     1705,  1724,  1743,  1759,  1773,  1785,  1798,  1815,
+     1836,  1859,  1880,  1894,  1901,  1905,  1915,  1940,
+     1981,  2026,  2047,  2005,  1858,  1576,  1152,   610,
+        0,  -610, -1152, -1576, -1858, -2005, -2047, -2026,
+    -1981, -1940, -1915, -1905, -1901, -1894, -1880, -1859,
+    -1836, -1815, -1798, -1785, -1773, -1759, -1743, -1724,
+    -1705, -1687, -1671, -1656, -1642, -1627, -1610, -1592,
+    -1574, -1557, -1541, -1526, -1511, -1495, -1478, -1461,
+    -1443, -1427, -1411, -1395, -1380, -1364, -1347, -1330,
+    -1313, -1296, -1280, -1265, -1249, -1232, -1215, -1198,
+    -1182, -1165, -1149, -1134, -1117, -1101, -1084, -1067,
+    -1051, -1034, -1018, -1002,  -986,  -970,  -953,  -936,
+     -920,  -903,  -887,  -871,  -855,  -838,  -821,  -805,
+     -788,  -772,  -756,  -740,  -724,  -707,  -690,  -673,
+     -657,  -641,  -625,  -609,  -592,  -575,  -559,  -542,
+     -526,  -510,  -493,  -477,  -461,  -444,  -427,  -411,
+     -394,  -378,  -362,  -346,  -329,  -312,  -296,  -279,
+     -263,  -247,  -230,  -214,  -197,  -181,  -164,  -148,
+     -131,  -115,   -99,   -82,   -66,   -49,   -33,   -16,
+};
+
+// sawtooth, harmonics 1..16
+static const int16_t WaveSaw1[WAVE_LEN] = {
+        0,    16,    32,    49,    65,    82,    99,   116,
+      133,   150,   167,   184,   200,   216,   233,   249,
+      265,   281,   297,   314,   330,   347,   364,   381,
+      398,   415,   432,   449,   465,   481,   497,   513,
+      529,   545,   562,   578,   595,   612,   629,   646,
+      663,   680,   697,   713,   729,   745,   760,   776,
+      792,   809,   825,   842,   859,   877,   894,   911,
+      927,   944,   960,   976,   991,  1007,  1022,  1038,
+     1055,  1071,  1088,  1106,  1123,  1140,  1157,  1174,
+     1191,  1206,  1222,  1237,  1252,  1267,  1283,  1299,
+     1315,  1333,  1351,  1369,  1387,  1404,  1421,  1437,
+     1453,  1467,  1481,  1495,  1509,  1524,  1540,  1557,
+     1575,  1595,  1615,  1635,  1654,  1671,  1687,  1701,
+     1712,  1722,  1732,  1742,  1754,  1770,  1791,  1816,
+     1845,  1877,  1908,  1935,  1953,  1957,  1939,  1896,
+     1820,  1709,  1560,  1373,  1150,   894,   612,   311,
+        0,  -311,  -612,  -894, -1150, -1373, -1560, -1709,
+    -1820, -1896, -1939, -1957, -1953, -1935, -1908, -1877,
+    -1845, -1816, -1791, -1770, -1754, -1742, -1732, -1722,
+    -1712, -1701, -1687, -1671, -1654, -1635, -1615, -1595,
+    -1575, -1557, -1540, -1524, -1509, -1495, -1481, -1467,
+    -1453, -1437, -1421, -1404, -1387, -1369, -1351, -1333,
+    -1315, -1299, -1283, -1267, -1252, -1237, -1222, -1206,
+    -1191, -1174, -1157, -1140, -1123, -1106, -1088, -1071,
+    -1055, -1038, -1022, -1007,  -991,  -976,  -960,  -944,
+     -927,  -911,  -894,  -877,  -859,  -842,  -825,  -809,
+     -792,  -776,  -760,  -745,  -729,  -713,  -697,  -680,
+     -663,  -646,  -629,  -612,  -595,  -578,  -562,  -545,
+     -529,  -513,  -497,  -481,  -465,  -449,  -432,  -415,
+     -398,  -381,  -364,  -347,  -330,  -314,  -297,  -281,
+     -265,  -249,  -233,  -216,  -200,  -184,  -167,  -150,
+     -133,  -116,   -99,   -82,   -65,   -49,   -32,   -16,
+};
+
+// sawtooth, harmonics 1..8
+static const int16_t WaveSaw2[WAVE_LEN] = {
+        0,    16,    32,    49,    65,    82,    98,   115,
+      132,   150,   167,   185,   203,   221,   239,   257,
+      274,   292,   310,   327,   345,   362,   379,   396,
+      412,   428,   444,   460,   476,   492,   508,   524,
+      540,   556,   573,   589,   606,   623,   641,   658,
+      676,   694,   712,   730,   747,   765,   783,   800,
+      818,   835,   851,   867,   883,   899,   914,   930,
+      945,   960,   975,   990,  1005,  1020,  1036,  1052,
+     1068,  1085,  1102,  1120,  1138,  1156,  1174,  1193,
+     1211,  1230,  1248,  1266,  1283,  1300,  1316,  1332,
+     1346,  1361,  1374,  1387,  1400,  1412,  1424,  1437,
+     1450,  1463,  1477,  1492,  1508,  1526,  1544,  1564,
+     1586,  1609,  1632,  1656,  1681,  1705,  1729,  1750,
+     1770,  1787,  1800,  1808,  1810,  1806,  1794,  1774,
+     1746,  1707,  1659,  1600,  1531,  1451,  1360,  1259,
+     1147,  1027,   897,   760,   617,   467,   314,   158,
+        0,  -158,  -314,  -467,  -617,  -760,  -897, -1027,
+    -1147, -1259, -1360, -1451, -1531, -1600, -1659, -1707,
+    -1746, -1774, -1794, -1806, -1810, -1808, -1800, -1787,
+    -1770, -1750, -1729, -1705, -1681, -1656, -1632, -1609,
+    -1586, -1564, -1544, -1526, -1508, -1492, -1477, -1463,
+    -1450, -1437, -1424, -1412, -1400, -1387, -1374, -1361,
+    -1346, -1332, -1316, -1300, -1283, -1266, -1248, -1230,
+    -1211, -1193, -1174, -1156, -1138, -1120, -1102, -1085,
+    -1068, -1052, -1036, -1020, -1005,  -990,  -975,  -960,
+     -945,  -930,  -914,  -899,  -883,  -867,  -851,  -835,
+     -818,  -800,  -783,  -765,  -747,  -730,  -712,  -694,
+     -676,  -658,  -641,  -623,  -606,  -589,  -573,  -556,
+     -540,  -524,  -508,  -492,  -476,  -460,  -444,  -428,
+     -412,  -396,  -379,  -362,  -345,  -327,  -310,  -292,
+     -274,  -257,  -239,  -221,  -203,  -185,  -167,  -150,
+     -132,  -115,   -98,   -82,   -65,   -49,   -32,   -16,
+};
+
+// sawtooth, harmonics 1..4
+static const int16_t WaveSaw3[WAVE_LEN] = {
+        0,    17,    34,    51,    68,    85,   102,   119,
+      137,   154,   172,   190,   208,   227,   245,   264,
+      283,   302,   322,   341,   361,   381,   400,   420,
+      440,   460,   480,   500,   520,   540,   559,   579,
+      598,   617,   636,   654,   673,   691,   708,   726,
+      743,   760,   776,   792,   808,   824,   839,   854,
+      869,   884,   898,   913,   927,   942,   956,   971,
+      985,  1000,  1015,  1030,  1046,  1062,  1078,  1094,
+     1111,  1129,  1146,  1165,  1183,  1202,  1222,  1242,
+     1262,  1282,  1303,  1324,  1345,  1366,  1386,  1407,
+     1428,  1448,  1467,  1486,  1504,  1522,  1538,  1553,
+     1566,  1579,  1589,  1598,  1605,  1609,  1612,  1612,
+     1609,  1604,  1596,  1585,  1571,  1555,  1535,  1511,
+     1485,  1455,  1422,  1386,  1346,  1303,  1257,  1207,
+     1154,  1099,  1040,   979,   915,   848,   779,   707,
+      634,   559,   482,   404,   325,   244,   163,    82,
+        0,   -82,  -163,  -244,  -325,  -404,  -482,  -559,
+     -634,  -707,  -779,  -848,  -915,  -979, -1040, -1099,
+    -1154, -1207, -1257, -1303, -1346, -1386, -1422, -1455,
+    -1485, -1511, -1535, -1555, -1571, -1585, -1596, -1604,
+    -1609, -1612, -1612, -1609, -1605, -1598, -1589, -1579,
+    -1566, -1553, -1538, -1522, -1504, -1486, -1467, -1448,
+    -1428, -1407, -1386, -1366, -1345, -1324, -1303, -1282,
+    -1262, -1242, -1222, -1202, -1183, -1165, -1146, -1129,
+    -1111, -1094, -1078, -1062, -1046, -1030, -1015, -1000,
+     -985,  -971,  -956,  -942,  -927,  -913,  -898,  -884,
+     -869,  -854,  -839,  -824,  -808,  -792,  -776,  -760,
+     -743,  -726,  -708,  -691,  -673,  -654,  -636,  -617,
+     -598,  -579,  -559,  -540,  -520,  -500,  -480,  -460,
+     -440,  -420,  -400,  -381,  -361,  -341,  -322,  -302,
+     -283,  -264,  -245,  -227,  -208,  -190,  -172,  -154,
+     -137,  -119,  -102,   -85,   -68,   -51,   -34,   -17,
+};
+
+// sawtooth, harmonics 1..2
+static const int16_t WaveSaw4[WAVE_LEN] = {
+        0,    19,    38,    58,    77,    96,   116,   135,
+      155,   175,   194,   214,   234,   255,   275,   295,
+      316,   337,   358,   379,   400,   422,   443,   465,
+      487,   509,   532,   554,   577,   599,   622,   645,
+      668,   692,   715,   738,   762,   785,   809,   832,
+      856,   879,   902,   925,   949,   971,   994,  1017,
+     1039,  1061,  1083,  1104,  1125,  1146,  1166,  1185,
+     1205,  1223,  1241,  1259,  1276,  1292,  1307,  1322,
+     1336,  1349,  1361,  1373,  1383,  1393,  1402,  1409,
+     1416,  1422,  1426,  1430,  1432,  1433,  1433,  1432,
+     1430,  1426,  1421,  1415,  1408,  1399,  1389,  1378,
+     1366,  1352,  1337,  1321,  1304,  1285,  1265,  1243,
+     1221,  1197,  1172,  1146,  1118,  1090,  1060,  1029,
+      997,   964,   930,   895,   859,   823,   785,   746,
+      707,   666,   625,   584,   541,   498,   455,   411,
+      366,   321,   276,   231,   185,   139,    93,    46,
+        0,   -46,   -93,  -139,  -185,  -231,  -276,  -321,
+     -366,  -411,  -455,  -498,  -541,  -584,  -625,  -666,
+     -707,  -746,  -785,  -823,  -859,  -895,  -930,  -964,
+     -997, -1029, -1060, -1090, -1118, -1146, -1172, -1197,
+    -1221, -1243, -1265, -1285, -1304, -1321, -1337, -1352,
+    -1366, -1378, -1389, -1399, -1408, -1415, -1421, -1426,
+    -1430, -1432, -1433, -1433, -1432, -1430, -1426, -1422,
+    -1416, -1409, -1402, -1393, -1383, -1373, -1361, -1349,
+    -1336, -1322, -1307, -1292, -1276, -1259, -1241, -1223,
+    -1205, -1185, -1166, -1146, -1125, -1104, -1083, -1061,
+    -1039, -1017,  -994,  -971,  -949,  -925,  -902,  -879,
+     -856,  -832,  -809,  -785,  -762,  -738,  -715,  -692,
+     -668,  -645,  -622,  -599,  -577,  -554,  -532,  -509,
+     -487,  -465,  -443,  -422,  -400,  -379,  -358,  -337,
+     -316,  -295,  -275,  -255,  -234,  -214,  -194,  -175,
+     -155,  -135,  -116,   -96,   -77,   -58,   -38,   -19,
+};
+
+// sawtooth, harmonics 1..1
+static const int16_t WaveSaw5[WAVE_LEN] = {
+        0,    33,    66,    98,   131,   164,   196,   228,
+      261,   293,   325,   356,   388,   419,   450,   481,
+      511,   541,   571,   601,   630,   658,   687,   715,
+      742,   769,   796,   822,   848,   873,   897,   921,
+      945,   968,   990,  1012,  1033,  1053,  1073,  1092,
+     1111,  1129,  1146,  1162,  1178,  1193,  1208,  1221,
+     1234,  1246,  1258,  1269,  1278,  1288,  1296,  1303,
+     1310,  1316,  1321,  1326,  1330,  1332,  1334,  1336,
+     1336,  1336,  1334,  1332,  1330,  1326,  1321,  1316,
+     1310,  1303,  1296,  1288,  1278,  1269,  1258,  1246,
+     1234,  1221,  1208,  1193,  1178,  1162,  1146,  1129,
+     1111,  1092,  1073,  1053,  1033,  1012,   990,   968,
+      945,   921,   897,   873,   848,   822,   796,   769,
+      742,   715,   687,   658,   630,   601,   571,   541,
+      511,   481,   450,   419,   388,   356,   325,   293,
+      261,   228,   196,   164,   131,    98,    66,    33,
+        0,   -33,   -66,   -98,  -131,  -164,  -196,  -228,
+     -261,  -293,  -325,  -356,  -388,  -419,  -450,  -481,
+     -511,  -541,  -571,  -601,  -630,  -658,  -687,  -715,
+     -742,  -769,  -796,  -822,  -848,  -873,  -897,  -921,
+     -945,  -968,  -990, -1012, -1033, -1053, -1073, -1092,
+    -1111, -1129, -1146, -1162, -1178, -1193, -1208, -1221,
+    -1234, -1246, -1258, -1269, -1278, -1288, -1296, -1303,
+    -1310, -1316, -1321, -1326, -1330, -1332, -1334, -1336,
+    -1336, -1336, -1334, -1332, -1330, -1326, -1321, -1316,
+    -1310, -1303, -1296, -1288, -1278, -1269, -1258, -1246,
+    -1234, -1221, -1208, -1193, -1178, -1162, -1146, -1129,
+    -1111, -1092, -1073, -1053, -1033, -1012,  -990,  -968,
+     -945,  -921,  -897,  -873,  -848,  -822,  -796,  -769,
+     -742,  -715,  -687,  -658,  -630,  -601,  -571,  -541,
+     -511,  -481,  -450,  -419,  -388,  -356,  -325,  -293,
+     -261,  -228,  -196,  -164,  -131,   -98,   -66,   -33,
+};
+
+const int16_t * const Wavetable[WAVE_COUNT][WAVE_LEVELS] = {
+    { WaveSine0, WaveSine0, WaveSine0, WaveSine0, WaveSine0, WaveSine0 },
+    { WaveTriangle0, WaveTriangle1, WaveTriangle2, WaveTriangle3, WaveTriangle4, WaveTriangle4 },
+    { WaveSquare0, WaveSquare1, WaveSquare2, WaveSquare3, WaveSquare4, WaveSquare4 },
+    { WaveSaw0, WaveSaw1, WaveSaw2, WaveSaw3, WaveSaw4, WaveSaw5 },
+};
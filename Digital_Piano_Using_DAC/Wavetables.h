@@ -0,0 +1,53 @@
+#ifndef __WAVETABLES_H__
+#define __WAVETABLES_H__
+
+#include <stdint.h>
+
+/*
+ * Single-cycle wavetables for Synth.c, all in flash.
+ *
+ * WAVE_LEN entries of signed 12-bit samples (-2047..2047). Every table
+ * starts at 0, so a new voice (phase 0) starts silently.
+ *
+ * Each wave has WAVE_LEVELS band-limited tables, one per octave of phase
+ * increment. Level l keeps harmonics 1..32 >> l. Wave_Level() picks the
+ * level for an increment so that the top harmonic stays below half the
+ * sample rate (an increment of 2^31), whatever the sample rate is:
+ *
+ *   inc < 2^26           level 0, 32 harmonics
+ *   2^(25+l) .. 2^(26+l) level l, 32 >> l harmonics (l = 1..5)
+ *
+ * Synth.c picks the level when a note starts or is retuned, not per
+ * sample. Tuning.c never returns an increment of 2^31 or more.
+ *
+ * Wavetables.c is generated by tools/gen_wavetables.py.
+ */
+
+#define WAVE_BITS      8u
+#define WAVE_LEN       (1u << WAVE_BITS)
+
+#define WAVE_SINE      0u
+#define WAVE_TRIANGLE  1u
+#define WAVE_SQUARE    2u
+#define WAVE_SAW       3u
+#define WAVE_COUNT     4u
+
+#define WAVE_LEVELS    6u
+#define WAVE_LEVEL0_BITS 26u   // increments below 2^26 use level 0
+
+extern const int16_t * const Wavetable[WAVE_COUNT][WAVE_LEVELS];
+
+/* Mip level for a phase increment (0 = most harmonics) */
+static inline uint8_t Wave_Level(uint32_t phaseInc)
+{
+    uint8_t level = 0;
+    phaseInc >>= WAVE_LEVEL0_BITS;
+    while (phaseInc != 0u && level < WAVE_LEVELS - 1u)
+    {
+        phaseInc >>= 1;
+        level++;
+    }
+    return level;
+}
+
+#endif /* __WAVETABLES_H__ */
@@ -20,19 +20,49 @@
 #include "main.h"
 #include "DAC.h"     
 #include "Piano.h"   
+#include "KeyMatrix.h"
+#include "MidiIn.h"
+#include "Stream.h"
+#include "Songs.h"
 #include "Sound.h" 
+#include "Telemetry.h"
+
+// USART1 receives MIDI or the stream, so telemetry stays on USART2 (PA2)
+#if TELEMETRY_PORT != TELEMETRY_PORT_USART2_PA2
+#error "USART1 is the MIDI/stream input: build with TELEMETRY_PORT_USART2_PA2 (the default)"
+#endif
 
 /* Private variables ---------------------------------------------------------*/
 TIM_HandleTypeDef htim3;
+TIM_HandleTypeDef htim14;
 
 /* USER CODE BEGIN PV */
-
+// Telemetry on PA2 (../Common/Telemetry.h): a TLM_KEY frame per key
+// change, and the audio load and MIDI or stream counters once a second
+#define TLM_BAUD         115200u
+#define TLM_BUTTONS      0u       // TLM_KEY source: key = Piano key bit
+#define TLM_MATRIX       1u       // TLM_KEY source: key = matrix key 0..31
+#define TLM_COUNTER_MS   1000u
+#define TLM_C_LOAD_MAX   16u      // TLM_COUNTER ids, from Sound_GetLoad()
+#define TLM_C_OVERRUNS   17u
+#if SOUND_STREAM
+#define TLM_C_FRAMES     1u       // TLM_COUNTER ids, from Stream_GetStats()
+#define TLM_C_CRC        2u
+#define TLM_C_LOST       3u
+#define TLM_C_UART       4u
+#define TLM_C_UNDERRUNS  5u
+#else
+#define TLM_C_MESSAGES   1u       // from MidiIn_Messages() / MidiIn_Errors()
+#define TLM_C_ERRORS     2u
+#endif
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
 void SystemClock_Config(void);
 static void MX_GPIO_Init(void);
+static void MX_DMA_Init(void);
 static void MX_TIM3_Init(void);
+static void MX_TIM14_Init(void);
 
 /* Private user code ---------------------------------------------------------*/
 /**
@@ -54,54 +84,138 @@ int main(void)
   SystemClock_Config();
   /* Initialize all configured peripherals */
   MX_GPIO_Init();
+  MX_DMA_Init();
   MX_TIM3_Init();
+  MX_TIM14_Init();
 
   /* USER CODE BEGIN 2 */
-    Piano_Init(); 
-    Sound_Init();          // initializes DAC + stops timer
- uint8_t key = 0;
-uint8_t note = NOTE_OFF;
-uint8_t lastNote = NOTE_OFF;
+    Piano_Init();
+    KeyMatrix_Init();      // starts the TIM14 row scan
+#if SOUND_STREAM
+    Stream_Init();         // USART1 RX on PA10, PCM/ADPCM frames
+#else
+    MidiIn_Init();         // USART1 RX on PA10, 31250 baud
+#endif
+    // After MidiIn/Stream: their RX channel 5 shares DMA1_Channel4_5_IRQn
+    // with telemetry's channel 4, and the last init sets its priority.
+    // Telemetry wants the lowest; the RX interrupt only wakes the main loop.
+    Telemetry_Init(TLM_APP_PIANO, TLM_BAUD);
+    Sound_Init();          // initializes DAC + starts the sample timer
+
+    // Button 1 held at reset: play the demo song
+    if (Piano_Keys() & 1u)
+    {
+        Sound_PlaySequence(Song_Demo);
+    }
+
+    // Note played by each key (bit k of the Piano key mask)
+    static const uint8_t keyNote[PIANO_KEYS] = { NOTE_LOW, NOTE_MED, NOTE_HIGH };
+    uint8_t held = 0;      // keys currently sounding
+    uint32_t matrixHeld = 0;
+    PianoEvent ev;
+    KeyMatrixEvent mev;
+    uint32_t tlmNext = HAL_GetTick() + TLM_COUNTER_MS;
   /* USER CODE END 2 */
 
   /* Infinite loop */
   /* USER CODE BEGIN WHILE */
- while (1)
-{
-    /* USER CODE BEGIN WHILE */
-
-    // Read which key is pressed: 0,1,2,3
-    key = Piano_In();
+  while (1)
+  {
+    // Key events come from the EXTI/SysTick interrupts (Piano.c).
+    // Compare the full key mask, so chords work and a dropped event
+    // cannot leave a note stuck.
+    while (Piano_GetEvent(&ev))
+    {
+        uint8_t diff = (uint8_t)(ev.keys ^ held);
+
+        for (uint8_t k = 0; k < PIANO_KEYS; k++)
+        {
+            if ((diff & (1u << k)) == 0u)
+            {
+                continue;
+            }
+            Telemetry_Key(TLM_BUTTONS, k, (ev.keys >> k) & 1u, ev.keys);
+            if (ev.keys & (1u << k))
+            {
+                Sound_NoteOnAt(SOUND_SRC_KEYS, keyNote[k], ev.time);
+            }
+            else
+            {
+                Sound_NoteOff(SOUND_SRC_KEYS, keyNote[k]);
+            }
+        }
+        held = ev.keys;
+    }
 
-    // Map key -> logical note
-    switch (key)
+    // Matrix keyboard: key k plays KEYMATRIX_BASE_NOTE + k
+    while (KeyMatrix_GetEvent(&mev))
     {
-        case 1:
-            note = NOTE_LOW;    // e.g., C4
-            break;
-        case 2:
-            note = NOTE_MED;    // e.g., E4
-            break;
-        case 3:
-            note = NOTE_HIGH;   // e.g., G4
-            break;
-        default:
-            note = NOTE_OFF;    // no key pressed
-            break;
+        uint32_t diff = mev.keys ^ matrixHeld;
+
+        for (uint8_t k = 0; diff != 0u; k++, diff >>= 1)
+        {
+            if ((diff & 1u) == 0u)
+            {
+                continue;
+            }
+            Telemetry_Key(TLM_MATRIX, k, (uint8_t)((mev.keys >> k) & 1u), mev.keys);
+            if (mev.keys & (1uL << k))
+            {
+                Sound_NoteOnAt(SOUND_SRC_MATRIX, (uint8_t)(KEYMATRIX_BASE_NOTE + k), mev.time);
+            }
+            else
+            {
+                Sound_NoteOff(SOUND_SRC_MATRIX, (uint8_t)(KEYMATRIX_BASE_NOTE + k));
+            }
+        }
+        matrixHeld = mev.keys;
     }
 
-    // Only change sound if note changed
-    if (note != lastNote)
+#if SOUND_STREAM
+    // Streamed audio (USART1) into the jitter buffer
+    Stream_Poll();
+#else
+    // External MIDI controller (USART1)
+    MidiIn_Poll();
+#endif
+
+    if ((int32_t)(HAL_GetTick() - tlmNext) >= 0)
     {
-        Sound_Play(note);
-        lastNote = note;
+        tlmNext += TLM_COUNTER_MS;
+        SoundLoad ld;
+        Sound_GetLoad(&ld);
+        Telemetry_Counter(TLM_C_LOAD_MAX, ld.maxCycles);
+        Telemetry_Counter(TLM_C_OVERRUNS, ld.overruns);
+#if SOUND_STREAM
+        StreamStats st;
+        Stream_GetStats(&st);
+        Telemetry_Counter(TLM_C_FRAMES, st.frames);
+        Telemetry_Counter(TLM_C_CRC, st.crcErrors);
+        Telemetry_Counter(TLM_C_LOST, st.lostFrames);
+        Telemetry_Counter(TLM_C_UART, st.uartErrors);
+        Telemetry_Counter(TLM_C_UNDERRUNS, st.jitter.underruns);
+#else
+        Telemetry_Counter(TLM_C_MESSAGES, MidiIn_Messages());
+        Telemetry_Counter(TLM_C_ERRORS, MidiIn_Errors());
+#endif
     }
 
-    HAL_Delay(10);   // small delay for debouncing
+    // Sleep until the next interrupt. With PRIMASK set, an event that
+    // arrives after the check still wakes the WFI.
+    __disable_irq();
+#if SOUND_STREAM
+    if (!Piano_HasEvent() && !KeyMatrix_HasEvent() && !Stream_Pending())
+#else
+    if (!Piano_HasEvent() && !KeyMatrix_HasEvent() && !MidiIn_Pending())
+#endif
+    {
+        __WFI();
+    }
+    __enable_irq();
     /* USER CODE END WHILE */
 
     /* USER CODE BEGIN 3 */
-}
+  }
   /* USER CODE END 3 */
 }
 
@@ -159,9 +273,9 @@ static void MX_TIM3_Init(void)
 
   /* USER CODE END TIM3_Init 1 */
   htim3.Instance = TIM3;
-  htim3.Init.Prescaler = 48;
+  htim3.Init.Prescaler = 0;
   htim3.Init.CounterMode = TIM_COUNTERMODE_UP;
-  htim3.Init.Period = 1000;
+  htim3.Init.Period = 999;
   htim3.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
   htim3.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
   if (HAL_TIM_Base_Init(&htim3) != HAL_OK)
@@ -180,11 +294,60 @@ static void MX_TIM3_Init(void)
     Error_Handler();
   }
   /* USER CODE BEGIN TIM3_Init 2 */
-
+  /* DMA1 Channel 3 is set up by the audio backend (AudioOut_*.c) */
   /* USER CODE END TIM3_Init 2 */
 
 }
 
+/**
+  * @brief TIM14 Initialization Function
+  * @param None
+  * @retval None
+  */
+static void MX_TIM14_Init(void)
+{
+
+  /* USER CODE BEGIN TIM14_Init 0 */
+
+  /* USER CODE END TIM14_Init 0 */
+
+  /* USER CODE BEGIN TIM14_Init 1 */
+  /* 8 MHz / 8 = 1 MHz, / 250 = 4 kHz row rate (KEYMATRIX_ROW_RATE) */
+  /* USER CODE END TIM14_Init 1 */
+  htim14.Instance = TIM14;
+  htim14.Init.Prescaler = 7;
+  htim14.Init.CounterMode = TIM_COUNTERMODE_UP;
+  htim14.Init.Period = 249;
+  htim14.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+  htim14.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+  if (HAL_TIM_Base_Init(&htim14) != HAL_OK)
+  {
+    Error_Handler();
+  }
+  /* USER CODE BEGIN TIM14_Init 2 */
+  /* Below the audio DMA; the handler is KeyMatrix_IRQHandler() */
+  HAL_NVIC_SetPriority(TIM14_IRQn, TICK_INT_PRIORITY, 0);
+  HAL_NVIC_EnableIRQ(TIM14_IRQn);
+  /* USER CODE END TIM14_Init 2 */
+
+}
+
+/**
+  * Enable DMA controller clock
+  */
+static void MX_DMA_Init(void)
+{
+
+  /* DMA controller clock enable */
+  __HAL_RCC_DMA1_CLK_ENABLE();
+
+  /* DMA interrupt init */
+  /* DMA1_Channel2_3_IRQn interrupt configuration */
+  HAL_NVIC_SetPriority(DMA1_Channel2_3_IRQn, 0, 0);
+  HAL_NVIC_EnableIRQ(DMA1_Channel2_3_IRQn);
+
+}
+
 /**
   * @brief GPIO Initialization Function
   * @param None
@@ -204,6 +367,10 @@ static void MX_GPIO_Init(void)
   /*Configure GPIO pin Output Level */
   HAL_GPIO_WritePin(GPIOC, GPIO_PIN_0|GPIO_PIN_1|GPIO_PIN_2|GPIO_PIN_3, GPIO_PIN_RESET);
 
+  /*Configure GPIO pin Output Level */
+  HAL_GPIO_WritePin(GPIOB, GPIO_PIN_8|GPIO_PIN_9|GPIO_PIN_10|GPIO_PIN_11
+                          |GPIO_PIN_12|GPIO_PIN_13|GPIO_PIN_14|GPIO_PIN_15, GPIO_PIN_SET);
+
   /*Configure GPIO pins : PC0 PC1 PC2 PC3 */
   GPIO_InitStruct.Pin = GPIO_PIN_0|GPIO_PIN_1|GPIO_PIN_2|GPIO_PIN_3;
   GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
@@ -213,10 +380,33 @@ static void MX_GPIO_Init(void)
 
   /*Configure GPIO pins : PB0 PB1 PB2 */
   GPIO_InitStruct.Pin = GPIO_PIN_0|GPIO_PIN_1|GPIO_PIN_2;
-  GPIO_InitStruct.Mode = GPIO_MODE_INPUT;
+  GPIO_InitStruct.Mode = GPIO_MODE_IT_RISING_FALLING;
   GPIO_InitStruct.Pull = GPIO_PULLUP;
   HAL_GPIO_Init(GPIOB, &GPIO_InitStruct);
 
+  /*Configure GPIO pins : PB8 PB9 PB10 PB11
+                           PB12 PB13 PB14 PB15 */
+  GPIO_InitStruct.Pin = GPIO_PIN_8|GPIO_PIN_9|GPIO_PIN_10|GPIO_PIN_11
+                          |GPIO_PIN_12|GPIO_PIN_13|GPIO_PIN_14|GPIO_PIN_15;
+  GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_OD;
+  GPIO_InitStruct.Pull = GPIO_NOPULL;
+  GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
+  HAL_GPIO_Init(GPIOB, &GPIO_InitStruct);
+
+  /*Configure GPIO pins : PC4 PC5 PC6 PC7 */
+  GPIO_InitStruct.Pin = GPIO_PIN_4|GPIO_PIN_5|GPIO_PIN_6|GPIO_PIN_7;
+  GPIO_InitStruct.Mode = GPIO_MODE_INPUT;
+  GPIO_InitStruct.Pull = GPIO_PULLUP;
+  HAL_GPIO_Init(GPIOC, &GPIO_InitStruct);
+
+  /* EXTI interrupt init*/
+  /* Same priority as SysTick: Piano.c queues events from both */
+  HAL_NVIC_SetPriority(EXTI0_1_IRQn, TICK_INT_PRIORITY, 0);
+  HAL_NVIC_EnableIRQ(EXTI0_1_IRQn);
+
+  HAL_NVIC_SetPriority(EXTI2_3_IRQn, TICK_INT_PRIORITY, 0);
+  HAL_NVIC_EnableIRQ(EXTI2_3_IRQn);
+
   /* USER CODE BEGIN MX_GPIO_Init_2 */
 
   /* USER CODE END MX_GPIO_Init_2 */
@@ -0,0 +1,146 @@
+/*
+ * Measure an output backend offline: C4 is held on the sine wave through
+ * the firmware's own Synth.c, built for that backend, and the sample
+ * stream the backend would play is analysed with a windowed FFT:
+ *   - ladder: AudioOut_Pack(), the top 4 bits (SOUND_BACKEND_LADDER)
+ *   - DAC1:   the 12-bit sample as written to DHR12R1
+ * SNR counts all energy that is not the fundamental (or DC) as noise;
+ * THD is harmonics 2.. over the fundamental, in amplitude.
+ *
+ * Build from the project folder, once per backend:
+ *   gcc -O2 -Wall -Wextra -I. -o backend_snr tools/backend_snr.c \
+ *       Synth.c Tuning.c Wavetables.c -lm
+ *   gcc -O2 -Wall -Wextra -I. -DSOUND_BACKEND=SOUND_BACKEND_DAC1 \
+ *       -o backend_snr_dac1 tools/backend_snr.c Synth.c Tuning.c Wavetables.c -lm
+ *   ./backend_snr; ./backend_snr_dac1
+ * Add -DSOUND_SAMPLE_RATE=... etc. to match SoundConfig.h if changed.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "AudioOut.h"
+#include "Synth.h"
+#include "Tuning.h"
+#include "Wavetables.h"
+#include "SoundConfig.h"
+
+#define FFT_BITS    13u
+#define FFT_LEN     (1u << FFT_BITS)
+#define SETTLE_SEC  3u            // let the decay reach the sustain level
+#define LOBE        5             // Blackman-Harris main lobe, in bins
+
+static uint16_t samples[FFT_LEN];
+static double   re[FFT_LEN];
+static double   im[FFT_LEN];
+
+static void fft(void)
+{
+    for (uint32_t i = 1, j = 0; i < FFT_LEN; i++)
+    {
+        uint32_t bit = FFT_LEN >> 1;
+        for (; j & bit; bit >>= 1)
+        {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j)
+        {
+            double t = re[i]; re[i] = re[j]; re[j] = t;
+            t = im[i]; im[i] = im[j]; im[j] = t;
+        }
+    }
+    for (uint32_t len = 2; len <= FFT_LEN; len <<= 1)
+    {
+        double a = -2.0 * M_PI / len;
+        for (uint32_t i = 0; i < FFT_LEN; i += len)
+        {
+            for (uint32_t k = 0; k < len / 2u; k++)
+            {
+                double wr = cos(a * k), wi = sin(a * k);
+                double xr = re[i + k + len / 2u] * wr - im[i + k + len / 2u] * wi;
+                double xi = re[i + k + len / 2u] * wi + im[i + k + len / 2u] * wr;
+                re[i + k + len / 2u] = re[i + k] - xr;
+                im[i + k + len / 2u] = im[i + k] - xi;
+                re[i + k] += xr;
+                im[i + k] += xi;
+            }
+        }
+    }
+}
+
+// Power in the main lobe around bin 'centre'
+static double lobe(double centre)
+{
+    double p = 0.0;
+    for (int b = (int)centre - LOBE; b <= (int)centre + LOBE + 1; b++)
+    {
+        if (b >= LOBE && b < (int)(FFT_LEN / 2u))
+        {
+            p += re[b] * re[b] + im[b] * im[b];
+        }
+    }
+    return p;
+}
+
+// 'bits'-bit stream: SNR in dB and THD in %
+static void analyse(const char *name, uint32_t (*pack)(uint16_t), uint8_t bits, double bin)
+{
+    for (uint32_t n = 0; n < FFT_LEN; n++)
+    {
+        double x = 2.0 * M_PI * n / (FFT_LEN - 1u);
+        double w = 0.35875 - 0.48829 * cos(x) + 0.14128 * cos(2.0 * x) - 0.01168 * cos(3.0 * x);
+        re[n] = ((double)pack(samples[n]) - (1u << (bits - 1u))) * w;
+        im[n] = 0.0;
+    }
+    fft();
+
+    double total = 0.0;
+    for (uint32_t b = LOBE; b < FFT_LEN / 2u; b++)   // skip DC
+    {
+        total += re[b] * re[b] + im[b] * im[b];
+    }
+    double fund = lobe(bin), harm = 0.0;
+    for (double h = 2.0 * bin; h < FFT_LEN / 2u - LOBE; h += bin)
+    {
+        harm += lobe(h);
+    }
+    printf("%-16s %2u bits  SNR %5.1f dB  THD %6.2f %%\n", name, bits,
+           10.0 * log10(fund / (total - fund)), 100.0 * sqrt(harm / fund));
+}
+
+#if SOUND_BACKEND == SOUND_BACKEND_DAC1
+#define BACKEND       "DAC1"
+#define BACKEND_BITS  12u
+static uint32_t sampleOut(uint16_t s)
+{
+    return AudioOut_Pack(s);           // DHR12R1 value
+}
+#else
+#define BACKEND       "ladder"
+#define BACKEND_BITS  4u
+static uint32_t sampleOut(uint16_t s)
+{
+    return AudioOut_Pack(s) & 0x0Fu;   // the PC0..PC3 bits of the BSRR word
+}
+#endif
+
+int main(void)
+{
+    uint32_t inc = Tuning_Inc(60u);   // NOTE_LOW, C4
+    uint16_t block[SOUND_BLOCK_SIZE];
+
+    Synth_Init();
+    Synth_SetWave(WAVE_SINE);
+    Synth_NoteOn(60u, inc);
+    for (uint32_t n = 0; n < SETTLE_SEC * SOUND_SAMPLE_RATE; n += SOUND_BLOCK_SIZE)
+    {
+        Synth_RenderBlock(block, SOUND_BLOCK_SIZE);
+    }
+    Synth_RenderBlock(samples, FFT_LEN);
+
+    double bin = inc * (double)FFT_LEN / 4294967296.0;
+    printf("C4 (%.1f Hz) at %u Hz: %.1f cycles in %u samples\n",
+           inc * (double)SOUND_SAMPLE_RATE / 4294967296.0, SOUND_SAMPLE_RATE, bin, FFT_LEN);
+    analyse(BACKEND, sampleOut, BACKEND_BITS, bin);
+    return 0;
+}
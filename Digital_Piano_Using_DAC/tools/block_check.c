@@ -0,0 +1,172 @@
+/*
+ * Check on a PC that the DMA block path renders the same samples as the
+ * per-sample path, bit for bit. The same script of random note on/off,
+ * retune, wave and all-off events, plus Song_Demo through Seq.c, is
+ * rendered twice from Synth_Init():
+ *   - blocks: Seq_Run(rest of block) + Synth_RenderBlock(), split at
+ *     script events, as Sound.c's renderBlock() splits at sequence events
+ *   - samples: Seq_Run(1) + Synth_RenderSample(), as the TIM3 ISR does
+ *
+ * Build from the project folder:
+ *   gcc -O2 -Wall -Wextra -I. -o block_check tools/block_check.c \
+ *       Seq.c Songs.c Synth.c Tuning.c Wavetables.c
+ *   ./block_check [seed]
+ * Add -DSOUND_SAMPLE_RATE=... etc. to match SoundConfig.h if changed.
+ *
+ * Cycle counts only mean something on the board: read Sound_GetLoad().
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include "Seq.h"
+#include "Songs.h"
+#include "Synth.h"
+#include "Tuning.h"
+#include "Wavetables.h"
+#include "SoundConfig.h"
+
+#define SECONDS     60u
+#define SAMPLES     (SECONDS * SOUND_SAMPLE_RATE)
+#define EVENTS      4000u
+#define SONG_AT     (SOUND_SAMPLE_RATE / 2u)
+
+typedef struct {
+    uint32_t at;         // sample the event applies before
+    uint8_t  op;         // 0 on, 1 off, 2 retune, 3 wave, 4 all off
+    uint8_t  key;
+    uint8_t  oldKey;
+} Event;
+
+static Event    script[EVENTS];
+static uint16_t outBlock[SAMPLES];
+static uint16_t outSample[SAMPLES];
+
+static int byTime(const void *a, const void *b)
+{
+    uint32_t ta = ((const Event *)a)->at, tb = ((const Event *)b)->at;
+    return (ta > tb) - (ta < tb);
+}
+
+static void makeScript(void)
+{
+    uint8_t last = 60;
+    for (uint32_t i = 0; i < EVENTS; i++)
+    {
+        Event *e = &script[i];
+        e->at     = (uint32_t)rand() % SAMPLES;
+        e->op     = (uint8_t)(rand() % 16);
+        e->key    = (uint8_t)(TUNING_FIRST_KEY + rand() % TUNING_KEYS);
+        e->oldKey = last;
+        // Mostly note on/off, with the rarer events now and then
+        e->op = (e->op < 7) ? 0u : (e->op < 13) ? 1u : (e->op < 14) ? 2u : (e->op < 15) ? 3u : 4u;
+        if (e->op == 3u)
+        {
+            e->key = (uint8_t)(rand() % WAVE_COUNT);
+        }
+        else
+        {
+            last = e->key;
+        }
+    }
+    qsort(script, EVENTS, sizeof(Event), byTime);
+}
+
+static void apply(const Event *e)
+{
+    switch (e->op)
+    {
+    case 0:
+        Synth_NoteOn(e->key, Tuning_Inc(e->key));
+        break;
+    case 1:
+        Synth_NoteOff(e->key);
+        break;
+    case 2:
+        Synth_Retune(e->oldKey, e->key, Tuning_Inc(e->key));
+        break;
+    case 3:
+        Synth_SetWave(e->key);
+        break;
+    default:
+        Synth_AllOff();
+        break;
+    }
+}
+
+static void renderBlocks(void)
+{
+    uint32_t next = 0;
+
+    Synth_Init();
+    Seq_Stop();
+    for (uint32_t t = 0; t < SAMPLES; t += SOUND_BLOCK_SIZE)
+    {
+        uint16_t done = 0;
+        if (t == SONG_AT)
+        {
+            Seq_Start(Song_Demo);
+        }
+        while (done < SOUND_BLOCK_SIZE)
+        {
+            while (next < EVENTS && script[next].at == t + done)
+            {
+                apply(&script[next++]);
+            }
+            uint16_t n = (uint16_t)(SOUND_BLOCK_SIZE - done);
+            if (next < EVENTS && script[next].at < t + SOUND_BLOCK_SIZE)
+            {
+                n = (uint16_t)(script[next].at - (t + done));
+            }
+            n = Seq_Run(n);
+            Synth_RenderBlock(&outBlock[t + done], n);
+            done = (uint16_t)(done + n);
+        }
+    }
+}
+
+static void renderSamples(void)
+{
+    uint32_t next = 0;
+
+    Synth_Init();
+    Seq_Stop();
+    for (uint32_t t = 0; t < SAMPLES; t++)
+    {
+        if (t == SONG_AT)
+        {
+            Seq_Start(Song_Demo);
+        }
+        while (next < EVENTS && script[next].at == t)
+        {
+            apply(&script[next++]);
+        }
+        Seq_Run(1);
+        outSample[t] = Synth_RenderSample();
+    }
+}
+
+int main(int argc, char **argv)
+{
+    unsigned seed = (argc > 1) ? (unsigned)atoi(argv[1]) : 1u;
+    srand(seed);
+    makeScript();
+
+    renderBlocks();
+    uint32_t songEvents = Seq_EventCount();
+    renderSamples();
+
+    uint32_t silent = 0;
+    for (uint32_t t = 0; t < SAMPLES; t++)
+    {
+        if (outBlock[t] != outSample[t])
+        {
+            printf("seed %u: sample %u differs: block %u, per-sample %u\n",
+                   seed, t, outBlock[t], outSample[t]);
+            return 1;
+        }
+        silent += (outBlock[t] == SYNTH_OUT_MID);
+    }
+    printf("seed %u: %u samples at %u Hz, %u-sample blocks, %u events + %u song events: identical (%.0f%% silent)\n",
+           seed, SAMPLES, SOUND_SAMPLE_RATE, SOUND_BLOCK_SIZE, EVENTS, songEvents,
+           100.0 * silent / SAMPLES);
+    return 0;
+}
@@ -0,0 +1,149 @@
+/*
+ * Check the ADSR envelope on a PC, with the firmware's own Synth.c:
+ *   - shape: A5 is played on the sine wave, held for a second and
+ *     released. The peak of every 2 ms window is compared with the
+ *     envelope SoundConfig.h asks for (linear attack, exponential decay
+ *     to the sustain level, exponential release)
+ *   - clicks: no step between samples, from note on to silence, is
+ *     larger than the waveform's own largest step at full level
+ *   - cost: host time per sample with four voices in their envelopes
+ *     (a PC figure; read Sound_GetLoad() on the board for M0 cycles)
+ *
+ * Build from the project folder:
+ *   gcc -O2 -Wall -Wextra -I. -o envelope_check tools/envelope_check.c \
+ *       Synth.c Tuning.c Wavetables.c -lm
+ *   ./envelope_check [-v]
+ * Add -DSYNTH_ATTACK_MS=... etc. to check other settings.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "Synth.h"
+#include "Tuning.h"
+#include "Wavetables.h"
+#include "SoundConfig.h"
+
+#define KEY          81u          // A5: 880 Hz, several periods per window
+#define WINDOW       (SOUND_SAMPLE_RATE / 500u)      // 2 ms
+#define HOLD         SOUND_SAMPLE_RATE               // 1 s
+#define TAIL         SOUND_SAMPLE_RATE               // after note off
+#define TOLERANCE    0.03         // of full level
+#define BENCH_SAMPLES (20u * 1000u * 1000u)
+
+static int failures;
+
+static void check(int ok, const char *what)
+{
+    printf("%-58s %s\n", what, ok ? "ok" : "FAIL");
+    failures += !ok;
+}
+
+// Envelope SoundConfig.h asks for at time t (s) with note off at 'off'
+static double expected(double t, double off)
+{
+    double ta = SYNTH_ATTACK_MS / 1000.0;
+    double level;
+
+    if (t < ta)
+    {
+        level = t / ta;
+    }
+    else
+    {
+        level = SYNTH_SUSTAIN + (1.0 - SYNTH_SUSTAIN) * exp(-(t - ta) / (SYNTH_DECAY_MS / 1000.0));
+    }
+    if (t >= off)
+    {
+        level = expected(off - 1e-9, 1e9) * exp(-(t - off) / (SYNTH_RELEASE_MS / 1000.0));
+    }
+    return level;
+}
+
+int main(int argc, char **argv)
+{
+    int verbose = argc > 1 && strcmp(argv[1], "-v") == 0;
+    uint32_t inc = Tuning_Inc(KEY);
+
+    // Full level: largest sample and step of the sine table A5 plays
+    const int16_t *table = Wavetable[WAVE_SINE][Wave_Level(inc)];
+    int32_t peak = 0;
+    for (uint32_t i = 0; i < WAVE_LEN; i++)
+    {
+        peak = abs(table[i]) > peak ? abs(table[i]) : peak;
+    }
+    double slope = peak * 2.0 * M_PI * inc / 4294967296.0;
+
+    // Note on, hold, note off, tail
+    Synth_Init();
+    Synth_NoteOn(KEY, inc);
+    double worst = 0.0, worstAt = 0.0;
+    int32_t prev = SYNTH_OUT_MID, step = 0;
+    for (uint32_t w = 0; w < (HOLD + TAIL) / WINDOW; w++)
+    {
+        int32_t high = 0;
+        if (w * WINDOW == HOLD)
+        {
+            Synth_NoteOff(KEY);
+        }
+        for (uint32_t n = 0; n < WINDOW; n++)
+        {
+            int32_t s = Synth_RenderSample();
+            high = abs(s - (int32_t)SYNTH_OUT_MID) > high ? abs(s - (int32_t)SYNTH_OUT_MID) : high;
+            step = abs(s - prev) > step ? abs(s - prev) : step;
+            prev = s;
+        }
+
+        // Compare with the envelope over the window, once the attack is
+        // over (the window peak cannot follow a 5 ms ramp)
+        double t0 = (double)(w * WINDOW) / SOUND_SAMPLE_RATE;
+        double t1 = (double)((w + 1u) * WINDOW) / SOUND_SAMPLE_RATE;
+        double off = (double)HOLD / SOUND_SAMPLE_RATE;
+        double lo = fmin(expected(t0, off), expected(t1, off));
+        double hi = fmax(expected(t0, off), expected(t1, off));
+        double got = (double)high / peak;
+        double err = got < lo ? lo - got : got > hi ? got - hi : 0.0;
+        if (verbose)
+        {
+            printf("%6.1f ms  %.3f  (%.3f .. %.3f)\n", t0 * 1000.0, got, lo, hi);
+        }
+        if (t0 > 2.0 * SYNTH_ATTACK_MS / 1000.0 && err > worst)
+        {
+            worst = err;
+            worstAt = t0;
+        }
+    }
+    printf("A5 at %u Hz: worst deviation %.4f of full level at %.0f ms\n",
+           SOUND_SAMPLE_RATE, worst, worstAt * 1000.0);
+    check(worst < TOLERANCE, "envelope follows the configured ADSR");
+    check(prev == (int32_t)SYNTH_OUT_MID, "the release ends in silence");
+    printf("largest step %d, waveform's own %.1f\n", step, slope);
+    check(step <= ceil(slope) + 1.0, "no step larger than the waveform's slope");
+
+    // Host cost: four voices, started 50 ms apart, through attack and decay
+    Synth_Init();
+    uint16_t block[SOUND_BLOCK_SIZE];
+    uint32_t sum = 0;
+    clock_t t0 = clock();
+    for (uint32_t n = 0; n < BENCH_SAMPLES; n += SOUND_BLOCK_SIZE)
+    {
+        uint32_t ms = n / SOUND_BLOCK_SIZE % 2000u;
+        if (ms % 50u == 0u && ms < 200u)
+        {
+            uint8_t key = (uint8_t)(48u + 7u * (ms / 50u));
+            Synth_NoteOn(key, Tuning_Inc(key));
+        }
+        if (ms == 1500u)
+        {
+            Synth_AllOff();
+        }
+        Synth_RenderBlock(block, SOUND_BLOCK_SIZE);
+        sum += block[n % SOUND_BLOCK_SIZE];
+    }
+    double ns = (double)(clock() - t0) / CLOCKS_PER_SEC * 1e9 / BENCH_SAMPLES;
+    printf("host: %.1f ns per sample, 4 enveloped voices (checksum %u)\n", ns, sum & 0xFFFFu);
+
+    printf("%s\n", failures ? "FAILED" : "all passed");
+    return failures != 0;
+}
@@ -0,0 +1,82 @@
+#!/usr/bin/env python3
+"""Generate Wavetables.c: band-limited single-cycle waveforms for Synth.c.
+
+The tables do not depend on the clock or sample rate (only the tuning
+table in Tuning.c does), so they are generated once and checked in.
+Re-run after changing WAVE_LEN or LEVELS:
+
+    python3 tools/gen_wavetables.py > Wavetables.c
+
+Each wave has one table per octave of phase increment (mip levels, see
+Wave_Level() in Wavetables.h). Level l keeps TOP_HARMONICS >> l
+harmonics: the highest one stays below half the sample rate for every
+increment that picks the level, whatever the sample rate is.
+"""
+import math
+
+WAVE_LEN = 256      # entries per table (must match WAVE_BITS in Wavetables.h)
+LEVELS = 6          # must match WAVE_LEVELS in Wavetables.h
+TOP_HARMONICS = 32  # harmonics in level 0 (WAVE_LEN / 8 keeps interpolation clean)
+PEAK = 2047         # signed 12-bit full scale
+
+
+def series(coeff, harmonics):
+    """Sum coeff(h) * sin(h x) for h = 1..harmonics with Lanczos sigma."""
+    out = []
+    for i in range(WAVE_LEN):
+        x = 2.0 * math.pi * i / WAVE_LEN
+        acc = 0.0
+        for h in range(1, harmonics + 1):
+            c = coeff(h)
+            if c:
+                sigma = 1.0 if h == 1 else math.sin(math.pi * h / (harmonics + 1)) / (math.pi * h / (harmonics + 1))
+                acc += c * sigma * math.sin(h * x)
+        out.append(acc)
+    return out
+
+
+WAVES = [
+    ("WaveSine",     "sine",     lambda h: 1.0 if h == 1 else 0.0),
+    ("WaveTriangle", "triangle", lambda h: ((-1) ** ((h - 1) // 2)) / (h * h) if h % 2 else 0.0),
+    ("WaveSquare",   "square",   lambda h: 1.0 / h if h % 2 else 0.0),
+    ("WaveSaw",      "sawtooth", lambda h: ((-1) ** (h + 1)) / h),
+]
+
+
+def main():
+    print("/* Generated by tools/gen_wavetables.py -- do not edit by hand. */")
+    print('#include "Wavetables.h"')
+    print()
+    print("/* %d entries, signed 12-bit, level l keeps harmonics 1..%d >> l (Lanczos sigma)." % (WAVE_LEN, TOP_HARMONICS))
+    print("   All levels of a wave share one scale, so a note keeps its loudness when")
+    print("   it moves to another level. Identical levels share a table. */")
+    rows = []
+    for name, desc, coeff in WAVES:
+        levels = [series(coeff, TOP_HARMONICS >> l) for l in range(LEVELS)]
+        peak = max(abs(v) for lv in levels for v in lv)
+        tables = []
+        names = []
+        for l, lv in enumerate(levels):
+            values = [int(round(v * PEAK / peak)) for v in lv]
+            if values in tables:
+                names.append(names[tables.index(values)])
+                continue
+            tname = "%s%d" % (name, l)
+            tables.append(values)
+            names.append(tname)
+            print()
+            print("// %s, harmonics 1..%d" % (desc, TOP_HARMONICS >> l))
+            print("static const int16_t %s[WAVE_LEN] = {" % tname)
+            for row in range(0, WAVE_LEN, 8):
+                print("    " + ", ".join("%5d" % v for v in values[row:row + 8]) + ",")
+            print("};")
+        rows.append(names)
+    print()
+    print("const int16_t * const Wavetable[WAVE_COUNT][WAVE_LEVELS] = {")
+    for names in rows:
+        print("    { " + ", ".join(names) + " },")
+    print("};")
+
+
+if __name__ == "__main__":
+    main()
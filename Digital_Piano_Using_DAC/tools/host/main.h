@@ -0,0 +1,30 @@
+#ifndef __MAIN_H__
+#define __MAIN_H__
+
+#include <stdint.h>
+
+/*
+ * Stand-in for the CubeMX main.h when firmware sources are built on a
+ * PC by the tools/ harnesses (-Itools/host). Only what those sources
+ * touch is here: peripherals are plain structs the harness owns and
+ * reads back, and the HAL calls are defined by the harness.
+ */
+
+typedef enum { HAL_OK = 0, HAL_ERROR = 1 } HAL_StatusTypeDef;
+
+typedef struct { volatile uint32_t IDR; volatile uint32_t BSRR; } GPIO_TypeDef;
+typedef struct { volatile uint32_t SR; } TIM_TypeDef;
+typedef struct { TIM_TypeDef *Instance; } TIM_HandleTypeDef;
+
+extern GPIO_TypeDef host_GPIOB, host_GPIOC;
+extern TIM_TypeDef  host_TIM14;
+
+#define GPIOB       (&host_GPIOB)
+#define GPIOC       (&host_GPIOC)
+#define TIM14       (&host_TIM14)
+#define TIM_SR_UIF  0x1u
+
+HAL_StatusTypeDef HAL_TIM_Base_Start_IT(TIM_HandleTypeDef *htim);
+void Error_Handler(void);
+
+#endif /* __MAIN_H__ */
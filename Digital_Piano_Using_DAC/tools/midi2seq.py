@@ -0,0 +1,183 @@
+#!/usr/bin/env python3
+"""Convert a standard MIDI file to the piano's sequence format (Seq.h).
+
+All tracks and channels are merged into one note stream. Notes outside
+the 88 piano keys (21..108) are dropped, tempo changes are kept, and
+everything else (velocity, controllers, program changes) is ignored.
+
+    python3 tools/midi2seq.py song.mid Song_Demo > Song_Demo.c
+    python3 tools/midi2seq.py --bin song.mid > song.seq   # for seq2wav
+
+Size and length are printed on stderr.
+"""
+import argparse
+import struct
+import sys
+
+SEQ_VERSION = 1
+OP_END = 0x00
+OP_TEMPO = 0x01
+OP_WAVE = 0x02
+OP_NOTE_OFF = 0x80
+
+KEY_LOW, KEY_HIGH = 21, 108
+DEFAULT_TEMPO = 500000          # us per quarter note (120 bpm)
+
+
+def read_varint(data, i):
+    value = 0
+    while True:
+        b = data[i]
+        i += 1
+        value = (value << 7) | (b & 0x7F)
+        if not b & 0x80:
+            return value, i
+
+
+def varint(value):
+    out = [value & 0x7F]
+    value >>= 7
+    while value:
+        out.append(0x80 | (value & 0x7F))
+        value >>= 7
+    return bytes(reversed(out))
+
+
+def parse_track(data, events, track):
+    """Append (tick, order, kind, value) tuples for one MTrk chunk."""
+    i, tick, status = 0, 0, 0
+    while i < len(data):
+        delta, i = read_varint(data, i)
+        tick += delta
+        b = data[i]
+        if b & 0x80:
+            status = b
+            i += 1
+        elif not status:
+            raise ValueError("track %d: running status with no status byte" % track)
+
+        if status == 0xFF:                       # meta event
+            kind = data[i]
+            length, i = read_varint(data, i + 1)
+            if kind == 0x51 and length == 3:
+                events.append((tick, 0, "tempo", int.from_bytes(data[i:i + 3], "big")))
+            i += length
+            if kind == 0x2F:
+                break
+            status = 0
+        elif status in (0xF0, 0xF7):             # sysex
+            length, i = read_varint(data, i)
+            i += length
+            status = 0
+        else:
+            kind = status & 0xF0
+            size = 1 if kind in (0xC0, 0xD0) else 2
+            args = data[i:i + size]
+            i += size
+            if kind == 0x90 and args[1] > 0:
+                events.append((tick, 2, "on", args[0]))
+            elif kind == 0x80 or kind == 0x90:
+                events.append((tick, 1, "off", args[0]))
+
+
+def read_midi(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    if data[:4] != b"MThd":
+        raise ValueError("not a MIDI file")
+    hlen, _fmt, ntracks, division = struct.unpack(">IHHH", data[4:14])
+    if division & 0x8000:
+        raise ValueError("SMPTE time division is not supported")
+
+    events = []
+    i = 8 + hlen
+    for track in range(ntracks):
+        if data[i:i + 4] != b"MTrk":
+            raise ValueError("track %d: missing MTrk" % track)
+        (length,) = struct.unpack(">I", data[i + 4:i + 8])
+        parse_track(data[i + 8:i + 8 + length], events, track)
+        i += 8 + length
+
+    # Same tick: tempo first, then offs, then ons (so repeated notes retrigger)
+    events.sort(key=lambda e: (e[0], e[1]))
+    return division, events
+
+
+def encode(ppq, events, wave=None):
+    tempo = DEFAULT_TEMPO
+    if events and events[0][2] == "tempo" and events[0][0] == 0:
+        tempo = events.pop(0)[3]
+
+    out = bytearray(b"SQ" + bytes([SEQ_VERSION]) + struct.pack(">H", ppq) + tempo.to_bytes(3, "big"))
+    stats = {"notes": 0, "dropped": 0, "seconds": 0.0}
+    last_tick = 0
+    held = {}
+    cur_tempo = tempo
+
+    def emit(tick, payload):
+        nonlocal last_tick
+        stats["seconds"] += (tick - last_tick) * cur_tempo / ppq / 1e6
+        out.extend(varint(tick - last_tick))
+        out.extend(payload)
+        last_tick = tick
+
+    if wave is not None:
+        emit(0, bytes([OP_WAVE, wave]))
+
+    for tick, _order, kind, value in events:
+        if kind == "tempo":
+            emit(tick, bytes([OP_TEMPO]) + value.to_bytes(3, "big"))
+            cur_tempo = value
+        elif not KEY_LOW <= value <= KEY_HIGH:
+            stats["dropped"] += kind == "on"
+        elif kind == "on":
+            held[value] = held.get(value, 0) + 1
+            stats["notes"] += 1
+            emit(tick, bytes([value]))
+        elif held.get(value, 0) > 0:
+            # Overlapping ons of one key: only the last off releases it
+            held[value] -= 1
+            if held[value] == 0:
+                emit(tick, bytes([OP_NOTE_OFF | value]))
+
+    emit(last_tick, bytes([OP_END]))
+    return bytes(out), stats
+
+
+def to_c(name, blob, source):
+    lines = ["/* Generated by tools/midi2seq.py from %s -- do not edit by hand. */" % source,
+             '#include "Seq.h"',
+             "",
+             "const uint8_t %s[%d] = {" % (name, len(blob))]
+    for i in range(0, len(blob), 16):
+        lines.append("    " + ", ".join("0x%02X" % b for b in blob[i:i + 16]) + ",")
+    lines.append("};")
+    return "\n".join(lines) + "\n"
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("midi")
+    ap.add_argument("name", nargs="?", default="Song", help="C array name")
+    ap.add_argument("--bin", action="store_true", help="write raw bytes instead of C")
+    ap.add_argument("--wave", type=int, help="WAVE_xxx index to select at the start")
+    args = ap.parse_args()
+
+    ppq, events = read_midi(args.midi)
+    blob, stats = encode(ppq, events, args.wave)
+
+    if args.bin:
+        sys.stdout.buffer.write(blob)
+    else:
+        sys.stdout.write(to_c(args.name, blob, args.midi))
+
+    minutes = stats["seconds"] / 60.0
+    sys.stderr.write("%d notes (%d outside 21..108 dropped), %.1f s, %d bytes" %
+                     (stats["notes"], stats["dropped"], stats["seconds"], len(blob)))
+    if minutes > 0:
+        sys.stderr.write(", %.0f bytes/minute" % (len(blob) / minutes))
+    sys.stderr.write("\n")
+
+
+if __name__ == "__main__":
+    main()
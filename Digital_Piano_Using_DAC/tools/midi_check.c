@@ -0,0 +1,178 @@
+/*
+ * Check the MIDI byte-stream parser (MidiParser.c) on a PC against
+ * hand-built streams, then time it on a long random stream.
+ *
+ * Build from the project folder:
+ *   gcc -O2 -Wall -Wextra -I. -o midi_check tools/midi_check.c MidiParser.c
+ *   ./midi_check
+ */
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "MidiParser.h"
+
+#define MAX_MSGS     16u
+#define BENCH_BYTES  (64u * 1024u * 1024u)
+
+typedef struct {
+    const char    *name;
+    const uint8_t *in;
+    uint32_t       len;
+    MidiMsg        out[MAX_MSGS];
+    uint32_t       count;
+} Case;
+
+#define BYTES(...)  (const uint8_t[]){ __VA_ARGS__ }, sizeof((const uint8_t[]){ __VA_ARGS__ })
+
+static const Case cases[] = {
+    { "note on, note off",
+      BYTES(0x90, 60, 100, 0x80, 60, 64),
+      { { 0x90, 60, 100 }, { 0x80, 60, 64 } }, 2 },
+    { "running status",
+      BYTES(0x91, 60, 100, 62, 90, 64, 80),
+      { { 0x91, 60, 100 }, { 0x91, 62, 90 }, { 0x91, 64, 80 } }, 3 },
+    { "velocity 0 is note off, running status kept",
+      BYTES(0x90, 60, 100, 60, 0, 62, 1),
+      { { 0x90, 60, 100 }, { 0x80, 60, 0 }, { 0x90, 62, 1 } }, 3 },
+    { "real-time between status and data",
+      BYTES(0x90, 0xF8, 60, 100),
+      { { 0xF8, 0, 0 }, { 0x90, 60, 100 } }, 2 },
+    { "real-time between the data bytes",
+      BYTES(0x90, 60, 0xFE, 100, 0xFA, 61, 0xFC, 101),
+      { { 0xFE, 0, 0 }, { 0x90, 60, 100 }, { 0xFA, 0, 0 }, { 0xFC, 0, 0 }, { 0x90, 61, 101 } }, 5 },
+    { "SysEx dropped, cancels running status",
+      BYTES(0x90, 60, 100, 0xF0, 0x7E, 0x7F, 0x09, 0x01, 0xF7, 61, 100, 0x90, 62, 100),
+      { { 0x90, 60, 100 }, { 0x90, 62, 100 } }, 2 },
+    { "real-time inside SysEx",
+      BYTES(0xF0, 0x43, 0xF8, 0x12, 0xF7, 0x90, 60, 100),
+      { { 0xF8, 0, 0 }, { 0x90, 60, 100 } }, 2 },
+    { "SysEx cut short by a status byte",
+      BYTES(0xF0, 0x43, 0x12, 0x80, 60, 0),
+      { { 0x80, 60, 0 } }, 1 },
+    { "system common dropped with its data",
+      BYTES(0xF2, 0x10, 0x20, 0xF3, 5, 0xF1, 0x31, 0xF6, 0x90, 60, 100),
+      { { 0x90, 60, 100 } }, 1 },
+    { "system common cancels running status",
+      BYTES(0x90, 60, 100, 0xF3, 5, 61, 100),
+      { { 0x90, 60, 100 } }, 1 },
+    { "stray data with no status",
+      BYTES(60, 100, 0x90, 60, 100),
+      { { 0x90, 60, 100 } }, 1 },
+    { "one data byte: program change, running status",
+      BYTES(0xC2, 5, 6, 0xD0, 90),
+      { { 0xC2, 5, 0 }, { 0xC2, 6, 0 }, { 0xD0, 90, 0 } }, 3 },
+    { "status byte inside a message restarts it",
+      BYTES(0x90, 60, 0xB0, 123, 0),
+      { { 0xB0, 123, 0 } }, 1 },
+    { "reset",
+      BYTES(0x90, 60, 0xFF, 100),
+      { { 0xFF, 0, 0 }, { 0x90, 60, 100 } }, 2 },
+};
+
+static int runCase(const Case *c)
+{
+    MidiParser p;
+    MidiMsg got[MAX_MSGS], m;
+    uint32_t n = 0;
+
+    MidiParser_Init(&p);
+    for (uint32_t i = 0; i < c->len; i++)
+    {
+        if (MidiParser_Feed(&p, c->in[i], &m) && n < MAX_MSGS)
+        {
+            got[n++] = m;
+        }
+    }
+
+    int ok = (n == c->count);
+    for (uint32_t i = 0; ok && i < n; i++)
+    {
+        ok = got[i].status == c->out[i].status && got[i].data1 == c->out[i].data1 &&
+             got[i].data2 == c->out[i].data2;
+    }
+    printf("%-58s %s\n", c->name, ok ? "ok" : "FAIL");
+    if (!ok)
+    {
+        for (uint32_t i = 0; i < n; i++)
+        {
+            printf("    got %02X %u %u\n", got[i].status, got[i].data1, got[i].data2);
+        }
+    }
+    return ok;
+}
+
+// A played stream: mostly running-status notes, some CCs, clock and SysEx
+static uint8_t *benchStream(void)
+{
+    static uint8_t buf[BENCH_BYTES];
+    uint32_t seed = 1, i = 0;
+
+    while (i < BENCH_BYTES - 16u)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        uint32_t r = seed >> 24;
+        if (r < 8u)
+        {
+            buf[i++] = 0xF8;
+        }
+        else if (r < 10u)
+        {
+            buf[i++] = 0xF0;
+            for (uint8_t k = 0; k < 6u; k++)
+            {
+                buf[i++] = (uint8_t)((seed >> k) & 0x7Fu);
+            }
+            buf[i++] = 0xF7;
+        }
+        else if (r < 40u)
+        {
+            buf[i++] = (uint8_t)(0xB0u | (r & 0x0Fu));
+            buf[i++] = 7;
+            buf[i++] = (uint8_t)(seed & 0x7Fu);
+        }
+        else
+        {
+            if (r < 60u)
+            {
+                buf[i++] = 0x90;
+            }
+            buf[i++] = (uint8_t)(21u + (seed >> 8) % 88u);
+            buf[i++] = (uint8_t)(seed & 0x7Fu);
+        }
+    }
+    while (i < BENCH_BYTES)
+    {
+        buf[i++] = 0xFE;
+    }
+    return buf;
+}
+
+int main(void)
+{
+    int failures = 0;
+    for (uint32_t i = 0; i < sizeof cases / sizeof cases[0]; i++)
+    {
+        failures += !runCase(&cases[i]);
+    }
+
+    const uint8_t *stream = benchStream();
+    MidiParser p;
+    MidiMsg m;
+    uint32_t msgs = 0, notes = 0;
+    MidiParser_Init(&p);
+    clock_t t0 = clock();
+    for (uint32_t i = 0; i < BENCH_BYTES; i++)
+    {
+        if (MidiParser_Feed(&p, stream[i], &m))
+        {
+            msgs++;
+            notes += (m.status & 0xE0u) == 0x80u;
+        }
+    }
+    double ns = (double)(clock() - t0) / CLOCKS_PER_SEC * 1e9 / BENCH_BYTES;
+    printf("host: %.2f ns per byte (%u messages, %u notes in %u MB)\n",
+           ns, msgs, notes, BENCH_BYTES >> 20);
+
+    printf("%s\n", failures ? "FAILED" : "all passed");
+    return failures != 0;
+}
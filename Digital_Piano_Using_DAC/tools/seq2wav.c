@@ -0,0 +1,215 @@
+/*
+ * Render a sequence (Seq.h) to a WAV file on a PC, using the same
+ * Seq.c/Synth.c code as the piano. Also checks event timing against an
+ * exact (double precision) schedule and prints the memory cost.
+ *
+ * Build from the project folder:
+ *   gcc -O2 -Wall -Wextra -I. -o seq2wav tools/seq2wav.c \
+ *       Seq.c Songs.c Synth.c Tuning.c Wavetables.c
+ * Add -DSOUND_SAMPLE_RATE=... etc. to match SoundConfig.h if changed.
+ *
+ *   python3 tools/midi2seq.py --bin song.mid > song.seq
+ *   ./seq2wav song.seq song.wav
+ *   ./seq2wav demo.wav              # Song_Demo from Songs.c
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include "Seq.h"
+#include "Songs.h"
+#include "Synth.h"
+#include "SoundConfig.h"
+
+#define CHUNK       SOUND_BLOCK_SIZE
+#define TAIL_SEC    1u            // let the last releases finish
+
+static uint8_t  *seq;
+static long      seqLen;
+static double   *ideal;           // exact sample time of every event
+static uint32_t  eventCount;
+
+static uint32_t readU24(const uint8_t *p)
+{
+    return ((uint32_t)p[0] << 16) | ((uint32_t)p[1] << 8) | p[2];
+}
+
+// Walk the stream like Seq.c does, but in doubles
+static void schedule(void)
+{
+    uint32_t ppq = (uint32_t)(seq[3] << 8) | seq[4];
+    double samplesPerTick = SOUND_SAMPLE_RATE * (readU24(&seq[5]) / 1e6) / ppq;
+    double t = 0.0;
+    long i = SEQ_HEADER_LEN;
+
+    ideal = malloc(sizeof(double) * (size_t)seqLen);
+    eventCount = 0;
+
+    while (i < seqLen)
+    {
+        uint32_t delta = 0;
+        uint8_t b;
+        do
+        {
+            b = seq[i++];
+            delta = (delta << 7) | (b & 0x7Fu);
+        } while (b & 0x80u);
+
+        t += delta * samplesPerTick;
+        ideal[eventCount++] = t;
+
+        uint8_t op = seq[i++];
+        if (op == SEQ_OP_TEMPO)
+        {
+            samplesPerTick = SOUND_SAMPLE_RATE * (readU24(&seq[i]) / 1e6) / ppq;
+            i += 3;
+        }
+        else if (op == SEQ_OP_WAVE)
+        {
+            i += 1;
+        }
+        else if (op == SEQ_OP_END)
+        {
+            break;
+        }
+    }
+}
+
+// Length of a sequence in memory, up to and including its end event
+static long seqLength(const uint8_t *s)
+{
+    long i = SEQ_HEADER_LEN;
+    uint8_t op;
+
+    do
+    {
+        while (s[i++] & 0x80u)
+        {
+        }
+        op = s[i++];
+        i += (op == SEQ_OP_TEMPO) ? 3 : (op == SEQ_OP_WAVE) ? 1 : 0;
+    } while (op != SEQ_OP_END);
+    return i;
+}
+
+static void put32(FILE *f, uint32_t v) { fwrite(&v, 4, 1, f); }
+static void put16(FILE *f, uint16_t v) { fwrite(&v, 2, 1, f); }
+
+int main(int argc, char **argv)
+{
+    if (argc != 2 && argc != 3)
+    {
+        fprintf(stderr, "usage: %s [in.seq] out.wav\n", argv[0]);
+        return 2;
+    }
+    const char *outName = argv[argc - 1];
+
+    if (argc == 2)
+    {
+        seq = (uint8_t *)Song_Demo;
+        seqLen = seqLength(Song_Demo);
+    }
+    else
+    {
+        FILE *in = fopen(argv[1], "rb");
+        if (!in)
+        {
+            perror(argv[1]);
+            return 1;
+        }
+        fseek(in, 0, SEEK_END);
+        seqLen = ftell(in);
+        rewind(in);
+        seq = malloc((size_t)seqLen);
+        if (fread(seq, 1, (size_t)seqLen, in) != (size_t)seqLen)
+        {
+            perror(argv[1]);
+            return 1;
+        }
+        fclose(in);
+    }
+
+    Synth_Init();
+    if (seqLen < (long)SEQ_HEADER_LEN || !Seq_Start(seq))
+    {
+        fprintf(stderr, "%s: not a sequence (version %u)\n", argv[argc - 2], SEQ_VERSION);
+        return 1;
+    }
+    schedule();
+
+    FILE *out = fopen(outName, "wb");
+    if (!out)
+    {
+        perror(outName);
+        return 1;
+    }
+    fwrite("RIFF\0\0\0\0WAVEfmt ", 1, 16, out);
+    put32(out, 16);
+    put16(out, 1);                          // PCM
+    put16(out, 1);                          // mono
+    put32(out, SOUND_SAMPLE_RATE);
+    put32(out, SOUND_SAMPLE_RATE * 2u);
+    put16(out, 2);
+    put16(out, 16);
+    fwrite("data\0\0\0\0", 1, 8, out);
+
+    // Same loop as Sound.c's renderBlock(): split chunks at events
+    uint16_t block[CHUNK];
+    uint32_t sample = 0;
+    uint32_t tail = 0;
+    uint32_t seen = 0;
+    double   worst = 0.0;
+
+    while (tail < TAIL_SEC * SOUND_SAMPLE_RATE)
+    {
+        uint16_t done = 0;
+        while (done < CHUNK)
+        {
+            uint16_t n = Seq_Run((uint16_t)(CHUNK - done));
+
+            // Events applied by this call happened at 'sample + done'
+            for (; seen < Seq_EventCount() && seen < eventCount; seen++)
+            {
+                double err = (double)(sample + done) - ideal[seen];
+                if (err < 0.0)
+                {
+                    err = -err;
+                }
+                if (err > worst)
+                {
+                    worst = err;
+                }
+            }
+
+            Synth_RenderBlock(&block[done], n);
+            done = (uint16_t)(done + n);
+        }
+
+        for (uint16_t i = 0; i < CHUNK; i++)
+        {
+            put16(out, (uint16_t)(((int32_t)block[i] - (int32_t)SYNTH_OUT_MID) * 16));
+        }
+        sample += CHUNK;
+        if (!Seq_IsPlaying())
+        {
+            tail += CHUNK;
+        }
+    }
+
+    long bytes = ftell(out);
+    fseek(out, 4, SEEK_SET);
+    put32(out, (uint32_t)(bytes - 8));
+    fseek(out, 40, SEEK_SET);
+    put32(out, (uint32_t)(bytes - 44));
+    fclose(out);
+
+    double seconds = ideal[eventCount - 1u] / SOUND_SAMPLE_RATE;
+    printf("%u events, %.1f s at %u Hz\n", eventCount, seconds, SOUND_SAMPLE_RATE);
+    printf("worst event timing error: %.3f samples (%.1f us)\n",
+           worst, worst * 1e6 / SOUND_SAMPLE_RATE);
+    printf("flash: %ld bytes", seqLen);
+    if (seconds > 0.0)
+    {
+        printf(", %.0f bytes/minute", seqLen * 60.0 / seconds);
+    }
+    printf("\n");
+    return 0;
+}
@@ -0,0 +1,125 @@
+/*
+ * Measure the ladder noise shaper on a PC: a 12-bit 289 Hz sine at the
+ * audio rate is run through the firmware's own NoiseShaper.c, and the
+ * in-band SNR (0 .. fs/2 of the audio rate) of the oversampled 4-bit
+ * stream is taken from a windowed FFT. The same sine truncated to the
+ * top 4 bits and held for SOUND_OVERSAMPLE ticks is the reference.
+ *
+ * Build from the project folder, once per shaper order:
+ *   gcc -O2 -Wall -Wextra -I. -DSOUND_LADDER_SHAPING=1 -o shaper_snr \
+ *       tools/shaper_snr.c NoiseShaper.c -lm
+ *   ./shaper_snr
+ * and again with -DSOUND_LADDER_SHAPING=2.
+ */
+#include <math.h>
+#include <stdio.h>
+#include "DAC.h"
+#include "NoiseShaper.h"
+#include "SoundConfig.h"
+
+#if !SOUND_LADDER_SHAPING
+#error "build with -DSOUND_LADDER_SHAPING=1 or 2"
+#endif
+
+#define TONE_HZ     289.0
+#define AMPLITUDE   1900.0        // 12-bit peak, clear of the ladder's top
+#define FFT_BITS    16u
+#define FFT_LEN     (1u << FFT_BITS)
+#define AUDIO_LEN   (FFT_LEN / SOUND_OVERSAMPLE)
+#define LOBE        5             // Blackman-Harris main lobe, in bins
+
+static uint16_t audio[AUDIO_LEN];
+static uint32_t words[FFT_LEN];
+static double   re[FFT_LEN];
+static double   im[FFT_LEN];
+
+static void fft(void)
+{
+    for (uint32_t i = 1, j = 0; i < FFT_LEN; i++)
+    {
+        uint32_t bit = FFT_LEN >> 1;
+        for (; j & bit; bit >>= 1)
+        {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j)
+        {
+            double t = re[i]; re[i] = re[j]; re[j] = t;
+            t = im[i]; im[i] = im[j]; im[j] = t;
+        }
+    }
+    for (uint32_t len = 2; len <= FFT_LEN; len <<= 1)
+    {
+        double a = -2.0 * M_PI / len;
+        for (uint32_t i = 0; i < FFT_LEN; i += len)
+        {
+            for (uint32_t k = 0; k < len / 2u; k++)
+            {
+                double wr = cos(a * k), wi = sin(a * k);
+                double xr = re[i + k + len / 2u] * wr - im[i + k + len / 2u] * wi;
+                double xi = re[i + k + len / 2u] * wi + im[i + k + len / 2u] * wr;
+                re[i + k + len / 2u] = re[i + k] - xr;
+                im[i + k + len / 2u] = im[i + k] - xi;
+                re[i + k] += xr;
+                im[i + k] += xi;
+            }
+        }
+    }
+}
+
+// In-band SNR of the ladder levels in 'words', in dB
+static double inBandSnr(void)
+{
+    for (uint32_t n = 0; n < FFT_LEN; n++)
+    {
+        double x = 2.0 * M_PI * n / (FFT_LEN - 1u);
+        double w = 0.35875 - 0.48829 * cos(x) + 0.14128 * cos(2.0 * x) - 0.01168 * cos(3.0 * x);
+        re[n] = ((double)(words[n] & 0x0Fu) - 7.5) * w;
+        im[n] = 0.0;
+    }
+    fft();
+
+    double tickRate = (double)SOUND_SAMPLE_RATE * SOUND_OVERSAMPLE;
+    int tone = (int)(TONE_HZ * FFT_LEN / tickRate + 0.5);
+    int edge = (int)(SOUND_SAMPLE_RATE / 2u * (double)FFT_LEN / tickRate);
+    double signal = 0.0, noise = 0.0;
+    for (int b = LOBE; b < edge; b++)   // skip DC
+    {
+        double p = re[b] * re[b] + im[b] * im[b];
+        if (b >= tone - LOBE && b <= tone + LOBE)
+        {
+            signal += p;
+        }
+        else
+        {
+            noise += p;
+        }
+    }
+    return 10.0 * log10(signal / noise);
+}
+
+int main(void)
+{
+    for (uint32_t n = 0; n < AUDIO_LEN; n++)
+    {
+        audio[n] = (uint16_t)lround(2048.0 + AMPLITUDE * sin(2.0 * M_PI * TONE_HZ * n / SOUND_SAMPLE_RATE));
+    }
+    printf("%.0f Hz sine at %u Hz, %ux oversampled, in-band 0-%u Hz\n",
+           TONE_HZ, SOUND_SAMPLE_RATE, SOUND_OVERSAMPLE, SOUND_SAMPLE_RATE / 2u);
+
+    // Reference: top 4 bits, held for every tick of the sample
+    for (uint32_t n = 0; n < FFT_LEN; n++)
+    {
+        words[n] = DAC_PortWord((uint8_t)(audio[n / SOUND_OVERSAMPLE] >> 8));
+    }
+    printf("truncate to 4 bits     %5.1f dB\n", inBandSnr());
+
+    NoiseShaper_Init();
+    for (uint32_t n = 0; n < AUDIO_LEN; n += SOUND_BLOCK_SIZE)
+    {
+        NoiseShaper_Run(&audio[n], &words[n * SOUND_OVERSAMPLE], SOUND_BLOCK_SIZE);
+    }
+    printf("order %u shaping        %5.1f dB\n", SOUND_LADDER_SHAPING, inBandSnr());
+    return 0;
+}
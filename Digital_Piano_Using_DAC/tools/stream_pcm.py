@@ -0,0 +1,187 @@
+#!/usr/bin/env python3
+"""Stream a WAV file to the piano as PCM8 or IMA ADPCM frames (Stream.h).
+
+The WAV (8/16-bit PCM, any rate, mono or stereo) is mixed down to mono,
+resampled to the stream rate and cut into frames. Frames go to a serial
+port, paced to real time, or to a file for testing.
+
+    python3 tools/stream_pcm.py song.wav --port /dev/ttyUSB0
+    python3 tools/stream_pcm.py song.wav --pcm8 --port /dev/ttyUSB0
+    python3 tools/stream_pcm.py song.wav -o song.bin     # no pacing
+
+The board must be built with SOUND_STREAM = 1 (SoundConfig.h). Serial
+output needs pyserial.
+"""
+import argparse
+import struct
+import sys
+import time
+import wave
+
+SYNC = b"\xA5\x5A"
+TYPE_PCM8, TYPE_ADPCM, TYPE_END = 0, 1, 2
+
+STREAM_RATE = 8000              # SOUND_STREAM_RATE
+BAUD = 115200                   # SOUND_STREAM_BAUD
+FRAME_SAMPLES = 120             # 15 ms: frame + PC jitter + JB_TARGET fit in JB_SIZE
+PREFILL_SAMPLES = 256           # JB_TARGET: sent ahead of real time
+
+INDEX_TABLE = [-1, -1, -1, -1, 2, 4, 6, 8] * 2
+STEP_TABLE = [
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37,
+    41, 45, 50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173,
+    190, 209, 230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658,
+    724, 796, 876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+    2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358, 5894, 6484,
+    7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899, 15289, 16818,
+    18500, 20350, 22385, 24623, 27086, 29794, 32767,
+]
+
+
+def crc8(data):
+    crc = 0
+    for b in data:
+        crc ^= b
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x07) & 0xFF if crc & 0x80 else (crc << 1) & 0xFF
+    return crc
+
+
+def frame(ftype, seq, payload=b""):
+    body = bytes([ftype, seq & 0xFF, len(payload)]) + payload
+    return SYNC + body + bytes([crc8(body)])
+
+
+def read_wav(path):
+    """Mono samples as floats in -1..1, and the file's sample rate."""
+    with wave.open(path, "rb") as w:
+        ch, width, rate = w.getnchannels(), w.getsampwidth(), w.getframerate()
+        raw = w.readframes(w.getnframes())
+    if width == 1:
+        vals = [(b - 128) / 128.0 for b in raw]
+    elif width == 2:
+        vals = [v / 32768.0 for v in struct.unpack("<%dh" % (len(raw) // 2), raw)]
+    else:
+        sys.exit("only 8- and 16-bit WAV files are supported")
+    mono = [sum(vals[i:i + ch]) / ch for i in range(0, len(vals), ch)]
+    return mono, rate
+
+
+def resample(x, src, dst):
+    """Linear interpolation; good enough for an 8 kHz 12-bit output."""
+    if src == dst or not x:
+        return x
+    n = int(len(x) * dst / src)
+    out = []
+    for i in range(n):
+        p = i * src / dst
+        k = int(p)
+        f = p - k
+        a = x[k]
+        b = x[k + 1] if k + 1 < len(x) else a
+        out.append(a + (b - a) * f)
+    return out
+
+
+class AdpcmEncoder:
+    def __init__(self):
+        self.pred = 0
+        self.index = 0
+
+    def encode(self, samples):
+        """Pack two 4-bit codes per byte, low nibble first (Adpcm.c)."""
+        codes = [self._nibble(s) for s in samples]
+        if len(codes) & 1:
+            codes.append(0)
+        return bytes(codes[i] | (codes[i + 1] << 4) for i in range(0, len(codes), 2))
+
+    def _nibble(self, s):
+        step = STEP_TABLE[self.index]
+        diff = s - self.pred
+        code = 8 if diff < 0 else 0
+        diff = abs(diff)
+        # Quantize with the decoder's own shift-and-add so both stay in step
+        dq = step >> 3
+        if diff >= step:
+            code |= 4
+            diff -= step
+            dq += step
+        if diff >= step >> 1:
+            code |= 2
+            diff -= step >> 1
+            dq += step >> 1
+        if diff >= step >> 2:
+            code |= 1
+            dq += step >> 2
+        self.pred += -dq if code & 8 else dq
+        self.pred = max(-32768, min(32767, self.pred))
+        self.index = max(0, min(88, self.index + INDEX_TABLE[code]))
+        return code
+
+
+def build_frames(samples, use_adpcm):
+    """List of (frame bytes, samples in it)."""
+    frames = []
+    enc = AdpcmEncoder()
+    for seq, i in enumerate(range(0, len(samples), FRAME_SAMPLES)):
+        chunk = samples[i:i + FRAME_SAMPLES]
+        if use_adpcm:
+            pcm = [max(-32768, min(32767, int(round(v * 32767)))) for v in chunk]
+            # Header = decoder state at the frame start, so frames stand alone
+            head = struct.pack("<hBB", enc.pred, enc.index, 0)
+            frames.append((frame(TYPE_ADPCM, seq, head + enc.encode(pcm)), len(chunk)))
+        else:
+            pcm = bytes(max(0, min(255, int(round(v * 127)) + 128)) for v in chunk)
+            frames.append((frame(TYPE_PCM8, seq, pcm), len(chunk)))
+    frames.append((frame(TYPE_END, len(frames)), 0))
+    return frames
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("wav")
+    ap.add_argument("--pcm8", action="store_true", help="send PCM8 instead of ADPCM")
+    ap.add_argument("--port", help="serial port, paced to real time")
+    ap.add_argument("--baud", type=int, default=BAUD)
+    ap.add_argument("--rate", type=int, default=STREAM_RATE, help="SOUND_STREAM_RATE")
+    ap.add_argument("-o", "--out", help="write the frames to a file instead")
+    args = ap.parse_args()
+
+    mono, src_rate = read_wav(args.wav)
+    samples = resample(mono, src_rate, args.rate)
+    frames = build_frames(samples, not args.pcm8)
+
+    total = sum(len(f) for f, _ in frames)
+    seconds = len(samples) / args.rate
+    print("%d samples, %.2f s, %d frames, %d bytes (%.0f%% of %d baud)"
+          % (len(samples), seconds, len(frames), total,
+             100.0 * total * 10 / max(seconds, 1e-9) / args.baud, args.baud),
+          file=sys.stderr)
+
+    if not args.port:
+        data = b"".join(f for f, _ in frames)
+        if args.out:
+            with open(args.out, "wb") as fh:
+                fh.write(data)
+        else:
+            sys.stdout.buffer.write(data)
+        return
+
+    import serial
+    with serial.Serial(args.port, args.baud) as port:
+        start = time.monotonic()
+        sent = 0
+        for f, n in frames:
+            # Stay PREFILL_SAMPLES ahead of playback, counting the frame
+            # being sent, no more: the jitter buffer holds only twice that.
+            due = start + max(0, sent + n - PREFILL_SAMPLES) / args.rate
+            delay = due - time.monotonic()
+            if delay > 0:
+                time.sleep(delay)
+            port.write(f)
+            sent += n
+        port.flush()
+
+
+if __name__ == "__main__":
+    main()
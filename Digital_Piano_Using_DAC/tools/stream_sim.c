@@ -0,0 +1,270 @@
+/*
+ * Check the stream receive path on a PC, with the firmware's own
+ * Adpcm.c and JitterBuffer.c:
+ *   - ADPCM: decode a frame file written by tools/stream_pcm.py and check
+ *     that the decoder, carried across frames, lands exactly on the
+ *     encoder state each next frame header records. Also the SNR of
+ *     the decoded audio against the test tone.
+ *   - drift: the sender's clock runs up to +/-1 % off ours. Frames are
+ *     paced as stream_pcm.py paces them, take their UART time to arrive
+ *     and are delayed at random by the PC. The audio side reads the
+ *     jitter buffer one block at a time. Reports the fill level once
+ *     the rate loop has settled, and any underruns or overruns.
+ *   - end: an END frame plays the buffer out without an underrun, and
+ *     the next stream waits for the prefill again.
+ *
+ * Build from the project folder:
+ *   gcc -O2 -Wall -Wextra -I. -I../Common -o stream_sim tools/stream_sim.c \
+ *       Adpcm.c JitterBuffer.c -lm
+ *   ./stream_sim -w tone.wav                      # write the test tone
+ *   python3 tools/stream_pcm.py tone.wav -o tone.bin
+ *   ./stream_sim tone.bin                         # ADPCM, then drift
+ *   ./stream_sim                                  # drift only
+ * Add -DSOUND_SAMPLE_RATE=... etc. to match SoundConfig.h if changed.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Adpcm.h"
+#include "JitterBuffer.h"
+#include "SoundConfig.h"
+#include "Stream.h"
+
+#define TONE_SEC      4u
+#define TONE_LEN      (TONE_SEC * SOUND_STREAM_RATE)
+#define FRAME_SAMPLES 120u        // stream_pcm.py
+#define PREFILL       256u        // stream_pcm.py sends this far ahead
+#define SIM_SEC       120u
+#define SETTLE_SEC    30u
+#define PC_JITTER_MS  10.0        // random extra delay per frame
+
+static int16_t tone[TONE_LEN];
+static int     failures;
+
+static void check(int ok, const char *what)
+{
+    printf("%-58s %s\n", what, ok ? "ok" : "FAIL");
+    failures += !ok;
+}
+
+// Test tone: a 110 Hz .. 3 kHz sweep under a 440 Hz sine
+static void makeTone(void)
+{
+    double phase = 0.0;
+    for (uint32_t n = 0; n < TONE_LEN; n++)
+    {
+        double f = 110.0 * pow(3000.0 / 110.0, (double)n / TONE_LEN);
+        phase += 2.0 * M_PI * f / SOUND_STREAM_RATE;
+        double x = 0.45 * sin(phase) + 0.35 * sin(2.0 * M_PI * 440.0 * n / SOUND_STREAM_RATE);
+        tone[n] = (int16_t)lround(x * 32767.0);
+    }
+}
+
+static void put16(FILE *f, uint32_t v) { fputc((int)(v & 0xFFu), f); fputc((int)(v >> 8), f); }
+static void put32(FILE *f, uint32_t v) { put16(f, v & 0xFFFFu); put16(f, v >> 16); }
+
+static int writeWav(const char *path)
+{
+    FILE *f = fopen(path, "wb");
+    if (f == NULL)
+    {
+        perror(path);
+        return 1;
+    }
+    fwrite("RIFF", 1, 4, f); put32(f, 36u + 2u * TONE_LEN); fwrite("WAVEfmt ", 1, 8, f);
+    put32(f, 16); put16(f, 1); put16(f, 1); put32(f, SOUND_STREAM_RATE);
+    put32(f, 2u * SOUND_STREAM_RATE); put16(f, 2); put16(f, 16);
+    fwrite("data", 1, 4, f); put32(f, 2u * TONE_LEN);
+    for (uint32_t n = 0; n < TONE_LEN; n++)
+    {
+        put16(f, (uint16_t)tone[n]);
+    }
+    fclose(f);
+    printf("wrote %s: %u s at %u Hz\n", path, TONE_SEC, SOUND_STREAM_RATE);
+    return 0;
+}
+
+static uint8_t crc8(uint8_t crc, uint8_t b)
+{
+    crc ^= b;
+    for (uint8_t i = 0; i < 8u; i++)
+    {
+        crc = (crc & 0x80u) ? (uint8_t)((crc << 1) ^ 0x07u) : (uint8_t)(crc << 1);
+    }
+    return crc;
+}
+
+static void checkAdpcm(const char *path)
+{
+    static uint8_t file[1u << 20];
+    static int16_t decoded[TONE_LEN + 2u * 255u];
+    FILE *f = fopen(path, "rb");
+    if (f == NULL)
+    {
+        perror(path);
+        failures++;
+        return;
+    }
+    size_t len = fread(file, 1, sizeof file, f);
+    fclose(f);
+
+    AdpcmState st = { 0, 0 };
+    uint32_t frames = 0, mismatches = 0, crcBad = 0, out = 0;
+    for (size_t i = 0; i + 6u <= len; )
+    {
+        const uint8_t *fr = &file[i];
+        if (fr[0] != STREAM_SYNC1 || fr[1] != STREAM_SYNC2)
+        {
+            i++;
+            continue;
+        }
+        uint8_t type = fr[2], plen = fr[4], crc = 0;
+        for (uint32_t k = 2; k < 5u + plen; k++)
+        {
+            crc = crc8(crc, fr[k]);
+        }
+        crcBad += (crc != fr[5u + plen]);
+        if (type == STREAM_ADPCM && out + 2u * (plen - 4u) <= sizeof decoded / 2u)
+        {
+            const uint8_t *p = &fr[5];
+            AdpcmState hdr = { (int16_t)(p[0] | (p[1] << 8)), p[2] };
+            if (frames > 0u && (hdr.predictor != st.predictor || hdr.index != st.index))
+            {
+                mismatches++;
+            }
+            Adpcm_Decode(&st, &p[4], (uint16_t)(plen - 4u), &decoded[out]);
+            out += 2u * (plen - 4u);
+            frames++;
+        }
+        i += 6u + plen;
+    }
+
+    double sig = 0.0, err = 0.0;
+    uint32_t n = out < TONE_LEN ? out : TONE_LEN;
+    for (uint32_t k = 0; k < n; k++)
+    {
+        sig += (double)tone[k] * tone[k];
+        err += ((double)decoded[k] - tone[k]) * ((double)decoded[k] - tone[k]);
+    }
+    printf("%s: %u ADPCM frames, %u samples, SNR %.1f dB against the tone\n",
+           path, frames, out, 10.0 * log10(sig / (err + 1e-9)));
+    check(frames > 0u && crcBad == 0u, "frames parse with good CRCs");
+    check(mismatches == 0u, "decoder tracks the encoder state across frames");
+    check(n == TONE_LEN && 10.0 * log10(sig / (err + 1e-9)) > 20.0, "decoded audio follows the tone");
+}
+
+// One drift run; non-zero if the buffer ran dry or overflowed
+static int drift(double offsetPct)
+{
+    static uint16_t block[SOUND_BLOCK_SIZE];
+    static int16_t  frame[FRAME_SAMPLES];
+    const double senderRate = SOUND_STREAM_RATE * (1.0 + offsetPct / 100.0);
+    const double uartMs = (FRAME_SAMPLES / 2u + 4u + 6u) * 10.0 * 1000.0 / SOUND_STREAM_BAUD;
+    const uint32_t blocks = SIM_SEC * 1000u;
+    uint32_t sent = 0, next = 0;
+    double lastArrival = 0.0, arrival = 0.0;
+    uint16_t lo = JB_SIZE, hi = 0;
+    JitterStats js;
+
+    JitterBuffer_Init();
+    for (uint32_t i = 0; i < FRAME_SAMPLES; i++)
+    {
+        frame[i] = (int16_t)(i * 7u % 512u);
+    }
+
+    for (uint32_t b = 0; b < blocks; b++)
+    {
+        double nowMs = (double)b;   // one block is 1 ms
+
+        // Deliver every frame whose last byte is in by now
+        for (;;)
+        {
+            if (next == sent)
+            {
+                // stream_pcm.py: PREFILL ahead, counting this frame
+                uint32_t ahead = sent + FRAME_SAMPLES;
+                double due = (ahead > PREFILL ? ahead - PREFILL : 0u) * 1000.0 / senderRate;
+                double a = due + uartMs + PC_JITTER_MS * rand() / RAND_MAX;
+                arrival = a > lastArrival + uartMs ? a : lastArrival + uartMs;
+                sent += FRAME_SAMPLES;
+            }
+            if (arrival > nowMs)
+            {
+                break;
+            }
+            JitterBuffer_Write(frame, FRAME_SAMPLES);
+            lastArrival = arrival;
+            next = sent;
+        }
+
+        memset(block, 0, sizeof block);
+        JitterBuffer_Mix(block, SOUND_BLOCK_SIZE);
+
+        if (b % 100u == 99u)
+        {
+            JitterBuffer_GetStats(&js);
+            if (b >= SETTLE_SEC * 1000u)
+            {
+                lo = js.minFill < lo ? js.minFill : lo;
+                hi = js.maxFill > hi ? js.maxFill : hi;
+            }
+        }
+    }
+    JitterBuffer_GetStats(&js);
+    printf("sender %+5.2f %%: fill %3u..%3u, rate %+6d ppm, %u underruns, %u overruns\n",
+           offsetPct, lo, hi, (int)js.ratePpm, (unsigned)js.underruns, (unsigned)js.overruns);
+    return js.underruns != 0u || js.overruns != 0u;
+}
+
+// A short stream, its END frame, then the start of another one
+static void endOfStream(void)
+{
+    static uint16_t block[SOUND_BLOCK_SIZE];
+    static int16_t  frame[FRAME_SAMPLES];
+    JitterStats js;
+
+    JitterBuffer_Init();
+    JitterBuffer_Write(frame, FRAME_SAMPLES);
+    JitterBuffer_End();
+    for (uint32_t b = 0; b < 100u; b++)
+    {
+        JitterBuffer_Mix(block, SOUND_BLOCK_SIZE);
+    }
+    JitterBuffer_GetStats(&js);
+    check(js.state == JB_IDLE && js.fill == 0u && js.underruns == 0u,
+          "an ended stream plays out without an underrun");
+
+    JitterBuffer_Write(frame, FRAME_SAMPLES);
+    JitterBuffer_Mix(block, SOUND_BLOCK_SIZE);
+    JitterBuffer_GetStats(&js);
+    check(js.state == JB_PREFILL && js.fill == FRAME_SAMPLES,
+          "the next stream waits for the prefill");
+}
+
+int main(int argc, char **argv)
+{
+    makeTone();
+    if (argc > 2 && strcmp(argv[1], "-w") == 0)
+    {
+        return writeWav(argv[2]);
+    }
+    if (argc > 1)
+    {
+        checkAdpcm(argv[1]);
+    }
+
+    srand(1);
+    printf("%u Hz stream into %u Hz audio, %u-sample frames, %u-sample buffer\n",
+           SOUND_STREAM_RATE, SOUND_SAMPLE_RATE, FRAME_SAMPLES, JB_SIZE);
+    int bad = 0;
+    for (int tenth = -10; tenth <= 10; tenth += 5)
+    {
+        bad |= drift(tenth / 10.0);
+    }
+    check(!bad, "no underruns or overruns for +/-1 % clock offset");
+    endOfStream();
+
+    printf("%s\n", failures ? "FAILED" : "all passed");
+    return failures != 0;
+}
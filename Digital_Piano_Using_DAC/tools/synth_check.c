@@ -0,0 +1,202 @@
+/*
+ * Check the DDS synth engine on a PC, with the firmware's own Synth.c
+ * and Tuning.c:
+ *   - pitch: every key's phase increment against exact equal
+ *     temperament, in cents
+ *   - retune: moving a sounding voice to another key never makes a step
+ *     larger than the two pitches' own slopes allow, and moving it onto
+ *     a key that already sounds leaves one voice for that key
+ *   - voices: a fifth note steals the oldest voice, released ones first
+ *   - cost: host time per sample with all voices sounding (a PC figure;
+ *     read Sound_GetLoad() on the board for M0 cycles)
+ *
+ * Build from the project folder:
+ *   gcc -O2 -Wall -Wextra -I. -o synth_check tools/synth_check.c \
+ *       Synth.c Tuning.c Wavetables.c -lm
+ *   ./synth_check
+ * Add -DSOUND_SAMPLE_RATE=... etc. to match SoundConfig.h if changed.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "Synth.h"
+#include "Tuning.h"
+#include "Wavetables.h"
+#include "SoundConfig.h"
+
+#define BENCH_SAMPLES  (20u * 1000u * 1000u)
+
+static int failures;
+
+static void check(int ok, const char *what)
+{
+    printf("%-58s %s\n", what, ok ? "ok" : "FAIL");
+    failures += !ok;
+}
+
+static double cents(uint8_t key)
+{
+    double exact = TUNING_A4_HZ * pow(2.0, (key - 69) / 12.0);
+    double f = Tuning_Inc(key) * (double)SOUND_SAMPLE_RATE / 4294967296.0;
+    return 1200.0 * log2(f / exact);
+}
+
+// Largest |step| between samples while 'key' sounds alone at full level
+static int32_t maxStep(uint8_t key)
+{
+    int32_t prev = SYNTH_OUT_MID, worst = 0;
+
+    Synth_Init();
+    Synth_NoteOn(key, Tuning_Inc(key));
+    for (uint32_t n = 0; n < SOUND_SAMPLE_RATE; n++)
+    {
+        int32_t s = Synth_RenderSample();
+        worst = abs(s - prev) > worst ? abs(s - prev) : worst;
+        prev = s;
+    }
+    return worst;
+}
+
+static int retuneIsSmooth(uint8_t from, uint8_t to)
+{
+    int32_t limit = maxStep(from) > maxStep(to) ? maxStep(from) : maxStep(to);
+    int32_t prev, worst = 0;
+
+    Synth_Init();
+    Synth_NoteOn(from, Tuning_Inc(from));
+    for (uint32_t n = 0; n < SOUND_SAMPLE_RATE / 3u; n++)
+    {
+        Synth_RenderSample();
+    }
+    prev = Synth_RenderSample();
+    Synth_Retune(from, to, Tuning_Inc(to));
+    for (uint32_t n = 0; n < SOUND_SAMPLE_RATE / 10u; n++)
+    {
+        int32_t s = Synth_RenderSample();
+        worst = abs(s - prev) > worst ? abs(s - prev) : worst;
+        prev = s;
+    }
+    return worst <= limit;
+}
+
+// Some output swing over the next 20 ms: a held note is still sounding
+static int sounding(void)
+{
+    uint16_t lo = SYNTH_OUT_MAX, hi = 0;
+    for (uint32_t n = 0; n < SOUND_SAMPLE_RATE / 50u; n++)
+    {
+        uint16_t s = Synth_RenderSample();
+        lo = s < lo ? s : lo;
+        hi = s > hi ? s : hi;
+    }
+    return hi - lo > 100;
+}
+
+static void run(uint32_t samples)
+{
+    while (samples--)
+    {
+        Synth_RenderSample();
+    }
+}
+
+// Four held notes 60..63, 10 ms apart
+static void fourNotes(void)
+{
+    Synth_Init();
+    for (uint8_t k = 0; k < SYNTH_VOICES; k++)
+    {
+        Synth_NoteOn((uint8_t)(60 + k), Tuning_Inc((uint8_t)(60 + k)));
+        run(SOUND_SAMPLE_RATE / 100u);
+    }
+}
+
+int main(void)
+{
+    // Pitch
+    double worst = 0.0;
+    uint8_t worstKey = 0, silent = 0;
+    for (uint8_t key = TUNING_FIRST_KEY; key <= TUNING_LAST_KEY; key++)
+    {
+        if (Tuning_Inc(key) == 0u)
+        {
+            silent++;
+            continue;
+        }
+        if (fabs(cents(key)) > worst)
+        {
+            worst = fabs(cents(key));
+            worstKey = key;
+        }
+    }
+    printf("%u Hz: worst pitch error %.6f cent (key %u), %u keys above fs/2 silent\n",
+           SOUND_SAMPLE_RATE, worst, worstKey, silent);
+    check(worst < 0.001, "every key within 0.001 cent");
+    check(Tuning_Inc(20) == 0u && Tuning_Inc(109) == 0u, "keys off the keyboard have no increment");
+
+    // Retune
+    check(retuneIsSmooth(60, 67) && retuneIsSmooth(67, 60) && retuneIsSmooth(36, 84),
+          "retune is phase-continuous");
+
+    // Retune onto a held key: one note off for 67 must silence both
+    Synth_Init();
+    Synth_NoteOn(60, Tuning_Inc(60));
+    Synth_NoteOn(67, Tuning_Inc(67));
+    run(SOUND_SAMPLE_RATE / 10u);
+    Synth_Retune(60, 67, Tuning_Inc(67));
+    Synth_NoteOff(67);
+    run(SOUND_SAMPLE_RATE);
+    check(Synth_RenderSample() == SYNTH_OUT_MID, "retune onto a sounding key merges the voices");
+
+    // Release
+    Synth_Init();
+    Synth_NoteOn(60, Tuning_Inc(60));
+    run(SOUND_SAMPLE_RATE / 10u);
+    Synth_NoteOff(60);
+    run(SOUND_SAMPLE_RATE);
+    check(Synth_RenderSample() == SYNTH_OUT_MID, "a released note fades to silence");
+
+    // Stealing: all voices busy, so key 72 takes the oldest (60). With
+    // everything but 60 released, silence proves 60 was the one taken.
+    fourNotes();
+    Synth_NoteOn(72, Tuning_Inc(72));
+    Synth_NoteOff(61);
+    Synth_NoteOff(62);
+    Synth_NoteOff(63);
+    Synth_NoteOff(72);
+    run(SOUND_SAMPLE_RATE);
+    check(Synth_RenderSample() == SYNTH_OUT_MID, "a fifth note steals the oldest voice");
+
+    // A released voice goes first: 62 is released, so 72 takes it and 60
+    // keeps sounding after the others are released.
+    fourNotes();
+    Synth_NoteOff(62);
+    Synth_NoteOn(72, Tuning_Inc(72));
+    Synth_NoteOff(61);
+    Synth_NoteOff(63);
+    Synth_NoteOff(72);
+    run(SOUND_SAMPLE_RATE);
+    check(sounding(), "released voices are stolen before held ones");
+
+    // Host cost with every voice busy
+    Synth_Init();
+    Synth_SetWave(WAVE_SAW);
+    for (uint8_t k = 0; k < SYNTH_VOICES; k++)
+    {
+        Synth_NoteOn((uint8_t)(48 + 7 * k), Tuning_Inc((uint8_t)(48 + 7 * k)));
+    }
+    uint16_t block[SOUND_BLOCK_SIZE];
+    uint32_t sum = 0;
+    clock_t t0 = clock();
+    for (uint32_t n = 0; n < BENCH_SAMPLES; n += SOUND_BLOCK_SIZE)
+    {
+        Synth_RenderBlock(block, SOUND_BLOCK_SIZE);
+        sum += block[n % SOUND_BLOCK_SIZE];
+    }
+    double ns = (double)(clock() - t0) / CLOCKS_PER_SEC * 1e9 / BENCH_SAMPLES;
+    printf("host: %.1f ns per sample, %u voices (checksum %u)\n", ns, SYNTH_VOICES, sum & 0xFFFFu);
+
+    printf("%s\n", failures ? "FAILED" : "all passed");
+    return failures != 0;
+}
@@ -0,0 +1,156 @@
+/*
+ * Measure wavetable aliasing on a PC: every key of every wave is played
+ * through the firmware's own Synth.c and Tuning.c, and a windowed FFT
+ * of the held note splits the output into harmonics of the note and
+ * everything else (aliases, interpolation and rounding noise).
+ *
+ * Build from the project folder:
+ *   gcc -O2 -Wall -Wextra -I. -o wave_alias tools/wave_alias.c \
+ *       Synth.c Tuning.c Wavetables.c -lm
+ *   ./wave_alias [-v]
+ * Add -DSOUND_SAMPLE_RATE=... etc. to match SoundConfig.h if changed.
+ *
+ * Prints the worst key of each wave: the energy off the harmonics,
+ * relative to the energy on them. -v prints every key.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "Synth.h"
+#include "Tuning.h"
+#include "Wavetables.h"
+#include "SoundConfig.h"
+
+#define FFT_BITS    13u
+#define FFT_LEN     (1u << FFT_BITS)
+#define SETTLE_SEC  3u            // let the decay reach the sustain level
+#define LOBE        5             // Blackman-Harris main lobe, in bins
+
+static double re[FFT_LEN];
+static double im[FFT_LEN];
+static double power[FFT_LEN / 2u];
+
+static void fft(void)
+{
+    for (uint32_t i = 1, j = 0; i < FFT_LEN; i++)
+    {
+        uint32_t bit = FFT_LEN >> 1;
+        for (; j & bit; bit >>= 1)
+        {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j)
+        {
+            double t = re[i]; re[i] = re[j]; re[j] = t;
+            t = im[i]; im[i] = im[j]; im[j] = t;
+        }
+    }
+    for (uint32_t len = 2; len <= FFT_LEN; len <<= 1)
+    {
+        double a = -2.0 * M_PI / len;
+        for (uint32_t i = 0; i < FFT_LEN; i += len)
+        {
+            for (uint32_t k = 0; k < len / 2u; k++)
+            {
+                double wr = cos(a * k), wi = sin(a * k);
+                double xr = re[i + k + len / 2u] * wr - im[i + k + len / 2u] * wi;
+                double xi = re[i + k + len / 2u] * wi + im[i + k + len / 2u] * wr;
+                re[i + k + len / 2u] = re[i + k] - xr;
+                im[i + k + len / 2u] = im[i + k] - xi;
+                re[i + k] += xr;
+                im[i + k] += xi;
+            }
+        }
+    }
+}
+
+// Off-harmonic to harmonic energy of a held key, in dB
+static double measure(uint8_t wave, uint8_t key)
+{
+    uint32_t inc = Tuning_Inc(key);
+    uint16_t block[SOUND_BLOCK_SIZE];
+
+    Synth_Init();
+    Synth_SetWave(wave);
+    Synth_NoteOn(key, inc);
+    for (uint32_t n = 0; n < SETTLE_SEC * SOUND_SAMPLE_RATE; n += SOUND_BLOCK_SIZE)
+    {
+        Synth_RenderBlock(block, SOUND_BLOCK_SIZE);
+    }
+    for (uint32_t n = 0; n < FFT_LEN; n++)
+    {
+        double x = 2.0 * M_PI * n / (FFT_LEN - 1u);
+        double w = 0.35875 - 0.48829 * cos(x) + 0.14128 * cos(2.0 * x) - 0.01168 * cos(3.0 * x);
+        re[n] = ((double)Synth_RenderSample() - SYNTH_OUT_MID) * w;
+        im[n] = 0.0;
+    }
+    fft();
+
+    for (uint32_t b = 0; b < FFT_LEN / 2u; b++)
+    {
+        power[b] = re[b] * re[b] + im[b] * im[b];
+    }
+
+    // Harmonics: bins around every multiple of the note below fs / 2
+    static uint8_t onHarmonic[FFT_LEN / 2u];
+    double binsPerHarmonic = inc * (double)FFT_LEN / 4294967296.0;
+    memset(onHarmonic, 0, sizeof onHarmonic);
+    for (double h = binsPerHarmonic; h < FFT_LEN / 2u; h += binsPerHarmonic)
+    {
+        for (int b = (int)h - LOBE; b <= (int)h + LOBE + 1; b++)
+        {
+            if (b >= 0 && b < (int)(FFT_LEN / 2u))
+            {
+                onHarmonic[b] = 1;
+            }
+        }
+    }
+
+    double on = 0.0, off = 0.0;
+    for (uint32_t b = LOBE; b < FFT_LEN / 2u; b++)   // skip DC
+    {
+        if (onHarmonic[b])
+        {
+            on += power[b];
+        }
+        else
+        {
+            off += power[b];
+        }
+    }
+    return 10.0 * log10((off + 1e-12) / on);
+}
+
+int main(int argc, char **argv)
+{
+    static const char *names[WAVE_COUNT] = { "sine", "triangle", "square", "sawtooth" };
+    int verbose = argc > 1 && strcmp(argv[1], "-v") == 0;
+
+    printf("%u Hz, %u-point FFT, worst key per wave (off-harmonic energy)\n",
+           SOUND_SAMPLE_RATE, FFT_LEN);
+    for (uint8_t w = 0; w < WAVE_COUNT; w++)
+    {
+        double worst = -1e9;
+        uint8_t worstKey = 0;
+        for (uint8_t key = TUNING_FIRST_KEY; key <= TUNING_LAST_KEY; key++)
+        {
+            if (Tuning_Inc(key) == 0u)
+            {
+                continue;
+            }
+            double db = measure(w, key);
+            if (verbose)
+            {
+                printf("%-8s key %3u  %7.1f dB\n", names[w], key, db);
+            }
+            if (db > worst)
+            {
+                worst = db;
+                worstKey = key;
+            }
+        }
+        printf("%-8s  %7.1f dB  (key %u)\n", names[w], worst, worstKey);
+    }
+    return 0;
+}
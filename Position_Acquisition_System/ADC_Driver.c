@@ -3,9 +3,32 @@
 /* Use the global handle CubeMX created */
 extern ADC_HandleTypeDef hadc;
 
+static DMA_HandleTypeDef hdma_adc;
+static TIM_HandleTypeDef htim3;
+
+/* CubeMX set-up, restored by ADC_StreamStop() */
+static ADC_InitTypeDef swInit;
+static uint32_t swSmpr;
+static uint32_t swChselr;
+
+/* Factory calibration in system memory */
+#define VREFINT_CAL  (*(const uint16_t *)0x1FFFF7BAu)   // VREFINT at 3.3 V
+#define TS_CAL1      (*(const uint16_t *)0x1FFFF7B8u)   // sensor at 30 C, 3.3 V
+
+static volatile uint8_t streaming = 0;
+static uint32_t streamRate = 0;
+static uint16_t streamLen = 0;
+static uint32_t streamChannels = 0;
+
+static uint8_t  awdOn = 0;
+static uint16_t awdLow = 0, awdHigh = 4095u;
+
 void ADC_DriverInit(void){
  
   HAL_ADCEx_Calibration_Start(&hadc);
+  swInit = hadc.Init;
+  swSmpr = hadc.Instance->SMPR;
+  swChselr = hadc.Instance->CHSELR;
 }
 /*
  * ADC_In
@@ -16,9 +39,250 @@ void ADC_DriverInit(void){
  * and stops the ADC.
  */
 uint16_t ADC_In(void){
+  if (streaming) {
+    return ADCStream_Latest(__HAL_DMA_GET_COUNTER(&hdma_adc));
+  }
   HAL_ADC_Start(&hadc);
   HAL_ADC_PollForConversion(&hadc, HAL_MAX_DELAY);
   uint16_t val = (uint16_t)HAL_ADC_GetValue(&hadc); // 0..4095
   HAL_ADC_Stop(&hadc);
   return val;
 }
+
+uint32_t ADC_StreamStart(uint16_t *buf, uint16_t len, uint32_t rateHz){
+  return ADC_ScanStart(buf, len, rateHz, swChselr);
+}
+
+void ADC_ScanConfigure(ScanConfig *cfg, uint32_t channels, uint32_t absolute){
+  cfg->channels = channels;
+  cfg->absolute = absolute;
+  cfg->vrefCal  = VREFINT_CAL;
+  cfg->tsCal    = TS_CAL1;
+}
+
+uint32_t ADC_ScanStart(uint16_t *buf, uint16_t len, uint32_t rateHz, uint32_t channels){
+  ADCStreamTiming t;
+  uint8_t n = Scan_Count(channels);
+
+  ADC_StreamStop();
+  /* APB1 prescaler is 1, so TIM3 runs at PCLK */
+  if (n == 0u || len < 2u * n || (len % (2u * n)) != 0u ||
+      !Scan_Timing(HAL_RCC_GetPCLK1Freq(), ADC_CLOCK_HZ, rateHz, channels, &t)) {
+    return 0;
+  }
+
+  __HAL_RCC_DMA1_CLK_ENABLE();
+  __HAL_RCC_TIM3_CLK_ENABLE();
+
+  /* TIM3 update -> TRGO -> one conversion */
+  TIM_MasterConfigTypeDef sMaster = {0};
+  htim3.Instance               = TIM3;
+  htim3.Init.Prescaler         = t.psc;
+  htim3.Init.CounterMode       = TIM_COUNTERMODE_UP;
+  htim3.Init.Period            = t.arr;
+  htim3.Init.ClockDivision     = TIM_CLOCKDIVISION_DIV1;
+  htim3.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+  sMaster.MasterOutputTrigger  = TIM_TRGO_UPDATE;
+  sMaster.MasterSlaveMode      = TIM_MASTERSLAVEMODE_DISABLE;
+  if (HAL_TIM_Base_Init(&htim3) != HAL_OK ||
+      HAL_TIMEx_MasterConfigSynchronization(&htim3, &sMaster) != HAL_OK) {
+    return 0;
+  }
+
+  /* ADC data register -> buf, circular */
+  hdma_adc.Instance                 = DMA1_Channel1;
+  hdma_adc.Init.Direction           = DMA_PERIPH_TO_MEMORY;
+  hdma_adc.Init.PeriphInc           = DMA_PINC_DISABLE;
+  hdma_adc.Init.MemInc              = DMA_MINC_ENABLE;
+  hdma_adc.Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+  hdma_adc.Init.MemDataAlignment    = DMA_MDATAALIGN_HALFWORD;
+  hdma_adc.Init.Mode                = DMA_CIRCULAR;
+  hdma_adc.Init.Priority            = DMA_PRIORITY_HIGH;
+  if (HAL_DMA_Init(&hdma_adc) != HAL_OK) {
+    return 0;
+  }
+  __HAL_LINKDMA(&hadc, DMA_Handle, hdma_adc);
+  HAL_NVIC_SetPriority(DMA1_Channel1_IRQn, 0, 0);
+  HAL_NVIC_EnableIRQ(DMA1_Channel1_IRQn);
+
+  /* Same channel, now triggered by TIM3 and feeding the DMA for good */
+  streaming = 1;                        // from here on, Stop undoes it
+  hadc.Init.ContinuousConvMode    = DISABLE;
+  hadc.Init.ExternalTrigConv      = ADC_EXTERNALTRIGCONV_T3_TRGO;
+  hadc.Init.ExternalTrigConvEdge  = ADC_EXTERNALTRIGCONVEDGE_RISING;
+  hadc.Init.DMAContinuousRequests = ENABLE;
+  hadc.Init.Overrun               = ADC_OVR_DATA_OVERWRITTEN;
+  if (HAL_ADC_Init(&hadc) != HAL_OK) {
+    ADC_StreamStop();
+    return 0;
+  }
+  hadc.Instance->SMPR = t.sampleTime;   // common to all channels; ADC is off here
+  hadc.Instance->CHSELR = channels;     // converted in ascending order
+
+  /* VREFINT and the temperature sensor are switched on for the scan */
+  uint32_t internal = 0;
+  if (channels & SCAN_CH(SCAN_CH_VREF)) {
+    internal |= ADC_CCR_VREFEN;
+  }
+  if (channels & SCAN_CH(SCAN_CH_TEMP)) {
+    internal |= ADC_CCR_TSEN;
+  }
+  if (internal) {
+    ADC->CCR |= internal;
+    HAL_Delay(1);                       // sensor start-up is 10 us
+  }
+
+  if (awdOn) {
+    ADC_AnalogWDGConfTypeDef sAwd = {0};
+    sAwd.WatchdogMode  = ADC_ANALOGWATCHDOG_SINGLE_REG;
+    sAwd.Channel       = ADC_CHANNEL_0;
+    sAwd.ITMode        = DISABLE;          // ADC_WatchdogIrq() turns it on
+    sAwd.HighThreshold = awdHigh;
+    sAwd.LowThreshold  = awdLow;
+    if (HAL_ADC_AnalogWDGConfig(&hadc, &sAwd) != HAL_OK) {
+      ADC_StreamStop();
+      return 0;
+    }
+    HAL_NVIC_SetPriority(ADC1_COMP_IRQn, 0, 0);
+    HAL_NVIC_EnableIRQ(ADC1_COMP_IRQn);
+  }
+
+  ADCStream_Reset(buf, len, n);
+  streamLen = len;
+  streamChannels = channels;
+  if (HAL_ADC_Start_DMA(&hadc, (uint32_t *)buf, len) != HAL_OK ||
+      HAL_TIM_Base_Start(&htim3) != HAL_OK) {
+    ADC_StreamStop();
+    return 0;
+  }
+
+  streamRate = t.rateHz;
+  return streamRate;
+}
+
+void ADC_StreamStop(void){
+  if (!streaming) {
+    return;
+  }
+  HAL_TIM_Base_Stop(&htim3);
+  HAL_ADC_Stop_DMA(&hadc);
+  HAL_NVIC_DisableIRQ(DMA1_Channel1_IRQn);
+  HAL_NVIC_DisableIRQ(ADC1_COMP_IRQn);
+  streaming = 0;
+  streamRate = 0;
+
+  hadc.Init = swInit;
+  HAL_ADC_Init(&hadc);
+  hadc.Instance->SMPR = swSmpr;
+  hadc.Instance->CHSELR = swChselr;
+  ADC->CCR &= ~(ADC_CCR_VREFEN | ADC_CCR_TSEN);
+  hadc.Instance->IER &= ~ADC_IER_AWDIE;
+  hadc.Instance->CFGR1 &= ~(ADC_CFGR1_AWDEN | ADC_CFGR1_AWDSGL);
+}
+
+uint16_t ADC_StreamPosition(void){
+  uint16_t w = (uint16_t)(streamLen - hdma_adc.Instance->CNDTR);
+  return (w >= streamLen) ? 0u : w;
+}
+
+void ADC_StreamFreeze(void){
+  htim3.Instance->CR1 &= ~TIM_CR1_CEN;   // no more triggers
+}
+
+uint32_t ADC_StreamSetRate(uint32_t rateHz){
+  ADCStreamTiming t;
+
+  /* The sampling time stays; it can only change with the ADC stopped */
+  if (!streaming ||
+      !Scan_Timing(HAL_RCC_GetPCLK1Freq(), ADC_CLOCK_HZ, rateHz, streamChannels, &t) ||
+      t.sampleTime < hadc.Instance->SMPR) {
+    return 0;
+  }
+  htim3.Instance->PSC = t.psc;
+  htim3.Instance->ARR = t.arr;
+  htim3.Instance->EGR = TIM_EGR_UG;     // load PSC now and restart the period
+  streamRate = t.rateHz;
+  return streamRate;
+}
+
+void ADC_WatchdogWindow(uint16_t low, uint16_t high){
+  awdOn = 1;
+  awdLow = low;
+  awdHigh = high;
+}
+
+void ADC_WatchdogOff(void){
+  awdOn = 0;
+}
+
+void ADC_WatchdogMove(uint16_t low, uint16_t high){
+  awdLow = low;
+  awdHigh = high;
+  if (!streaming || !awdOn) {
+    return;
+  }
+
+  /* TR can only be written with conversions stopped. ADSTP in the middle
+     of a scan would restart the next one at the first channel while the
+     DMA carries on mid-frame, so hold the trigger and let a scan that
+     has started finish first (one scan, under 60 us). The next trigger
+     comes that much late. A scan whose first result is not in yet is
+     cut, which costs that frame but keeps the order. */
+  uint32_t cen = htim3.Instance->CR1 & TIM_CR1_CEN;
+  uint8_t  n = Scan_Count(streamChannels);
+  htim3.Instance->CR1 &= ~TIM_CR1_CEN;
+  while (hdma_adc.Instance->CNDTR % n != 0u) {}
+  hadc.Instance->CR |= ADC_CR_ADSTP;
+  while (hadc.Instance->CR & ADC_CR_ADSTART) {}
+  hadc.Instance->TR = ((uint32_t)high << ADC_TR_HT_Pos) | ((uint32_t)low << ADC_TR_LT_Pos);
+  hadc.Instance->CR |= ADC_CR_ADSTART;
+  htim3.Instance->CR1 |= cen;
+}
+
+void ADC_WatchdogIrq(uint8_t on){
+  if (!on) {
+    hadc.Instance->IER &= ~ADC_IER_AWDIE;
+  } else if (!(hadc.Instance->IER & ADC_IER_AWDIE)) {
+    hadc.Instance->ISR = ADC_ISR_AWD;  // drop a flag from before now
+    hadc.Instance->IER |= ADC_IER_AWDIE;
+  }
+}
+
+void ADC_IRQHandler(void){
+  uint32_t isr = hadc.Instance->ISR;
+
+  if (isr & ADC_ISR_OVR) {
+    hadc.Instance->ISR = ADC_ISR_OVR;  // overwritten data is fine in stream mode
+  }
+  if ((isr & ADC_ISR_AWD) && (hadc.Instance->IER & ADC_IER_AWDIE)) {
+    hadc.Instance->ISR = ADC_ISR_AWD;
+    ADC_WatchdogEvent(ADC_StreamPosition());
+  }
+}
+
+uint8_t ADC_StreamRunning(void){
+  return streaming;
+}
+
+uint32_t ADC_StreamRate(void){
+  return streamRate;
+}
+
+void ADC_StreamGetStats(ADCStreamStats *stats){
+  ADCStream_GetStats(stats);
+}
+
+void ADC_DMA_IRQHandler(void){
+  HAL_DMA_IRQHandler(&hdma_adc);
+}
+
+/* HAL calls these from the DMA half-transfer / transfer-complete interrupt */
+void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *h){
+  (void)h;
+  ADCStream_Done(0, &hdma_adc.Instance->CNDTR);
+}
+
+void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *h){
+  (void)h;
+  ADCStream_Done(1, &hdma_adc.Instance->CNDTR);
+}
@@ -3,11 +3,97 @@
 
 #include "stm32f0xx_hal.h"
 #include <stdint.h>
+#include "ADC_Stream.h"
+#include "Scan.h"
+
+#define ADC_CLOCK_HZ  14000000u   // HSI14, ADC_CLOCK_ASYNC_DIV1
 
 /* Call after MX_ADC_Init() */
 void ADC_DriverInit(void);
 
-/* Do one blocking conversion on PA0 (ADC1_IN0) */
+/*
+ * Do one blocking conversion on PA0 (ADC1_IN0). While streaming it
+ * returns the newest streamed sample instead (of a scan: the lowest
+ * scanned channel).
+ */
 uint16_t ADC_In(void);
 
+/*
+ * Streaming mode
+ * --------------
+ * TIM3 TRGO starts one conversion per period; DMA1 channel 1 writes the
+ * results into 'buf' (circular, 'len' samples, even) and every half is
+ * passed to ADC_StreamBlock() (see ADC_Stream.h). The CPU is not
+ * involved per sample and SysTick is not used.
+ *
+ * ADC_StreamStart() picks the timer prescaler/reload for rateHz
+ * (ADC_STREAM_MIN_HZ .. ADC_STREAM_MAX_HZ) and the longest sampling
+ * time that fits, and returns the rate actually reached, or 0 if the
+ * rate or buffer is not usable. Choose 'len' so a half fills in a
+ * sensible time: at 1 Hz a 256-sample buffer gives one block every
+ * 128 s. ADC_StreamStop() goes back to the single-conversion setup.
+ *
+ * Needs, in stm32f0xx_it.c:
+ *   DMA1_Channel1_IRQHandler -> ADC_DMA_IRQHandler()
+ */
+uint32_t ADC_StreamStart(uint16_t *buf, uint16_t len, uint32_t rateHz);
+void     ADC_StreamStop(void);
+uint8_t  ADC_StreamRunning(void);
+uint32_t ADC_StreamRate(void);
+void     ADC_StreamGetStats(ADCStreamStats *stats);
+void     ADC_DMA_IRQHandler(void);
+
+/*
+ * Scan mode
+ * ---------
+ * Same as streaming, but every trigger converts all SCAN_CH() channels
+ * in 'channels' (ascending order, see Scan.h), so 'buf' fills with
+ * frames and 'len' must be a multiple of twice the channel count. The
+ * sampling time fits the whole frame into a trigger period, and is at
+ * least 71.5 cycles when VREFINT or the temperature sensor is scanned;
+ * both are switched on here. ADC_StreamStart() is a scan of the CubeMX
+ * channel. ADC_ScanConfigure() fills a ScanConfig with the factory
+ * calibration for Scan_Init().
+ */
+uint32_t ADC_ScanStart(uint16_t *buf, uint16_t len, uint32_t rateHz, uint32_t channels);
+void     ADC_ScanConfigure(ScanConfig *cfg, uint32_t channels, uint32_t absolute);
+
+/* Index in buf the DMA writes next (0..len-1) */
+uint16_t ADC_StreamPosition(void);
+
+/*
+ * Changes the sample rate of a running stream without stopping it. The
+ * sampling time chosen at start stays, so only rates that allow at least
+ * that long work; returns the new rate or 0.
+ */
+uint32_t ADC_StreamSetRate(uint32_t rateHz);
+
+/* Stops the conversions at once and keeps buf as it is; interrupt-safe.
+   ADC_StreamStop() still has to follow. */
+void     ADC_StreamFreeze(void);
+
+/*
+ * Analog watchdog on the streamed channel
+ * ---------------------------------------
+ * ADC_WatchdogWindow() turns the watchdog on from the next
+ * ADC_StreamStart() on, ADC_WatchdogOff() turns it off. A sample outside
+ * low..high sets the watchdog flag. ADC_WatchdogMove() changes the
+ * window of a running stream: it holds the trigger until the scan in
+ * progress has finished, then briefly stops the conversions.
+ * ADC_WatchdogIrq() switches the interrupt on (an old flag is cleared
+ * first) or off at any time; the interrupt calls ADC_WatchdogEvent()
+ * with ADC_StreamPosition().
+ *
+ * Needs, in stm32f0xx_it.c:
+ *   ADC1_COMP_IRQHandler -> ADC_IRQHandler()
+ */
+void     ADC_WatchdogWindow(uint16_t low, uint16_t high);
+void     ADC_WatchdogOff(void);
+void     ADC_WatchdogMove(uint16_t low, uint16_t high);
+void     ADC_WatchdogIrq(uint8_t on);
+void     ADC_IRQHandler(void);
+
+/* Implemented by the application; runs in the ADC interrupt */
+void     ADC_WatchdogEvent(uint16_t writeIndex);
+
 #endif
@@ -0,0 +1,86 @@
+#include "ADC_Stream.h"
+
+/* Sampling times in ADC half-cycles (1.5 .. 239.5), by SMPR code */
+static const uint16_t sampleHalfCycles[8] = { 3, 15, 27, 57, 83, 111, 143, 479 };
+#define CONV_HALF_CYCLES  25u     // 12.5 cycles of successive approximation
+
+static const uint16_t *buffer;
+static uint16_t length;
+static uint8_t  frame;            // channels converted per trigger
+static uint8_t  expect;           // half the next interrupt should report
+static volatile uint32_t blocks;
+static volatile uint32_t late;
+
+uint8_t ADCStream_Timing(uint32_t timClk, uint32_t adcClk, uint32_t rateHz,
+                         uint8_t channels, ADCStreamTiming *t){
+  if (rateHz < ADC_STREAM_MIN_HZ || rateHz > ADC_STREAM_MAX_HZ || channels == 0u) {
+    return 0;
+  }
+
+  /* Timer period in ticks, then the smallest prescaler that fits 16 bits */
+  uint32_t ticks = (timClk + rateHz / 2u) / rateHz;
+  uint32_t psc = (ticks - 1u) / 65536u;
+  uint32_t arr = (ticks + psc / 2u) / (psc + 1u);
+  if (arr < 2u) {
+    return 0;
+  }
+  ticks = (psc + 1u) * arr;
+  uint32_t rate = (timClk + ticks / 2u) / ticks;
+
+  /* ADC half-cycles per period, keeping 1/4 spare for trigger jitter,
+     shared by the channels of one trigger */
+  uint32_t budget = (2u * adcClk / rate) * 3u / 4u / channels;
+  int8_t k = 7;
+  while (k >= 0 && sampleHalfCycles[k] + CONV_HALF_CYCLES > budget) {
+    k--;
+  }
+  if (k < 0) {
+    return 0;
+  }
+
+  t->psc        = (uint16_t)psc;
+  t->arr        = (uint16_t)(arr - 1u);
+  t->sampleTime = (uint8_t)k;
+  t->rateHz     = rate;
+  return 1;
+}
+
+void ADCStream_Reset(const uint16_t *buf, uint16_t len, uint8_t channels){
+  buffer = buf;
+  length = len;
+  frame = channels;
+  expect = 0;
+  blocks = 0;
+  late = 0;
+}
+
+void ADCStream_Done(uint8_t half, const volatile uint32_t *remaining){
+  uint16_t n = length / 2u;
+
+  if (half != expect) {
+    late++;                      // a whole half went by unseen
+  }
+  expect = half ^ 1u;
+  blocks++;
+
+  ADC_StreamBlock(buffer + half * n, n);
+
+  /* The DMA should still be filling the other half */
+  uint32_t w = length - *remaining;
+  if ((w >= n) == (half != 0u)) {
+    late++;
+  }
+}
+
+uint16_t ADCStream_Latest(uint32_t remaining){
+  uint32_t w = length - remaining;   // index the DMA writes next
+
+  /* First channel of the newest complete frame */
+  w -= w % frame;
+  return buffer[(w == 0u ? length : w) - frame];
+}
+
+void ADCStream_GetStats(ADCStreamStats *stats){
+  stats->blocks = blocks;
+  stats->late   = late;
+}
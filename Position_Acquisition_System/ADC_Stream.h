@@ -0,0 +1,64 @@
+#ifndef __ADC_STREAM_H__
+#define __ADC_STREAM_H__
+
+#include <stdint.h>
+
+/*
+ * Buffer and timing logic of the ADC stream (ADC_Driver.c does the HAL
+ * side). No HAL in here, so it also builds on a PC and can be fed
+ * synthetic samples.
+ *
+ * The DMA fills a circular buffer of 'len' samples. Each half-transfer
+ * and transfer-complete interrupt hands one half (len/2 samples) to
+ * ADC_StreamBlock(), which the application implements. While the
+ * application works on one half the DMA fills the other, so a block
+ * must be done within len/2 sample periods; blocks that took longer,
+ * or were skipped, are counted as 'late'.
+ *
+ * With several channels per trigger (a scan) the buffer holds whole
+ * frames, one sample per channel, so len/2 must be a multiple of the
+ * channel count.
+ */
+
+#define ADC_STREAM_MIN_HZ  1u
+#define ADC_STREAM_MAX_HZ  500000u   // 7.5-cycle sampling at 14 MHz still fits
+
+typedef struct {
+  uint32_t rateHz;       // rate actually reached
+  uint16_t psc;          // timer prescaler register
+  uint16_t arr;          // timer auto-reload register
+  uint8_t  sampleTime;   // ADC SMPR code, 0 (1.5 cycles) .. 7 (239.5 cycles)
+} ADCStreamTiming;
+
+typedef struct {
+  uint32_t blocks;       // blocks handed to ADC_StreamBlock()
+  uint32_t late;         // blocks partly overwritten or skipped
+} ADCStreamStats;
+
+/*
+ * Timer settings for 'rateHz' triggers from a timer clocked at timClk,
+ * and the longest ADC sampling time at which 'channels' conversions per
+ * trigger still leave a quarter of the period spare. Returns 0 if the
+ * rate is out of range.
+ */
+uint8_t  ADCStream_Timing(uint32_t timClk, uint32_t adcClk, uint32_t rateHz,
+                          uint8_t channels, ADCStreamTiming *t);
+
+void     ADCStream_Reset(const uint16_t *buf, uint16_t len, uint8_t channels);
+
+/*
+ * Half 'half' (0 = first, 1 = second) is full. 'remaining' is the DMA
+ * transfer counter (CNDTR); it is read again after the block was
+ * handled to see whether the DMA has come round already.
+ */
+void     ADCStream_Done(uint8_t half, const volatile uint32_t *remaining);
+
+/* First channel of the newest complete frame, 'remaining' as above */
+uint16_t ADCStream_Latest(uint32_t remaining);
+
+void     ADCStream_GetStats(ADCStreamStats *stats);
+
+/* Implemented by the application; runs in the DMA interrupt */
+void     ADC_StreamBlock(const uint16_t *block, uint16_t count);
+
+#endif /* __ADC_STREAM_H__ */
@@ -0,0 +1,130 @@
+#include "Acq.h"
+#include "SampleRing.h"
+
+#define FILT_BUF_LEN  129u     // outputs of one block: (n >> osLog2) + 1
+
+static AcqConfig cfg;
+static uint8_t  osLog2;
+static uint8_t  extraBits;             // filter output bits above 12
+static uint16_t filtBuf[FILT_BUF_LEN];
+
+static volatile uint8_t idle = 0;
+static uint32_t rawIndex;              // full-rate samples since the start
+static uint16_t ref;                   // value the "still" count refers to
+static uint16_t still;
+static uint8_t  haveRef;
+static uint32_t shown;                 // last position on the display
+static int32_t  shownVel;
+static uint8_t  haveShown;
+
+static volatile uint32_t wakeups, conversions, redraws, motions;
+
+uint8_t Acq_Init(const AcqConfig *c, const FilterConfig *filterCfg,
+                 const TrackConfig *trackCfg){
+  cfg = *c;
+  if (cfg.idleDiv == 0u) {
+    cfg.idleDiv = 1u;
+  }
+  if (!Filter_Init(filterCfg) ||
+      !Track_Init(trackCfg, Filter_Bits(), filterCfg->osLog2)) {
+    return 0;
+  }
+  osLog2 = filterCfg->osLog2;
+  extraBits = (uint8_t)(Filter_Bits() - FILTER_IN_BITS);
+  SampleRing_Init();
+
+  idle = 0;
+  rawIndex = 0;
+  still = 0;
+  haveRef = 0;
+  haveShown = 0;
+  wakeups = 0;
+  conversions = 0;
+  redraws = 0;
+  motions = 0;
+  return 1;
+}
+
+static void goIdle(void){
+  uint16_t centre = (uint16_t)(ref >> extraBits);
+  uint16_t low  = (centre > cfg.window) ? (uint16_t)(centre - cfg.window) : 0u;
+  uint16_t high = (centre + cfg.window < 4095u) ? (uint16_t)(centre + cfg.window) : 4095u;
+
+  idle = 1;
+  Track_Hold();
+  Acq_HwSleep(low, high);
+}
+
+void Acq_Block(const uint16_t *block, uint16_t n){
+  conversions += n;
+
+  if (idle) {
+    rawIndex += (uint32_t)n * cfg.idleDiv;
+    return;
+  }
+
+  rawIndex += n;
+  if (n > (uint16_t)((FILT_BUF_LEN - 1u) << osLog2)) {
+    n = (uint16_t)((FILT_BUF_LEN - 1u) << osLog2);   // more than filtBuf holds
+  }
+  uint16_t m = Filter_Process(block, n, filtBuf);
+
+  for (uint16_t i = 0; i < m; i++) {
+    uint16_t v = filtBuf[i];
+
+    /* With the block a multiple of 2^osLog2, output i ends its window
+       (m - 1 - i) windows before the end of the block */
+    uint32_t t = rawIndex - 1u - ((uint32_t)(m - 1u - i) << osLog2);
+    SampleRing_Put(t, v);
+    Track_Update(v, t);
+
+    uint16_t d = (v > ref) ? (uint16_t)(v - ref) : (uint16_t)(ref - v);
+    if (!haveRef || d > cfg.deadband) {
+      ref = v;
+      haveRef = 1;
+      still = 0;
+    } else if (still < 0xFFFFu) {
+      still++;
+    }
+  }
+
+  if (cfg.mode == ACQ_EVENT && haveRef && still >= cfg.settle) {
+    goIdle();
+  }
+}
+
+void Acq_Watchdog(void){
+  if (!idle) {
+    return;
+  }
+  idle = 0;
+  still = 0;
+  motions++;
+  Acq_HwWake();
+}
+
+uint8_t Acq_Idle(void){
+  return idle;
+}
+
+void Acq_Wakeup(void){
+  wakeups++;
+}
+
+uint8_t Acq_Redraw(uint32_t pos, int32_t vel){
+  if (cfg.mode == ACQ_EVENT && haveShown && pos == shown && vel == shownVel) {
+    return 0;
+  }
+  shown = pos;
+  shownVel = vel;
+  haveShown = 1;
+  redraws++;
+  return 1;
+}
+
+void Acq_GetStats(AcqStats *stats){
+  stats->wakeups     = wakeups;
+  stats->conversions = conversions;
+  stats->redraws     = redraws;
+  stats->motions     = motions;
+}
@@ -0,0 +1,77 @@
+#ifndef __ACQ_H__
+#define __ACQ_H__
+
+#include <stdint.h>
+#include "Filter.h"
+#include "Track.h"
+
+/*
+ * Position acquisition: ADC stream blocks -> Filter -> SampleRing and
+ * Track, in one of two modes. No HAL in here; the hardware is reached through
+ * the Acq_Hw...() hooks, so it also runs on a PC against a simulated
+ * ADC.
+ *
+ * ACQ_PERIODIC  every block is filtered and queued, and the display
+ *               redraws every time (the original behaviour).
+ * ACQ_EVENT     once the filtered value has stayed within 'deadband'
+ *               for 'settle' outputs, Acq_HwSleep() drops the sample
+ *               rate by 'idleDiv' and arms the ADC analog watchdog on
+ *               'window' raw counts either side of that value. Blocks
+ *               are then only counted. The first sample outside the
+ *               window calls Acq_Watchdog(), which restores the full
+ *               rate (Acq_HwWake()). The display redraws only when the
+ *               shown value changes.
+ *
+ * Counters (AcqStats) for comparing the modes:
+ *   wakeups      returns from WFE/WFI in the main loop (Acq_Wakeup())
+ *   conversions  ADC samples taken
+ *   redraws      LCD updates (Acq_Redraw() returning 1)
+ *   motions      watchdog wake-ups
+ * Sample times in the ring are raw sample indexes at the full rate;
+ * idle blocks advance them by idleDiv per sample.
+ *
+ * Every filtered value also updates the tracker (Track.h) with the same
+ * time, so it runs at the filter output rate; going idle holds it at
+ * rest, and the first value after waking restarts it.
+ */
+
+#define ACQ_PERIODIC  0u
+#define ACQ_EVENT     1u
+
+typedef struct {
+  uint8_t  mode;       // ACQ_PERIODIC / ACQ_EVENT
+  uint16_t window;     // raw counts either side of the idle value
+  uint16_t deadband;   // filtered counts that still count as "still"
+  uint16_t settle;     // still filtered outputs before going idle
+  uint16_t idleDiv;    // full rate / idle rate
+} AcqConfig;
+
+typedef struct {
+  uint32_t wakeups;
+  uint32_t conversions;
+  uint32_t redraws;
+  uint32_t motions;
+} AcqStats;
+
+/*
+ * Also sets up the filter and the tracker and empties the sample ring.
+ * Returns 0 if the filter or tracker configuration is out of range.
+ */
+uint8_t  Acq_Init(const AcqConfig *cfg, const FilterConfig *filterCfg,
+                  const TrackConfig *trackCfg);
+
+/* Interrupt side */
+void     Acq_Block(const uint16_t *block, uint16_t n);   // DMA block
+void     Acq_Watchdog(void);                             // analog watchdog
+
+/* Main loop side */
+uint8_t  Acq_Idle(void);
+void     Acq_Wakeup(void);
+uint8_t  Acq_Redraw(uint32_t pos, int32_t vel);   // 1 if the display should show them
+void     Acq_GetStats(AcqStats *stats);
+
+/* Implemented by the application */
+void     Acq_HwSleep(uint16_t low, uint16_t high);   // slow rate, watchdog on low..high
+void     Acq_HwWake(void);                           // full rate, watchdog off
+
+#endif /* __ACQ_H__ */
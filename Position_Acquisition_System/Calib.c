@@ -0,0 +1,135 @@
+#include "Calib.h"
+
+#define LUT_SIZE  (1u << CALIB_LUT_BITS)
+
+static uint16_t xs[CALIB_MAX_POINTS];
+static int32_t  ys[CALIB_MAX_POINTS];
+static int32_t  slope[CALIB_MAX_POINTS];   // segment i: position per sample, Q(q)
+static uint8_t  q = 16;                    // slope fraction bits
+static uint8_t  segs = 0;                  // segments (points - 1)
+static uint8_t  lutShift;
+static uint8_t  lut[LUT_SIZE];             // first segment that can hold a bucket
+
+void Calib_Default(CalibPoints *p, uint16_t fullScale, uint8_t bits, uint16_t posMax){
+  p->count = 0;
+  p->bits = bits;
+  Calib_AddPoint(p, 0, 0);
+  Calib_AddPoint(p, fullScale, posMax);
+}
+
+uint8_t Calib_AddPoint(CalibPoints *p, uint16_t sample, uint16_t pos){
+  if (p->count >= CALIB_MAX_POINTS) {
+    return 0;
+  }
+  p->sample[p->count] = sample;
+  p->pos[p->count] = pos;
+  p->count++;
+  return 1;
+}
+
+uint8_t Calib_Build(CalibPoints *p){
+  uint8_t n = p->count;
+
+  if (n < 2u || n > CALIB_MAX_POINTS) {
+    return 0;
+  }
+
+  /* Sort by sample (insertion sort, a handful of points) */
+  for (uint8_t i = 1; i < n; i++) {
+    uint16_t s = p->sample[i], y = p->pos[i];
+    uint8_t j = i;
+    while (j > 0u && p->sample[j - 1u] > s) {
+      p->sample[j] = p->sample[j - 1u];
+      p->pos[j] = p->pos[j - 1u];
+      j--;
+    }
+    p->sample[j] = s;
+    p->pos[j] = y;
+  }
+  for (uint8_t i = 0; i < n; i++) {
+    if ((i > 0u && p->sample[i] == p->sample[i - 1u]) || p->pos[i] > CALIB_MAX_POS) {
+      return 0;
+    }
+  }
+
+  for (uint8_t i = 0; i < n; i++) {
+    xs[i] = p->sample[i];
+    ys[i] = p->pos[i];
+  }
+  /* As many slope fraction bits as the steepest rise allows: dx * slope
+     is at most |dy| << q (plus rounding) and has to stay below 2^31 */
+  uint32_t maxDy = 0;
+  for (uint8_t i = 0; i + 1u < n; i++) {
+    int32_t dy = ys[i + 1u] - ys[i];
+    uint32_t a = (uint32_t)(dy < 0 ? -dy : dy);
+    if (a > maxDy) {
+      maxDy = a;
+    }
+  }
+  q = 16;
+  while (q < 24u && maxDy + 1u <= (0x7FFF0000u >> (q + 1u))) {
+    q++;
+  }
+
+  for (uint8_t i = 0; i + 1u < n; i++) {
+    int32_t dy = ys[i + 1u] - ys[i];
+    int32_t dx = xs[i + 1u] - xs[i];
+    int32_t r = (dy < 0) ? -(dx / 2) : dx / 2;   // round to nearest
+    slope[i] = (int32_t)(((int64_t)dy * (1 << q) + r) / dx);
+  }
+  segs = (uint8_t)(n - 1u);
+
+  /* Smallest shift that maps the last point into LUT_SIZE buckets */
+  lutShift = 0;
+  while (((uint32_t)xs[n - 1u] >> lutShift) >= LUT_SIZE) {
+    lutShift++;
+  }
+  uint8_t s = 0;
+  for (uint32_t b = 0; b < LUT_SIZE; b++) {
+    while (s + 1u < segs && xs[s + 1u] <= (b << lutShift)) {
+      s++;
+    }
+    lut[b] = s;
+  }
+  return 1;
+}
+
+/* Segment holding 'sample', which is inside xs[0]..xs[segs] */
+static uint8_t segment(uint16_t sample){
+  uint32_t b = (uint32_t)sample >> lutShift;
+  uint8_t s = lut[b < LUT_SIZE ? b : LUT_SIZE - 1u];
+  while (sample >= xs[s + 1u]) {     // a breakpoint inside this bucket
+    s++;
+  }
+  return s;
+}
+
+uint16_t Calib_Position(uint16_t sample){
+  if (sample <= xs[0]) {
+    return (uint16_t)ys[0];
+  }
+  if (sample >= xs[segs]) {
+    return (uint16_t)ys[segs];
+  }
+
+  uint8_t s = segment(sample);
+  int32_t dx = sample - xs[s];
+  return (uint16_t)(ys[s] + ((dx * slope[s] + (1 << (q - 1u))) >> q));
+}
+
+int32_t Calib_Delta(uint16_t sample, int32_t delta){
+  uint8_t s;
+
+  if (sample < xs[0]) {
+    s = 0;
+  } else if (sample >= xs[segs]) {
+    s = (uint8_t)(segs - 1u);
+  } else {
+    s = segment(sample);
+  }
+  int64_t d = ((int64_t)delta * slope[s] + (1 << (q - 1u))) >> q;
+  if (d > INT32_MAX) {              // steep segment, large delta
+    return INT32_MAX;
+  }
+  return (d < INT32_MIN) ? INT32_MIN : (int32_t)d;
+}
@@ -0,0 +1,55 @@
+#ifndef __CALIB_H__
+#define __CALIB_H__
+
+#include <stdint.h>
+
+/*
+ * Piecewise-linear sample -> position conversion. No HAL, so it also
+ * builds on a PC.
+ *
+ * Calibration is a list of up to CALIB_MAX_POINTS reference points
+ * (filtered sample, position in 0.001 cm). Calib_Build() sorts them and
+ * precomputes, per segment, the slope dy/dx in fixed point (the reciprocal of
+ * the segment width, times its height), plus a small table that maps
+ * the top bits of a sample to its segment. Calib_Position() then costs
+ * one table lookup, at most a compare or two, and one multiply-shift;
+ * the divides all happen in Calib_Build(). Samples outside the
+ * calibrated range clamp to the end points.
+ */
+
+#define CALIB_MAX_POINTS  9u
+#define CALIB_MAX_POS     32767     // keeps dx * slope inside 31 bits
+#define CALIB_LUT_BITS    6u        // 64 buckets over the sample range
+
+typedef struct {
+  uint16_t sample[CALIB_MAX_POINTS];   // filtered ADC value
+  uint16_t pos[CALIB_MAX_POINTS];      // 0.001 cm
+  uint8_t  count;
+  uint8_t  bits;                       // filter output bits the samples are in
+} CalibPoints;
+
+/* Two points: 0 -> 0.000 cm, fullScale -> posMax (the old linear map) */
+void     Calib_Default(CalibPoints *p, uint16_t fullScale, uint8_t bits, uint16_t posMax);
+
+/* Adds a point; returns 0 when full */
+uint8_t  Calib_AddPoint(CalibPoints *p, uint16_t sample, uint16_t pos);
+
+/*
+ * Builds the conversion tables from p (p is sorted in place). Returns 0
+ * and keeps the old tables if there are fewer than two points, two
+ * share a sample, or a position is above CALIB_MAX_POS.
+ */
+uint8_t  Calib_Build(CalibPoints *p);
+
+/* Filtered sample -> position in 0.001 cm */
+uint16_t Calib_Position(uint16_t sample);
+
+/*
+ * A change of 'delta' samples at 'sample' in 0.001 cm, by the slope of
+ * the segment there (the end segments outside the calibrated range).
+ * Both in the same fixed point, e.g. Q16 velocities from Track.h.
+ * Saturates at the int32_t limits.
+ */
+int32_t  Calib_Delta(uint16_t sample, int32_t delta);
+
+#endif /* __CALIB_H__ */
@@ -0,0 +1,69 @@
+#include "CalibStore.h"
+#include <string.h>
+
+#define CALIB_MAGIC  0xCA1Bu
+
+typedef struct {
+  uint16_t    magic;
+  uint16_t    crc;             // CRC-16/CCITT over 'points'
+  CalibPoints points;
+} CalibRecord;
+
+/* Whole halfwords, as flash is programmed 16 bits at a time */
+#define RECORD_HALFWORDS  ((sizeof(CalibRecord) + 1u) / 2u)
+
+static uint16_t crc16(const uint8_t *d, uint32_t n){
+  uint16_t crc = 0xFFFFu;
+  while (n--) {
+    crc ^= (uint16_t)(*d++ << 8);
+    for (uint8_t b = 0; b < 8u; b++) {
+      crc = (crc & 0x8000u) ? (uint16_t)((crc << 1) ^ 0x1021u) : (uint16_t)(crc << 1);
+    }
+  }
+  return crc;
+}
+
+uint8_t CalibStore_Load(CalibPoints *p){
+  const CalibRecord *rec = (const CalibRecord *)CALIB_FLASH_ADDR;
+
+  if (rec->magic != CALIB_MAGIC ||
+      rec->crc != crc16((const uint8_t *)&rec->points, sizeof(CalibPoints)) ||
+      rec->points.count > CALIB_MAX_POINTS) {
+    return 0;
+  }
+  *p = rec->points;
+  return 1;
+}
+
+uint8_t CalibStore_Save(const CalibPoints *p){
+  uint16_t buf[RECORD_HALFWORDS];
+  CalibRecord rec;
+  FLASH_EraseInitTypeDef erase = {0};
+  uint32_t pageError = 0;
+  uint8_t ok = 1;
+
+  memset(&rec, 0, sizeof(rec));
+  rec.magic  = CALIB_MAGIC;
+  rec.points = *p;
+  rec.crc    = crc16((const uint8_t *)&rec.points, sizeof(CalibPoints));
+  memset(buf, 0xFF, sizeof(buf));
+  memcpy(buf, &rec, sizeof(rec));
+
+  erase.TypeErase   = FLASH_TYPEERASE_PAGES;
+  erase.PageAddress = CALIB_FLASH_ADDR;
+  erase.NbPages     = 1;
+
+  HAL_FLASH_Unlock();
+  if (HAL_FLASHEx_Erase(&erase, &pageError) != HAL_OK) {
+    ok = 0;
+  }
+  for (uint32_t i = 0; ok && i < RECORD_HALFWORDS; i++) {
+    if (HAL_FLASH_Program(FLASH_TYPEPROGRAM_HALFWORD,
+                          CALIB_FLASH_ADDR + 2u * i, buf[i]) != HAL_OK) {
+      ok = 0;
+    }
+  }
+  HAL_FLASH_Lock();
+
+  return ok && memcmp((const void *)CALIB_FLASH_ADDR, buf, sizeof(rec)) == 0;
+}
@@ -0,0 +1,23 @@
+#ifndef __CALIB_STORE_H__
+#define __CALIB_STORE_H__
+
+#include "stm32f0xx_hal.h"
+#include <stdint.h>
+#include "Calib.h"
+
+/*
+ * Keeps the calibration points in the last 1 KB flash page of the
+ * STM32F051R8 (0x0800FC00). The linker script must leave that page out
+ * of FLASH (LENGTH = 63K). The record has a magic word and a CRC, so a
+ * blank or half-written page is ignored.
+ */
+
+#define CALIB_FLASH_ADDR  0x0800FC00u
+
+/* Returns 1 and fills p if a valid record is stored */
+uint8_t CalibStore_Load(CalibPoints *p);
+
+/* Erases the page and writes p; returns 1 if it reads back correctly */
+uint8_t CalibStore_Save(const CalibPoints *p);
+
+#endif /* __CALIB_STORE_H__ */
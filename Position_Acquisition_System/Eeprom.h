@@ -0,0 +1,67 @@
+#ifndef __EEPROM_H__
+#define __EEPROM_H__
+
+#include <stdint.h>
+
+/*
+ * Page-write EEPROM used by Log.c.
+ *
+ * Exactly one implementation is compiled, chosen by EEPROM_BACKEND:
+ *   Eeprom_25AA040A.c : Microchip 25AA040A (512 x 8, 16-byte pages) on
+ *                       SPI1: PB3 = SCK, PB4 = MISO (SO), PB5 = MOSI
+ *                       (SI), PB6 = CS#. WP# and HOLD# tied high.
+ *                       Page data goes out by DMA1 Channel 3; the
+ *                       write cycle (5 ms max) is then WIP-polled.
+ *   Eeprom_Ram.c      : the same device in RAM, for a board without
+ *                       the chip and for tools/log_sim.c on a PC. It
+ *                       can cut a write short to model a power failure.
+ *
+ * Eeprom_WritePage() only starts a write; Eeprom_Busy() moves it along
+ * and must be called until it returns 0. Nothing here waits for the
+ * device, except Eeprom_Read(), which is meant for start-up.
+ */
+
+#define EEPROM_BACKEND_25AA040A  0
+#define EEPROM_BACKEND_RAM       1
+
+#ifndef EEPROM_BACKEND
+#define EEPROM_BACKEND       EEPROM_BACKEND_25AA040A
+#endif
+
+#define EEPROM_SIZE          512u
+#define EEPROM_PAGE          16u
+
+void    Eeprom_Init(void);
+
+/* Blocking sequential read; no write may be in progress */
+void    Eeprom_Read(uint16_t addr, uint8_t *buf, uint16_t n);
+
+/*
+ * Starts writing EEPROM_PAGE bytes at the page-aligned 'addr'. 'data'
+ * is copied, so it may be reused at once. Returns 0 if a write is
+ * still in progress.
+ */
+uint8_t Eeprom_WritePage(uint16_t addr, const uint8_t *data);
+
+/* 1 while a write is in progress (transfer or write cycle) */
+uint8_t Eeprom_Busy(void);
+
+#if EEPROM_BACKEND == EEPROM_BACKEND_RAM
+typedef struct {
+  uint32_t pageWrites;     // completed or cut short
+  uint32_t pageCycles[EEPROM_SIZE / EEPROM_PAGE];   // writes per page (wear)
+} EepromRamStats;
+
+/* The array itself, erased (0xFF) by Eeprom_Init() */
+uint8_t *Eeprom_RamImage(void);
+
+/*
+ * Power fails during the write in progress: only its first 'keep'
+ * bytes reach the array. Nothing happens when no write is in progress.
+ */
+void    Eeprom_RamPowerFail(uint8_t keep);
+
+void    Eeprom_RamGetStats(EepromRamStats *stats);
+#endif
+
+#endif /* __EEPROM_H__ */
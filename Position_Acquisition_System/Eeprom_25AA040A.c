@@ -0,0 +1,184 @@
+#include "Eeprom.h"
+
+#if EEPROM_BACKEND == EEPROM_BACKEND_25AA040A
+
+#include "main.h"
+
+/*
+ * 25AA040A on SPI1, mode 0 at PCLK/2 = 4 MHz (5 MHz max at 3.3 V).
+ *
+ * A page write is a small state machine, moved along by Eeprom_Busy():
+ *   W_DATA  CS# low, WREN and WRITE + address sent by hand (3 bytes),
+ *           then the 16 data bytes by DMA1 Channel 3. Once the DMA and
+ *           the SPI are done, CS# goes high, which starts the write
+ *           cycle.
+ *   W_WIP   every poll reads the status register (2 bytes, ~4 us) and
+ *           finishes when WIP clears.
+ * RX is not DMA'd; the FIFO overruns during the page and is emptied
+ * afterwards. The 9th address bit goes in bit 3 of the instruction.
+ */
+
+#define CS_PORT     GPIOB
+#define CS_PIN      GPIO_PIN_6
+
+#define CMD_READ    0x03u
+#define CMD_WRITE   0x02u
+#define CMD_RDSR    0x05u
+#define CMD_WREN    0x06u
+#define SR_WIP      0x01u
+#define A8(addr)    ((uint8_t)(((addr) >> 5) & 0x08u))
+
+#define W_IDLE      0u
+#define W_DATA      1u
+#define W_WIP       2u
+
+SPI_HandleTypeDef hspi1;
+static DMA_HandleTypeDef hdma_spi1_tx;
+
+static uint8_t page[EEPROM_PAGE];
+static volatile uint8_t state = W_IDLE;
+
+#define SPI_DR8  (*(__IO uint8_t *)&SPI1->DR)   // byte access, no packing
+
+static inline void csLow(void)  { CS_PORT->BRR  = CS_PIN; }
+static inline void csHigh(void) { CS_PORT->BSRR = CS_PIN; }
+
+static uint8_t xfer(uint8_t b){
+  while (!(SPI1->SR & SPI_SR_TXE)) {}
+  SPI_DR8 = b;
+  while (!(SPI1->SR & SPI_SR_RXNE)) {}
+  return SPI_DR8;
+}
+
+/* Wait for the last bit, then drop whatever the RX FIFO kept */
+static void drain(void){
+  while (SPI1->SR & (SPI_SR_FTLVL | SPI_SR_BSY)) {}
+  while (SPI1->SR & SPI_SR_FRLVL) {
+    (void)SPI_DR8;
+  }
+  (void)SPI1->SR;                        // DR then SR read clears OVR
+}
+
+void Eeprom_Init(void){
+  GPIO_InitTypeDef GPIO_InitStruct = {0};
+
+  __HAL_RCC_GPIOB_CLK_ENABLE();
+  __HAL_RCC_SPI1_CLK_ENABLE();
+  __HAL_RCC_DMA1_CLK_ENABLE();
+
+  /* PB6 = CS#, idle high */
+  csHigh();
+  GPIO_InitStruct.Pin = CS_PIN;
+  GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
+  GPIO_InitStruct.Pull = GPIO_NOPULL;
+  GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH;
+  HAL_GPIO_Init(CS_PORT, &GPIO_InitStruct);
+
+  /* PB3 = SPI1_SCK, PB4 = SPI1_MISO, PB5 = SPI1_MOSI */
+  GPIO_InitStruct.Pin = GPIO_PIN_3 | GPIO_PIN_4 | GPIO_PIN_5;
+  GPIO_InitStruct.Mode = GPIO_MODE_AF_PP;
+  GPIO_InitStruct.Alternate = GPIO_AF0_SPI1;
+  HAL_GPIO_Init(GPIOB, &GPIO_InitStruct);
+
+  hspi1.Instance = SPI1;
+  hspi1.Init.Mode = SPI_MODE_MASTER;
+  hspi1.Init.Direction = SPI_DIRECTION_2LINES;
+  hspi1.Init.DataSize = SPI_DATASIZE_8BIT;
+  hspi1.Init.CLKPolarity = SPI_POLARITY_LOW;
+  hspi1.Init.CLKPhase = SPI_PHASE_1EDGE;
+  hspi1.Init.NSS = SPI_NSS_SOFT;
+  hspi1.Init.BaudRatePrescaler = SPI_BAUDRATEPRESCALER_2;
+  hspi1.Init.FirstBit = SPI_FIRSTBIT_MSB;
+  hspi1.Init.TIMode = SPI_TIMODE_DISABLE;
+  hspi1.Init.CRCCalculation = SPI_CRCCALCULATION_DISABLE;
+  hspi1.Init.CRCPolynomial = 7;
+  hspi1.Init.CRCLength = SPI_CRC_LENGTH_DATASIZE;
+  hspi1.Init.NSSPMode = SPI_NSS_PULSE_DISABLE;
+  if (HAL_SPI_Init(&hspi1) != HAL_OK) {
+    Error_Handler();
+  }
+
+  /* SPI1_TX: DMA1 Channel 3, bytes, no interrupt (polled TC flag) */
+  hdma_spi1_tx.Instance = DMA1_Channel3;
+  hdma_spi1_tx.Init.Direction = DMA_MEMORY_TO_PERIPH;
+  hdma_spi1_tx.Init.PeriphInc = DMA_PINC_DISABLE;
+  hdma_spi1_tx.Init.MemInc = DMA_MINC_ENABLE;
+  hdma_spi1_tx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+  hdma_spi1_tx.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+  hdma_spi1_tx.Init.Mode = DMA_NORMAL;
+  hdma_spi1_tx.Init.Priority = DMA_PRIORITY_LOW;   // the ADC stream goes first
+  if (HAL_DMA_Init(&hdma_spi1_tx) != HAL_OK) {
+    Error_Handler();
+  }
+  __HAL_LINKDMA(&hspi1, hdmatx, hdma_spi1_tx);
+  DMA1_Channel3->CPAR = (uint32_t)&SPI1->DR;
+  __HAL_SPI_ENABLE(&hspi1);
+
+  /* A write cut short by a reset may still be running */
+  state = W_WIP;
+  while (Eeprom_Busy()) {}
+}
+
+void Eeprom_Read(uint16_t addr, uint8_t *buf, uint16_t n){
+  csLow();
+  xfer((uint8_t)(CMD_READ | A8(addr)));
+  xfer((uint8_t)addr);
+  while (n--) {
+    *buf++ = xfer(0xFFu);
+  }
+  csHigh();
+}
+
+uint8_t Eeprom_WritePage(uint16_t addr, const uint8_t *data){
+  if (state != W_IDLE) {
+    return 0;
+  }
+  for (uint8_t i = 0; i < EEPROM_PAGE; i++) {
+    page[i] = data[i];
+  }
+
+  csLow();
+  xfer(CMD_WREN);
+  csHigh();                              // WREN only latches on CS# high
+
+  csLow();
+  xfer((uint8_t)(CMD_WRITE | A8(addr)));
+  xfer((uint8_t)addr);
+
+  DMA1->IFCR = DMA_IFCR_CGIF3;
+  DMA1_Channel3->CCR  &= ~DMA_CCR_EN;
+  DMA1_Channel3->CMAR  = (uint32_t)page;
+  DMA1_Channel3->CNDTR = EEPROM_PAGE;
+  SPI1->CR2 |= SPI_CR2_TXDMAEN;
+  DMA1_Channel3->CCR  |= DMA_CCR_EN;
+  state = W_DATA;
+  return 1;
+}
+
+uint8_t Eeprom_Busy(void){
+  if (state == W_DATA) {
+    if (!(DMA1->ISR & DMA_ISR_TCIF3)) {
+      return 1;
+    }
+    drain();
+    DMA1_Channel3->CCR &= ~DMA_CCR_EN;
+    SPI1->CR2 &= ~SPI_CR2_TXDMAEN;
+    DMA1->IFCR = DMA_IFCR_CGIF3;
+    csHigh();                            // starts the write cycle
+    state = W_WIP;
+    return 1;
+  }
+
+  if (state == W_WIP) {
+    csLow();
+    xfer(CMD_RDSR);
+    uint8_t sr = xfer(0xFFu);
+    csHigh();
+    if (!(sr & SR_WIP)) {
+      state = W_IDLE;
+    }
+  }
+  return state != W_IDLE;
+}
+
+#endif /* EEPROM_BACKEND == EEPROM_BACKEND_25AA040A */
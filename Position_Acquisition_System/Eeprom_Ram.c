@@ -0,0 +1,81 @@
+#include "Eeprom.h"
+
+#if EEPROM_BACKEND == EEPROM_BACKEND_RAM
+
+/*
+ * 25AA040A stand-in. A page write lands in the array when the write
+ * cycle ends, which here is EEPROM_RAM_CYCLE calls of Eeprom_Busy()
+ * after Eeprom_WritePage(), so callers that forget to poll hang just
+ * like on the real part.
+ */
+
+#ifndef EEPROM_RAM_CYCLE
+#define EEPROM_RAM_CYCLE  3u
+#endif
+
+static uint8_t  mem[EEPROM_SIZE];
+static uint8_t  pending[EEPROM_PAGE];
+static uint16_t pendingAddr;
+static uint8_t  cycle;                 // polls until the write is done, 0 = idle
+static EepromRamStats stats;
+
+void Eeprom_Init(void){
+  for (uint16_t i = 0; i < EEPROM_SIZE; i++) {
+    mem[i] = 0xFFu;
+  }
+  cycle = 0;
+  stats.pageWrites = 0;
+  for (uint8_t p = 0; p < EEPROM_SIZE / EEPROM_PAGE; p++) {
+    stats.pageCycles[p] = 0;
+  }
+}
+
+void Eeprom_Read(uint16_t addr, uint8_t *buf, uint16_t n){
+  while (n--) {
+    *buf++ = mem[addr++ & (EEPROM_SIZE - 1u)];   // wraps like the device
+  }
+}
+
+static void land(uint8_t keep){
+  for (uint8_t i = 0; i < keep; i++) {
+    mem[pendingAddr + i] = pending[i];
+  }
+  stats.pageWrites++;
+  stats.pageCycles[pendingAddr / EEPROM_PAGE]++;
+  cycle = 0;
+}
+
+uint8_t Eeprom_WritePage(uint16_t addr, const uint8_t *data){
+  if (cycle != 0u) {
+    return 0;
+  }
+  pendingAddr = (uint16_t)(addr & (EEPROM_SIZE - EEPROM_PAGE));
+  for (uint8_t i = 0; i < EEPROM_PAGE; i++) {
+    pending[i] = data[i];
+  }
+  cycle = EEPROM_RAM_CYCLE;
+  return 1;
+}
+
+uint8_t Eeprom_Busy(void){
+  if (cycle != 0u && --cycle == 0u) {
+    land(EEPROM_PAGE);
+  }
+  return cycle != 0u;
+}
+
+uint8_t *Eeprom_RamImage(void){
+  return mem;
+}
+
+void Eeprom_RamPowerFail(uint8_t keep){
+  if (cycle != 0u) {
+    land(keep < EEPROM_PAGE ? keep : EEPROM_PAGE);
+  }
+}
+
+void Eeprom_RamGetStats(EepromRamStats *s){
+  *s = stats;
+}
+
+#endif /* EEPROM_BACKEND == EEPROM_BACKEND_RAM */
@@ -0,0 +1,99 @@
+#include "Filter.h"
+
+#define IIR_GUARD  8u     // fraction bits kept in the IIR state
+
+static FilterConfig cfg = { 0, FILTER_NONE, 1, 3 };
+static uint8_t  shift;            // sum -> output
+static uint32_t half;             // half an output step
+static uint16_t ratioMask;
+
+static uint32_t acc;              // decimator partial sum
+static uint16_t accCount;
+static uint8_t  primed;           // stage 2 has seen an output
+
+static int32_t  iir;              // output << IIR_GUARD
+static uint16_t window[FILTER_MEDIAN_MAX];
+static uint8_t  windowPos;
+
+uint8_t Filter_Init(const FilterConfig *c){
+  if (c->osLog2 > FILTER_OS_MAX_LOG2 || c->post > FILTER_MEDIAN ||
+      (c->post == FILTER_IIR && (c->iirShift < 1u || c->iirShift > 8u)) ||
+      (c->post == FILTER_MEDIAN &&
+       (c->medianN < 3u || c->medianN > FILTER_MEDIAN_MAX || !(c->medianN & 1u)))) {
+    return 0;
+  }
+
+  cfg = *c;
+  shift = (uint8_t)(cfg.osLog2 - cfg.osLog2 / 2u);   // keep osLog2/2 extra bits
+  half = (1u << shift) >> 1;
+  ratioMask = (uint16_t)((1u << cfg.osLog2) - 1u);
+  acc = 0;
+  accCount = 0;
+  primed = 0;
+  return 1;
+}
+
+static uint16_t median(void){
+  uint16_t s[FILTER_MEDIAN_MAX];
+
+  /* Insertion sort; at most 7 entries */
+  for (uint8_t i = 0; i < cfg.medianN; i++) {
+    uint16_t v = window[i];
+    uint8_t j = i;
+    while (j > 0u && s[j - 1u] > v) {
+      s[j] = s[j - 1u];
+      j--;
+    }
+    s[j] = v;
+  }
+  return s[cfg.medianN >> 1];
+}
+
+static uint16_t post(uint16_t x){
+  if (!primed) {
+    /* Start from the first value instead of ramping up from 0 */
+    iir = (int32_t)x << IIR_GUARD;
+    for (uint8_t i = 0; i < FILTER_MEDIAN_MAX; i++) {
+      window[i] = x;
+    }
+    windowPos = 0;
+    primed = 1;
+  }
+
+  switch (cfg.post) {
+  case FILTER_IIR:
+    iir += (((int32_t)x << IIR_GUARD) - iir) >> cfg.iirShift;
+    return (uint16_t)((iir + (1 << (IIR_GUARD - 1u))) >> IIR_GUARD);
+
+  case FILTER_MEDIAN:
+    window[windowPos] = x;
+    if (++windowPos >= cfg.medianN) {
+      windowPos = 0;
+    }
+    return median();
+
+  default:
+    return x;
+  }
+}
+
+uint16_t Filter_Process(const uint16_t *in, uint16_t n, uint16_t *out){
+  uint16_t m = 0;
+
+  for (uint16_t i = 0; i < n; i++) {
+    acc += in[i];
+    if ((accCount++ & ratioMask) == ratioMask) {
+      out[m++] = post((uint16_t)((acc + half) >> shift));
+      acc = 0;
+    }
+  }
+  return m;
+}
+
+uint8_t Filter_Bits(void){
+  return (uint8_t)(FILTER_IN_BITS + cfg.osLog2 / 2u);
+}
+
+uint16_t Filter_FullScale(void){
+  return (uint16_t)(((1u << FILTER_IN_BITS) - 1u) << (cfg.osLog2 / 2u));
+}
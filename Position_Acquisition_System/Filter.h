@@ -0,0 +1,53 @@
+#ifndef __FILTER_H__
+#define __FILTER_H__
+
+#include <stdint.h>
+
+/*
+ * Fixed-point filter between the ADC stream and the display. No HAL and
+ * no divides, so it runs cheaply on the M0 and also builds on a PC.
+ *
+ * Stage 1, boxcar decimator (a first-order CIC): sums 2^osLog2 raw
+ * 12-bit samples and keeps osLog2/2 extra bits, e.g. 16x -> 14 bits.
+ * Against white noise each 4x gives one more effective bit.
+ *
+ * Stage 2, optional, on the decimated samples:
+ *   FILTER_IIR     y += (x - y) / 2^iirShift, with 8 guard bits so
+ *                  small steps are not lost to rounding
+ *   FILTER_MEDIAN  median of the last medianN outputs (3, 5 or 7);
+ *                  removes spikes without smearing steps
+ *
+ * Filter_Process() takes whole DMA blocks. The decimator carries its
+ * partial sum across calls, so the block length need not be a multiple
+ * of the ratio.
+ */
+
+#define FILTER_NONE        0u
+#define FILTER_IIR         1u
+#define FILTER_MEDIAN      2u
+
+#define FILTER_IN_BITS     12u
+#define FILTER_OS_MAX_LOG2 8u       // 256x -> 16-bit output
+#define FILTER_MEDIAN_MAX  7u
+
+typedef struct {
+  uint8_t osLog2;     // decimate by 2^osLog2 (0 = no decimation)
+  uint8_t post;       // FILTER_NONE / FILTER_IIR / FILTER_MEDIAN
+  uint8_t iirShift;   // IIR time constant, 1..8 (2^iirShift outputs)
+  uint8_t medianN;    // odd, 3..FILTER_MEDIAN_MAX
+} FilterConfig;
+
+/* Returns 0 (and keeps the old set-up) if cfg is out of range */
+uint8_t  Filter_Init(const FilterConfig *cfg);
+
+/*
+ * Filters n raw samples into out[] and returns how many outputs were
+ * written: at most (n >> osLog2) + 1.
+ */
+uint16_t Filter_Process(const uint16_t *in, uint16_t n, uint16_t *out);
+
+/* Output resolution and the output for a full-scale (4095) input */
+uint8_t  Filter_Bits(void);
+uint16_t Filter_FullScale(void);
+
+#endif /* __FILTER_H__ */
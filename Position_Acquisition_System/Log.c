@@ -0,0 +1,339 @@
+#include "Log.h"
+
+#define HDR_LEN    3u          // sequence + CRC
+#define DATA_END   (EEPROM_PAGE - 1u)   // last byte repeats the sequence
+#define DT_ESC     126u        // varint dt follows
+#define H_EVENT    0x80u
+#define H_END      0xFFu       // padding / erased
+#define REC_MAX    12u         // H + 5-byte dt + code + 3-byte value, rounded up
+
+/* Page being filled */
+static uint8_t  fill[EEPROM_PAGE];
+static uint8_t  fillLen;               // 0 = no page open
+static uint32_t fillStart;             // time of its first record
+static uint32_t prevTime;
+static uint16_t prevPos;
+
+/* Sealed pages; 'busy' while queue[tail] is in the EEPROM */
+static uint8_t  queue[LOG_QUEUE][EEPROM_PAGE];
+static uint16_t queueAddr[LOG_QUEUE];
+static uint8_t  head, tail;
+static uint8_t  busy;
+
+static uint8_t  nextPage;
+static uint8_t  nextSeq;
+static uint32_t flushAfter;
+static LogStats stats;
+
+static uint16_t crc16(const uint8_t *p){
+  uint16_t crc = 0xFFFFu;
+
+  for (uint8_t i = 0; i < EEPROM_PAGE; i++) {
+    if (i == 1u || i == 2u) {
+      continue;                        // the CRC itself
+    }
+    crc ^= (uint16_t)(p[i] << 8);
+    for (uint8_t b = 0; b < 8u; b++) {
+      crc = (crc & 0x8000u) ? (uint16_t)((crc << 1) ^ 0x1021u) : (uint16_t)(crc << 1);
+    }
+  }
+  return crc;
+}
+
+static uint8_t pageValid(const uint8_t *p){
+  uint8_t erased = 1;
+
+  for (uint8_t i = 0; i < EEPROM_PAGE; i++) {
+    if (p[i] != 0xFFu) {
+      erased = 0;
+    }
+  }
+  return !erased && p[DATA_END] == p[0] &&
+         crc16(p) == (uint16_t)(p[1] | (p[2] << 8));
+}
+
+static uint8_t putVarint(uint8_t *out, uint32_t v){
+  uint8_t n = 0;
+
+  while (v >= 0x80u) {
+    out[n++] = (uint8_t)(v | 0x80u);
+    v >>= 7;
+  }
+  out[n++] = (uint8_t)v;
+  return n;
+}
+
+/* Returns the bytes used, 0 if the varint runs past 'end' */
+static uint8_t getVarint(const uint8_t *in, const uint8_t *end, uint32_t *v){
+  uint32_t r = 0;
+  uint8_t n = 0;
+
+  do {
+    if (in + n >= end || n > 4u) {
+      return 0;
+    }
+    r |= (uint32_t)(in[n] & 0x7Fu) << (7u * n);
+  } while (in[n++] & 0x80u);
+  *v = r;
+  return n;
+}
+
+/* Record relative to (prevTime, prevPos) */
+static uint8_t encode(uint8_t *out, uint32_t time, uint8_t kind, uint16_t value){
+  uint32_t dt = (time > prevTime) ? time - prevTime : 0u;
+  uint8_t h = (kind == LOG_POS) ? 0u : H_EVENT;
+  uint8_t n = 1;
+
+  if (dt < DT_ESC) {
+    out[0] = (uint8_t)(h | dt);
+  } else {
+    out[0] = (uint8_t)(h | DT_ESC);
+    n += putVarint(out + n, dt);
+  }
+  if (kind == LOG_POS) {
+    int32_t d = (int32_t)value - (int32_t)prevPos;
+    n += putVarint(out + n, (d < 0) ? ((uint32_t)(-d) << 1) - 1u : (uint32_t)d << 1);
+  } else {
+    out[n++] = kind;
+    n += putVarint(out + n, value);
+  }
+  return n;
+}
+
+static void seal(void){
+  uint8_t *p = queue[head % LOG_QUEUE];
+
+  for (uint8_t i = fillLen; i < DATA_END; i++) {
+    fill[i] = H_END;
+  }
+  fill[0] = nextSeq;
+  fill[DATA_END] = nextSeq++;
+  uint16_t crc = crc16(fill);
+  fill[1] = (uint8_t)crc;
+  fill[2] = (uint8_t)(crc >> 8);
+
+  for (uint8_t i = 0; i < EEPROM_PAGE; i++) {
+    p[i] = fill[i];
+  }
+  queueAddr[head % LOG_QUEUE] = (uint16_t)(nextPage * EEPROM_PAGE);
+  nextPage = (uint8_t)((nextPage + 1u) % LOG_PAGES);
+  head++;
+  fillLen = 0;
+}
+
+static uint8_t queueFull(void){
+  return (uint8_t)(head - tail) >= LOG_QUEUE;
+}
+
+/* Newest valid page whose successor doesn't follow it, with the
+   longest run of predecessors behind it; -1 if there is none */
+static int8_t findNewest(const uint8_t *seq, const uint8_t *valid, uint8_t *run){
+  int8_t best = -1;
+  uint8_t bestRun = 0;
+
+  for (uint8_t i = 0; i < LOG_PAGES; i++) {
+    uint8_t nx = (uint8_t)((i + 1u) % LOG_PAGES);
+    if (!valid[i] || (valid[nx] && seq[nx] == (uint8_t)(seq[i] + 1u))) {
+      continue;
+    }
+    uint8_t n = 1;
+    uint8_t j = i;
+    while (n < LOG_PAGES) {
+      uint8_t pv = (uint8_t)((j + LOG_PAGES - 1u) % LOG_PAGES);
+      if (!valid[pv] || (uint8_t)(seq[pv] + 1u) != seq[j]) {
+        break;
+      }
+      j = pv;
+      n++;
+    }
+    if (n > bestRun) {
+      best = (int8_t)i;
+      bestRun = n;
+    }
+  }
+  *run = bestRun;
+  return best;
+}
+
+/* Sequence numbers and validity of all pages; returns the bad ones */
+static uint8_t scan(uint8_t *seq, uint8_t *valid){
+  uint8_t p[EEPROM_PAGE];
+  uint8_t bad = 0;
+
+  for (uint8_t i = 0; i < LOG_PAGES; i++) {
+    Eeprom_Read((uint16_t)(i * EEPROM_PAGE), p, EEPROM_PAGE);
+    valid[i] = pageValid(p);
+    seq[i] = p[0];
+    for (uint8_t k = 0; !valid[i] && k < EEPROM_PAGE; k++) {
+      if (p[k] != 0xFFu) {
+        bad++;                         // a cut-short write, or never ours
+        break;
+      }
+    }
+  }
+  return bad;
+}
+
+void Log_Init(uint32_t flushAge){
+  uint8_t seq[LOG_PAGES], valid[LOG_PAGES];
+  uint8_t run;
+
+  fillLen = 0;
+  head = 0;
+  tail = 0;
+  busy = 0;
+  flushAfter = flushAge;
+  stats.records = 0;
+  stats.dropped = 0;
+  stats.recordBytes = 0;
+  stats.pages = 0;
+  stats.torn = scan(seq, valid);
+
+  int8_t newest = findNewest(seq, valid, &run);
+  if (newest < 0) {
+    nextPage = 0;
+    nextSeq = 0;
+    stats.recovered = 0;
+  } else {
+    nextPage = (uint8_t)(((uint8_t)newest + 1u) % LOG_PAGES);
+    nextSeq = (uint8_t)(seq[newest] + 1u);
+    stats.recovered = run;
+  }
+}
+
+uint8_t Log_Put(uint32_t time, uint8_t kind, uint16_t value){
+  uint8_t rec[REC_MAX];
+  uint8_t n;
+
+  if (fillLen != 0u) {
+    n = encode(rec, time, kind, value);
+    if (fillLen + n > DATA_END) {
+      if (queueFull()) {
+        stats.dropped++;
+        return 0;
+      }
+      seal();
+    }
+  }
+  if (fillLen == 0u) {
+    /* New page: base time, then the record against (time, 0) */
+    fillLen = (uint8_t)(HDR_LEN + putVarint(fill + HDR_LEN, time));
+    fillStart = time;
+    prevTime = time;
+    prevPos = 0;
+    n = encode(rec, time, kind, value);
+  }
+
+  for (uint8_t i = 0; i < n; i++) {
+    fill[fillLen++] = rec[i];
+  }
+  prevTime = time;
+  if (kind == LOG_POS) {
+    prevPos = value;
+  }
+  stats.records++;
+  stats.recordBytes += n;
+  return 1;
+}
+
+void Log_Flush(void){
+  if (fillLen != 0u && !queueFull()) {
+    seal();
+  }
+}
+
+void Log_Poll(uint32_t now){
+  if (fillLen != 0u && now - fillStart >= flushAfter) {
+    Log_Flush();
+  }
+
+  if (Eeprom_Busy()) {
+    return;
+  }
+  if (busy) {
+    busy = 0;
+    tail++;
+    stats.pages++;
+  }
+  if (head != tail && Eeprom_WritePage(queueAddr[tail % LOG_QUEUE], queue[tail % LOG_QUEUE])) {
+    busy = 1;
+  }
+}
+
+uint8_t Log_Pending(void){
+  return head != tail;
+}
+
+static uint32_t walkPage(const uint8_t *p, LogVisit visit, void *ctx){
+  const uint8_t *end = p + DATA_END;
+  const uint8_t *in = p + HDR_LEN;
+  uint32_t count = 0;
+  uint32_t v;
+  uint8_t n;
+  LogRec rec;
+
+  if ((n = getVarint(in, end, &rec.time)) == 0u) {
+    return 0;
+  }
+  in += n;
+  rec.value = 0;
+
+  while (in < end && (*in & 0x7Fu) != 0x7Fu) {     // 0x7F, 0xFF: end
+    uint8_t h = *in++;
+    uint32_t dt = h & 0x7Fu;
+
+    if (dt == DT_ESC) {
+      if ((n = getVarint(in, end, &dt)) == 0u) {
+        break;
+      }
+      in += n;
+    }
+    rec.time += dt;
+    if (!(h & H_EVENT)) {
+      if ((n = getVarint(in, end, &v)) == 0u) {
+        break;
+      }
+      in += n;
+      rec.kind = LOG_POS;
+      rec.value = (uint16_t)(rec.value + ((v & 1u) ? -(int32_t)((v + 1u) >> 1) : (int32_t)(v >> 1)));
+      visit(&rec, ctx);
+    } else {
+      LogRec ev;
+      if (in >= end || (n = getVarint(in + 1, end, &v)) == 0u) {
+        break;
+      }
+      ev.time = rec.time;
+      ev.kind = *in;
+      ev.value = (uint16_t)v;
+      in += 1u + n;
+      visit(&ev, ctx);
+    }
+    count++;
+  }
+  return count;
+}
+
+uint32_t Log_Walk(LogVisit visit, void *ctx){
+  uint8_t seq[LOG_PAGES], valid[LOG_PAGES];
+  uint8_t p[EEPROM_PAGE];
+  uint8_t run;
+  uint32_t count = 0;
+
+  scan(seq, valid);
+  int8_t newest = findNewest(seq, valid, &run);
+  if (newest < 0) {
+    return 0;
+  }
+
+  uint8_t i = (uint8_t)(((uint8_t)newest + 1u + LOG_PAGES - run) % LOG_PAGES);
+  while (run--) {
+    Eeprom_Read((uint16_t)(i * EEPROM_PAGE), p, EEPROM_PAGE);
+    count += walkPage(p, visit, ctx);
+    i = (uint8_t)((i + 1u) % LOG_PAGES);
+  }
+  return count;
+}
+
+void Log_GetStats(LogStats *s){
+  *s = stats;
+}
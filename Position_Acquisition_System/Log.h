@@ -0,0 +1,100 @@
+#ifndef __LOG_H__
+#define __LOG_H__
+
+#include <stdint.h>
+#include "Eeprom.h"
+
+/*
+ * Position/event log in the EEPROM (Eeprom.h). No HAL in here, so with
+ * Eeprom_Ram.c it also runs on a PC (tools/log_sim.c).
+ *
+ * Records are (time, kind, value): LOG_POS with a position, or an event
+ * code with an argument. Time is whatever the caller counts in; main.c
+ * uses 0.1 s since reset.
+ *
+ * Page format (EEPROM_PAGE = 16 bytes, every write is one whole page):
+ *   [0]     sequence number, +1 per page written (mod 256)
+ *   [1..2]  CRC-16/CCITT of bytes 0 and 3..15, little-endian
+ *   [3..14] base time (varint), then records until 0xFF or byte 14
+ *   [15]    the sequence number again
+ * A record is a head byte H and varints:
+ *   H = 0ddddddd  position: dt, then zigzag(dpos)
+ *   H = 1ddddddd  event:    dt, then one code byte and the argument
+ * d = 0..125 is dt itself, 126 means a varint dt follows; 0x7F and 0xFF
+ * never start a record. dt and dpos are relative to the previous record
+ * of the same page, the first one to (base time, position 0), so every
+ * page decodes on its own. A typical moving-slider record is 2-3 bytes.
+ *
+ * Placement: pages are written round-robin over the whole device, so
+ * every page wears the same; on a 25AA040A (1M cycles) one page every
+ * 10 s lasts about 10 years. Nothing else is ever written, so there is
+ * no header block a power failure could tear. At start-up Log_Init()
+ * reads every page and ignores erased ones and ones failing their CRC
+ * or whose first and last bytes differ. A write cut short leaves the
+ * old last byte, so it is caught even when the mix of old and new bytes
+ * happens to pass the CRC. The newest page is the valid one whose
+ * successor does not carry the next sequence number. Writing resumes
+ * after it, so a torn page is simply written again. A power failure
+ * loses the page being written and whatever was still in RAM.
+ *
+ * Batching: records collect in a RAM page. It is sealed (padded with
+ * 0xFF, numbered, CRC'd) when the next record does not fit, when
+ * Log_Flush() is called, or by Log_Poll() once its first record is
+ * 'flushAge' time units old, and then queued for writing. Log_Poll()
+ * hands queued pages to the EEPROM one at a time and never waits; when
+ * all LOG_QUEUE pages are waiting, new records are dropped and counted.
+ * Log_Put(), Log_Poll() and Log_Flush() are for the main loop only.
+ */
+
+#define LOG_PAGES    (EEPROM_SIZE / EEPROM_PAGE)
+#define LOG_QUEUE    4u          // sealed pages waiting for the EEPROM
+
+#define LOG_POS      0u          // value = position
+#define LOG_EV_BOOT  1u          // value = pages recovered
+#define LOG_EV_CAL   2u          // value = calibration points
+#define LOG_EV_SCOPE 3u          // value = capture sent (1) or stopped (0)
+#define LOG_EV_IDLE  4u          // event mode: slider at rest
+#define LOG_EV_WAKE  5u          // event mode: slider moved
+
+typedef struct {
+  uint32_t time;
+  uint8_t  kind;               // LOG_POS or LOG_EV_...
+  uint16_t value;
+} LogRec;
+
+typedef struct {
+  uint32_t records;            // taken by Log_Put()
+  uint32_t dropped;            // queue full
+  uint32_t recordBytes;        // their encoded size
+  uint32_t pages;              // pages written
+  uint8_t  recovered;          // valid pages found by Log_Init()
+  uint8_t  torn;               // pages failing their CRC at Log_Init()
+} LogStats;
+
+typedef void (*LogVisit)(const LogRec *rec, void *ctx);
+
+/* Finds the newest page and continues after it. Eeprom_Init() first. */
+void     Log_Init(uint32_t flushAge);
+
+/* Returns 0 if the record was dropped */
+uint8_t  Log_Put(uint32_t time, uint8_t kind, uint16_t value);
+
+/* Seals the page being filled, if it holds anything */
+void     Log_Flush(void);
+
+/* Moves the EEPROM along; 'now' is in record time units */
+void     Log_Poll(uint32_t now);
+
+/* 1 while pages are queued or being written */
+uint8_t  Log_Pending(void);
+
+/*
+ * Calls 'visit' for every record stored in the EEPROM, oldest first
+ * (not the ones still in RAM). Blocking, and only with nothing
+ * pending. Returns the number of records.
+ */
+uint32_t Log_Walk(LogVisit visit, void *ctx);
+
+void     Log_GetStats(LogStats *stats);
+
+#endif /* __LOG_H__ */
@@ -0,0 +1,57 @@
+#include "SampleRing.h"
+#include "Barrier.h"
+
+static SampleRec ring[SAMPLE_RING_SIZE];
+static volatile uint16_t head = 0;      // written by the producer only
+static volatile uint16_t tail = 0;      // written by the consumer only
+static volatile uint32_t overruns = 0;
+static volatile uint16_t highWater = 0;
+
+void SampleRing_Init(void){
+  head = 0;
+  tail = 0;
+  overruns = 0;
+  highWater = 0;
+}
+
+uint8_t SampleRing_Put(uint32_t time, uint16_t sample){
+  uint16_t h = head;
+  uint16_t used = (uint16_t)(h - tail);
+
+  if (used >= SAMPLE_RING_SIZE) {
+    overruns++;
+    return 0;
+  }
+
+  ring[h & (SAMPLE_RING_SIZE - 1u)].time   = time;
+  ring[h & (SAMPLE_RING_SIZE - 1u)].sample = sample;
+  COMPILER_BARRIER();
+  head = (uint16_t)(h + 1u);             // publish after the entry is written
+
+  if (used + 1u > highWater) {
+    highWater = (uint16_t)(used + 1u);
+  }
+  return 1;
+}
+
+uint8_t SampleRing_Get(SampleRec *rec){
+  uint16_t t = tail;
+
+  if (t == head) {
+    return 0;
+  }
+  COMPILER_BARRIER();
+  *rec = ring[t & (SAMPLE_RING_SIZE - 1u)];
+  COMPILER_BARRIER();
+  tail = (uint16_t)(t + 1u);             // free the entry after the copy
+  return 1;
+}
+
+uint16_t SampleRing_Count(void){
+  return (uint16_t)(head - tail);
+}
+
+void SampleRing_GetStats(SampleRingStats *stats){
+  stats->overruns  = overruns;
+  stats->highWater = highWater;
+}
@@ -0,0 +1,42 @@
+#ifndef __SAMPLE_RING_H__
+#define __SAMPLE_RING_H__
+
+#include <stdint.h>
+
+/*
+ * Single-producer / single-consumer ring of timestamped samples, from
+ * the DMA interrupt to the main loop. No HAL, so it also builds on a PC.
+ *
+ * The producer only writes 'head' and the consumer only writes 'tail',
+ * each with one aligned 16-bit store, so no LDREX/STREX (not on the M0)
+ * and no interrupt masking are needed. An entry is published by moving
+ * head after it is written, and freed by moving tail after it is read.
+ *
+ * When the ring is full the new sample is dropped and counted; the
+ * producer never touches entries the consumer may be reading.
+ */
+
+#define SAMPLE_RING_SIZE  32u     // power of two
+
+typedef struct {
+  uint32_t time;       // raw ADC sample index at the end of the window
+  uint16_t sample;     // filtered value
+} SampleRec;
+
+typedef struct {
+  uint32_t overruns;   // samples dropped on a full ring
+  uint16_t highWater;  // most entries ever waiting
+} SampleRingStats;
+
+void    SampleRing_Init(void);
+
+/* Producer (interrupt). Returns 0 if the ring was full. */
+uint8_t SampleRing_Put(uint32_t time, uint16_t sample);
+
+/* Consumer (main loop). Returns 0 when empty. */
+uint8_t SampleRing_Get(SampleRec *rec);
+uint16_t SampleRing_Count(void);
+
+void    SampleRing_GetStats(SampleRingStats *stats);
+
+#endif /* __SAMPLE_RING_H__ */
@@ -0,0 +1,145 @@
+#include "Scan.h"
+
+#define GAIN_ONE   (1uL << 16)
+#define GAIN_MAX   (2uL << 16)         // VDDA can't be twice 3.3 V; guards the multiply
+
+static ScanConfig cfg;
+static uint8_t  count;
+static int8_t   vrefSlot = -1;
+static int8_t   tempSlot = -1;
+static uint8_t  absSlots;              // bit s: slot s is SCAN_ABS
+static volatile uint16_t vdda;
+static volatile int16_t  temp;
+
+uint8_t Scan_Count(uint32_t channels){
+  uint8_t n = 0;
+
+  for (; channels != 0u; channels &= channels - 1u) {
+    n++;
+  }
+  return n;
+}
+
+uint8_t Scan_Timing(uint32_t timClk, uint32_t adcClk, uint32_t rateHz,
+                    uint32_t channels, ADCStreamTiming *t){
+  uint8_t n = Scan_Count(channels);
+
+  if (n == 0u || n > SCAN_MAX_CHANNELS ||
+      !ADCStream_Timing(timClk, adcClk, rateHz, n, t)) {
+    return 0;
+  }
+
+  /* The internal channels need a long sampling time */
+  if ((channels & (SCAN_CH(SCAN_CH_TEMP) | SCAN_CH(SCAN_CH_VREF))) &&
+      t->sampleTime < SCAN_INTERNAL_SMP) {
+    return 0;
+  }
+  return 1;
+}
+
+uint8_t Scan_Init(const ScanConfig *c){
+  uint8_t n = Scan_Count(c->channels);
+
+  if (n == 0u || n > SCAN_MAX_CHANNELS || (c->absolute & ~c->channels) ||
+      (c->channels >> (SCAN_CH_VREF + 1u))) {
+    return 0;
+  }
+  /* Anything corrected needs VREFINT, and so does the temperature */
+  if ((c->absolute || (c->channels & SCAN_CH(SCAN_CH_TEMP))) &&
+      (!(c->channels & SCAN_CH(SCAN_CH_VREF)) || c->vrefCal == 0u)) {
+    return 0;
+  }
+
+  cfg = *c;
+  count = n;
+  vrefSlot = -1;
+  tempSlot = -1;
+  absSlots = 0;
+  vdda = 0;
+  temp = 0;
+
+  uint8_t s = 0;
+  for (uint8_t ch = 0; ch <= SCAN_CH_VREF; ch++) {
+    if (!(cfg.channels & SCAN_CH(ch))) {
+      continue;
+    }
+    if (ch == SCAN_CH_VREF) {
+      vrefSlot = (int8_t)s;
+    } else if (ch == SCAN_CH_TEMP) {
+      tempSlot = (int8_t)s;
+    }
+    if (cfg.absolute & SCAN_CH(ch)) {
+      absSlots |= (uint8_t)(1u << s);
+    }
+    s++;
+  }
+  return count;
+}
+
+int8_t Scan_Slot(uint8_t ch){
+  if (ch > SCAN_CH_VREF || !(cfg.channels & SCAN_CH(ch))) {
+    return -1;
+  }
+  return (int8_t)Scan_Count(cfg.channels & (SCAN_CH(ch) - 1u));
+}
+
+/* Average of one slot over the block, in 1/16 LSB */
+static uint32_t average16(const uint16_t *block, uint16_t frames, uint8_t slot){
+  uint32_t sum = 0;
+
+  for (uint16_t k = 0; k < frames; k++) {
+    sum += block[k * count + slot];
+  }
+  return ((sum << 4) + frames / 2u) / frames;
+}
+
+uint16_t Scan_Split(const uint16_t *block, uint16_t n, uint16_t *out, uint16_t stride){
+  uint16_t frames = (uint16_t)(n / count);
+  uint32_t gain = GAIN_ONE;
+
+  if (frames == 0u) {
+    return 0;
+  }
+
+  if (vrefSlot >= 0) {
+    uint32_t ref16 = average16(block, frames, (uint8_t)vrefSlot);
+    gain = (ref16 != 0u) ? ((uint32_t)cfg.vrefCal << 20) / ref16 : GAIN_MAX;
+    if (gain > GAIN_MAX) {
+      gain = GAIN_MAX;
+    }
+    vdda = (uint16_t)((SCAN_CAL_MV * gain + GAIN_ONE / 2u) >> 16);
+  }
+
+  for (uint8_t s = 0; s < count; s++) {
+    const uint16_t *in = block + s;
+    uint16_t *o = out + s * stride;
+
+    if (absSlots & (1u << s)) {
+      for (uint16_t k = 0; k < frames; k++, in += count) {
+        uint32_t v = (*in * gain + GAIN_ONE / 2u) >> 16;
+        o[k] = (uint16_t)((v > 4095u) ? 4095u : v);
+      }
+    } else {
+      for (uint16_t k = 0; k < frames; k++, in += count) {
+        o[k] = *in;
+      }
+    }
+  }
+
+  if (tempSlot >= 0) {
+    /* Sensor reading as at 3.300 V, 1/16 LSB; 3300 / 4095 / 4.3 C per
+       LSB is 1.874, or 480 / 256 */
+    uint32_t ts16 = (average16(block, frames, (uint8_t)tempSlot) * gain + GAIN_ONE / 2u) >> 16;
+    int32_t  d = (int32_t)((uint32_t)cfg.tsCal << 4) - (int32_t)ts16;
+    temp = (int16_t)(300 + (d * 480 + (d < 0 ? -2048 : 2048)) / 4096);
+  }
+  return frames;
+}
+
+uint16_t Scan_VddaMilliVolts(void){
+  return vdda;
+}
+
+int16_t Scan_TempDeciC(void){
+  return temp;
+}
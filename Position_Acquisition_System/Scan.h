@@ -0,0 +1,71 @@
+#ifndef __SCAN_H__
+#define __SCAN_H__
+
+#include <stdint.h>
+#include "ADC_Stream.h"
+
+/*
+ * Multi-channel scan: scheduling, de-interleave and supply correction.
+ * No HAL in here; ADC_Driver.c programs the scan, this file makes sense
+ * of the samples, so it also runs on a PC.
+ *
+ * A scan is a bit mask of ADC channels (bit n = ADC_IN n). Every trigger
+ * converts all of them in ascending channel order, so the DMA buffer
+ * holds frames of Scan_Count() samples, one per channel.
+ *
+ * The ADC measures against VDDA. VREFINT_CAL is what VREFINT read with
+ * VDDA = 3.300 V in production, so VDDA = 3.300 V * VREFINT_CAL / VREFINT.
+ * Scan_Split() averages VREFINT over the block and works out that ratio
+ * once (two divides per block); every SCAN_ABS channel is then scaled by
+ * it with one multiply and a shift, i.e. reported as if VDDA had been
+ * exactly 3.300 V. Use it for inputs that do not come from VDDA (an
+ * external reference, a sensor with its own supply). A slider fed from
+ * VDDA itself is ratiometric already and must not be corrected: supply
+ * droop moves its wiper and the reference together.
+ *
+ * The temperature sensor is corrected the same way and turned into
+ * 0.1 C with TS_CAL1 (30 C at 3.300 V) and the typical slope of
+ * 4.3 mV/C from the datasheet, so it is good to a few degrees.
+ */
+
+#define SCAN_CH_TEMP       16u
+#define SCAN_CH_VREF       17u
+#define SCAN_CH(n)         (1uL << (n))
+#define SCAN_MAX_CHANNELS  8u
+#define SCAN_INTERNAL_SMP  6u        // 71.5 cycles = 5.1 us at 14 MHz; TS and VREFINT need 4 us
+#define SCAN_CAL_MV        3300u     // VDDA at which VREFINT_CAL and TS_CAL1 were taken
+
+#define SCAN_RATIO  0u
+#define SCAN_ABS    1u
+
+typedef struct {
+  uint32_t channels;     // SCAN_CH() bits to convert
+  uint32_t absolute;     // subset of channels scaled to 3.300 V (SCAN_ABS)
+  uint16_t vrefCal;      // VREFINT_CAL from system memory
+  uint16_t tsCal;        // TS_CAL1 from system memory
+} ScanConfig;
+
+/* Scheduling */
+uint8_t  Scan_Count(uint32_t channels);
+uint8_t  Scan_Timing(uint32_t timClk, uint32_t adcClk, uint32_t rateHz,
+                     uint32_t channels, ADCStreamTiming *t);
+
+/* Returns the channel count, 0 if the configuration is not usable */
+uint8_t  Scan_Init(const ScanConfig *cfg);
+
+/* Position of channel 'ch' in a frame, -1 if it is not scanned */
+int8_t   Scan_Slot(uint8_t ch);
+
+/*
+ * De-interleaves 'n' samples (whole frames) from 'block' into 'out':
+ * channel slot s gets out[s * stride] onwards, corrected as configured.
+ * Returns the number of frames (samples per channel); stride must be at
+ * least that.
+ */
+uint16_t Scan_Split(const uint16_t *block, uint16_t n, uint16_t *out, uint16_t stride);
+
+/* From the last Scan_Split(); 0 if VREFINT / the sensor is not scanned */
+uint16_t Scan_VddaMilliVolts(void);
+int16_t  Scan_TempDeciC(void);
+
+#endif /* __SCAN_H__ */
@@ -0,0 +1,241 @@
+#include "Scope.h"
+
+static ScopeConfig cfg;
+static const uint16_t *ring;
+static uint16_t depth;
+static volatile uint8_t state = SCOPE_IDLE;
+static uint32_t written;            // samples in completed blocks
+static uint32_t trigIndex;          // T
+static uint8_t  watching;           // watchdog interrupt is on
+static uint32_t armedAt;            // first sample the watchdog covers
+
+static uint16_t at(uint32_t index){
+  return ring[index % depth];
+}
+
+/* Sample index of the DMA write position, from the block count */
+static uint32_t absIndex(uint16_t writeIndex){
+  uint16_t base = (uint16_t)(written % depth);
+  uint16_t ahead = (uint16_t)((writeIndex + depth - base) % depth);
+  return written + ahead;
+}
+
+static uint8_t past(uint16_t s){
+  return (cfg.trigger == SCOPE_TRIG_RISING) ? (s >= cfg.level) : (s <= cfg.level);
+}
+
+/* On the far side of the level, by more than the hysteresis */
+static uint8_t beyond(uint16_t s){
+  return (cfg.trigger == SCOPE_TRIG_RISING) ? (s + cfg.hyst < cfg.level)
+                                            : (s > cfg.level + cfg.hyst);
+}
+
+static void watch(uint8_t on){
+  watching = on;
+  Scope_HwWatchdog(on);
+}
+
+static void trigger(uint32_t t){
+  watch(0);
+  trigIndex = t;
+  state = SCOPE_TRIGGERED;
+}
+
+/*
+ * Until the watchdog is armed, every block is searched for a sample
+ * beyond the level and then for the first one past it. A crossing
+ * inside the block triggers here; a block that went beyond without
+ * crossing back arms the watchdog from its end. Only the samples from
+ * 'pre' on count.
+ */
+static void armFrom(const uint16_t *block, uint16_t n){
+  uint32_t first = written - n;
+  uint16_t i = (first < cfg.pre) ? (uint16_t)(cfg.pre - first) : 0u;
+  uint8_t clear = 0;
+
+  for (; i < n; i++) {
+    if (beyond(block[i])) {
+      clear = 1;
+    } else if (clear && past(block[i])) {
+      trigger(first + i);
+      return;
+    }
+  }
+  if (clear) {
+    armedAt = written;
+    watch(1);
+  }
+}
+
+uint8_t Scope_Arm(const ScopeConfig *c, const uint16_t *buf, uint16_t n){
+  if (n < 2u * SCOPE_GUARD || (n & 1u) || c->trigger > SCOPE_TRIG_NOW ||
+      c->pre == 0u || (uint32_t)c->pre + c->post > n / 2u - SCOPE_GUARD ||
+      c->level > 4095u) {
+    return 0;
+  }
+
+  watch(0);
+  cfg = *c;
+  ring = buf;
+  depth = n;
+  written = 0;
+  trigIndex = 0;
+  armedAt = 0;
+  state = SCOPE_FILLING;
+  return 1;
+}
+
+void Scope_Window(const ScopeConfig *c, uint16_t *low, uint16_t *high){
+  if (c->trigger == SCOPE_TRIG_FALLING) {
+    *low = (uint16_t)(c->level + 1u);     // flags samples <= level
+    *high = 4095u;
+  } else if (c->trigger == SCOPE_TRIG_RISING && c->level > 0u) {
+    *low = 0u;
+    *high = (uint16_t)(c->level - 1u);    // flags samples >= level
+  } else {
+    *low = 0u;                            // never flags
+    *high = 4095u;
+  }
+}
+
+void Scope_Block(const uint16_t *block, uint16_t n){
+  written += n;
+
+  switch (state) {
+  case SCOPE_FILLING:
+    if (written < cfg.pre) {
+      break;
+    }
+    if (cfg.trigger == SCOPE_TRIG_NOW) {
+      trigger(written);
+      break;
+    }
+    state = SCOPE_ARMED;
+    /* fall through */
+
+  case SCOPE_ARMED:
+    if (cfg.trigger <= SCOPE_TRIG_FALLING && !watching) {
+      armFrom(block, n);
+    }
+    if (state != SCOPE_TRIGGERED) {
+      break;
+    }
+    /* A crossing inside the block may be complete already */
+    /* fall through */
+
+  case SCOPE_TRIGGERED:
+    if (written >= trigIndex + cfg.post) {
+      Scope_HwStop();
+      state = SCOPE_DONE;
+    }
+    break;
+
+  default:
+    break;
+  }
+}
+
+void Scope_Watchdog(uint16_t writeIndex){
+  if (state != SCOPE_ARMED) {
+    watch(0);
+    return;
+  }
+
+  /* The flagged sample is a few conversions before the write position
+     (interrupt latency); the first one past the level is T */
+  uint32_t w = absIndex(writeIndex);
+  uint32_t t = (w > SCOPE_REFINE_MAX) ? w - SCOPE_REFINE_MAX : 0u;
+  if (t < armedAt) {
+    t = armedAt;
+  }
+  while (t < w && !past(at(t))) {
+    t++;
+  }
+  if (t < w) {
+    trigger(t);
+  }
+  /* else a flag from before arming; stay armed */
+}
+
+void Scope_External(uint16_t writeIndex){
+  if (state == SCOPE_ARMED) {
+    trigger(absIndex(writeIndex));
+  }
+}
+
+uint8_t Scope_State(void){
+  return state;
+}
+
+uint32_t Scope_TriggerIndex(void){
+  return trigIndex;
+}
+
+static uint16_t crc;
+
+static uint16_t crc16(uint16_t c, const uint8_t *d, uint16_t n){
+  while (n--) {
+    c ^= (uint16_t)(*d++ << 8);
+    for (uint8_t b = 0; b < 8u; b++) {
+      c = (c & 0x8000u) ? (uint16_t)((c << 1) ^ 0x1021u) : (uint16_t)(c << 1);
+    }
+  }
+  return c;
+}
+
+static void emit(void (*put)(const uint8_t *, uint16_t), const uint8_t *d, uint16_t n){
+  crc = crc16(crc, d, n);
+  put(d, n);
+}
+
+uint8_t Scope_Dump(uint32_t rateHz, void (*put)(const uint8_t *data, uint16_t n)){
+  uint8_t b[24];
+  uint16_t count = (uint16_t)(cfg.pre + cfg.post);
+  uint32_t first = trigIndex - cfg.pre;
+
+  if (state != SCOPE_DONE) {
+    return 0;
+  }
+
+  b[0] = 'S';
+  b[1] = 'C';
+  put(b, 2);
+
+  crc = 0xFFFFu;
+  b[0]  = SCOPE_VERSION;
+  b[1]  = cfg.trigger;
+  b[2]  = (uint8_t)rateHz;
+  b[3]  = (uint8_t)(rateHz >> 8);
+  b[4]  = (uint8_t)(rateHz >> 16);
+  b[5]  = (uint8_t)(rateHz >> 24);
+  b[6]  = (uint8_t)cfg.pre;
+  b[7]  = (uint8_t)(cfg.pre >> 8);
+  b[8]  = (uint8_t)cfg.post;
+  b[9]  = (uint8_t)(cfg.post >> 8);
+  b[10] = (uint8_t)cfg.level;
+  b[11] = (uint8_t)(cfg.level >> 8);
+  emit(put, b, 12);
+
+  /* Two samples per 3 bytes, sent in chunks of 8 samples */
+  uint16_t i = 0;
+  while (i < count) {
+    uint8_t m = 0;
+    for (uint8_t k = 0; k < 8u && i < count; k += 2u) {
+      uint16_t a = at(first + i++) & 0x0FFFu;
+      uint16_t c = (i < count) ? (at(first + i++) & 0x0FFFu) : 0u;
+      b[m++] = (uint8_t)a;
+      b[m++] = (uint8_t)((a >> 8) | (c << 4));
+      b[m++] = (uint8_t)(c >> 4);
+    }
+    if (count & 1u && i == count) {
+      m--;                          // odd count: last byte would be all padding
+    }
+    emit(put, b, m);
+  }
+
+  uint16_t c = crc;
+  b[0] = (uint8_t)c;
+  b[1] = (uint8_t)(c >> 8);
+  put(b, 2);
+  return 1;
+}
@@ -0,0 +1,86 @@
+#ifndef __SCOPE_H__
+#define __SCOPE_H__
+
+#include <stdint.h>
+
+/*
+ * Burst capture ("scope mode") with pre-trigger. No HAL in here; the
+ * hardware is reached through the Scope_Hw...() hooks, which the
+ * application implements, so it also builds and runs on a PC.
+ *
+ * The ADC stream writes straight into the capture ring (circular DMA,
+ * 'depth' samples) and Scope_Block() is called for every half. Samples
+ * are numbered from the start of the stream; the trigger fixes sample
+ * T and the capture is T - pre .. T + post - 1.
+ *
+ * Triggers:
+ *   SCOPE_TRIG_RISING / FALLING  the first sample past the level after
+ *       one beyond level -/+ hyst, from sample 'pre' on. Scope_Block()
+ *       looks for both in each block until a block goes beyond without
+ *       crossing back; from its end the ADC analog watchdog is armed
+ *       (Scope_HwWatchdog(1)), with the window set up front by
+ *       Scope_Window(). Scope_Watchdog() then searches the last
+ *       SCOPE_REFINE_MAX samples for the first one past the level, so
+ *       T is exact.
+ *   SCOPE_TRIG_EXT  edge on a GPIO; Scope_External() takes the sample
+ *       being converted at that moment.
+ *   SCOPE_TRIG_NOW  as soon as 'pre' samples exist.
+ *
+ * The capture stops (Scope_HwStop()) at the first block boundary at or
+ * after T + post, so up to half the ring plus the stop latency is
+ * written after the last sample: pre + post may be at most
+ * depth / 2 - SCOPE_GUARD.
+ *
+ * Dump format (Scope_Dump()), little-endian:
+ *   'S' 'C'  version  trigger  rateHz(4)  pre(2)  post(2)  level(2)
+ *   samples, two 12-bit values per 3 bytes (a0..a7, a8..a11|b0..b3,
+ *   b4..b11), oldest first, padded to whole bytes
+ *   CRC-16/CCITT (0xFFFF start) over everything after 'S' 'C'
+ * tools/scope_decode.py turns dumps into CSV.
+ */
+
+#define SCOPE_TRIG_RISING   0u
+#define SCOPE_TRIG_FALLING  1u
+#define SCOPE_TRIG_EXT      2u
+#define SCOPE_TRIG_NOW      3u
+
+#define SCOPE_GUARD         64u     // samples written while stopping
+#define SCOPE_REFINE_MAX    32u     // samples searched for the crossing
+#define SCOPE_VERSION       1u
+
+#define SCOPE_IDLE          0u
+#define SCOPE_FILLING       1u      // collecting the pre-trigger samples
+#define SCOPE_ARMED         2u      // waiting for the trigger
+#define SCOPE_TRIGGERED     3u      // collecting the post-trigger samples
+#define SCOPE_DONE          4u
+
+typedef struct {
+  uint8_t  trigger;    // SCOPE_TRIG_xxx
+  uint16_t level;      // 0..4095, RISING / FALLING
+  uint16_t hyst;       // must be beyond level -/+ hyst before arming
+  uint16_t pre;        // samples before the trigger
+  uint16_t post;       // samples from the trigger on
+} ScopeConfig;
+
+/* Returns 0 if cfg does not fit a ring of 'depth' samples */
+uint8_t  Scope_Arm(const ScopeConfig *cfg, const uint16_t *ring, uint16_t depth);
+
+/* Watchdog window for cfg: the hardware flags samples outside low..high */
+void     Scope_Window(const ScopeConfig *cfg, uint16_t *low, uint16_t *high);
+
+/* Producer side (interrupts); 'writeIndex' is where the DMA writes next */
+void     Scope_Block(const uint16_t *block, uint16_t n);
+void     Scope_Watchdog(uint16_t writeIndex);
+void     Scope_External(uint16_t writeIndex);
+
+uint8_t  Scope_State(void);
+uint32_t Scope_TriggerIndex(void);
+
+/* Writes the capture in the dump format through 'put'. Only when done. */
+uint8_t  Scope_Dump(uint32_t rateHz, void (*put)(const uint8_t *data, uint16_t n));
+
+/* Implemented by the application */
+void     Scope_HwWatchdog(uint8_t on);   // watchdog interrupt on (flag cleared first) / off
+void     Scope_HwStop(void);             // stop conversions now
+
+#endif /* __SCOPE_H__ */
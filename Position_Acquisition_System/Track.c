@@ -0,0 +1,137 @@
+#include "Track.h"
+#include "Barrier.h"
+
+#define STATE_LIMIT  (1L << 30)
+
+static TrackConfig cfg = { TRACK_ONE, 0, 0, 0 };
+static int32_t  posMax;              // full scale, Q16
+static uint8_t  step;                // log2 of the time per output
+static int32_t  x, v, a;
+static uint32_t last;
+static uint8_t  primed;
+
+static TrackState shared;
+static volatile uint32_t seq;        // odd while 'shared' is being written
+static volatile uint32_t updates, bridged, restarts;
+
+uint8_t Track_Init(const TrackConfig *c, uint8_t bits, uint8_t stepLog2){
+  if (bits > TRACK_MAX_BITS || stepLog2 > 16u ||
+      c->alpha == 0u || c->alpha > TRACK_ONE || c->beta > 2u * TRACK_ONE ||
+      c->gamma > c->beta || c->maxGap > TRACK_MAX_GAP) {
+    return 0;
+  }
+
+  cfg = *c;
+  posMax = (int32_t)(((1uL << bits) - 1u) << 16);
+  step = stepLog2;
+  x = 0;
+  v = 0;
+  a = 0;
+  primed = 0;
+  shared.pos = 0;
+  shared.vel = 0;
+  shared.acc = 0;
+  shared.time = 0;
+  updates = 0;
+  bridged = 0;
+  restarts = 0;
+  return 1;
+}
+
+/* Q16 x Q16 -> Q16, rounded */
+static int32_t mulQ16(uint32_t g, int32_t r){
+  return (int32_t)(((int64_t)g * r + 0x8000) >> 16);
+}
+
+static int32_t clamp(int32_t s, int32_t lo, int32_t hi){
+  return (s < lo) ? lo : (s > hi) ? hi : s;
+}
+
+void Track_FadingGains(TrackConfig *c, uint32_t theta, uint8_t order){
+  if (theta > TRACK_ONE) {
+    theta = TRACK_ONE;
+  }
+  uint32_t u  = TRACK_ONE - theta;                        // 1 - theta
+  uint32_t u2 = (uint32_t)(((uint64_t)u * u) >> 16);
+  uint32_t t2 = (uint32_t)(((uint64_t)theta * theta) >> 16);
+
+  if (order == TRACK_AB) {
+    c->alpha = TRACK_ONE - t2;                            // 1 - theta^2
+    c->beta  = u2;                                        // (1 - theta)^2
+    c->gamma = 0;
+  } else {
+    uint32_t t3 = (uint32_t)(((uint64_t)t2 * theta) >> 16);
+    c->alpha = TRACK_ONE - t3;                            // 1 - theta^3
+    c->beta  = (uint32_t)(((uint64_t)(3u * u2 / 2u) * (TRACK_ONE + theta)) >> 16);
+    c->gamma = (uint32_t)(((uint64_t)u2 * u) >> 16);      // (1 - theta)^3
+  }
+  if (c->alpha == 0u) {
+    c->alpha = 1u;                                        // theta = 1: hold still
+  }
+}
+
+static void predict(void){
+  x = clamp(x + v + a / 2, -STATE_LIMIT, STATE_LIMIT);
+  v = clamp(v + a, -STATE_LIMIT, STATE_LIMIT);
+}
+
+static void publish(uint32_t time){
+  seq++;                                 // odd: being written
+  COMPILER_BARRIER();
+  shared.pos  = x;
+  shared.vel  = v;
+  shared.acc  = a;
+  shared.time = time;
+  COMPILER_BARRIER();
+  seq++;
+}
+
+void Track_Update(uint16_t z, uint32_t time){
+  int32_t zq = (int32_t)((uint32_t)z << 16);
+  uint32_t steps = (time - last) >> step;
+
+  updates++;
+  if (!primed || steps == 0u || steps > cfg.maxGap + 1u) {
+    x = zq;
+    v = 0;
+    a = 0;
+    primed = 1;
+    restarts++;
+  } else {
+    for (; steps > 1u; steps--) {        // bounded by maxGap
+      predict();
+      bridged++;
+    }
+    predict();
+
+    int32_t r = clamp(zq - x, -STATE_LIMIT, STATE_LIMIT);
+    x = clamp(x + mulQ16(cfg.alpha, r), 0, posMax);
+    v = clamp(v + mulQ16(cfg.beta, r), -STATE_LIMIT, STATE_LIMIT);
+    a = clamp(a + mulQ16(cfg.gamma, r), -STATE_LIMIT, STATE_LIMIT);
+  }
+  last = time;
+  publish(time);
+}
+
+void Track_Hold(void){
+  v = 0;
+  a = 0;
+  publish(last);
+}
+
+void Track_Get(TrackState *state){
+  uint32_t s;
+
+  do {
+    s = seq;
+    COMPILER_BARRIER();
+    *state = shared;
+    COMPILER_BARRIER();
+  } while ((s & 1u) || s != seq);
+}
+
+void Track_GetStats(TrackStats *stats){
+  stats->updates  = updates;
+  stats->bridged  = bridged;
+  stats->restarts = restarts;
+}
@@ -0,0 +1,85 @@
+#ifndef __TRACK_H__
+#define __TRACK_H__
+
+#include <stdint.h>
+
+/*
+ * Alpha-beta-gamma tracker: position, velocity and acceleration from
+ * the filtered sample stream. No HAL and no divides, so it also builds
+ * on a PC.
+ *
+ * Everything is Q16 and counted per filter output ("step"):
+ *   pos  filtered counts
+ *   vel  counts per step
+ *   acc  counts per step^2
+ * so the update needs no sample period. Multiply by the output rate
+ * (or its square) for per-second values.
+ *
+ * Per output z:
+ *   predict   pos += vel + acc/2,  vel += acc
+ *   residual  r = z - pos
+ *   correct   pos += alpha*r,  vel += beta*r,  acc += gamma*r
+ * With gamma = 0 it is a plain alpha-beta filter. (gamma here is the
+ * 2*gamma/T^2 of the textbook form.) Track_FadingGains() gives the
+ * critically damped (fading-memory) gains for a smoothing factor theta:
+ * closer to 1 is smoother and slower.
+ *
+ * An update costs three 32x32->64 multiplies and a fixed amount of
+ * other work. Missing outputs (a full sample ring upstream, a skipped
+ * block) are bridged with up to maxGap predict-only steps; after a
+ * longer gap, such as an event-mode idle period, the tracker restarts
+ * at the new sample with zero velocity. Track_Hold() zeroes velocity
+ * and acceleration when the producer knows the slider is at rest.
+ *
+ * Track_Update() runs in the producer (DMA interrupt); Track_Get() may
+ * be called from the main loop at any time and returns a consistent
+ * snapshot of the newest state. It retries if an update lands while it
+ * copies, and the producer never waits.
+ */
+
+#define TRACK_ONE       65536uL     // 1.0 in Q16
+#define TRACK_MAX_BITS  14u         // input bits; keeps pos << 16 inside 31 bits
+#define TRACK_MAX_GAP   4u          // predict-only steps bridged at most
+
+#define TRACK_AB        2u          // alpha-beta
+#define TRACK_ABG       3u          // alpha-beta-gamma
+
+typedef struct {
+  uint32_t alpha;      // Q16, 0 < alpha <= 1
+  uint32_t beta;       // Q16, 0 <= beta <= 2
+  uint32_t gamma;      // Q16, 0 <= gamma <= beta
+  uint8_t  maxGap;     // 0..TRACK_MAX_GAP
+} TrackConfig;
+
+typedef struct {
+  int32_t  pos;        // Q16 counts
+  int32_t  vel;        // Q16 counts per step
+  int32_t  acc;        // Q16 counts per step^2
+  uint32_t time;       // time of the newest sample (as passed in)
+} TrackState;
+
+typedef struct {
+  uint32_t updates;    // samples taken in
+  uint32_t bridged;    // predict-only steps over gaps
+  uint32_t restarts;   // first sample, or after a gap above maxGap
+} TrackStats;
+
+/*
+ * 'bits' is the input resolution, 'stepLog2' the time between outputs
+ * in Track_Update() time units as a power of two. Returns 0 (and keeps
+ * the old set-up) if anything is out of range.
+ */
+uint8_t  Track_Init(const TrackConfig *cfg, uint8_t bits, uint8_t stepLog2);
+
+/* Fills alpha/beta/gamma for 'order' (TRACK_AB / TRACK_ABG), theta in Q16 */
+void     Track_FadingGains(TrackConfig *cfg, uint32_t theta, uint8_t order);
+
+/* Producer */
+void     Track_Update(uint16_t z, uint32_t time);
+void     Track_Hold(void);
+
+/* Consumer */
+void     Track_Get(TrackState *state);
+void     Track_GetStats(TrackStats *stats);
+
+#endif /* __TRACK_H__ */
@@ -1,4 +1,5 @@
-/* Lab 3 Phase 2 – Step 4: 10 Hz timer, mailbox, LCD display */
+/* Lab 3 Phase 2 – Step 4: 10 Hz timer, mailbox, LCD display
+ * (sampling now from TIM3 + DMA, see ADC_Driver.h) */
 
 #include "main.h"
 #include "stm32f0xx_hal.h"
@@ -6,8 +7,24 @@
 
 #include "LCD.h"
 #include "ADC_Driver.h"
+#include "Filter.h"
+#include "Calib.h"
+#include "CalibStore.h"
+#include "SampleRing.h"
+#include "Scope.h"
+#include "Acq.h"
+#include "Scan.h"
+#include "Track.h"
+#include "Eeprom.h"
+#include "Log.h"
+#include "Telemetry.h"
 
-/* Global ADC handle (CubeMX) */
+/* PA9 is the LCD enable, so telemetry stays on the default PA2 */
+#if TELEMETRY_PORT != TELEMETRY_PORT_USART2_PA2
+#error "PA9 is the LCD enable: build with TELEMETRY_PORT_USART2_PA2 (the default)"
+#endif
+
+/* Global handles (CubeMX) */
 ADC_HandleTypeDef hadc;
 
 /* Prototypes */
@@ -15,71 +32,415 @@ void SystemClock_Config(void);
 static void MX_GPIO_Init(void);
 static void MX_ADC_Init(void);
 
-/* -------- Mailbox & heartbeat -------- */
-volatile uint16_t ADC_Mailbox = 0;
-volatile uint8_t  ADC_MailboxFlag = 0;
+/* -------- Calibration -------- */
+#define CAL_BUTTON_PIN  GPIO_PIN_1     // PA1 to GND; hold at reset to calibrate
+#define POS_MAX         2000u          // 2.000 cm
+
+/* Reference positions visited during calibration (0.001 cm) */
+static const uint16_t calRefs[] = { 0u, 500u, 1000u, 1500u, 2000u };
 
-/* Convert ADC sample, ADC is 12 bits 2^12 = 4096... 0 to 4095 */
+static CalibPoints calPoints;
+
+/* Convert filtered sample to position (0.001 cm) via the calibration table */
 static uint32_t Position_FromSample(uint16_t sample){
-  /* linear map: 0 → 0.000 cm, 4095 → ~2.000 cm */
-  return ((uint32_t)sample * 2000u + 2047u) / 4095u;
+  return Calib_Position(sample);
+}
+
+/* Tracker velocity (Q16 samples per filter output) at 'sample' -> 0.001 cm/s */
+static int32_t Velocity_FromTrack(uint16_t sample, int32_t vel, uint32_t rateHz){
+  int64_t v = (int64_t)Calib_Delta(sample, vel) * (int32_t)rateHz;
+  return (int32_t)((v + 0x8000) >> 16);
+}
+
+/* -------- ADC stream -------- */
+#define SAMPLE_RATE_HZ  1280u          // 128-frame blocks -> 10 Hz
+#define SCAN_BLOCK      128u           // frames per DMA block
+
+/* PA0 slider (more can go on PA4..PA7), temperature sensor, VREFINT.
+   The slider hangs off VDDA, so it stays ratiometric; put it in
+   SCAN_ABSOLUTE if it gets its own supply. */
+#define SCAN_SLIDER     0u
+#define SCAN_CHANNELS   (SCAN_CH(SCAN_SLIDER) | SCAN_CH(SCAN_CH_TEMP) | SCAN_CH(SCAN_CH_VREF))
+#define SCAN_ABSOLUTE   0u
+#define SCAN_FRAME      3u             // channels in SCAN_CHANNELS
+
+/* -------- Scope mode -------- */
+#define SCOPE_DEPTH     2048u          // capture ring, shared with the stream
+#define SCOPE_RATE_HZ   ADC_STREAM_MAX_HZ
+#define SCOPE_TRIG_PIN  GPIO_PIN_0     // PB0, rising edge for SCOPE_TRIG_EXT
+
+/* Rising through mid-travel; 240 samples before, 720 from the trigger on */
+static const ScopeConfig scopeCfg = { SCOPE_TRIG_RISING, 2048u, 64u, 240u, 720u };
+static volatile uint8_t scopeMode = 0;
+
+static uint16_t adcBuf[SCOPE_DEPTH];
+static uint16_t scanBuf[SCAN_FRAME * SCAN_BLOCK];   // one block, per channel
+static uint16_t *sliderBuf;
+
+/* 16x boxcar -> 14 bits at 80 Hz, then an IIR with a 4-output time constant */
+static const FilterConfig filterCfg = { 4u, FILTER_IIR, 2u, 3u };
+
+/* Alpha-beta-gamma tracker on the 80 Hz filter output: fading-memory
+   gains for theta = 0.7, bridging up to two lost outputs */
+#define TRACK_THETA     45875u         // 0.7 in Q16
+static TrackConfig trackCfg;
+
+/* -------- Position log (25AA040A, see Log.h) -------- */
+#define LOG_STEP        10u            // log a move of 0.010 cm or more
+#define LOG_FLUSH_AGE   50u            // write a part-filled page after 5 s
+#define LOG_TICKS(raw)  ((raw) / (SAMPLE_RATE_HZ / 10u))   // sample index -> 0.1 s
+
+static uint32_t logNow;                // newest sample time, 0.1 s
+static uint32_t logBase;               // logNow when the stream (re)started
+
+/* -------- Telemetry (USART2 TX on PA2 by DMA, see Telemetry.h) -------- */
+#define TLM_BAUD        115200u
+#define TLM_RAW         0u             // 1: raw slider samples from the DMA interrupt too
+
+#define TLM_CH_FILTERED 0u             // 80 Hz filter output, 3 per frame
+#define TLM_CH_RAW      1u             // 1280 Hz slider samples, with TLM_RAW
+#define TLM_FSM_ACQ     0u             // running (0) / idle (1), arg = position
+#define TLM_C_POS       1u             // 0.001 cm, on every redraw
+#define TLM_C_VEL       2u             // 0.001 cm/s, two's complement
+#define TLM_C_LOG_PAGES 3u             // position log page writes, when idle
+
+static uint32_t tlmMs;                 // sample clock in ms, see TelemetryPort_Now()
+static uint32_t tlmBase;               // tlmMs when the stream (re)started
+static uint16_t tlmBatch[3];
+static uint8_t  tlmFill;
+
+/* -------- Acquisition mode -------- */
+#define ACQ_MODE        ACQ_EVENT      // or ACQ_PERIODIC: redraw every 100 ms
+#define IDLE_DIV        64u            // 1280 Hz -> 20 Hz while the slider rests
+
+/* Sleep after 200 ms within 4 raw LSB; wake on a step of more than 16 */
+static const AcqConfig acqCfg = { ACQ_MODE, 16u, 16u, 16u, IDLE_DIV };
+
+/* Called from the DMA interrupt for every half of adcBuf */
+void ADC_StreamBlock(const uint16_t *block, uint16_t count){
+  if (scopeMode) {
+    Scope_Block(block, count);
+    return;
+  }
+
+  uint16_t frames = Scan_Split(block, count, scanBuf, SCAN_BLOCK);
+  Acq_Block(sliderBuf, frames);
+#if TLM_RAW
+  for (uint16_t i = 0; i < frames; i += 3u) {
+    Telemetry_Adc(TLM_CH_RAW, sliderBuf + i, (uint8_t)(frames - i < 3u ? frames - i : 3u));
+  }
+#endif
+  __SEV();                         // wake the main loop out of WFE
+
+  /* heartbeat LED on PC8 */
+  HAL_GPIO_TogglePin(GPIOC, GPIO_PIN_8);
+}
+
+/* Acquisition hooks: slow down and watch, or back to the full rate */
+void Acq_HwSleep(uint16_t low, uint16_t high){
+  ADC_WatchdogMove(low, high);
+  ADC_StreamSetRate(SAMPLE_RATE_HZ / IDLE_DIV);
+  ADC_WatchdogIrq(1);
+}
+
+void Acq_HwWake(void){
+  ADC_WatchdogIrq(0);
+  ADC_StreamSetRate(SAMPLE_RATE_HZ);
+}
+
+/*
+ * Position stream: scan, filter, ring and the 1280 Hz ADC stream, from
+ * scratch.
+ * Event mode starts with the watchdog on but its window wide open;
+ * Acq_HwSleep() narrows it.
+ */
+static void StartPositionStream(uint8_t mode){
+  AcqConfig cfg = acqCfg;
+  ScanConfig scan;
+
+  ADC_StreamStop();
+  logBase = logNow;                     // sample times restart from 0
+  tlmBase = tlmMs;
+  tlmFill = 0;
+  ADC_ScanConfigure(&scan, SCAN_CHANNELS, SCAN_ABSOLUTE);
+  if (Scan_Init(&scan) != SCAN_FRAME) { Error_Handler(); }
+  sliderBuf = scanBuf + Scan_Slot(SCAN_SLIDER) * SCAN_BLOCK;
+
+  cfg.mode = mode;
+  Track_FadingGains(&trackCfg, TRACK_THETA, TRACK_ABG);
+  trackCfg.maxGap = 2u;
+  if (!Acq_Init(&cfg, &filterCfg, &trackCfg)) { Error_Handler(); }
+  if (mode == ACQ_EVENT) {
+    ADC_WatchdogWindow(0u, 4095u);
+  } else {
+    ADC_WatchdogOff();
+  }
+  if (ADC_ScanStart(adcBuf, 2u * SCAN_FRAME * SCAN_BLOCK, SAMPLE_RATE_HZ,
+                    SCAN_CHANNELS) == 0) {
+    Error_Handler();
+  }
+}
+
+/* Scope hooks: analog watchdog and GPIO trigger, stop, UART dump */
+void Scope_HwWatchdog(uint8_t on){
+  ADC_WatchdogIrq(on);
 }
 
-/* Called by HAL every 1 ms from SysTick_Handler */
-void HAL_SYSTICK_Callback(void){
-  static uint32_t msCount = 0;
-  msCount++;
-  if (msCount >= 100) {          // 100 ms -> 10 Hz
-    msCount = 0;
+void Scope_HwStop(void){
+  ADC_StreamFreeze();
+}
 
-    uint16_t s = ADC_In();       // take one ADC sample
-    ADC_Mailbox = s;
-    ADC_MailboxFlag = 1;
+void ADC_WatchdogEvent(uint16_t writeIndex){
+  if (scopeMode) {
+    Scope_Watchdog(writeIndex);
+  } else {
+    Acq_Watchdog();
+  }
+}
 
-    /* heartbeat LED on PC8 */
-    HAL_GPIO_TogglePin(GPIOC, GPIO_PIN_8);
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin){
+  if (scopeMode && (GPIO_Pin & SCOPE_TRIG_PIN)) {
+    Scope_External(ADC_StreamPosition());
   }
 }
 
+/* The dump borrows the telemetry UART; telemetry is suspended meanwhile */
+static void ScopePut(const uint8_t *data, uint16_t n){
+  Telemetry_SendRaw(data, n);
+}
+
+/* SysTick is off while the main loop sleeps, so telemetry takes its
+   time from the sample stream */
+uint32_t TelemetryPort_Now(void){
+  return tlmMs;
+}
+
+/* Every filtered sample goes out, three to a frame */
+static void TlmSample(const SampleRec *rec){
+  tlmMs = tlmBase + (uint32_t)((uint64_t)rec->time * 1000u / SAMPLE_RATE_HZ);
+  tlmBatch[tlmFill++] = rec->sample;
+  if (tlmFill == 3u) {
+    Telemetry_Adc(TLM_CH_FILTERED, tlmBatch, 3u);
+    tlmFill = 0;
+  }
+}
+
+static uint8_t ButtonDown(void){
+  return HAL_GPIO_ReadPin(GPIOA, CAL_BUTTON_PIN) == GPIO_PIN_RESET;
+}
+
+/*
+ * RunScope
+ * --------
+ * Stops the position stream, captures one triggered burst at
+ * SCOPE_RATE_HZ into adcBuf and dumps it on USART2 (tools/scope_decode.py).
+ * Pressing PA1 again gives up waiting for the trigger.
+ */
+static void RunScope(void){
+  uint16_t low, high;
+
+  LCD_Clear();
+  LCD_OutString("Scope armed");
+  while (ButtonDown()) {}
+  HAL_Delay(20);
+
+  ADC_StreamStop();
+  scopeMode = 1;
+  Scope_Window(&scopeCfg, &low, &high);
+  ADC_WatchdogWindow(low, high);
+  uint32_t rate = 0;
+  if (Scope_Arm(&scopeCfg, adcBuf, SCOPE_DEPTH)) {
+    rate = ADC_StreamStart(adcBuf, SCOPE_DEPTH, SCOPE_RATE_HZ);
+  }
+
+  while (rate != 0u && Scope_State() != SCOPE_DONE && !ButtonDown()) {
+    __WFE();
+  }
+  ADC_StreamStop();
+  scopeMode = 0;
+
+  LCD_Clear();
+  if (rate != 0u && Scope_State() == SCOPE_DONE) {
+    LCD_OutString("Scope sending");
+    Telemetry_Suspend();
+    Scope_Dump(rate, ScopePut);
+    Telemetry_Resume();
+    Log_Put(logNow, LOG_EV_SCOPE, 1u);
+  } else {
+    LCD_OutString("Scope stopped");
+    Log_Put(logNow, LOG_EV_SCOPE, 0u);
+  }
+  while (ButtonDown()) {}
+  HAL_Delay(500);
+
+  StartPositionStream(ACQ_MODE);
+  LCD_Clear();
+}
+
+/* Next filtered sample taken after this call */
+static uint16_t WaitSample(void){
+  SampleRec rec;
+
+  while (SampleRing_Get(&rec)) {}        // drop anything older
+  while (!SampleRing_Get(&rec)) {
+    __WFE();
+  }
+  return rec.sample;
+}
+
+static void WaitPress(void){
+  while (HAL_GPIO_ReadPin(GPIOA, CAL_BUTTON_PIN) == GPIO_PIN_RESET) {}
+  HAL_Delay(20);                 // let the release bounce settle
+  while (HAL_GPIO_ReadPin(GPIOA, CAL_BUTTON_PIN) == GPIO_PIN_SET) {}
+  HAL_Delay(20);
+}
+
+/*
+ * Calibrate
+ * ---------
+ * Asks for each calRefs[] position in turn; move the slider there and
+ * press PA1. The table is rebuilt and stored in flash.
+ */
+static void Calibrate(void){
+  CalibPoints p;
+  p.count = 0;
+  p.bits = Filter_Bits();
+
+  for (uint8_t i = 0; i < sizeof(calRefs) / sizeof(calRefs[0]); i++) {
+    LCD_Clear();
+    LCD_OutString("Cal ");
+    LCD_OutUFix(calRefs[i]);
+    LCD_OutString(" cm");
+    WaitPress();
+    Calib_AddPoint(&p, WaitSample(), calRefs[i]);
+  }
+
+  LCD_Clear();
+  if (Calib_Build(&p) && CalibStore_Save(&p)) {
+    calPoints = p;
+    LCD_OutString("Cal saved");
+    Log_Put(logNow, LOG_EV_CAL, p.count);
+  } else {
+    Calib_Build(&calPoints);     // back to the previous table
+    LCD_OutString("Cal failed");
+  }
+  HAL_Delay(1000);
+}
+
 int main(void)
 {
   HAL_Init();
   SystemClock_Config();
   MX_GPIO_Init();
   MX_ADC_Init();
+  Telemetry_Init(TLM_APP_POSITION, TLM_BAUD);
 
   ADC_DriverInit();
+  StartPositionStream(ACQ_PERIODIC);    // calibration needs every sample
 
   HAL_Delay(100);
   LCD_Init();
+
+  /* Position log: find where the last run stopped */
+  LogStats logStats;
+  Eeprom_Init();
+  Log_Init(LOG_FLUSH_AGE);
+  Log_GetStats(&logStats);
+  Log_Put(logNow, LOG_EV_BOOT, logStats.recovered);
+
+  /* Stored calibration, or the plain linear map if there is none */
+  if (!CalibStore_Load(&calPoints) || calPoints.bits != Filter_Bits() ||
+      !Calib_Build(&calPoints)) {
+    Calib_Default(&calPoints, Filter_FullScale(), Filter_Bits(), POS_MAX);
+    Calib_Build(&calPoints);
+  }
+  if (HAL_GPIO_ReadPin(GPIOA, CAL_BUTTON_PIN) == GPIO_PIN_RESET) {
+    Calibrate();
+  }
+  StartPositionStream(ACQ_MODE);
+
   LCD_Clear();
  LCD_OutString("Pos: 0.000 cm");
 
   //uint32_t lastPos = 0xFFFFFFFFu;
+  uint32_t logged = 0xFFFFu;
+  uint8_t  wasIdle = 0;
 
 while (1) {
-  /* 1) Wait for the mailbox flag to be set */
-  while (!ADC_MailboxFlag) {
-    // busy-wait; nothing else in foreground
+  /* 1) Sleep until the DMA interrupt has queued a sample or PA1 goes
+        down. The DMA interrupt ends with SEV, so a sample queued after
+        the check still makes WFE return. SysTick is only needed by the
+        LCD, so it does not wake us every millisecond. */
+  SampleRec rec;
+  uint8_t got;
+  HAL_SuspendTick();
+  while (!(got = SampleRing_Get(&rec)) && !ButtonDown()) {
+    if (Log_Pending()) {
+      Log_Poll(logNow);          // a page write is running: keep it moving
+      continue;
+    }
+    __WFE();
+    Acq_Wakeup();
   }
+  HAL_ResumeTick();
 
-  /* 2 & 3) Read ADC sample from mailbox and clear flag (atomically) */
-  uint16_t sample;
-  __disable_irq();
-  sample = ADC_Mailbox;
-  ADC_MailboxFlag = 0;
-  __enable_irq();
+  /* PA1 during normal running: one scope capture */
+  if (ButtonDown()) {
+    RunScope();
+    continue;
+  }
+
+  /* 2 & 3) Drain the ring; each block queues 8 samples, all of which
+            already went through the tracker, and the LCD only shows
+            its newest state. Telemetry gets every one of them. */
+  if (got) {
+    TlmSample(&rec);
+  }
+  while (SampleRing_Get(&rec)) {
+    TlmSample(&rec);
+  }
+  TrackState st;
+  Track_Get(&st);
+  uint16_t sample = (uint16_t)((st.pos + 0x8000) >> 16);
 
-  /* 4) Convert ADC sample to fixed-point position (0.001 cm units) */
+  /* 4) Convert to fixed-point position (0.001 cm) and velocity (0.001 cm/s) */
   uint32_t pos = Position_FromSample(sample);  // 0..2000 -> 0.000–2.000 cm
+  int32_t  vel = Velocity_FromTrack(sample, st.vel, SAMPLE_RATE_HZ >> filterCfg.osLog2);
 
-  /* 5) Output fixed-point number on LCD with units of cm */
+  /* Log moves and idle/wake, then give the EEPROM its turn */
+  logNow = logBase + LOG_TICKS(st.time);
+  if (Acq_Idle() != wasIdle) {
+    wasIdle = Acq_Idle();
+    Log_Put(logNow, wasIdle ? LOG_EV_IDLE : LOG_EV_WAKE, 0u);
+    Telemetry_State(TLM_FSM_ACQ, (uint8_t)!wasIdle, wasIdle, 0u, pos);
+    if (wasIdle) {
+      Log_Flush();               // nothing more until the slider moves
+      Log_GetStats(&logStats);
+      Telemetry_Counter(TLM_C_LOG_PAGES, logStats.pages);
+    }
+  }
+  if (pos + LOG_STEP <= logged || logged + LOG_STEP <= pos) {
+    logged = pos;
+    Log_Put(logNow, LOG_POS, (uint16_t)pos);
+  }
+  Log_Poll(logNow);
+  if (!Acq_Redraw(pos, vel)) {
+    continue;                    // event mode: same values, leave the LCD alone
+  }
+  Telemetry_Counter(TLM_C_POS, pos);
+  Telemetry_Counter(TLM_C_VEL, (uint32_t)vel);
+
+  /* 5) Output fixed-point numbers on LCD with units of cm and cm/s */
   LCD_Clear();
   LCD_OutString("Pos: ");
   LCD_OutUFix(pos);       // prints X.XXX
   LCD_OutString(" cm");
+  LCD_OutCmd(0xC0);       // second line
+  LCD_OutString("Vel: ");
+  LCD_OutChar(vel < 0 ? '-' : ' ');
+  LCD_OutUFix((uint32_t)(vel < 0 ? -vel : vel));   // *.*** above 9.999
+  LCD_OutString(" cm/s");
 
-    
     /* no blocking delays needed; loop just waits for new samples */
   }
 }
@@ -157,6 +518,21 @@ static void MX_GPIO_Init(void)
   GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
   HAL_GPIO_Init(GPIOC, &GPIO_InitStruct);
 
+  /* Calibration button PA1, active low; its edge only wakes the main loop */
+  GPIO_InitStruct.Pin   = CAL_BUTTON_PIN;
+  GPIO_InitStruct.Mode  = GPIO_MODE_IT_FALLING;
+  GPIO_InitStruct.Pull  = GPIO_PULLUP;
+  HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
+
+  /* Scope trigger input PB0, rising edge */
+  __HAL_RCC_GPIOB_CLK_ENABLE();
+  GPIO_InitStruct.Pin   = SCOPE_TRIG_PIN;
+  GPIO_InitStruct.Mode  = GPIO_MODE_IT_RISING;
+  GPIO_InitStruct.Pull  = GPIO_PULLDOWN;
+  HAL_GPIO_Init(GPIOB, &GPIO_InitStruct);
+  HAL_NVIC_SetPriority(EXTI0_1_IRQn, 0, 0);
+  HAL_NVIC_EnableIRQ(EXTI0_1_IRQn);
+
   /* default low */
   HAL_GPIO_WritePin(GPIOA, GPIO_PIN_8 | GPIO_PIN_9, GPIO_PIN_RESET);
   HAL_GPIO_WritePin(GPIOC, GPIO_PIN_0 | GPIO_PIN_1 |
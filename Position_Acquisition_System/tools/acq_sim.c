@@ -0,0 +1,204 @@
+/*
+ * Run the acquisition modes (Acq.c with Filter, Track, SampleRing and
+ * Calib) on a PC against a simulated slider and ADC, and compare them.
+ * The ADC samples a scripted slider plus Gaussian noise at 1280 Hz, or
+ * at 1280 / IDLE_DIV Hz after Acq_HwSleep(); 128-sample blocks go to
+ * Acq_Block() as from the DMA interrupt. The analog watchdog, once
+ * Acq_HwSleep() turned it on, calls Acq_Watchdog() on the first sample
+ * outside its window. The main loop is modelled as main.c runs it: it
+ * wakes on every interrupt (Acq_Wakeup()), sleeps again while the ring
+ * is empty, and otherwise drains it and offers the tracker's position
+ * and velocity to Acq_Redraw().
+ *
+ * The script, 90 s: rest at 1000, 1000 -> 3000 over 1 s at 10 s, a
+ * 40 LSB wiggle at 40 s, 3000 -> 500 over 2 s at 60 s.
+ *   - event mode takes far fewer wake-ups, conversions and redraws
+ *   - the watchdog wakes once per move, not at rest
+ *   - at rest before each move and at the end, both modes show the
+ *     same position to within a count
+ * A second pass at NOISY_LSB noise shows what happens when the noise
+ * approaches the window (printed, not checked).
+ *
+ * Build from the project folder:
+ *   gcc -O2 -Wall -Wextra -I. -I../Common -o acq_sim tools/acq_sim.c Acq.c \
+ *       Filter.c Track.c SampleRing.c Calib.c -lm
+ *   ./acq_sim [seed]
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "Acq.h"
+#include "Calib.h"
+#include "SampleRing.h"
+
+#define RATE_HZ      1280u
+#define IDLE_DIV     64u
+#define BLOCK        128u
+#define SECONDS      90u
+#define NOISE_LSB    2.0
+#define NOISY_LSB    6.0
+#define POS_MAX      2000u
+#define THETA        45875u          // 0.7 in Q16, as main.c
+
+static const double restAt[] = { 9.9, 39.9, 59.9, 89.9 };
+#define RESTS  (sizeof restAt / sizeof restAt[0])
+
+static const AcqConfig    acqCfg    = { ACQ_PERIODIC, 16u, 16u, 16u, IDLE_DIV };
+static const FilterConfig filterCfg = { 4u, FILTER_IIR, 2u, 3u };
+
+static uint8_t  awdOn;
+static uint16_t awdLow, awdHigh;
+static uint32_t period;             // full-rate ticks per sample
+static int      failures;
+
+static void check(int ok, const char *what)
+{
+  printf("%-58s %s\n", what, ok ? "ok" : "FAIL");
+  failures += !ok;
+}
+
+void Acq_HwSleep(uint16_t low, uint16_t high)
+{
+  awdLow = low;
+  awdHigh = high;
+  period = IDLE_DIV;
+  awdOn = 1;
+}
+
+void Acq_HwWake(void)
+{
+  awdOn = 0;
+  period = 1u;
+}
+
+static double gauss(void)
+{
+  double u = (rand() + 1.0) / (RAND_MAX + 2.0), v = (rand() + 1.0) / (RAND_MAX + 2.0);
+  return sqrt(-2.0 * log(u)) * cos(2.0 * M_PI * v);
+}
+
+/* Slider position in raw LSB at time s */
+static double slider(double s)
+{
+  if (s < 10.0) {
+    return 1000.0;
+  }
+  if (s < 11.0) {
+    return 1000.0 + 2000.0 * (s - 10.0);
+  }
+  if (s >= 40.0 && s < 40.5) {
+    return 3000.0 + 40.0 * sin(M_PI * (s - 40.0) / 0.5);
+  }
+  if (s < 60.0) {
+    return 3000.0;
+  }
+  if (s < 62.0) {
+    return 3000.0 - 2500.0 * (s - 60.0) / 2.0;
+  }
+  return 500.0;
+}
+
+/* The main loop after a wake-up: drain, convert, offer to the LCD */
+static void mainLoop(uint32_t *shown)
+{
+  SampleRec rec;
+  TrackState st;
+  uint8_t got = 0;
+
+  Acq_Wakeup();
+  while (SampleRing_Get(&rec)) {
+    got = 1;
+  }
+  if (!got) {
+    return;                       // back to WFE
+  }
+  Track_Get(&st);
+  uint16_t sample = (uint16_t)((st.pos + 0x8000) >> 16);
+  uint32_t pos = Calib_Position(sample);
+  int64_t v = (int64_t)Calib_Delta(sample, st.vel) * (int32_t)(RATE_HZ >> filterCfg.osLog2);
+  int32_t vel = (int32_t)((v + 0x8000) >> 16);
+  if (Acq_Redraw(pos, vel)) {
+    *shown = pos;
+  }
+}
+
+/* One 90 s run; 'at' gets the shown position at each rest time */
+static void run(uint8_t mode, double noise, AcqStats *st, uint32_t *at)
+{
+  AcqConfig c = acqCfg;
+  TrackConfig tc;
+  static uint16_t block[BLOCK];
+  uint16_t fill = 0;
+  uint32_t shown = 0, next = 0, r = 0;
+
+  c.mode = mode;
+  Track_FadingGains(&tc, THETA, TRACK_ABG);
+  tc.maxGap = 2u;
+  Acq_Init(&c, &filterCfg, &tc);
+  Acq_HwWake();
+
+  for (uint32_t tick = 0; tick < SECONDS * RATE_HZ; tick++) {
+    double s = (double)tick / RATE_HZ;
+    while (r < RESTS && s >= restAt[r]) {
+      at[r++] = shown;
+    }
+    if (tick < next) {
+      continue;
+    }
+    next = tick + period;
+
+    double x = slider(s) + noise * gauss();
+    uint16_t sample = (uint16_t)lround(x < 0.0 ? 0.0 : x > 4095.0 ? 4095.0 : x);
+    block[fill++] = sample;
+    if (awdOn && (sample < awdLow || sample > awdHigh)) {
+      Acq_Watchdog();             // the interrupt, then the main loop wakes
+      mainLoop(&shown);
+    }
+    if (fill == BLOCK) {
+      Acq_Block(block, BLOCK);
+      fill = 0;
+      mainLoop(&shown);
+    }
+  }
+  while (r < RESTS) {
+    at[r++] = shown;
+  }
+  Acq_GetStats(st);
+}
+
+int main(int argc, char **argv)
+{
+  AcqStats per, ev, noisy;
+  uint32_t atPer[RESTS], atEv[RESTS], atNoisy[RESTS];
+  CalibPoints p;
+
+  srand((argc > 1) ? (unsigned)atoi(argv[1]) : 1u);
+  Calib_Default(&p, 16380u, 14, POS_MAX);
+  Calib_Build(&p);
+
+  run(ACQ_PERIODIC, NOISE_LSB, &per, atPer);
+  run(ACQ_EVENT, NOISE_LSB, &ev, atEv);
+  run(ACQ_EVENT, NOISY_LSB, &noisy, atNoisy);
+
+  printf("%u s, %.0f LSB rms noise   wake-ups  conversions  redraws  watchdog\n",
+         SECONDS, NOISE_LSB);
+  printf("  periodic                %8u  %11u  %7u  %8s\n", per.wakeups, per.conversions,
+         per.redraws, "-");
+  printf("  event                   %8u  %11u  %7u  %8u\n", ev.wakeups, ev.conversions,
+         ev.redraws, ev.motions);
+  printf("  event, %.0f LSB rms noise %8u  %11u  %7u  %8u\n", NOISY_LSB, noisy.wakeups,
+         noisy.conversions, noisy.redraws, noisy.motions);
+
+  int same = 1;
+  for (uint32_t r = 0; r < RESTS; r++) {
+    printf("  at %4.1f s: periodic %u, event %u (0.001 cm)\n", restAt[r], atPer[r], atEv[r]);
+    same &= abs((int)atPer[r] - (int)atEv[r]) <= 1;
+  }
+  check(ev.wakeups * 5u < per.wakeups && ev.conversions * 5u < per.conversions &&
+        ev.redraws * 5u < per.redraws, "event mode: a fifth of the work or less");
+  check(ev.motions == 3u, "watchdog wakes once per move");
+  check(same, "same position at rest in both modes, within 1 count");
+
+  printf("%s\n", failures ? "FAILED" : "all passed");
+  return failures != 0;
+}
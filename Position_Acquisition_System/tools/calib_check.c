@@ -0,0 +1,203 @@
+/*
+ * Check the piecewise-linear conversion (Calib.c) on a PC:
+ *   - default: the two-point table against the old linear formula
+ *     (s * 2000 + fs / 2) / fs, for every input at 12 to 16 bits
+ *   - tables: a fixed 9-point nonlinear table and random tables of 2 to
+ *     9 points, rising and falling, against exact interpolation for
+ *     every input, and Calib_Delta() against the segment slope. The
+ *     slope is rounded to q >= 16 fraction bits, so a segment dx wide
+ *     can be off by dx / 2^(q+1) on top of the final rounding; q is 16
+ *     only for the steepest tables
+ *   - Calib_Delta() saturates where the result leaves int32_t
+ *   - rejects: duplicate samples, too few points, positions above
+ *     CALIB_MAX_POS; the old table stays in use
+ *   - cost: host time per conversion against the divide formula (a PC
+ *     figure; on the M0 the divide is a library call)
+ *
+ * Build from the project folder:
+ *   gcc -O2 -Wall -Wextra -I. -o calib_check tools/calib_check.c Calib.c -lm
+ *   ./calib_check [seed]
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "Calib.h"
+
+#define POS_MAX       2000u           // 2.000 cm
+#define RANDOM_TABLES 2000u
+#define BENCH         (64u * 1024u * 1024u)
+
+static int failures;
+
+static void check(int ok, const char *what)
+{
+  printf("%-58s %s\n", what, ok ? "ok" : "FAIL");
+  failures += !ok;
+}
+
+/* Exact interpolation through p (sorted), clamped at the ends */
+static double exact(const CalibPoints *p, uint16_t s)
+{
+  if (s <= p->sample[0]) {
+    return p->pos[0];
+  }
+  for (uint8_t i = 1; i < p->count; i++) {
+    if (s <= p->sample[i]) {
+      double f = (double)(s - p->sample[i - 1u]) / (p->sample[i] - p->sample[i - 1u]);
+      return p->pos[i - 1u] + f * ((double)p->pos[i] - p->pos[i - 1u]);
+    }
+  }
+  return p->pos[p->count - 1u];
+}
+
+/* Worst |Calib_Position - exact| over every input up to fullScale */
+static double worstError(const CalibPoints *p, uint16_t fullScale)
+{
+  double worst = 0.0;
+  for (uint32_t s = 0; s <= fullScale; s++) {
+    double e = fabs(Calib_Position((uint16_t)s) - exact(p, (uint16_t)s));
+    worst = e > worst ? e : worst;
+  }
+  return worst;
+}
+
+static void defaults(void)
+{
+  uint32_t worst = 0;
+  int exact12 = 1;
+
+  for (uint8_t bits = 12; bits <= 16u; bits++) {
+    uint16_t fs = (uint16_t)(4095u << (bits - 12u));
+    CalibPoints p;
+    Calib_Default(&p, fs, bits, POS_MAX);
+    Calib_Build(&p);
+    for (uint32_t s = 0; s <= fs; s++) {
+      uint32_t old = (s * POS_MAX + fs / 2u) / fs;
+      uint32_t d = (uint32_t)abs((int)Calib_Position((uint16_t)s) - (int)old);
+      worst = d > worst ? d : worst;
+      exact12 &= bits != 12u || d == 0u;
+    }
+  }
+  printf("default table, 12..16 bits: worst difference %u count(s)\n", worst);
+  check(worst <= 1u, "default table within 1 count of the old formula");
+  check(exact12, "default table exact at 12 bits");
+}
+
+static void tables(void)
+{
+  /* 9 points over 14 bits on a bent curve, added out of order */
+  static const uint16_t xs[9] = { 16380, 0, 2100, 4000, 6200, 8190, 10500, 12800, 14600 };
+  CalibPoints p = { .count = 0, .bits = 14 };
+  for (uint8_t i = 0; i < 9u; i++) {
+    double f = xs[i] / 16380.0;
+    Calib_AddPoint(&p, xs[i], (uint16_t)lround(POS_MAX * (0.85 * f + 0.15 * f * f)));
+  }
+  check(Calib_Build(&p) && p.sample[0] == 0u && p.sample[8] == 16380u, "9 points build, sorted");
+  double nine = worstError(&p, 16380u);
+  printf("9-point table: worst error %.3f counts against exact interpolation\n", nine);
+
+  /* Random tables, rising and falling: positions up to 2.000 cm, as
+     the capture on the board makes, and up to CALIB_MAX_POS */
+  double worst[2] = { 0.0, 0.0 }, worstDelta = 0.0;
+  int saturated = 1;
+  for (uint32_t t = 0; t < RANDOM_TABLES; t++) {
+    CalibPoints r = { .count = 0, .bits = 14 };
+    uint8_t n = (uint8_t)(2 + rand() % (CALIB_MAX_POINTS - 1u));
+    uint8_t full = t % 2u;
+    uint32_t top = full ? CALIB_MAX_POS : POS_MAX;
+    for (uint8_t i = 0; i < n; i++) {
+      Calib_AddPoint(&r, (uint16_t)(rand() % 16381), (uint16_t)((uint32_t)rand() % (top + 1u)));
+    }
+    if (!Calib_Build(&r)) {
+      continue;                    // two drew the same sample
+    }
+    double e = worstError(&r, 16380u);
+    worst[full] = e > worst[full] ? e : worst[full];
+
+    /* Delta: a Q16 step of 100 samples inside each segment */
+    for (uint8_t i = 0; i + 1u < r.count; i++) {
+      double dy = (double)r.pos[i + 1u] - r.pos[i], dx = r.sample[i + 1u] - r.sample[i];
+      double want = 100.0 * 65536.0 * dy / dx;
+      int32_t got = Calib_Delta(r.sample[i], 100 * 65536);
+      if (fabs(want) >= 2147483647.0) {
+        saturated &= got == (want > 0.0 ? INT32_MAX : INT32_MIN);
+        continue;
+      }
+      double d = fabs(got - want) / 65536.0;
+      worstDelta = d > worstDelta ? d : worstDelta;
+    }
+  }
+  printf("%u random tables: worst error %.3f counts up to 2.000 cm, %.3f up to %u\n",
+         RANDOM_TABLES, worst[0], worst[1], CALIB_MAX_POS);
+  printf("Calib_Delta(): worst %.3f counts over 100 samples\n", worstDelta);
+  check(nine <= 0.51 && worst[0] <= 0.51, "within 0.51 counts of exact interpolation, 2.000 cm");
+  check(worst[1] <= 0.5 + 16380.0 / (1u << 17), "within 0.5 + dx / 2^17 counts, full range");
+  check(worstDelta <= 0.5, "Calib_Delta() follows the segment slope");
+  check(saturated, "Calib_Delta() saturates instead of wrapping");
+  Calib_Build(&p);
+}
+
+static void rejects(void)
+{
+  CalibPoints good, bad;
+  Calib_Default(&good, 16380u, 14, POS_MAX);
+  Calib_Build(&good);
+  uint16_t before = Calib_Position(8190u);
+
+  Calib_Default(&bad, 16380u, 14, POS_MAX);
+  Calib_AddPoint(&bad, 8190u, 100u);
+  Calib_AddPoint(&bad, 8190u, 900u);
+  int dup = !Calib_Build(&bad);
+
+  bad.count = 1;
+  int few = !Calib_Build(&bad);
+
+  Calib_Default(&bad, 16380u, 14, CALIB_MAX_POS + 1u);
+  int high = !Calib_Build(&bad);
+
+  Calib_Default(&bad, 16380u, 14, POS_MAX);
+  for (uint8_t i = 2; i < CALIB_MAX_POINTS; i++) {
+    Calib_AddPoint(&bad, (uint16_t)(i * 100u), i);
+  }
+  int full = !Calib_AddPoint(&bad, 50u, 1u);
+
+  check(dup && few && high && full, "duplicates, one point, high positions, a 10th point refused");
+  check(Calib_Position(8190u) == before, "a refused table leaves the old one in use");
+}
+
+static void bench(void)
+{
+  CalibPoints p;
+  volatile uint32_t fs = 16380u;
+  uint32_t sum = 0;
+
+  Calib_Default(&p, 16380u, 14, POS_MAX);
+  Calib_Build(&p);
+
+  clock_t t0 = clock();
+  for (uint32_t i = 0; i < BENCH; i++) {
+    sum += Calib_Position((uint16_t)((i * 40503u) % 16381u));
+  }
+  double table = (double)(clock() - t0) / CLOCKS_PER_SEC * 1e9 / BENCH;
+
+  t0 = clock();
+  for (uint32_t i = 0; i < BENCH; i++) {
+    uint32_t s = (i * 40503u) % 16381u;
+    sum += (s * POS_MAX + fs / 2u) / fs;
+  }
+  double divide = (double)(clock() - t0) / CLOCKS_PER_SEC * 1e9 / BENCH;
+  printf("host: %.2f ns per conversion, %.2f ns for the divide (checksum %u)\n",
+         table, divide, sum & 0xFFFFu);
+}
+
+int main(int argc, char **argv)
+{
+  srand((argc > 1) ? (unsigned)atoi(argv[1]) : 1u);
+  defaults();
+  tables();
+  rejects();
+  bench();
+  printf("%s\n", failures ? "FAILED" : "all passed");
+  return failures != 0;
+}
@@ -0,0 +1,150 @@
+/*
+ * Check the fixed-point filter pipeline (Filter.c) on a PC:
+ *   - noise: a steady mid-scale input with 3 LSB rms Gaussian noise
+ *     through each configuration in the README table; the output noise
+ *     is given in 12-bit LSBs
+ *   - spikes: 1-in-200 samples replaced by +/-800 LSB spikes, without
+ *     decimation, raw against a median of 5
+ *   - blocks: random block lengths give exactly the output of
+ *     fixed 128-sample blocks
+ *   - cost: host time per input sample (a PC figure, not M0 cycles)
+ *
+ * Build from the project folder:
+ *   gcc -O2 -Wall -Wextra -I. -o filter_check tools/filter_check.c Filter.c -lm
+ *   ./filter_check [seed]
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "Filter.h"
+
+#define SAMPLES       (1u << 20)
+#define BLOCK         128u
+#define NOISE_RMS     3.0
+#define SPIKE_EVERY   200
+#define SPIKE_LSB     800
+#define MID           2048.0
+
+static uint16_t in[SAMPLES];
+static uint16_t out[SAMPLES + 1u];
+static uint16_t out2[SAMPLES + 1u];
+static int      failures;
+
+static void check(int ok, const char *what)
+{
+  printf("%-58s %s\n", what, ok ? "ok" : "FAIL");
+  failures += !ok;
+}
+
+static double gauss(void)
+{
+  double u = (rand() + 1.0) / (RAND_MAX + 2.0), v = (rand() + 1.0) / (RAND_MAX + 2.0);
+  return sqrt(-2.0 * log(u)) * cos(2.0 * M_PI * v);
+}
+
+static void makeInput(int spikes)
+{
+  for (uint32_t i = 0; i < SAMPLES; i++) {
+    double x = MID + NOISE_RMS * gauss();
+    if (spikes && rand() % SPIKE_EVERY == 0) {
+      x += (rand() & 1) ? SPIKE_LSB : -SPIKE_LSB;
+    }
+    in[i] = (uint16_t)lround(x < 0.0 ? 0.0 : x > 4095.0 ? 4095.0 : x);
+  }
+}
+
+/* Whole input through the filter in blocks of 'block' (0 = random) */
+static uint32_t run(const FilterConfig *c, uint16_t block, uint16_t *dst)
+{
+  uint32_t m = 0;
+
+  Filter_Init(c);
+  for (uint32_t i = 0; i < SAMPLES; ) {
+    uint32_t n = block ? block : 1u + (uint32_t)rand() % 300u;
+    n = n < SAMPLES - i ? n : SAMPLES - i;
+    m += Filter_Process(&in[i], (uint16_t)n, &dst[m]);
+    i += n;
+  }
+  return m;
+}
+
+/* rms about mid-scale, in 12-bit LSBs, after the first 'skip' outputs */
+static double noise(const uint16_t *y, uint32_t m, uint32_t skip)
+{
+  double scale = (double)(1u << (Filter_Bits() - FILTER_IN_BITS)), sum = 0.0;
+
+  for (uint32_t i = skip; i < m; i++) {
+    double e = y[i] / scale - MID;
+    sum += e * e;
+  }
+  return sqrt(sum / (m - skip));
+}
+
+int main(int argc, char **argv)
+{
+  static const struct { const char *name; FilterConfig cfg; double claim; } rows[] = {
+    { "raw",            { 0, FILTER_NONE, 1, 3 }, 3.01 },
+    { "16x boxcar",     { 4, FILTER_NONE, 1, 3 }, 0.76 },
+    { "16x + IIR, k=2", { 4, FILTER_IIR,  2, 3 }, 0.30 },
+    { "256x boxcar",    { 8, FILTER_NONE, 1, 3 }, 0.19 },
+  };
+  srand((argc > 1) ? (unsigned)atoi(argv[1]) : 1u);
+
+  /* Noise */
+  makeInput(0);
+  double raw = 0.0;
+  int near = 1;
+  printf("%u samples, %.1f LSB rms noise:\n", SAMPLES, NOISE_RMS);
+  for (uint32_t r = 0; r < sizeof rows / sizeof rows[0]; r++) {
+    uint32_t m = run(&rows[r].cfg, BLOCK, out);
+    double n = noise(out, m, 16u);
+    raw = r == 0u ? n : raw;
+    printf("  %-16s %5.2f LSB  %4.1f dB  (README %.2f)\n", rows[r].name, n,
+           20.0 * log10(raw / n), rows[r].claim);
+    near &= fabs(n - rows[r].claim) <= 0.02 + 0.05 * rows[r].claim;
+  }
+  check(near, "output noise matches the README table");
+
+  /* Spikes */
+  makeInput(1);
+  FilterConfig none = { 0, FILTER_NONE, 1, 3 }, med5 = { 0, FILTER_MEDIAN, 1, 5 };
+  double spiky = noise(out, run(&none, BLOCK, out), 0);
+  double cleaned = noise(out, run(&med5, BLOCK, out), 0);
+  printf("1-in-%d spikes of %d LSB: %.1f LSB rms raw, %.2f after median-5\n",
+         SPIKE_EVERY, SPIKE_LSB, spiky, cleaned);
+  check(cleaned < 2.0, "median-5 removes the spikes");
+
+  /* Block lengths */
+  int same = 1;
+  for (uint32_t r = 1; r < sizeof rows / sizeof rows[0]; r++) {
+    uint32_t a = run(&rows[r].cfg, BLOCK, out), b = run(&rows[r].cfg, 0, out2);
+    same &= a == b;
+    for (uint32_t i = 0; same && i < a; i++) {
+      same = out[i] == out2[i];
+    }
+  }
+  same &= run(&med5, BLOCK, out) == run(&med5, 0, out2);
+  check(same, "random block lengths give the same output");
+
+  /* Host cost */
+  static const struct { const char *name; FilterConfig cfg; } bench[] = {
+    { "16x boxcar", { 4, FILTER_NONE, 1, 3 } },
+    { "16x + IIR",  { 4, FILTER_IIR,  2, 3 } },
+    { "median-7",   { 0, FILTER_MEDIAN, 1, 7 } },
+  };
+  uint32_t sum = 0;
+  for (uint32_t r = 0; r < sizeof bench / sizeof bench[0]; r++) {
+    clock_t t0 = clock();
+    for (uint32_t k = 0; k < 8u; k++) {
+      uint32_t m = run(&bench[r].cfg, BLOCK, out);
+      sum += out[m - 1u];
+    }
+    double ns = (double)(clock() - t0) / CLOCKS_PER_SEC * 1e9 / (8.0 * SAMPLES);
+    printf("host: %-10s %.2f ns per input sample\n", bench[r].name, ns);
+  }
+  printf("(checksum %u)\n", sum & 0xFFFFu);
+
+  printf("%s\n", failures ? "FAILED" : "all passed");
+  return failures != 0;
+}
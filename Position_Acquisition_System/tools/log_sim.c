@@ -0,0 +1,207 @@
+/*
+ * Run the position log (Log.c) against the RAM EEPROM (Eeprom_Ram.c) on
+ * a PC: a simulated day of slider use for write amplification and wear,
+ * then repeated power failures at random points, each followed by a
+ * restart, to check what Log_Init() recovers.
+ *
+ * Build from the project folder:
+ *   gcc -O2 -Wall -Wextra -I. -DEEPROM_BACKEND=EEPROM_BACKEND_RAM -o log_sim \
+ *       tools/log_sim.c Log.c Eeprom_Ram.c
+ *   ./log_sim [seed]
+ *
+ * Time is in 0.1 s, as in main.c; the main loop polls the log every
+ * tick and logs the position whenever it moved by LOG_STEP.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include "Log.h"
+
+#define LOG_STEP     10          // 0.010 cm, as main.c
+#define FLUSH_AGE    50u         // 5 s
+#define DAY          864000u     // ticks
+#define MAX_TRUTH    400000u
+#define FAILURES     2000u
+#define PAGE_RECS    5           // (16 - 4 header - 1 base) / 2 bytes
+
+static LogRec   truth[MAX_TRUTH];
+static uint32_t truthLen;
+
+static LogRec   seen[MAX_TRUTH];
+static uint32_t seenLen;
+
+static uint32_t now;
+static uint16_t pos, logged;
+static int32_t  vel;               // 0.001 cm per tick
+static uint32_t restLeft;
+
+static void put(uint8_t kind, uint16_t value)
+{
+  if (Log_Put(now, kind, value) && truthLen < MAX_TRUTH) {
+    truth[truthLen].time = now;
+    truth[truthLen].kind = kind;
+    truth[truthLen].value = value;
+    truthLen++;
+  }
+}
+
+/* A hand on the slider: moves of a second or two, then rests */
+static void tick(void)
+{
+  if (restLeft > 0u) {
+    if (--restLeft == 0u) {
+      vel = (rand() % 61) - 30;
+      put(LOG_EV_WAKE, 0);
+    }
+  } else {
+    int32_t p = (int32_t)pos + vel + (rand() % 5) - 2;
+    pos = (uint16_t)(p < 0 ? 0 : p > 2000 ? 2000 : p);
+    if (rand() % 15 == 0) {
+      restLeft = 100u + (uint32_t)(rand() % 3000);     // 10 s .. 5 min
+      put(LOG_EV_IDLE, 0);
+      Log_Flush();
+    }
+  }
+  if (abs((int)pos - (int)logged) >= LOG_STEP) {
+    logged = pos;
+    put(LOG_POS, pos);
+  }
+  Log_Poll(now);
+  now++;
+}
+
+static void collect(const LogRec *rec, void *ctx)
+{
+  (void)ctx;
+  if (seenLen < MAX_TRUTH) {
+    seen[seenLen++] = *rec;
+  }
+}
+
+static int same(const LogRec *a, const LogRec *b)
+{
+  return a->time == b->time && a->kind == b->kind && a->value == b->value;
+}
+
+/* Index in truth of seen[0], if seen is one contiguous slice of it */
+static long slice(void)
+{
+  if (seenLen == 0u) {
+    return 0;
+  }
+  for (long s = (long)truthLen - (long)seenLen; s >= 0; s--) {
+    uint32_t i = 0;
+    while (i < seenLen && same(&seen[i], &truth[s + (long)i])) {
+      i++;
+    }
+    if (i == seenLen) {
+      return s;
+    }
+  }
+  return -1;
+}
+
+static void walk(void)
+{
+  seenLen = 0;
+  Log_Walk(collect, NULL);
+}
+
+static void day(void)
+{
+  EepromRamStats es;
+  LogStats ls;
+
+  Eeprom_Init();
+  Log_Init(FLUSH_AGE);
+  put(LOG_EV_BOOT, 0);
+  for (uint32_t t = 0; t < DAY; t++) {
+    tick();
+  }
+  Log_Flush();
+  while (Log_Pending()) {
+    Log_Poll(now);
+  }
+  Log_GetStats(&ls);
+  Eeprom_RamGetStats(&es);
+
+  uint32_t minC = 0xFFFFFFFFu, maxC = 0;
+  for (uint32_t p = 0; p < LOG_PAGES; p++) {
+    minC = es.pageCycles[p] < minC ? es.pageCycles[p] : minC;
+    maxC = es.pageCycles[p] > maxC ? es.pageCycles[p] : maxC;
+  }
+  double amp = (double)ls.pages * EEPROM_PAGE / ls.recordBytes;
+  double years = 1e6 * LOG_PAGES / ls.pages / 365.0;
+
+  printf("one day: %u records, %u dropped, %.2f bytes/record, %.1f records/page\n",
+         ls.records, ls.dropped, (double)ls.recordBytes / ls.records,
+         (double)ls.records / ls.pages);
+  printf("  %u page writes (%.1f/hour), write amplification %.2f "
+         "(one page per record: %.2f)\n",
+         ls.pages, ls.pages / 24.0, amp,
+         (double)ls.records * EEPROM_PAGE / ls.recordBytes);
+  printf("  wear per page %u..%u cycles, 1M-cycle life %.0f years\n",
+         minC, maxC, years);
+
+  walk();
+  long s = slice();
+  printf("  read back %u records (the newest %u pages), %s\n", seenLen, LOG_PAGES,
+         (s >= 0 && (uint32_t)s + seenLen == truthLen) ? "match the tail of the log" : "MISMATCH");
+}
+
+static int failures(void)
+{
+  uint32_t bad = 0, torn = 0, lostTotal = 0;
+
+  truthLen = 0;
+  Eeprom_Init();
+  Log_Init(FLUSH_AGE);
+
+  for (uint32_t f = 0; f < FAILURES; f++) {
+    /* Run a while, then power fails somewhere */
+    uint32_t run = 1u + (uint32_t)(rand() % 3000);
+    for (uint32_t t = 0; t < run; t++) {
+      tick();
+    }
+    if (rand() & 1) {                          // half the time during a write
+      Log_Flush();
+      while (!Log_Pending()) {
+        tick();
+      }
+      Log_Poll(now);
+    }
+    walk();                                    // committed before the failure
+    long beforeStart = slice();
+    long beforeEnd = beforeStart + (long)seenLen;
+
+    Eeprom_RamPowerFail((uint8_t)(rand() % (EEPROM_PAGE + 1u)));
+
+    LogStats ls;
+    Log_Init(FLUSH_AGE);                       // restart: RAM contents gone
+    Log_GetStats(&ls);
+    torn += ls.torn;
+    walk();
+    long s = slice();
+    long end = s + (long)seenLen;
+
+    /* Contiguous, and nothing committed lost except the oldest page
+       (the torn write's target; a page holds at most PAGE_RECS) */
+    if (s < 0 || beforeStart < 0 || end < beforeEnd || s > beforeStart + PAGE_RECS) {
+      bad++;
+      continue;
+    }
+    lostTotal += truthLen - (uint32_t)end;     // never reached the EEPROM
+    truthLen = (uint32_t)end;
+    put(LOG_EV_BOOT, ls.recovered);
+  }
+  printf("%u power failures: %u torn pages seen at restart, %u bad recoveries, "
+         "%.1f records lost per failure (RAM batch + queue)\n",
+         FAILURES, torn, bad, (double)lostTotal / FAILURES);
+  return bad != 0u;
+}
+
+int main(int argc, char **argv)
+{
+  srand(argc > 1 ? (unsigned)atoi(argv[1]) : 1u);
+  day();
+  return failures();
+}
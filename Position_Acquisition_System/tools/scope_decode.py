@@ -0,0 +1,124 @@
+#!/usr/bin/env python3
+"""Decode scope-mode dumps (Scope.h) into CSV.
+
+Reads raw bytes from a file or a serial port, finds every 'SC' record,
+checks its CRC and writes one CSV per capture: sample number relative
+to the trigger, time in microseconds, raw 12-bit value and volts.
+
+    python3 tools/scope_decode.py dump.bin                 # -> dump_0.csv, ...
+    python3 tools/scope_decode.py --port /dev/ttyUSB0 -o cap.csv
+    python3 tools/scope_decode.py dump.bin -o -            # CSV to stdout
+
+Serial input needs pyserial; the board sends at 115200 baud on PA2.
+"""
+import argparse
+import struct
+import sys
+
+MAGIC = b"SC"
+HEADER = struct.Struct("<BBIHHH")       # version, trigger, rate, pre, post, level
+TRIGGERS = ["rising", "falling", "ext", "now"]
+VREF = 3.3
+
+
+def crc16(data, crc=0xFFFF):
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) & 0xFFFF if crc & 0x8000 else (crc << 1) & 0xFFFF
+    return crc
+
+
+def unpack12(data, count):
+    out = []
+    for i in range(0, len(data) - 1, 3):
+        b0, b1 = data[i], data[i + 1]
+        b2 = data[i + 2] if i + 2 < len(data) else 0
+        out.append(b0 | (b1 & 0x0F) << 8)
+        out.append(b1 >> 4 | b2 << 4)
+    return out[:count]
+
+
+def records(buf):
+    """Yield (header dict, samples) for every valid record in buf."""
+    pos = 0
+    while True:
+        pos = buf.find(MAGIC, pos)
+        if pos < 0 or pos + 2 + HEADER.size > len(buf):
+            return
+        version, trig, rate, pre, post, level = HEADER.unpack_from(buf, pos + 2)
+        count = pre + post
+        body_len = HEADER.size + (count * 3 + 1) // 2
+        end = pos + 2 + body_len
+        if version != 1 or end + 2 > len(buf):
+            pos += 1
+            continue
+        body = buf[pos + 2:end]
+        (crc,) = struct.unpack_from("<H", buf, end)
+        if crc16(body) != crc:
+            print("scope_decode: CRC error at byte %d, skipped" % pos, file=sys.stderr)
+            pos += 1
+            continue
+        head = dict(trigger=TRIGGERS[trig] if trig < len(TRIGGERS) else str(trig),
+                    rate=rate, pre=pre, post=post, level=level)
+        yield head, unpack12(body[HEADER.size:], count)
+        pos = end + 2
+
+
+def write_csv(f, head, samples):
+    f.write("# trigger=%s level=%d rate=%d Hz pre=%d post=%d\n"
+            % (head["trigger"], head["level"], head["rate"], head["pre"], head["post"]))
+    f.write("n,time_us,raw,volts\n")
+    for i, v in enumerate(samples):
+        n = i - head["pre"]
+        f.write("%d,%.3f,%d,%.4f\n" % (n, n * 1e6 / head["rate"], v, v * VREF / 4095))
+
+
+def read_serial(port, baud, timeout):
+    import serial
+    with serial.Serial(port, baud, timeout=timeout) as s:
+        data = bytearray()
+        while True:
+            chunk = s.read(4096)
+            if not chunk:
+                if data:
+                    return bytes(data)
+                continue
+            data += chunk
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("input", nargs="?", help="dump file (raw bytes)")
+    ap.add_argument("--port", help="read from this serial port instead")
+    ap.add_argument("--baud", type=int, default=115200)
+    ap.add_argument("--timeout", type=float, default=1.0,
+                    help="serial: stop after this many idle seconds once data came")
+    ap.add_argument("-o", "--output", help="CSV file, '-' for stdout; "
+                    "numbered per capture when there are several")
+    args = ap.parse_args()
+
+    if args.port:
+        buf = read_serial(args.port, args.baud, args.timeout)
+    elif args.input:
+        with open(args.input, "rb") as f:
+            buf = f.read()
+    else:
+        ap.error("give a dump file or --port")
+
+    base = args.output or (args.input.rsplit(".", 1)[0] if args.input else "scope") + ".csv"
+    caps = list(records(buf))
+    if not caps:
+        sys.exit("scope_decode: no valid capture found")
+    for k, (head, samples) in enumerate(caps):
+        if base == "-":
+            write_csv(sys.stdout, head, samples)
+            continue
+        name = base if len(caps) == 1 else "%s_%d.csv" % (base[:-4] if base.endswith(".csv") else base, k)
+        with open(name, "w") as f:
+            write_csv(f, head, samples)
+        print("%s: %d samples, trigger %s at %d Hz" % (name, len(samples), head["trigger"], head["rate"]))
+
+
+if __name__ == "__main__":
+    main()
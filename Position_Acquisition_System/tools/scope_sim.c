@@ -0,0 +1,297 @@
+/*
+ * Run the scope capture (Scope.c) on a PC against a simulated ADC. Each
+ * tick converts one sample of a noisy sine into the 2048-sample ring,
+ * as the circular DMA does, and every half ring goes to Scope_Block().
+ * The analog watchdog flags samples outside the Scope_Window() window;
+ * its interrupt runs 0..MAX_LATENCY samples later if still enabled.
+ * Scope_HwStop() takes effect 0..MAX_STOP samples late. The PB0 edge
+ * reaches Scope_External() with the same latency.
+ *   - rising / falling: over CAPTURES captures each, T is the first
+ *     sample past the level after one beyond level -/+ hyst, from
+ *     sample 'pre' on, whether Scope_Block() or the watchdog found it
+ *   - external: T is within the interrupt latency of the edge
+ *   - immediate: T is the end of the first block
+ *   - every capture decodes (12-bit unpack, CRC) to exactly the
+ *     source samples T - pre .. T + post - 1; one flipped bit fails
+ *     the CRC
+ *   - pre + post above depth / 2 - SCOPE_GUARD is refused
+ *   - a level the signal never leaves the far side of never triggers
+ *   - a signal that is beyond the level only inside blocks, never at
+ *     their ends, still triggers
+ * With a file name the dumps are also written there, followed by a
+ * copy of the first one with a flipped bit, for tools/scope_decode.py.
+ *
+ * Build from the project folder:
+ *   gcc -O2 -Wall -Wextra -I. -o scope_sim tools/scope_sim.c Scope.c -lm
+ *   ./scope_sim [seed] [dump.bin]
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Scope.h"
+
+#define DEPTH        2048u
+#define HALF         (DEPTH / 2u)
+#define RATE_HZ      500000u
+#define CAPTURES     200u
+#define MAX_LATENCY  20u         // samples: 40 us at 500 kHz
+#define MAX_STOP     40u         // samples until the ADC really stops
+#define MAX_TICKS    (1u << 17)
+#define DUMP_MAX     (16u + 3u * DEPTH / 2u)
+
+static uint16_t source[MAX_TICKS];
+static uint16_t ring[DEPTH];
+static uint16_t awdLow, awdHigh;
+static uint8_t  awdOn, awdPending;
+static uint32_t awdAt, arms;
+static uint32_t stopAt;
+static uint32_t tick;                 // samples converted so far
+static uint8_t  dump[DUMP_MAX];
+static uint32_t dumpLen;
+static FILE    *dumpFile;
+static int      failures;
+
+static void check(int ok, const char *what)
+{
+  printf("%-58s %s\n", what, ok ? "ok" : "FAIL");
+  failures += !ok;
+}
+
+static uint32_t latency(uint32_t most)
+{
+  return (uint32_t)rand() % (most + 1u);
+}
+
+void Scope_HwWatchdog(uint8_t on)
+{
+  awdOn = on;
+  awdPending = 0;                     // flag cleared first
+  arms += on;
+}
+
+void Scope_HwStop(void)
+{
+  stopAt = tick + latency(MAX_STOP);
+}
+
+static void put(const uint8_t *data, uint16_t n)
+{
+  memcpy(&dump[dumpLen], data, n);
+  dumpLen += n;
+}
+
+/* A noisy sine between 'lo' and 'hi'; nothing random per tick after */
+static void makeSource(uint16_t lo, uint16_t hi)
+{
+  double period = 300.0 + rand() % 4700, phase = rand() % 1000 / 1000.0 * 2.0 * M_PI;
+  for (uint32_t k = 0; k < MAX_TICKS; k++) {
+    double v = (lo + hi) / 2.0 + (hi - lo) / 2.0 * sin(2.0 * M_PI * k / period + phase);
+    v += rand() % 9 - 4;
+    source[k] = (uint16_t)(v < 0.0 ? 0.0 : v > 4095.0 ? 4095.0 : v);
+  }
+}
+
+/* Runs the stream until the capture is done and the ADC has stopped,
+   with an external edge at 'edge' (0 = none); returns 0 on timeout */
+static uint8_t run(uint32_t edge, uint32_t *extAt)
+{
+  uint32_t extFire = 0;
+
+  tick = 0;
+  stopAt = MAX_TICKS;
+  awdOn = awdPending = 0;
+  while (tick < stopAt) {
+    if (tick >= MAX_TICKS) {
+      return 0;
+    }
+    uint16_t s = source[tick];
+    ring[tick % DEPTH] = s;
+    if (awdOn && !awdPending && (s < awdLow || s > awdHigh)) {
+      awdPending = 1;
+      awdAt = tick + 1u + latency(MAX_LATENCY);
+    }
+    if (edge != 0u && tick == edge) {
+      extFire = tick + 1u + latency(MAX_LATENCY);
+    }
+    tick++;
+
+    /* Interrupts due after this sample, in either order */
+    uint8_t dma = tick % HALF == 0u, awd = awdPending && awdOn && tick >= awdAt;
+    uint8_t ext = extFire != 0u && tick == extFire, first = (uint8_t)(rand() % 2);
+    for (uint8_t k = 0; k < 2u; k++) {
+      if (dma && k == first) {
+        Scope_Block(&ring[(tick - HALF) % DEPTH], HALF);
+      }
+      if (awd && k != first) {
+        awdPending = 0;
+        Scope_Watchdog((uint16_t)(tick % DEPTH));
+      }
+    }
+    if (ext) {
+      *extAt = tick;
+      Scope_External((uint16_t)(tick % DEPTH));
+    }
+  }
+  return Scope_State() == SCOPE_DONE;
+}
+
+static uint16_t crc16(uint16_t c, const uint8_t *d, uint32_t n)
+{
+  while (n--) {
+    c ^= (uint16_t)(*d++ << 8);
+    for (uint8_t b = 0; b < 8u; b++) {
+      c = (c & 0x8000u) ? (uint16_t)((c << 1) ^ 0x1021u) : (uint16_t)(c << 1);
+    }
+  }
+  return c;
+}
+
+/* Decodes dump[] and compares it with the source around T */
+static uint8_t dumpMatches(const ScopeConfig *c, uint32_t t)
+{
+  uint16_t count = (uint16_t)(c->pre + c->post);
+  uint32_t body = 12u + (count * 3u + 1u) / 2u;
+
+  dumpLen = 0;
+  if (!Scope_Dump(RATE_HZ, put) || dumpLen != 2u + body + 2u || dump[0] != 'S' ||
+      dump[1] != 'C' || dump[2] != SCOPE_VERSION || dump[3] != c->trigger) {
+    return 0;
+  }
+  if (crc16(0xFFFFu, &dump[2], body) != (dump[2u + body] | dump[3u + body] << 8)) {
+    return 0;
+  }
+  const uint8_t *p = &dump[14];
+  for (uint16_t i = 0; i < count; i += 2u, p += 3) {
+    uint16_t a = (uint16_t)(p[0] | (p[1] & 0x0Fu) << 8);
+    uint16_t b = (uint16_t)(p[1] >> 4 | (i + 1u < count ? p[2] : 0u) << 4);
+    if (a != source[t - c->pre + i] || (i + 1u < count && b != source[t - c->pre + i + 1u])) {
+      return 0;
+    }
+  }
+  if (dumpFile != NULL) {
+    fwrite(dump, 1, dumpLen, dumpFile);
+  }
+  return 1;
+}
+
+/* The first sample past the level after one beyond it, from 'pre' on */
+static uint32_t expectedT(const ScopeConfig *c)
+{
+  uint8_t rising = c->trigger == SCOPE_TRIG_RISING, clear = 0;
+
+  for (uint32_t t = c->pre; t < MAX_TICKS; t++) {
+    uint16_t s = source[t];
+    if (rising ? s + c->hyst < c->level : s > c->level + c->hyst) {
+      clear = 1;
+    } else if (clear && (rising ? s >= c->level : s <= c->level)) {
+      return t;
+    }
+  }
+  return MAX_TICKS;
+}
+
+static void levelTriggers(uint8_t trig)
+{
+  uint32_t exact = 0, matched = 0, done = 0, watched = 0;
+  char what[64];
+
+  for (uint32_t n = 0; n < CAPTURES; n++) {
+    uint16_t lo = (uint16_t)(200 + rand() % 800), hi = (uint16_t)(3000 + rand() % 800);
+    ScopeConfig c = { trig, (uint16_t)(lo + 300 + rand() % (hi - lo - 600)), 64u,
+                      (uint16_t)(1 + rand() % 480), (uint16_t)(rand() % 480) };
+    makeSource(lo, hi);
+    Scope_Window(&c, &awdLow, &awdHigh);
+    arms = 0;
+    if (!Scope_Arm(&c, ring, DEPTH) || !run(0, NULL)) {
+      continue;
+    }
+    done++;
+    watched += arms != 0u;
+    exact += Scope_TriggerIndex() == expectedT(&c);
+    matched += dumpMatches(&c, Scope_TriggerIndex());
+  }
+  printf("%s: %u captures (%u via the watchdog), %u exact, %u decoded intact\n",
+         trig == SCOPE_TRIG_RISING ? "rising" : "falling", done, watched, exact, matched);
+  snprintf(what, sizeof what, "%s: T is the first sample past the level",
+           trig == SCOPE_TRIG_RISING ? "rising" : "falling");
+  check(done == CAPTURES && exact == CAPTURES, what);
+  snprintf(what, sizeof what, "%s: every dump matches the source",
+           trig == SCOPE_TRIG_RISING ? "rising" : "falling");
+  check(matched == CAPTURES, what);
+}
+
+static void otherTriggers(void)
+{
+  uint32_t good = 0, extAt = 0;
+
+  for (uint32_t n = 0; n < CAPTURES; n++) {
+    ScopeConfig c = { SCOPE_TRIG_EXT, 0u, 0u, (uint16_t)(1 + rand() % 480), (uint16_t)(rand() % 480) };
+    uint32_t edge = 2u * HALF + (uint32_t)rand() % 50000u;
+    makeSource(500, 3500);
+    Scope_Window(&c, &awdLow, &awdHigh);
+    extAt = 0;
+    good += Scope_Arm(&c, ring, DEPTH) && run(edge, &extAt) &&
+            Scope_TriggerIndex() == extAt && extAt > edge && extAt <= edge + 1u + MAX_LATENCY &&
+            dumpMatches(&c, extAt);
+  }
+  check(good == CAPTURES, "external: T within the latency of the edge, dump intact");
+
+  ScopeConfig now = { SCOPE_TRIG_NOW, 0u, 0u, 700u, 260u };
+  makeSource(500, 3500);
+  Scope_Window(&now, &awdLow, &awdHigh);
+  check(Scope_Arm(&now, ring, DEPTH) && run(0, NULL) && Scope_TriggerIndex() == HALF &&
+        dumpMatches(&now, HALF), "immediate: T at the end of the first block, dump intact");
+
+  /* One flipped bit in the samples */
+  dump[20] ^= 0x10u;
+  uint32_t body = dumpLen - 4u;
+  check(crc16(0xFFFFu, &dump[2], body) != (dump[2u + body] | dump[3u + body] << 8),
+        "a flipped bit fails the CRC");
+  if (dumpFile != NULL) {
+    fwrite(dump, 1, dumpLen, dumpFile);
+  }
+}
+
+static void limits(void)
+{
+  ScopeConfig c = { SCOPE_TRIG_RISING, 2048u, 64u, 240u, (uint16_t)(HALF - SCOPE_GUARD - 240u) };
+  uint8_t fits = Scope_Arm(&c, ring, DEPTH);
+  c.post++;
+  check(fits && !Scope_Arm(&c, ring, DEPTH), "pre + post up to depth / 2 - SCOPE_GUARD only");
+
+  /* Signal always above the level: the watchdog is never armed */
+  ScopeConfig high = { SCOPE_TRIG_RISING, 400u, 64u, 240u, 720u };
+  makeSource(1000, 3000);
+  Scope_Window(&high, &awdLow, &awdHigh);
+  Scope_Arm(&high, ring, DEPTH);
+  run(0, NULL);
+  check(Scope_State() == SCOPE_ARMED && !awdOn, "level below the signal: no trigger");
+
+  /* Low in the first half of every block, high at its end */
+  ScopeConfig mid = { SCOPE_TRIG_RISING, 2048u, 64u, 240u, 200u };
+  for (uint32_t k = 0; k < MAX_TICKS; k++) {
+    source[k] = (k % HALF < HALF / 2u) ? 1000u : 3000u;
+  }
+  Scope_Window(&mid, &awdLow, &awdHigh);
+  check(Scope_Arm(&mid, ring, DEPTH) && run(0, NULL) && Scope_TriggerIndex() == HALF / 2u,
+        "beyond the level only inside blocks: still triggers");
+}
+
+int main(int argc, char **argv)
+{
+  srand((argc > 1) ? (unsigned)atoi(argv[1]) : 1u);
+  if (argc > 2 && (dumpFile = fopen(argv[2], "wb")) == NULL) {
+    perror(argv[2]);
+    return 2;
+  }
+  levelTriggers(SCOPE_TRIG_RISING);
+  levelTriggers(SCOPE_TRIG_FALLING);
+  otherTriggers();
+  limits();
+  if (dumpFile != NULL) {
+    fclose(dumpFile);
+  }
+  printf("%s\n", failures ? "FAILED" : "all passed");
+  return failures != 0;
+}
@@ -0,0 +1,224 @@
+/*
+ * Run the ADC stream hand-off and timing maths (ADC_Stream.c) on a PC.
+ * A simulated DMA writes a known sample sequence into the circular
+ * buffer, counting CNDTR down, and raises the half-transfer and
+ * transfer-complete interrupts; HT is served before TC, one per entry,
+ * as HAL_DMA_IRQHandler() does. ADC_StreamBlock() checks every sample
+ * of its block, then keeps the "interrupt" busy for a while, during
+ * which the DMA carries on.
+ *   - fast consumer: 1-channel and 3-channel frames, every sample
+ *     arrives intact and in order, no block is flagged late, and
+ *     ADCStream_Latest() always returns the newest complete frame
+ *   - slow consumer: blocks that overrun their half are flagged late
+ *   - timing: every rate from 1 Hz to 500 kHz gets the nearest period
+ *     TIM3 can make and the longest sampling time that leaves a
+ *     quarter of it spare; the README table is checked as printed
+ *
+ * Build from the project folder:
+ *   gcc -O2 -Wall -Wextra -I. -o stream_sim tools/stream_sim.c ADC_Stream.c -lm
+ *   ./stream_sim [seed]
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ADC_Stream.h"
+
+#define TIM_CLOCK_HZ  8000000u      // HSI, no PLL: SystemClock_Config()
+#define ADC_CLOCK_HZ  14000000u     // HSI14, as ADC_Driver.h
+#define BUF_LEN       384u          // 1 and 3 channels both fit
+#define FAST_SAMPLES  100000u
+
+static uint16_t buf[BUF_LEN];
+static uint16_t len;
+static uint8_t  channels;
+static volatile uint32_t cndtr;
+static uint32_t written;            // samples the DMA has written
+static uint32_t checked;            // samples ADC_StreamBlock() has seen
+static uint8_t  pendHT, pendTC;
+static uint8_t  slow;               // consumer mode
+static uint32_t overran;            // blocks that really overran
+static uint32_t corrupt;
+static int      failures;
+
+static void check(int ok, const char *what)
+{
+  printf("%-58s %s\n", what, ok ? "ok" : "FAIL");
+  failures += !ok;
+}
+
+/* Sample number k of the stream: 12 bits that change every sample */
+static uint16_t value(uint32_t k)
+{
+  return (uint16_t)((k * 2654435761u) >> 20);
+}
+
+static void dmaStep(void)
+{
+  buf[len - cndtr] = value(written++);
+  if (--cndtr == 0u) {
+    cndtr = len;
+    pendTC = 1;
+  } else if (cndtr == len / 2u) {
+    pendHT = 1;
+  }
+}
+
+/* The DMA interrupt, entered again while anything is pending */
+static void dmaIrqs(void)
+{
+  while (pendHT || pendTC) {
+    if (pendHT) {
+      pendHT = 0;
+      ADCStream_Done(0, &cndtr);
+    } else {
+      pendTC = 0;
+      ADCStream_Done(1, &cndtr);
+    }
+  }
+}
+
+void ADC_StreamBlock(const uint16_t *block, uint16_t count)
+{
+  uint16_t half = len / 2u;
+
+  /* In the fast run every block must continue the sequence exactly */
+  if (!slow) {
+    for (uint16_t i = 0; i < count; i++) {
+      corrupt += block[i] != value(checked + i);
+    }
+  }
+  checked += count;
+
+  /* Work: the DMA keeps going meanwhile */
+  uint32_t work = slow && rand() % 10 == 0 ? half + (uint32_t)rand() % half
+                                           : (uint32_t)rand() % (half - channels);
+  overran += work >= half;
+  for (uint32_t i = 0; i < work; i++) {
+    dmaStep();
+  }
+}
+
+static void startRun(uint8_t ch, uint8_t slowMode)
+{
+  len = BUF_LEN;
+  channels = ch;
+  slow = slowMode;
+  cndtr = len;
+  written = checked = overran = corrupt = 0;
+  pendHT = pendTC = 0;
+  ADCStream_Reset(buf, len, ch);
+}
+
+static void fastRun(uint8_t ch)
+{
+  uint32_t wrongLatest = 0;
+  ADCStreamStats st;
+  char what[64];
+
+  startRun(ch, 0);
+  while (checked < FAST_SAMPLES) {
+    dmaStep();
+    dmaIrqs();
+    if (written >= ch && rand() % 7 == 0) {
+      uint32_t frame = written / ch - 1u;
+      wrongLatest += ADCStream_Latest(cndtr) != value(frame * ch);
+    }
+  }
+  ADCStream_GetStats(&st);
+  printf("%u channel(s): %u samples in %u blocks, %u late, %u corrupt\n",
+         ch, checked, st.blocks, st.late, corrupt);
+  snprintf(what, sizeof what, "%u channel(s): every sample intact, none late", ch);
+  check(corrupt == 0u && st.late == 0u && checked >= FAST_SAMPLES, what);
+  snprintf(what, sizeof what, "%u channel(s): ADCStream_Latest() is the newest frame", ch);
+  check(wrongLatest == 0u, what);
+}
+
+static void slowRun(void)
+{
+  ADCStreamStats st;
+
+  startRun(1, 1);
+  while (checked < FAST_SAMPLES) {
+    dmaStep();
+    dmaIrqs();
+  }
+  ADCStream_GetStats(&st);
+  printf("slow consumer: %u blocks, %u overran their half, %u flagged late\n",
+         st.blocks, overran, st.late);
+  check(st.late >= overran && overran > 0u, "slow consumer: every overrun flagged late");
+}
+
+/* Sampling times in ADC half-cycles by SMPR code (reference manual) */
+static const uint16_t smpHalf[8] = { 3, 15, 27, 57, 83, 111, 143, 479 };
+#define CONV_HALF  25u
+
+static int timingOk(uint32_t rateHz, uint8_t ch, double *err)
+{
+  ADCStreamTiming t;
+
+  if (!ADCStream_Timing(TIM_CLOCK_HZ, ADC_CLOCK_HZ, rateHz, ch, &t)) {
+    /* Only refused when even 1.5 cycles per channel does not fit */
+    return 4u * (smpHalf[0] + CONV_HALF) * ch * rateHz > 3u * 2u * ADC_CLOCK_HZ;
+  }
+  uint32_t ticks = (t.psc + 1u) * (t.arr + 1u);
+  double want = (double)TIM_CLOCK_HZ / rateHz;
+  double got = (double)TIM_CLOCK_HZ / ticks;
+  *err = fabs(got - rateHz) / rateHz;
+
+  /* Nearest period the prescaler allows, reported as reached */
+  int ok = fabs(ticks - want) <= (t.psc + 1u) / 2.0 + 0.5 &&
+           t.rateHz == (uint32_t)lround(got) && t.arr >= 1u;
+
+  /* Longest sampling time with a quarter of the period spare */
+  double budget = 2.0 * ADC_CLOCK_HZ / t.rateHz * 3.0 / 4.0;
+  ok &= (smpHalf[t.sampleTime] + CONV_HALF) * ch <= (uint32_t)budget;
+  ok &= t.sampleTime == 7u || (smpHalf[t.sampleTime + 1u] + CONV_HALF) * ch > (uint32_t)budget;
+  return ok;
+}
+
+static void timing(void)
+{
+  static const struct { uint32_t rate, actual; const char *smp; } table[] = {
+    { 1u, 1u, "239.5" }, { 1280u, 1280u, "239.5" }, { 100000u, 100000u, "71.5" },
+    { 300000u, 296296u, "13.5" }, { 500000u, 500000u, "7.5" },
+  };
+  static const char *smpName[8] = { "1.5", "7.5", "13.5", "28.5", "41.5", "55.5", "71.5", "239.5" };
+  ADCStreamTiming t;
+  uint32_t rates = 0, bad = 0;
+  double worst = 0.0, err = 0.0;
+
+  for (uint8_t ch = 1; ch <= 3u; ch += 2u) {
+    for (double r = 1.0; r <= ADC_STREAM_MAX_HZ; r = r < 2000.0 ? r + 1.0 : r * 1.0007) {
+      bad += !timingOk((uint32_t)r, ch, &err);
+      worst = ch == 1u && err > worst ? err : worst;
+      rates++;
+    }
+    bad += !timingOk(ADC_STREAM_MAX_HZ, ch, &err);
+  }
+  printf("timing: %u rates at 1 and 3 channels, worst rate error %.3f %% (1 channel)\n",
+         rates, 100.0 * worst);
+  check(bad == 0u, "timing: nearest period, longest sampling time that fits");
+  check(!ADCStream_Timing(TIM_CLOCK_HZ, ADC_CLOCK_HZ, 0u, 1, &t) &&
+        !ADCStream_Timing(TIM_CLOCK_HZ, ADC_CLOCK_HZ, ADC_STREAM_MAX_HZ + 1u, 1, &t),
+        "timing: rates outside 1 Hz..500 kHz refused");
+
+  int rows = 1;
+  for (uint32_t i = 0; i < sizeof table / sizeof table[0]; i++) {
+    rows &= ADCStream_Timing(TIM_CLOCK_HZ, ADC_CLOCK_HZ, table[i].rate, 1, &t) &&
+            t.rateHz == table[i].actual && strcmp(smpName[t.sampleTime], table[i].smp) == 0;
+    printf("  %6u Hz: %s cycles, %u Hz\n", table[i].rate, smpName[t.sampleTime], t.rateHz);
+  }
+  check(rows, "timing: README table");
+}
+
+int main(int argc, char **argv)
+{
+  srand((argc > 1) ? (unsigned)atoi(argv[1]) : 1u);
+  fastRun(1);
+  fastRun(3);
+  slowRun();
+  timing();
+  printf("%s\n", failures ? "FAILED" : "all passed");
+  return failures != 0;
+}
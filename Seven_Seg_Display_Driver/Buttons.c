@@ -0,0 +1,101 @@
+#include "Buttons.h"
+#include "Timebase.h"
+#include "main.h"
+
+// Button k is on PA(k + 1)
+#define BUTTON_SHIFT   1u
+#define BUTTON_PINS    (GPIO_PIN_1 | GPIO_PIN_2)
+#define READ_BUTTONS() ((uint8_t)((~GPIOA->IDR & BUTTON_PINS) >> BUTTON_SHIFT))
+
+static volatile uint32_t edges = 0;
+static volatile uint16_t maxEdgeCycles = 0;
+static volatile uint16_t maxTickCycles = 0;
+
+// CPU cycles since 'start', from the SysTick down-counter (< 1 ms)
+static uint16_t cyclesSince(uint32_t start)
+{
+    uint32_t now = SysTick->VAL;
+    uint32_t d = (start >= now) ? start - now : start + SysTick->LOAD + 1u - now;
+    return (d > 0xFFFFu) ? 0xFFFFu : (uint16_t)d;
+}
+
+void Buttons_Init(void)
+{
+    // PA1/PA2 are EXTI inputs with pull-ups from CubeMX (falling edge);
+    // the debouncer needs both edges.
+    EXTI->RTSR |= BUTTON_PINS;
+    EXTI->FTSR |= BUTTON_PINS;
+
+    // Same priority as SysTick, so the two callbacks never preempt each other
+    HAL_NVIC_SetPriority(EXTI0_1_IRQn, TICK_INT_PRIORITY, 0);
+    HAL_NVIC_SetPriority(EXTI2_3_IRQn, TICK_INT_PRIORITY, 0);
+
+    edges = 0;
+    maxEdgeCycles = 0;
+    maxTickCycles = 0;
+    EXTI->PR = BUTTON_PINS;   // drop edges seen before now
+    Debounce_Init(BUTTONS_COUNT, READ_BUTTONS());
+}
+
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
+{
+    uint32_t start = SysTick->VAL;
+    uint32_t now = Timebase_Us();
+
+    for (uint8_t k = 0; k < BUTTONS_COUNT; k++)
+    {
+        if (GPIO_Pin & (1u << (k + BUTTON_SHIFT)))
+        {
+            Debounce_Edge(k, now);
+            edges++;
+        }
+    }
+
+    uint16_t c = cyclesSince(start);
+    if (c > maxEdgeCycles)
+    {
+        maxEdgeCycles = c;
+    }
+}
+
+// 1 ms SysTick: run the debouncer while a button is moving or held
+void HAL_SYSTICK_Callback(void)
+{
+    if (!Debounce_Busy())
+    {
+        return;
+    }
+
+    uint32_t start = SysTick->VAL;
+
+    Debounce_Tick(READ_BUTTONS(), Timebase_Us());
+
+    uint16_t c = cyclesSince(start);
+    if (c > maxTickCycles)
+    {
+        maxTickCycles = c;
+    }
+}
+
+uint8_t Buttons_GetEvent(ButtonEvent *ev)
+{
+    return Debounce_GetEvent(ev);
+}
+
+uint8_t Buttons_HasEvent(void)
+{
+    return Debounce_HasEvent();
+}
+
+uint8_t Buttons_State(void)
+{
+    return Debounce_State();
+}
+
+void Buttons_GetStats(ButtonStats *stats)
+{
+    stats->edges         = edges;
+    stats->overruns      = Debounce_Overruns();
+    stats->maxEdgeCycles = maxEdgeCycles;
+    stats->maxTickCycles = maxTickCycles;
+}
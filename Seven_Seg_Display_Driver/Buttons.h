@@ -0,0 +1,50 @@
+#ifndef BUTTONS_H
+#define BUTTONS_H
+
+#include <stdint.h>
+#include "Debounce.h"
+
+/*
+ * Push buttons on PA1 (button 0, increment) and PA2 (button 1,
+ * decrement), active-low with internal pull-ups.
+ *
+ * The EXTI interrupt (both edges) only timestamps the edge and wakes the
+ * debouncer (Debounce.c). The debouncer then runs from the 1 ms SysTick
+ * until the button has settled, and queues press / release / long-press
+ * / auto-repeat events for the main loop. Nothing blocks in an
+ * interrupt, and with no button activity the SysTick hook returns at once.
+ *
+ * Both callbacks time themselves with the SysTick counter. Buttons_GetStats()
+ * reports the worst case, in CPU cycles. Interrupt entry and exit (about 30
+ * cycles) and the HAL dispatch are not included.
+ *
+ * Needs, in stm32f0xx_it.c:
+ *   EXTI0_1_IRQHandler / EXTI2_3_IRQHandler -> HAL_GPIO_EXTI_IRQHandler()
+ *   SysTick_Handler -> HAL_IncTick() and HAL_SYSTICK_IRQHandler()
+ */
+
+#define BUTTONS_COUNT     2u
+#define BUTTON_INC        0u      // PA1
+#define BUTTON_DEC        1u      // PA2
+
+typedef struct {
+    uint32_t edges;           // raw EXTI edges seen (bounces included)
+    uint32_t overruns;        // events lost to a full queue
+    uint16_t maxEdgeCycles;   // longest EXTI callback
+    uint16_t maxTickCycles;   // longest SysTick callback
+} ButtonStats;
+
+void    Buttons_Init(void);
+
+/* Pop the oldest event into 'ev'. Returns 0 when the queue is empty. */
+uint8_t Buttons_GetEvent(ButtonEvent *ev);
+
+/* Non-zero while events are waiting */
+uint8_t Buttons_HasEvent(void);
+
+/* Debounced pressed mask, bit n = button n */
+uint8_t Buttons_State(void);
+
+void    Buttons_GetStats(ButtonStats *stats);
+
+#endif
@@ -0,0 +1,176 @@
+#include "Debounce.h"
+#include "Barrier.h"
+
+static ButtonEvent queue[DEBOUNCE_QUEUE_SIZE];
+static volatile uint8_t head = 0;        // written by Debounce_Tick()
+static volatile uint8_t tail = 0;        // written by the main loop
+static volatile uint32_t overruns = 0;
+
+// ===== Producer state (EXTI / tick) =====
+static uint8_t  count;
+static volatile uint8_t state = 0;       // debounced pressed mask
+static volatile uint8_t busy = 0;        // buttons that need ticks
+static uint8_t  edgePending = 0;         // edgeTime[] holds a burst start
+static uint8_t  integ[DEBOUNCE_MAX_BUTTONS];
+static uint32_t edgeTime[DEBOUNCE_MAX_BUTTONS];
+static uint8_t  quiet[DEBOUNCE_MAX_BUTTONS];     // ticks since the last edge
+static uint32_t pressTime[DEBOUNCE_MAX_BUTTONS];
+static uint32_t nextDue[DEBOUNCE_MAX_BUTTONS];   // us after pressTime
+static uint8_t  longSent = 0;
+
+static void push(uint32_t time, uint8_t button, uint8_t type)
+{
+    uint8_t h = head;
+
+    if ((uint8_t)(h - tail) >= DEBOUNCE_QUEUE_SIZE)
+    {
+        overruns++;   // main loop too slow; Debounce_State() is still right
+        return;
+    }
+
+    queue[h & (DEBOUNCE_QUEUE_SIZE - 1u)].time   = time;
+    queue[h & (DEBOUNCE_QUEUE_SIZE - 1u)].button = button;
+    queue[h & (DEBOUNCE_QUEUE_SIZE - 1u)].type   = type;
+    COMPILER_BARRIER();
+    head = (uint8_t)(h + 1u);   // publish after the entry is written
+}
+
+void Debounce_Init(uint8_t n, uint8_t pressed)
+{
+    count = (n > DEBOUNCE_MAX_BUTTONS) ? DEBOUNCE_MAX_BUTTONS : n;
+    head = 0;
+    tail = 0;
+    overruns = 0;
+    edgePending = 0;
+    longSent = 0;
+    state = pressed;
+    busy = 0;
+
+    for (uint8_t k = 0; k < count; k++)
+    {
+        quiet[k] = DEBOUNCE_INTEGRATE;
+        integ[k] = ((pressed >> k) & 1u) ? DEBOUNCE_INTEGRATE : 0u;
+        // Held at start: no long press or repeat until released once
+        nextDue[k] = 0xFFFFFFFFu;
+    }
+}
+
+void Debounce_Edge(uint8_t button, uint32_t timeUs)
+{
+    uint8_t bit = (uint8_t)(1u << button);
+
+    if (!(edgePending & bit))
+    {
+        edgeTime[button] = timeUs;
+        edgePending |= bit;
+    }
+    quiet[button] = 0;
+    busy |= bit;
+}
+
+void Debounce_Tick(uint8_t pressed, uint32_t nowUs)
+{
+    for (uint8_t k = 0; k < count; k++)
+    {
+        uint8_t bit = (uint8_t)(1u << k);
+
+        if (!(busy & bit))
+        {
+            continue;
+        }
+
+        if (quiet[k] < DEBOUNCE_INTEGRATE)
+        {
+            quiet[k]++;
+        }
+
+        if (pressed & bit)
+        {
+            if (integ[k] < DEBOUNCE_INTEGRATE)
+            {
+                integ[k]++;
+            }
+        }
+        else if (integ[k] > 0u)
+        {
+            integ[k]--;
+        }
+
+        uint8_t  down = (state & bit) != 0u;
+        uint32_t t    = (edgePending & bit) ? edgeTime[k] : nowUs;
+
+        if (!down && integ[k] == DEBOUNCE_INTEGRATE)
+        {
+            state |= bit;
+            edgePending &= (uint8_t)~bit;
+            longSent &= (uint8_t)~bit;
+            pressTime[k] = t;
+            nextDue[k] = DEBOUNCE_LONG_MS * 1000u;
+            push(t, k, BUTTON_PRESS);
+        }
+        else if (down && integ[k] == 0u)
+        {
+            state &= (uint8_t)~bit;
+            edgePending &= (uint8_t)~bit;
+            push(t, k, BUTTON_RELEASE);
+        }
+        else if (quiet[k] >= DEBOUNCE_INTEGRATE &&
+                 ((down && integ[k] == DEBOUNCE_INTEGRATE) ||
+                  (!down && integ[k] == 0u)))
+        {
+            edgePending &= (uint8_t)~bit;   // a glitch that settled back
+        }
+
+        if (state & bit)
+        {
+            // Held: long press, then auto-repeat, at exact multiples
+            if ((uint32_t)(nowUs - pressTime[k]) >= nextDue[k])
+            {
+                uint8_t type = (longSent & bit) ? BUTTON_REPEAT : BUTTON_LONG;
+                longSent |= bit;
+                push(pressTime[k] + nextDue[k], k, type);
+                nextDue[k] += DEBOUNCE_REPEAT_MS * 1000u;
+            }
+        }
+        else if (integ[k] == 0u && !(edgePending & bit))
+        {
+            busy &= (uint8_t)~bit;   // released and quiet: stop ticking it
+        }
+    }
+}
+
+uint8_t Debounce_Busy(void)
+{
+    return busy;
+}
+
+uint8_t Debounce_GetEvent(ButtonEvent *ev)
+{
+    uint8_t t = tail;
+
+    if (t == head)
+    {
+        return 0;
+    }
+
+    COMPILER_BARRIER();
+    *ev = queue[t & (DEBOUNCE_QUEUE_SIZE - 1u)];
+    COMPILER_BARRIER();
+    tail = (uint8_t)(t + 1u);   // free the entry after the copy
+    return 1;
+}
+
+uint8_t Debounce_HasEvent(void)
+{
+    return tail != head;
+}
+
+uint8_t Debounce_State(void)
+{
+    return state;
+}
+
+uint32_t Debounce_Overruns(void)
+{
+    return overruns;
+}
@@ -0,0 +1,59 @@
+#ifndef DEBOUNCE_H
+#define DEBOUNCE_H
+
+#include <stdint.h>
+
+/*
+ * Button debouncer and event queue. No HAL in here, so it also builds
+ * on a PC and can be fed recorded or synthetic edge traces.
+ *
+ * Debounce_Edge() is called for every raw edge (EXTI). It only records
+ * the time of the first edge of a burst and marks the button busy.
+ * Debounce_Tick() runs every DEBOUNCE_TICK_MS while Debounce_Busy(). Per
+ * button an integrator counts up on "pressed" samples and down on
+ * "released" ones, clamped to 0..DEBOUNCE_INTEGRATE. The state flips
+ * only at the ends, so bounces shorter than DEBOUNCE_INTEGRATE ticks
+ * never show. A flip is reported with the time of the edge that started
+ * it; that time is kept until the line has been quiet for
+ * DEBOUNCE_INTEGRATE ticks, so a slow bounce train keeps its first edge.
+ *
+ * While held, a button reports BUTTON_LONG after DEBOUNCE_LONG_MS and
+ * then BUTTON_REPEAT every DEBOUNCE_REPEAT_MS.
+ *
+ * Debounce_Edge() and Debounce_Tick() must not preempt each other (same
+ * interrupt priority); the main loop is the only consumer of events.
+ */
+
+#define DEBOUNCE_MAX_BUTTONS  8u
+#define DEBOUNCE_TICK_MS      1u
+#define DEBOUNCE_INTEGRATE    5u      // ticks of agreement to change state
+#define DEBOUNCE_LONG_MS      800u
+#define DEBOUNCE_REPEAT_MS    150u
+#define DEBOUNCE_QUEUE_SIZE   16u     // power of two
+
+#define BUTTON_PRESS    0u
+#define BUTTON_RELEASE  1u
+#define BUTTON_LONG     2u
+#define BUTTON_REPEAT   3u
+
+typedef struct {
+    uint32_t time;     // us; edge time for press/release, due time otherwise
+    uint8_t  button;   // 0..count-1
+    uint8_t  type;     // BUTTON_xxx
+} ButtonEvent;
+
+/* 'pressed' = buttons already down, so they don't report a press */
+void     Debounce_Init(uint8_t count, uint8_t pressed);
+
+/* Producer side (interrupts) */
+void     Debounce_Edge(uint8_t button, uint32_t timeUs);
+void     Debounce_Tick(uint8_t pressed, uint32_t nowUs);
+uint8_t  Debounce_Busy(void);
+
+/* Consumer side (main loop) */
+uint8_t  Debounce_GetEvent(ButtonEvent *ev);   // 0 when empty
+uint8_t  Debounce_HasEvent(void);
+uint8_t  Debounce_State(void);                 // debounced pressed mask
+uint32_t Debounce_Overruns(void);              // events lost to a full queue
+
+#endif
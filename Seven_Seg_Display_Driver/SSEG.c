@@ -1,8 +1,8 @@
 #include "SSEG.h"
+#include "SSEGTransport.h"
 
-/* Common-cathode: driving PBx HIGH turns the segment ON (through your 1kΩ). */
-/* Bit order in LUT: bit0=a, bit1=b, bit2=c, bit3=d, bit4=e, bit5=f, bit6=g, bit7=dp */
-static const uint8_t digitLUT[10] = {
+/* Segment bits: bit0=a, bit1=b, bit2=c, bit3=d, bit4=e, bit5=f, bit6=g, bit7=dp */
+static const uint8_t glyphLUT[16] = {
 /*0*/ 0b00111111,
 /*1*/ 0b00000110,
 /*2*/ 0b01011011,
@@ -12,43 +12,148 @@ static const uint8_t digitLUT[10] = {
 /*6*/ 0b01111101,
 /*7*/ 0b00000111,
 /*8*/ 0b01111111,
-/*9*/ 0b01101111
+/*9*/ 0b01101111,
+/*A*/ 0b01110111,
+/*b*/ 0b01111100,
+/*C*/ 0b00111001,
+/*d*/ 0b01011110,
+/*E*/ 0b01111001,
+/*F*/ 0b01110001
 };
+#define GLYPH_MINUS   0b01000000
+#define GLYPH_BLANK   0u
 
-/* Write the 8 segment lines PB0..PB7 according to 'bits' */
-static inline void writeSegments(uint8_t bits)
+/* Framebuffer (main loop) */
+static uint8_t fb[SSEG_DIGITS];          // segments without dp
+static uint8_t dpMask = 0;               // bit d = dp on digit d
+static uint8_t level[SSEG_DIGITS];
+
+static void publish(uint8_t d)
 {
-    const uint16_t ALL =
-        GPIO_PIN_0|GPIO_PIN_1|GPIO_PIN_2|GPIO_PIN_3|
-        GPIO_PIN_4|GPIO_PIN_5|GPIO_PIN_6|GPIO_PIN_7;
+    uint8_t  segments = (uint8_t)(fb[d] | ((dpMask >> d) & 1u ? SSEG_DP : 0u));
+    uint32_t l = level[d];
 
-    /* Clear all, then set the required ones */
-    HAL_GPIO_WritePin(GPIOB, ALL, GPIO_PIN_RESET);
+    // Square law: 1 -> SSEG_ON_MIN, SSEG_BRIGHT_MAX -> SSEG_ON_MAX
+    uint16_t onTicks = (l == 0u) ? 0u :
+        (uint16_t)(SSEG_ON_MIN + ((SSEG_ON_MAX - SSEG_ON_MIN) * l * l) /
+                                 (SSEG_BRIGHT_MAX * SSEG_BRIGHT_MAX));
 
-    if (bits & (1u<<0)) HAL_GPIO_WritePin(GPIOB, GPIO_PIN_0, GPIO_PIN_SET); // a
-    if (bits & (1u<<1)) HAL_GPIO_WritePin(GPIOB, GPIO_PIN_1, GPIO_PIN_SET); // b
-    if (bits & (1u<<2)) HAL_GPIO_WritePin(GPIOB, GPIO_PIN_2, GPIO_PIN_SET); // c
-    if (bits & (1u<<3)) HAL_GPIO_WritePin(GPIOB, GPIO_PIN_3, GPIO_PIN_SET); // d
-    if (bits & (1u<<4)) HAL_GPIO_WritePin(GPIOB, GPIO_PIN_4, GPIO_PIN_SET); // e
-    if (bits & (1u<<5)) HAL_GPIO_WritePin(GPIOB, GPIO_PIN_5, GPIO_PIN_SET); // f
-    if (bits & (1u<<6)) HAL_GPIO_WritePin(GPIOB, GPIO_PIN_6, GPIO_PIN_SET); // g
-    if (bits & (1u<<7)) HAL_GPIO_WritePin(GPIOB, GPIO_PIN_7, GPIO_PIN_SET); // dp
+    SSEGTransport_Set(d, segments, onTicks);
 }
 
 void SSEG_Init(void)
 {
-    /* GPIOB was already configured by MX_GPIO_Init().
-       Just show 0 at startup. */
-    SSEG_Out(0);
+    for (uint8_t d = 0; d < SSEG_DIGITS; d++)
+    {
+        fb[d] = GLYPH_BLANK;
+        level[d] = SSEG_BRIGHT_MAX;
+    }
+    dpMask = 0;
+    SSEGTransport_Init();
+    for (uint8_t d = 0; d < SSEG_DIGITS; d++)
+    {
+        publish(d);
+    }
 }
 
 void SSEG_Out(uint8_t num)
 {
     if (num > 9) num = 0;
-    uint8_t bits = digitLUT[num];
 
-    /* Uncomment to light the decimal point on digit 2: */
-    // bits |= (1u << 7);
+    for (uint8_t d = 0; d < SSEG_DIGITS; d++)
+    {
+        fb[d] = (d == 1u) ? glyphLUT[num] : GLYPH_BLANK;
+        publish(d);
+    }
+}
+
+void SSEG_ShowInt(int32_t value, uint8_t zeroPad)
+{
+    uint8_t  neg = (value < 0);
+    uint32_t mag = neg ? (uint32_t)(-value) : (uint32_t)value;
+
+    if (value > 9999 || value < -999)
+    {
+        for (uint8_t d = 0; d < SSEG_DIGITS; d++)
+        {
+            fb[d] = GLYPH_MINUS;
+            publish(d);
+        }
+        return;
+    }
+
+    for (int8_t d = SSEG_DIGITS - 1; d >= 0; d--)
+    {
+        if (mag != 0u || d == SSEG_DIGITS - 1 || zeroPad)
+        {
+            fb[d] = glyphLUT[mag % 10u];
+            mag /= 10u;
+        }
+        else if (neg)
+        {
+            fb[d] = GLYPH_MINUS;   // sign just left of the number
+            neg = 0;
+        }
+        else
+        {
+            fb[d] = GLYPH_BLANK;
+        }
+    }
+    if (neg)
+    {
+        fb[0] = GLYPH_MINUS;       // zero-padded: sign replaces D1
+    }
+    for (uint8_t d = 0; d < SSEG_DIGITS; d++)
+    {
+        publish(d);
+    }
+}
+
+void SSEG_ShowHex(uint16_t value)
+{
+    for (int8_t d = SSEG_DIGITS - 1; d >= 0; d--)
+    {
+        fb[d] = glyphLUT[value & 0xFu];
+        value >>= 4;
+        publish((uint8_t)d);
+    }
+}
+
+void SSEG_SetDP(uint8_t digit, uint8_t on)
+{
+    if (digit >= SSEG_DIGITS) return;
 
-    writeSegments(bits);
+    if (on)
+    {
+        dpMask |= (uint8_t)(1u << digit);
+    }
+    else
+    {
+        dpMask &= (uint8_t)~(1u << digit);
+    }
+    publish(digit);
+}
+
+void SSEG_SetRaw(uint8_t digit, uint8_t segments)
+{
+    if (digit >= SSEG_DIGITS) return;
+
+    fb[digit] = segments & (uint8_t)~SSEG_DP;
+    SSEG_SetDP(digit, (segments & SSEG_DP) != 0u);
+}
+
+void SSEG_SetBrightness(uint8_t digit, uint8_t lvl)
+{
+    if (digit >= SSEG_DIGITS) return;
+
+    level[digit] = (lvl > SSEG_BRIGHT_MAX) ? SSEG_BRIGHT_MAX : lvl;
+    publish(digit);
+}
+
+void SSEG_SetBrightnessAll(uint8_t lvl)
+{
+    for (uint8_t d = 0; d < SSEG_DIGITS; d++)
+    {
+        SSEG_SetBrightness(d, lvl);
+    }
 }
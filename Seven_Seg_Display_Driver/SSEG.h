@@ -4,18 +4,134 @@
 #include "main.h"
 #include <stdint.h>
 
+/*
+ * 4-digit multiplexed driver for the LTC-5650G.
+ *
+ * SSEG.c keeps the framebuffer; a transport (SSEGTransport.h) scans it
+ * out from TIM14, one digit per update, refreshing all four at
+ * SSEG_REFRESH_HZ:
+ *   SSEG_TRANSPORT_GPIO  segments a..g,dp on PB0..PB7, digit selects
+ *                        D1..D4 on PB8..PB11 (D1 = leftmost). One BSRR
+ *                        write per digit; TIM14 CC1 blanks it.
+ *   SSEG_TRANSPORT_595   SSEG_595_CHAIN chained 74HC595s on SPI1
+ *                        (PA5 SCK, PA7 MOSI), latch on PB12, OE# on PA4
+ *                        driven by TIM14 CH1 PWM. One DMA transfer per
+ *                        digit and no other CPU work.
+ *
+ * Brightness is per-digit PWM. The on-time never exceeds the slot minus
+ * SSEG_BLANK_US, so every digit is dark for at least that long around
+ * the switch to the next one (no ghosting through slow transistor
+ * turn-off or a latch that isn't finished).
+ *
+ * Needs, in stm32f0xx_it.c:
+ *   TIM14_IRQHandler -> SSEG_TIM_IRQHandler()
+ */
+
+#define SSEG_TRANSPORT_GPIO  0
+#define SSEG_TRANSPORT_595   1
+
+#ifndef SSEG_TRANSPORT
+#define SSEG_TRANSPORT     SSEG_TRANSPORT_GPIO
+#endif
+
+#define SSEG_DIGITS        4u
+#define SSEG_REFRESH_HZ    500u     // per digit; TIM14 updates at 4x this
+#define SSEG_BLANK_US      20u      // minimum dark time between digits
+#define SSEG_BRIGHT_MAX    15u
+
+/* Pin polarity: 1 = driving the line high lights the segment / digit */
+#ifndef SSEG_SEG_ON_HIGH
+#define SSEG_SEG_ON_HIGH   1        // line -> 1 kOhm -> segment anode
+#endif
+#ifndef SSEG_DIGIT_ON_HIGH
+#define SSEG_DIGIT_ON_HIGH 1        // line -> NPN base, collector to the cathode
+#endif
+
+/*
+ * 74HC595 chain (SSEG_TRANSPORT_595). Chain byte 0 is the 595 wired to
+ * MOSI, byte 1 the one fed from its QH', and so on; within a byte bit 0
+ * is QA. Outputs not listed here stay low.
+ */
+#ifndef SSEG_595_CHAIN
+#define SSEG_595_CHAIN       2u     // 595s in the chain
+#endif
+#ifndef SSEG_595_SEG_BYTE
+#define SSEG_595_SEG_BYTE    0u     // segments a..g,dp on QA..QH
+#endif
+#ifndef SSEG_595_DIGIT_BYTE
+#define SSEG_595_DIGIT_BYTE  1u     // D1..D4 selects ...
+#endif
+#ifndef SSEG_595_DIGIT_SHIFT
+#define SSEG_595_DIGIT_SHIFT 0u     // ... starting at this bit (QA)
+#endif
+
+#if SSEG_TRANSPORT == SSEG_TRANSPORT_595 && \
+    (SSEG_595_SEG_BYTE == SSEG_595_DIGIT_BYTE || \
+     SSEG_595_SEG_BYTE >= SSEG_595_CHAIN || SSEG_595_DIGIT_BYTE >= SSEG_595_CHAIN || \
+     SSEG_595_DIGIT_SHIFT + SSEG_DIGITS > 8u)
+#error "SSEG_595_xxx: segments and digit selects need separate 595s in the chain"
+#endif
+
+/* Segment bits: bit0=a, bit1=b, bit2=c, bit3=d, bit4=e, bit5=f, bit6=g, bit7=dp */
+#define SSEG_DP            0x80u
+
 /*
  * SSEG_Init
- * Initializes the single-digit seven-segment output (PB0..PB7).
- * Call once after MX_GPIO_Init().
+ * Sets up the transport and TIM14, clears the display and starts the
+ * scan at full brightness. Call once after MX_GPIO_Init().
  */
 void SSEG_Init(void);
 
 /*
  * SSEG_Out
- * Displays a decimal digit [0..9] on the enabled digit (your D2 with T4→GND).
+ * Displays a decimal digit [0..9] on D2 with the other digits blank,
+ * as the original single-digit driver did.
  */
 void SSEG_Out(uint8_t num);
 
-#endif
+/*
+ * SSEG_ShowInt
+ * Displays value right-aligned. Range -999..9999; anything else shows
+ * "----". zeroPad = 1 fills unused digits with 0 instead of blanks.
+ * Decimal points set with SSEG_SetDP() are kept.
+ */
+void SSEG_ShowInt(int32_t value, uint8_t zeroPad);
+
+/*
+ * SSEG_ShowHex
+ * Displays value as 4 hex digits (0-9, A, b, C, d, E, F).
+ */
+void SSEG_ShowHex(uint16_t value);
+
+/*
+ * SSEG_SetDP
+ * Turns the decimal point of one digit (0 = D1) on or off.
+ */
+void SSEG_SetDP(uint8_t digit, uint8_t on);
+
+/*
+ * SSEG_SetRaw
+ * Sets the segment bits of one digit directly (dp included).
+ */
+void SSEG_SetRaw(uint8_t digit, uint8_t segments);
 
+/*
+ * SSEG_SetBrightness
+ * Sets one digit's brightness, 0 (off) .. SSEG_BRIGHT_MAX. The levels
+ * follow a square law so the steps look even.
+ */
+void SSEG_SetBrightness(uint8_t digit, uint8_t level);
+
+/*
+ * SSEG_SetBrightnessAll
+ * Same level for every digit.
+ */
+void SSEG_SetBrightnessAll(uint8_t level);
+
+/*
+ * SSEG_TIM_IRQHandler
+ * TIM14 update: drive the next digit. TIM14 CC1: blank it.
+ */
+void SSEG_TIM_IRQHandler(void);
+
+#endif
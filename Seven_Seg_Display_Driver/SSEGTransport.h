@@ -0,0 +1,43 @@
+#ifndef SSEG_TRANSPORT_H
+#define SSEG_TRANSPORT_H
+
+#include "SSEG.h"
+
+/*
+ * How SSEG.c gets the framebuffer onto the display.
+ *
+ * Exactly one implementation is compiled, chosen by SSEG_TRANSPORT:
+ *   SSEGTransport_GPIO.c : segments PB0..PB7, digits PB8..PB11. One BSRR
+ *                          write per digit; TIM14 CC1 blanks the digit.
+ *   SSEGTransport_595.c  : SSEG_595_CHAIN chained 74HC595s on SPI1, one
+ *                          DMA transfer per digit, latch on PB12. TIM14
+ *                          CH1 PWM on the 595 OE# pins sets the on-time.
+ * Both scan one digit per TIM14 update and define SSEG_TIM_IRQHandler().
+ */
+
+/* TIM14 at 1 MHz: one slot per digit */
+#define SSEG_TIM_CLOCK    8000000u
+#define SSEG_TICK_HZ      1000000u
+#define SSEG_SLOT_TICKS   (SSEG_TICK_HZ / (SSEG_REFRESH_HZ * SSEG_DIGITS))
+#define SSEG_ON_MAX       (SSEG_SLOT_TICKS - SSEG_BLANK_US)
+#define SSEG_ON_MIN       8u        // a few times the ISR entry latency
+
+#if SSEG_ON_MAX < 100u
+#error "SSEG_REFRESH_HZ too high for the PWM resolution"
+#endif
+
+/*
+ * SSEGTransport_Init
+ * Sets up the pins and TIM14 with every digit off, and starts the scan.
+ */
+void SSEGTransport_Init(void);
+
+/*
+ * SSEGTransport_Set
+ * Segments (dp included) and on-time in TIM14 ticks for one digit;
+ * onTicks = 0 turns the digit off. Takes effect from the digit's next
+ * slot. Main loop only.
+ */
+void SSEGTransport_Set(uint8_t digit, uint8_t segments, uint16_t onTicks);
+
+#endif
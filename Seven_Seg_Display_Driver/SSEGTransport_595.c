@@ -0,0 +1,194 @@
+#include "SSEGTransport.h"
+
+#if SSEG_TRANSPORT == SSEG_TRANSPORT_595
+
+/*
+ * Chained 74HC595s on SPI1 (PA5 = SCK -> SRCLK, PA7 = MOSI -> SER of the
+ * first 595; each QH' feeds the next SER). All RCLKs on PB12, all OE#
+ * on PA4 (TIM14_CH1). SRCLR# tied high.
+ *
+ * Each TIM14 update, in this order:
+ *   1. pulse RCLK: the frame shifted during the last slot reaches the
+ *      outputs. OE# is high at this point, so nothing is lit.
+ *   2. start a DMA transfer of the next digit's frame (SSEG_595_CHAIN
+ *      bytes, a few microseconds at 4 MHz); no interrupt on completion.
+ *   3. preload CCR1 with the next digit's on-time.
+ * CH1 runs in PWM mode 2 with active-low output: OE# goes low at
+ * CCR1 = slot - on-time and back high at the end of the slot. The
+ * on-time sits at the end of the slot, so the latch always happens
+ * at least SSEG_BLANK_US before the outputs turn on.
+ */
+
+#define LATCH_PORT    GPIOB
+#define LATCH_PIN     GPIO_PIN_12
+
+SPI_HandleTypeDef hspi1;
+static DMA_HandleTypeDef hdma_spi1_tx;
+static TIM_HandleTypeDef htim14;
+
+/* One frame per digit, in shift order: frame[d][0] ends up in the last 595 */
+static uint8_t frame[SSEG_DIGITS][SSEG_595_CHAIN];
+static volatile uint16_t slotTicks[SSEG_DIGITS];
+static uint8_t slot = 0;                   // digit on the outputs now (ISR)
+
+/* Chain byte i (0 = next to the MCU) is sent last */
+#define TX_INDEX(i)   (SSEG_595_CHAIN - 1u - (i))
+
+void SSEGTransport_Set(uint8_t digit, uint8_t segments, uint16_t onTicks)
+{
+    uint8_t digits = (onTicks != 0u) ? (uint8_t)(1u << digit) : 0u;
+
+#if !SSEG_SEG_ON_HIGH
+    segments = (uint8_t)~segments;
+#endif
+#if !SSEG_DIGIT_ON_HIGH
+    digits ^= (1u << SSEG_DIGITS) - 1u;
+#endif
+
+    // Single-byte stores: the DMA sees each byte either old or new
+    frame[digit][TX_INDEX(SSEG_595_SEG_BYTE)] = segments;
+    frame[digit][TX_INDEX(SSEG_595_DIGIT_BYTE)] =
+        (uint8_t)(digits << SSEG_595_DIGIT_SHIFT);
+    slotTicks[digit] = onTicks;
+}
+
+static inline void latch(void)
+{
+    LATCH_PORT->BSRR = LATCH_PIN;   // >= 2 clocks at 8 MHz: well over tW(RCLK)
+    LATCH_PORT->BRR  = LATCH_PIN;
+}
+
+static void startFrame(uint8_t d)
+{
+    DMA1_Channel3->CCR  &= ~DMA_CCR_EN;
+    DMA1_Channel3->CMAR  = (uintptr_t)frame[d];
+    DMA1_Channel3->CNDTR = SSEG_595_CHAIN;
+    DMA1_Channel3->CCR  |= DMA_CCR_EN;
+}
+
+void SSEGTransport_Init(void)
+{
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+    TIM_OC_InitTypeDef sConfigOC = {0};
+
+    for (uint8_t d = 0; d < SSEG_DIGITS; d++)
+    {
+        for (uint8_t i = 0; i < SSEG_595_CHAIN; i++)
+        {
+            frame[d][i] = 0;
+        }
+        SSEGTransport_Set(d, 0, 0);
+    }
+
+    __HAL_RCC_GPIOA_CLK_ENABLE();
+    __HAL_RCC_GPIOB_CLK_ENABLE();
+    __HAL_RCC_SPI1_CLK_ENABLE();
+    __HAL_RCC_TIM14_CLK_ENABLE();
+    __HAL_RCC_DMA1_CLK_ENABLE();
+
+    /* PB12 = RCLK, idle low */
+    LATCH_PORT->BRR = LATCH_PIN;
+    GPIO_InitStruct.Pin = LATCH_PIN;
+    GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
+    GPIO_InitStruct.Pull = GPIO_NOPULL;
+    GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH;
+    HAL_GPIO_Init(LATCH_PORT, &GPIO_InitStruct);
+
+    /* PA5 = SPI1_SCK, PA7 = SPI1_MOSI */
+    GPIO_InitStruct.Pin = GPIO_PIN_5 | GPIO_PIN_7;
+    GPIO_InitStruct.Mode = GPIO_MODE_AF_PP;
+    GPIO_InitStruct.Alternate = GPIO_AF0_SPI1;
+    HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
+
+    /* SPI1: master, TX only in practice, 4 MHz, MSB first (QH gets bit 7) */
+    hspi1.Instance = SPI1;
+    hspi1.Init.Mode = SPI_MODE_MASTER;
+    hspi1.Init.Direction = SPI_DIRECTION_2LINES;
+    hspi1.Init.DataSize = SPI_DATASIZE_8BIT;
+    hspi1.Init.CLKPolarity = SPI_POLARITY_LOW;
+    hspi1.Init.CLKPhase = SPI_PHASE_1EDGE;
+    hspi1.Init.NSS = SPI_NSS_SOFT;
+    hspi1.Init.BaudRatePrescaler = SPI_BAUDRATEPRESCALER_2;
+    hspi1.Init.FirstBit = SPI_FIRSTBIT_MSB;
+    hspi1.Init.TIMode = SPI_TIMODE_DISABLE;
+    hspi1.Init.CRCCalculation = SPI_CRCCALCULATION_DISABLE;
+    hspi1.Init.CRCPolynomial = 7;
+    hspi1.Init.CRCLength = SPI_CRC_LENGTH_DATASIZE;
+    hspi1.Init.NSSPMode = SPI_NSS_PULSE_DISABLE;
+    if (HAL_SPI_Init(&hspi1) != HAL_OK)
+    {
+        Error_Handler();
+    }
+
+    /* SPI1_TX: DMA1 Channel 3, byte writes so the FIFO doesn't pack pairs */
+    hdma_spi1_tx.Instance = DMA1_Channel3;
+    hdma_spi1_tx.Init.Direction = DMA_MEMORY_TO_PERIPH;
+    hdma_spi1_tx.Init.PeriphInc = DMA_PINC_DISABLE;
+    hdma_spi1_tx.Init.MemInc = DMA_MINC_ENABLE;
+    hdma_spi1_tx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    hdma_spi1_tx.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+    hdma_spi1_tx.Init.Mode = DMA_NORMAL;
+    hdma_spi1_tx.Init.Priority = DMA_PRIORITY_LOW;
+    if (HAL_DMA_Init(&hdma_spi1_tx) != HAL_OK)
+    {
+        Error_Handler();
+    }
+    __HAL_LINKDMA(&hspi1, hdmatx, hdma_spi1_tx);
+    DMA1_Channel3->CPAR = (uintptr_t)&SPI1->DR;
+    SPI1->CR2 |= SPI_CR2_TXDMAEN;
+    __HAL_SPI_ENABLE(&hspi1);
+
+    /* PA4 = TIM14_CH1 -> OE# */
+    GPIO_InitStruct.Pin = GPIO_PIN_4;
+    GPIO_InitStruct.Mode = GPIO_MODE_AF_PP;
+    GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
+    GPIO_InitStruct.Alternate = GPIO_AF4_TIM14;
+    HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
+
+    /* TIM14: 1 MHz count, update = next digit, CH1 = OE# PWM */
+    htim14.Instance = TIM14;
+    htim14.Init.Prescaler = SSEG_TIM_CLOCK / SSEG_TICK_HZ - 1u;
+    htim14.Init.CounterMode = TIM_COUNTERMODE_UP;
+    htim14.Init.Period = SSEG_SLOT_TICKS - 1u;
+    htim14.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+    htim14.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+    if (HAL_TIM_PWM_Init(&htim14) != HAL_OK)
+    {
+        Error_Handler();
+    }
+    sConfigOC.OCMode = TIM_OCMODE_PWM2;        // active from CCR1 to the end
+    sConfigOC.Pulse = SSEG_SLOT_TICKS;         // never: all dark
+    sConfigOC.OCPolarity = TIM_OCPOLARITY_LOW; // active = OE# low = lit
+    sConfigOC.OCFastMode = TIM_OCFAST_DISABLE;
+    if (HAL_TIM_PWM_ConfigChannel(&htim14, &sConfigOC, TIM_CHANNEL_1) != HAL_OK)
+    {
+        Error_Handler();
+    }
+
+    HAL_NVIC_SetPriority(TIM14_IRQn, 0, 0);
+    HAL_NVIC_EnableIRQ(TIM14_IRQn);
+
+    // First update latches frame[0] and shows D1
+    slot = SSEG_DIGITS - 1u;
+    startFrame(0);
+    __HAL_TIM_ENABLE_IT(&htim14, TIM_IT_UPDATE);
+    if (HAL_TIM_PWM_Start(&htim14, TIM_CHANNEL_1) != HAL_OK)
+    {
+        Error_Handler();
+    }
+}
+
+void SSEG_TIM_IRQHandler(void)
+{
+    TIM14->SR = ~TIM_SR_UIF;
+
+    latch();
+    uint8_t s = (uint8_t)((slot + 1u) & (SSEG_DIGITS - 1u));
+    uint8_t next = (uint8_t)((s + 1u) & (SSEG_DIGITS - 1u));
+
+    startFrame(next);
+    TIM14->CCR1 = SSEG_SLOT_TICKS - slotTicks[next];   // preloaded
+    slot = s;
+}
+
+#endif /* SSEG_TRANSPORT == SSEG_TRANSPORT_595 */
@@ -0,0 +1,123 @@
+#include "SSEGTransport.h"
+
+#if SSEG_TRANSPORT == SSEG_TRANSPORT_GPIO
+
+#define SEG_PINS      0x00FFu      // PB0..PB7
+#define DIGIT_PINS    0x0F00u      // PB8..PB11
+#define DIGIT_PIN(d)  ((uint16_t)(GPIO_PIN_8 << (d)))
+
+static TIM_HandleTypeDef htim14;
+
+/* Precomputed for the ISR: one 32-bit store each, so never torn */
+static volatile uint32_t slotWord[SSEG_DIGITS];   // BSRR value per digit
+static volatile uint16_t slotTicks[SSEG_DIGITS];  // CC1 blanking point
+static uint8_t slot = 0;                          // digit driven now (ISR)
+
+/* BSRR value that drives all 12 pins: 'lit' pins on, the others off */
+static uint32_t pinWord(uint16_t lit)
+{
+    uint16_t high =
+        ((SSEG_SEG_ON_HIGH   ? lit : (uint16_t)~lit) & SEG_PINS) |
+        ((SSEG_DIGIT_ON_HIGH ? lit : (uint16_t)~lit) & DIGIT_PINS);
+
+    return high | ((uint32_t)(~high & (SEG_PINS | DIGIT_PINS)) << 16);
+}
+
+/* BSRR value that turns every digit off and leaves the segments alone */
+#if SSEG_DIGIT_ON_HIGH
+#define BLANK_WORD    ((uint32_t)DIGIT_PINS << 16)
+#else
+#define BLANK_WORD    ((uint32_t)DIGIT_PINS)
+#endif
+
+void SSEGTransport_Set(uint8_t digit, uint8_t segments, uint16_t onTicks)
+{
+    uint16_t lit = segments;
+
+    if (onTicks != 0u)
+    {
+        lit |= DIGIT_PIN(digit);
+    }
+    slotTicks[digit] = onTicks;
+    slotWord[digit]  = pinWord(lit);
+}
+
+void SSEGTransport_Init(void)
+{
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+    TIM_OC_InitTypeDef sConfigOC = {0};
+
+    for (uint8_t d = 0; d < SSEG_DIGITS; d++)
+    {
+        SSEGTransport_Set(d, 0, 0);
+    }
+
+    /* PB0..PB7 are set up by MX_GPIO_Init(); take PB8..PB11 as well */
+    __HAL_RCC_GPIOB_CLK_ENABLE();
+    GPIOB->BSRR = BLANK_WORD;
+    GPIO_InitStruct.Pin = SEG_PINS | DIGIT_PINS;
+    GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
+    GPIO_InitStruct.Pull = GPIO_NOPULL;
+    GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
+    HAL_GPIO_Init(GPIOB, &GPIO_InitStruct);
+
+    /* TIM14: 1 MHz count, update = next digit, CC1 = blank it */
+    __HAL_RCC_TIM14_CLK_ENABLE();
+    htim14.Instance = TIM14;
+    htim14.Init.Prescaler = SSEG_TIM_CLOCK / SSEG_TICK_HZ - 1u;
+    htim14.Init.CounterMode = TIM_COUNTERMODE_UP;
+    htim14.Init.Period = SSEG_SLOT_TICKS - 1u;
+    htim14.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+    htim14.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+    if (HAL_TIM_OC_Init(&htim14) != HAL_OK)
+    {
+        Error_Handler();
+    }
+    sConfigOC.OCMode = TIM_OCMODE_TIMING;   // interrupt only, no pin
+    sConfigOC.Pulse = 0;
+    sConfigOC.OCPolarity = TIM_OCPOLARITY_HIGH;
+    sConfigOC.OCFastMode = TIM_OCFAST_DISABLE;
+    if (HAL_TIM_OC_ConfigChannel(&htim14, &sConfigOC, TIM_CHANNEL_1) != HAL_OK)
+    {
+        Error_Handler();
+    }
+    // CCR1 written in the update ISR takes effect at the next update
+    TIM14->CCMR1 |= TIM_CCMR1_OC1PE;
+
+    // Highest priority: a late interrupt shows up as uneven brightness
+    HAL_NVIC_SetPriority(TIM14_IRQn, 0, 0);
+    HAL_NVIC_EnableIRQ(TIM14_IRQn);
+
+    slot = SSEG_DIGITS - 1u;   // first update drives D1
+    if (HAL_TIM_OC_Start_IT(&htim14, TIM_CHANNEL_1) != HAL_OK ||
+        HAL_TIM_Base_Start_IT(&htim14) != HAL_OK)
+    {
+        Error_Handler();
+    }
+}
+
+void SSEG_TIM_IRQHandler(void)
+{
+    uint32_t sr = TIM14->SR;
+
+    // Blank first: if both flags are set the CC1 is the previous digit's
+    if (sr & TIM_SR_CC1IF)
+    {
+        TIM14->SR = ~TIM_SR_CC1IF;
+        GPIOB->BSRR = BLANK_WORD;
+    }
+    if (sr & TIM_SR_UIF)
+    {
+        TIM14->SR = ~TIM_SR_UIF;
+        uint8_t s = (uint8_t)((slot + 1u) & (SSEG_DIGITS - 1u));
+        // Entered so late that this digit's on-time is over: leave it dark
+        if (TIM14->CNT < slotTicks[s])
+        {
+            GPIOB->BSRR = slotWord[s];   // the previous digit is already dark
+        }
+        TIM14->CCR1 = slotTicks[(s + 1u) & (SSEG_DIGITS - 1u)];   // preloaded
+        slot = s;
+    }
+}
+
+#endif /* SSEG_TRANSPORT == SSEG_TRANSPORT_GPIO */
@@ -3,9 +3,30 @@
 /* USER CODE END Header */
 #include "main.h"
 #include "SSEG.h"   // <-- add this
+#include "Buttons.h"
+#include "Settings.h"
+#include "Telemetry.h"  // build with -DTELEMETRY_PORT=TELEMETRY_PORT_USART1_PA9
+
+// The default telemetry pin, PA2, is the DEC button here
+#if TELEMETRY_PORT != TELEMETRY_PORT_USART1_PA9
+#error "PA2 is the DEC button: build with -DTELEMETRY_PORT=TELEMETRY_PORT_USART1_PA9"
+#endif
+
+// The GPIO transport drives PB8/PB9 as digit selects, and the 24AA16 needs
+// them for I2C1: build that wiring with -DEEPROM24_BACKEND=EEPROM24_BACKEND_RAM
+#if SSEG_TRANSPORT == SSEG_TRANSPORT_GPIO && EEPROM24_BACKEND == EEPROM24_BACKEND_I2C
+#error "SSEG_TRANSPORT_GPIO uses PB8/PB9: add -DEEPROM24_BACKEND=EEPROM24_BACKEND_RAM or use SSEG_TRANSPORT_595"
+#endif
+
+#define NUM_SAVE_MS  2000u    // store g_num this long after its first change
+
+// Telemetry on PA9: a TLM_KEY frame per press / release, a TLM_COUNTER with g_num
+#define TLM_BAUD     115200u
+#define TLM_BUTTONS  0u       // TLM_KEY source, key = BUTTON_INC / BUTTON_DEC
+#define TLM_C_NUM    1u       // TLM_COUNTER id of g_num
 
 /* Private variables ---------------------------------------------------------*/
-volatile uint8_t g_num = 0;   // current digit 0..9
+uint16_t g_num = 0;           // displayed number 0..9999
 
 /* Private function prototypes -----------------------------------------------*/
 void SystemClock_Config(void);
@@ -20,32 +41,53 @@ int main(void)
   SystemClock_Config();
   MX_GPIO_Init();
 
-  SSEG_Init();        // show 0 on the 2nd digit (T4->GND)
-
-  while (1) {
-    __WFI();          // sleep; wake on button interrupt
-  }
-}
+  // g_num survives a reset in the 24AA16; a burst of presses is one write
+  Eeprom24_Init();
+  Settings_Init(NUM_SAVE_MS);
+  g_num = (uint16_t)(Settings_GetOr(SET_SSEG_NUM, 0) % 10000u);
 
-/* ----- Button ISR callback (PA1 = INC, PA2 = DEC, active-low) ----- */
-void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
-{
-  if (GPIO_Pin == GPIO_PIN_1 || GPIO_Pin == GPIO_PIN_2) {
-    HAL_Delay(20);    // debounce ~20 ms
+  SSEG_Init();        // starts the TIM14 digit scan
+  SSEG_ShowInt(g_num, 0);
+  Buttons_Init();     // EXTI edges + SysTick debounce
+  Telemetry_Init(TLM_APP_SSEG, TLM_BAUD);
+  Telemetry_Counter(TLM_C_NUM, g_num);
 
-    GPIO_TypeDef *port = GPIOA;
-    uint16_t pin = (GPIO_Pin == GPIO_PIN_1) ? GPIO_PIN_1 : GPIO_PIN_2;
+  while (1) {
+    ButtonEvent ev;
 
-    if (HAL_GPIO_ReadPin(port, pin) == GPIO_PIN_RESET) {  // still pressed?
-      if (GPIO_Pin == GPIO_PIN_1) {       // PA1 -> increment
-        g_num = (g_num + 1) % 10;
-      } else {                            // PA2 -> decrement
-        g_num = (g_num == 0) ? 9 : (g_num - 1);
+    // PA1 = INC, PA2 = DEC; holding a button auto-repeats
+    while (Buttons_GetEvent(&ev)) {
+      if (ev.type == BUTTON_PRESS || ev.type == BUTTON_RELEASE) {
+        Telemetry_Key(TLM_BUTTONS, ev.button, ev.type == BUTTON_PRESS, Buttons_State());
+      }
+      if (ev.type != BUTTON_PRESS && ev.type != BUTTON_REPEAT) {
+        continue;
       }
-      SSEG_Out(g_num);                    // update segments
+      if (ev.button == BUTTON_INC) {
+        g_num = (g_num + 1) % 10000;
+      } else {
+        g_num = (g_num == 0) ? 9999 : (g_num - 1);
+      }
+      SSEG_ShowInt(g_num, 0);             // update the framebuffer
+      Settings_Set(SET_SSEG_NUM, g_num);
+      Telemetry_Counter(TLM_C_NUM, g_num);
+    }
+    Settings_Poll(HAL_GetTick());
+
+    // Sleep until the next interrupt (SysTick at the latest, so the
+    // settings poll still runs every ms; the telemetry DMA runs on). With PRIMASK set, an event
+    // that arrives after the check still wakes the WFI.
+    __disable_irq();
+    if (!Buttons_HasEvent()) {
+      __WFI();
     }
+    __enable_irq();
   }
 }
 
 /* --- keep the CubeMX-generated SystemClock_Config() and MX_GPIO_Init() --- */
 /* --- keep stm32f0xx_it.c calling HAL_GPIO_EXTI_IRQHandler for EXTI0_1 & EXTI2_3 --- */
+/* --- and HAL_SYSTICK_IRQHandler() after HAL_IncTick() in SysTick_Handler --- */
+/* --- and add SSEG_TIM_IRQHandler() to TIM14_IRQHandler --- */
+/* --- and Eeprom24_IRQHandler() to I2C1_IRQHandler --- */
+/* --- and Telemetry_IRQHandler() to DMA1_Channel2_3_IRQHandler --- */
@@ -0,0 +1,347 @@
+/*
+ * Run the display driver (SSEG.c with SSEGTransport_595.c) against a
+ * simulated 74HC595 chain on a PC, one 1 MHz TIM14 tick at a time.
+ *   - SPI1/DMA: a DMA start moves CNDTR bytes from CMAR to the SPI one
+ *     at a time; each is shifted MSB first, 4 bits per tick (4 MHz),
+ *     into the chain, and each 595's QH' feeds the next one's SER
+ *   - RCLK: a rising edge on PB12 copies every shift register to its
+ *     outputs
+ *   - OE#: TIM14 CH1 in PWM mode 2, active low: the outputs are on
+ *     while CNT >= CCR1, with CCR1 preloaded (it takes effect at the
+ *     update)
+ * The update interrupt is entered a random 0..latency after the
+ * update and runs in one instant.
+ *   - overlap: never two digits lit at once, unused outputs stay low
+ *   - segments: a lit digit shows only its own segments, while the
+ *     main loop keeps rewriting digits
+ *   - latch: never while the outputs are on, never with a shift under
+ *     way, for latency up to SSEG_BLANK_US - 1 (a longer latency is
+ *     run too and its latch collisions reported)
+ *   - duty: every digit is lit for exactly its brightness table on-time
+ *
+ * Build from the project folder, for 2 and for 3 chained 595s:
+ *   gcc -O2 -Wall -Wextra -Itools/host -I. -DSSEG_TRANSPORT=1 \
+ *       -o chain_sim tools/chain_sim.c SSEG.c SSEGTransport_595.c
+ *   gcc -O2 -Wall -Wextra -Itools/host -I. -DSSEG_TRANSPORT=1 \
+ *       -DSSEG_595_CHAIN=3 -DSSEG_595_SEG_BYTE=2 -DSSEG_595_DIGIT_BYTE=0 \
+ *       -DSSEG_595_DIGIT_SHIFT=4 \
+ *       -o chain_sim3 tools/chain_sim.c SSEG.c SSEGTransport_595.c
+ *   ./chain_sim [seed]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "main.h"
+#include "SSEG.h"
+#include "SSEGTransport.h"
+
+#if SSEG_TRANSPORT != SSEG_TRANSPORT_595
+#error "chain_sim models the 595 transport: build with -DSSEG_TRANSPORT=1"
+#endif
+
+#define LATENCY_US    (SSEG_BLANK_US - 1u)
+#define LATE_US       30u
+#define RUN_SEC       2u
+#define BITS_PER_TICK 4u          // SPI1 at 4 MHz
+
+GPIO_TypeDef host_GPIOA, host_GPIOB;
+TIM_TypeDef  host_TIM14;
+SPI_TypeDef  host_SPI1;
+DMA_Channel_TypeDef host_DMA1_Channel3;
+
+static uint32_t now;             // ticks since start
+static uint32_t cnt;             // TIM14 counter
+static uint32_t ccr1;            // active CCR1 (host_TIM14.CCR1 is the preload)
+static uint32_t isrAt;           // tick the ISR will be entered ...
+static int      isrDue;          // ... if set
+static uint32_t latency;
+
+static uint8_t  shiftReg[SSEG_595_CHAIN];   // byte 0 = the 595 on MOSI
+static uint8_t  outputs[SSEG_595_CHAIN];
+static const uint8_t *dmaSrc;
+static uint32_t dmaBits;         // bits left to shift
+static uint8_t  spiByte;         // byte the DMA moved to SPI1->DR
+
+static uint8_t  given[SSEG_DIGITS];         // segments the main loop last set
+// Every value given per digit while a shift was under way (a 256-bit
+// set each); the DMA reads the frame byte by byte, so any of them can
+// end up in the chain
+static uint8_t  inFlight[SSEG_DIGITS][32];
+static uint8_t  shown[SSEG_DIGITS][32];     // ... for the latched frame
+
+static uint32_t latchLit, latchShifting;
+static int      failures;
+
+void HAL_GPIO_Init(GPIO_TypeDef *port, GPIO_InitTypeDef *init)
+{
+    (void)port;
+    (void)init;
+}
+
+HAL_StatusTypeDef HAL_SPI_Init(SPI_HandleTypeDef *hspi)
+{
+    return hspi->Init.FirstBit == SPI_FIRSTBIT_MSB ? HAL_OK : HAL_ERROR;
+}
+
+HAL_StatusTypeDef HAL_DMA_Init(DMA_HandleTypeDef *hdma)
+{
+    (void)hdma;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_PWM_Init(TIM_HandleTypeDef *htim)
+{
+    return htim->Init.Period == SSEG_SLOT_TICKS - 1u ? HAL_OK : HAL_ERROR;
+}
+
+HAL_StatusTypeDef HAL_TIM_PWM_ConfigChannel(TIM_HandleTypeDef *htim, TIM_OC_InitTypeDef *cfg, uint32_t channel)
+{
+    (void)channel;
+    if (cfg->OCMode != TIM_OCMODE_PWM2 || cfg->OCPolarity != TIM_OCPOLARITY_LOW)
+    {
+        return HAL_ERROR;
+    }
+    htim->Instance->CCR1 = cfg->Pulse;
+    htim->Instance->CCMR1 |= TIM_CCMR1_OC1PE;   // as the HAL does for PWM
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_PWM_Start(TIM_HandleTypeDef *htim, uint32_t channel)
+{
+    (void)htim;
+    (void)channel;
+    cnt = 0;
+    ccr1 = host_TIM14.CCR1;
+    return HAL_OK;
+}
+
+void HAL_NVIC_SetPriority(int irq, uint32_t pre, uint32_t sub)
+{
+    (void)irq;
+    (void)pre;
+    (void)sub;
+}
+
+void HAL_NVIC_EnableIRQ(int irq)
+{
+    (void)irq;
+}
+
+void Error_Handler(void)
+{
+    printf("Error_Handler\n");
+    exit(2);
+}
+
+static void check(int ok, const char *what)
+{
+    printf("%-58s %s\n", what, ok ? "ok" : "FAIL");
+    failures += !ok;
+}
+
+// The brightness table SSEG.h documents
+static uint32_t onTicks(uint32_t level)
+{
+    return level == 0u ? 0u : SSEG_ON_MIN + (SSEG_ON_MAX - SSEG_ON_MIN) * level * level /
+                                            (SSEG_BRIGHT_MAX * SSEG_BRIGHT_MAX);
+}
+
+static int outputsOn(void)
+{
+    return cnt >= ccr1;
+}
+
+static void noteGiven(uint8_t d)
+{
+    inFlight[d][given[d] >> 3] |= (uint8_t)(1u << (given[d] & 7u));
+}
+
+static int wasShown(uint8_t d, uint8_t seg)
+{
+    return (shown[d][seg >> 3] >> (seg & 7u)) & 1u;
+}
+
+// Start a transfer if the ISR (or Init) enabled the channel
+static void dmaPoll(void)
+{
+    if (host_DMA1_Channel3.CCR & DMA_CCR_EN)
+    {
+        host_DMA1_Channel3.CCR &= ~DMA_CCR_EN;
+        dmaSrc = (const uint8_t *)host_DMA1_Channel3.CMAR;
+        dmaBits = 8u * host_DMA1_Channel3.CNDTR;
+        memset(inFlight, 0, sizeof inFlight);
+        for (uint8_t d = 0; d < SSEG_DIGITS; d++)
+        {
+            noteGiven(d);
+        }
+    }
+}
+
+static void shiftBit(uint8_t bit)
+{
+    for (uint8_t i = SSEG_595_CHAIN - 1u; i > 0u; i--)
+    {
+        shiftReg[i] = (uint8_t)((shiftReg[i] << 1) | (shiftReg[i - 1u] >> 7));
+    }
+    shiftReg[0] = (uint8_t)((shiftReg[0] << 1) | bit);
+}
+
+// One timer tick: SPI bits, count, maybe enter the ISR
+static void tick(void)
+{
+    now++;
+    for (uint32_t b = 0; b < BITS_PER_TICK && dmaBits != 0u; b++)
+    {
+        if ((dmaBits & 7u) == 0u)
+        {
+            spiByte = *dmaSrc++;
+        }
+        dmaBits--;
+        shiftBit((uint8_t)((spiByte >> (dmaBits & 7u)) & 1u));
+    }
+
+    if (++cnt == SSEG_SLOT_TICKS)
+    {
+        cnt = 0;
+        ccr1 = host_TIM14.CCR1;
+        isrAt = now + (latency ? (uint32_t)rand() % (latency + 1u) : 0u);
+        isrDue = 1;
+    }
+    if (isrDue && now == isrAt)
+    {
+        host_TIM14.SR = TIM_SR_UIF;
+        host_GPIOB.BSRR = 0;
+        SSEG_TIM_IRQHandler();
+        isrDue = 0;
+        if (host_GPIOB.BSRR & GPIO_PIN_12)
+        {
+            latchLit += outputsOn();
+            latchShifting += dmaBits != 0u;
+            memcpy(outputs, shiftReg, sizeof outputs);
+            memcpy(shown, inFlight, sizeof shown);
+        }
+        dmaPoll();
+    }
+}
+
+typedef struct {
+    int      overlap;
+    int      stray;
+    uint32_t litUs[SSEG_DIGITS];
+} Result;
+
+/*
+ * Run for RUN_SEC at the given levels. With 'rewrite' the main loop
+ * sets random segments on random digits every few hundred ticks; a lit
+ * digit must show one of the values it was given while its frame was
+ * shifted.
+ */
+static void run(const uint8_t *levels, int rewrite, Result *r)
+{
+    for (uint8_t d = 0; d < SSEG_DIGITS; d++)
+    {
+        given[d] = (uint8_t)(0x11u << d);
+        SSEG_SetRaw(d, given[d]);
+        SSEG_SetBrightness(d, levels[d]);
+    }
+    // Two frames to let the old settings drain out of the chain
+    for (uint32_t t = 0; t < 2u * SSEG_DIGITS * SSEG_SLOT_TICKS; t++)
+    {
+        tick();
+    }
+
+    *r = (Result){ 0 };
+    for (uint32_t t = 0; t < RUN_SEC * SSEG_TICK_HZ; t++)
+    {
+        if (rewrite && rand() % 300 == 0)
+        {
+            uint8_t d = (uint8_t)(rand() % SSEG_DIGITS);
+            given[d] = (uint8_t)rand();
+            SSEG_SetRaw(d, given[d]);
+            if (dmaBits != 0u)
+            {
+                noteGiven(d);
+            }
+        }
+        tick();
+        if (!outputsOn())
+        {
+            continue;
+        }
+
+        uint8_t seg = SSEG_SEG_ON_HIGH ? outputs[SSEG_595_SEG_BYTE] : (uint8_t)~outputs[SSEG_595_SEG_BYTE];
+        uint8_t sel = (uint8_t)(outputs[SSEG_595_DIGIT_BYTE] >> SSEG_595_DIGIT_SHIFT);
+        uint8_t lit = (uint8_t)((SSEG_DIGIT_ON_HIGH ? sel : ~sel) & ((1u << SSEG_DIGITS) - 1u));
+        for (uint8_t i = 0; i < SSEG_595_CHAIN; i++)
+        {
+            uint8_t used = i == SSEG_595_SEG_BYTE ? 0xFFu :
+                           i == SSEG_595_DIGIT_BYTE ? (uint8_t)(((1u << SSEG_DIGITS) - 1u) << SSEG_595_DIGIT_SHIFT) : 0u;
+            r->overlap |= (outputs[i] & ~used) != 0u;
+        }
+        if (lit & (lit - 1u))
+        {
+            r->overlap = 1;
+            continue;
+        }
+        if (lit)
+        {
+            int d = __builtin_ctz(lit);
+            r->stray |= !wasShown((uint8_t)d, seg);
+            r->litUs[d]++;
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    unsigned seed = (argc > 1) ? (unsigned)atoi(argv[1]) : 1u;
+    const uint32_t slots = RUN_SEC * SSEG_REFRESH_HZ;
+    int overlap = 0, stray = 0, exact = 1;
+    uint8_t levels[SSEG_DIGITS];
+    Result r;
+
+    srand(seed);
+    SSEG_Init();
+    dmaPoll();
+    printf("%u chained 595s (segments byte %u, digits byte %u from bit %u), on-time %u..%u us\n",
+           (unsigned)SSEG_595_CHAIN, (unsigned)SSEG_595_SEG_BYTE, (unsigned)SSEG_595_DIGIT_BYTE,
+           (unsigned)SSEG_595_DIGIT_SHIFT, (unsigned)SSEG_ON_MIN, (unsigned)SSEG_ON_MAX);
+
+    // Every level on every digit, four digits at a time
+    for (uint8_t base = 0; base <= SSEG_BRIGHT_MAX; base++)
+    {
+        for (uint8_t d = 0; d < SSEG_DIGITS; d++)
+        {
+            levels[d] = (uint8_t)((base + 5u * d) % (SSEG_BRIGHT_MAX + 1u));
+        }
+        for (int pass = 0; pass < 2; pass++)
+        {
+            latency = pass ? LATENCY_US : 0u;
+            run(levels, pass, &r);
+            overlap |= r.overlap;
+            stray |= r.stray;
+            for (uint8_t d = 0; d < SSEG_DIGITS; d++)
+            {
+                exact &= r.litUs[d] == onTicks(levels[d]) * slots;
+            }
+        }
+    }
+
+    check(!overlap, "one digit at a time, unused outputs low");
+    check(!stray, "a lit digit shows only its own segments");
+    check(exact, "on-time is exactly the brightness table");
+    printf("latency 0..%u us: %u latches while lit, %u during a shift\n",
+           (unsigned)LATENCY_US, (unsigned)latchLit, (unsigned)latchShifting);
+    check(latchLit == 0u && latchShifting == 0u, "the latch comes only while dark and shifted");
+
+    // Past SSEG_BLANK_US at full brightness: show what goes wrong
+    latchLit = latchShifting = 0;
+    latency = LATE_US;
+    memset(levels, SSEG_BRIGHT_MAX, sizeof levels);
+    run(levels, 1, &r);
+    printf("latency 0..%u us at full brightness: %u of %u latches while lit\n",
+           LATE_US, (unsigned)latchLit, (unsigned)(slots * SSEG_DIGITS));
+
+    printf("%s\n", failures ? "FAILED" : "all passed");
+    return failures != 0;
+}
@@ -0,0 +1,215 @@
+/*
+ * Feed the button debouncer (Debounce.c) synthetic edge traces on a PC
+ * and check every event it reports. Three buttons are pressed
+ * independently, PRESSES in all:
+ *   - every edge bounces 0..MAX_BOUNCES times, 50..450 us apart
+ *   - 1.5 ms glitches land between presses and during holds
+ *   - holds run from 30 ms to 1.5 s, so some reach the long press and
+ *     the auto-repeats; none end within SLACK_MS of one (the release
+ *     needs a few ms to confirm, so a hold ending there may go either
+ *     way)
+ * EXTI is modelled as a Debounce_Edge() call at the exact edge time,
+ * SysTick as a Debounce_Tick() every 1 ms with the line levels at that
+ * instant, only while Debounce_Busy(), as Buttons.c does. The events
+ * must match the presses one for one:
+ *   PRESS at the first edge, LONG at +800 ms, REPEAT every 150 ms after
+ *   that while held, RELEASE at the first edge of the release, and
+ *   nothing from the glitches.
+ *
+ * Build from the project folder:
+ *   gcc -O2 -Wall -Wextra -I. -I../Common -o debounce_sim tools/debounce_sim.c Debounce.c
+ *   ./debounce_sim [seed]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include "Debounce.h"
+
+#define BUTTONS       3u
+#define PRESSES       3000u
+#define MAX_BOUNCES   7u
+#define GLITCH_US     1500u
+#define SLACK_MS      20u
+#define MAX_EDGES     (PRESSES * (4u * MAX_BOUNCES + 8u))
+#define MAX_EXPECT    (PRESSES * 12u)
+
+typedef struct {
+    uint32_t time;
+    uint8_t  button;
+    uint8_t  level;    // 1 = pressed
+} Edge;
+
+static Edge        edges[MAX_EDGES];
+static uint32_t    nEdges;
+static ButtonEvent expect[BUTTONS][MAX_EXPECT / BUTTONS];
+static uint32_t    nExpect[BUTTONS], nGot[BUTTONS];
+static uint32_t    glitches, bounces, longs, repeats;
+static int         failures;
+
+static void check(int ok, const char *what)
+{
+    printf("%-58s %s\n", what, ok ? "ok" : "FAIL");
+    failures += !ok;
+}
+
+static uint32_t range(uint32_t lo, uint32_t hi)
+{
+    return lo + (uint32_t)rand() % (hi - lo + 1u);
+}
+
+static void addEdge(uint32_t t, uint8_t b, uint8_t level)
+{
+    edges[nEdges++] = (Edge){ t, b, level };
+}
+
+static void addExpect(uint8_t b, uint32_t t, uint8_t type)
+{
+    expect[b][nExpect[b]++] = (ButtonEvent){ t, b, type };
+}
+
+// An edge to 'level' at t and its bounce train; returns the last edge time
+static uint32_t bouncyEdge(uint32_t t, uint8_t b, uint8_t level)
+{
+    uint32_t n = range(0, MAX_BOUNCES);
+
+    addEdge(t, b, level);
+    bounces += n;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        t += range(50, 450);
+        addEdge(t, b, (uint8_t)!level);
+        t += range(50, 450);
+        addEdge(t, b, level);
+    }
+    return t;
+}
+
+static void glitch(uint32_t t, uint8_t b, uint8_t level)
+{
+    addEdge(t, b, (uint8_t)!level);
+    addEdge(t + GLITCH_US, b, level);
+    glitches++;
+}
+
+// A hold time that does not end within SLACK_MS of the long press or a repeat
+static uint32_t holdMs(void)
+{
+    for (;;)
+    {
+        uint32_t h = range(30, 1500), clear = 1;
+        for (uint32_t due = DEBOUNCE_LONG_MS; due < 1600u; due += DEBOUNCE_REPEAT_MS)
+        {
+            clear &= h + SLACK_MS < due || h > due + SLACK_MS;
+        }
+        if (clear)
+        {
+            return h;
+        }
+    }
+}
+
+static void makeTrace(uint8_t b)
+{
+    uint32_t t = range(1, 50) * 1000u + range(0, 999);
+
+    for (uint32_t p = 0; p < PRESSES / BUTTONS; p++)
+    {
+        // Gap, with a glitch in it if there is room
+        uint32_t gap = range(30, 300) * 1000u + range(0, 999);
+        if (gap > 45000u)
+        {
+            glitch(t + 20000u, b, 0);
+        }
+        t += gap;
+
+        // Press, hold (maybe with a glitch), release
+        uint32_t hold = holdMs() * 1000u, t0 = t;
+        uint32_t settled = bouncyEdge(t0, b, 1);
+        addExpect(b, t0, BUTTON_PRESS);
+        if (hold > 60000u && rand() % 2)
+        {
+            glitch(t0 + range(20000, hold - 20000u), b, 1);
+        }
+        for (uint32_t due = DEBOUNCE_LONG_MS; due * 1000u < hold; due += DEBOUNCE_REPEAT_MS)
+        {
+            addExpect(b, t0 + due * 1000u, due == DEBOUNCE_LONG_MS ? BUTTON_LONG : BUTTON_REPEAT);
+            longs += due == DEBOUNCE_LONG_MS;
+            repeats += due != DEBOUNCE_LONG_MS;
+        }
+        t = t0 + hold > settled ? t0 + hold : settled + 1000u;
+        addExpect(b, t, BUTTON_RELEASE);
+        t = bouncyEdge(t, b, 0);
+    }
+}
+
+static int byTime(const void *a, const void *b)
+{
+    const Edge *x = a, *y = b;
+    return (x->time > y->time) - (x->time < y->time);
+}
+
+int main(int argc, char **argv)
+{
+    unsigned seed = (argc > 1) ? (unsigned)atoi(argv[1]) : 1u;
+    uint8_t level = 0;
+    uint32_t e = 0, wrong = 0, unexpected = 0;
+    ButtonEvent ev;
+
+    srand(seed);
+    for (uint8_t b = 0; b < BUTTONS; b++)
+    {
+        makeTrace(b);
+    }
+    qsort(edges, nEdges, sizeof edges[0], byTime);
+
+    Debounce_Init(BUTTONS, 0);
+    uint32_t end = edges[nEdges - 1u].time + 100000u;
+    for (uint32_t now = 1000u; now < end; now += DEBOUNCE_TICK_MS * 1000u)
+    {
+        // EXTI: every edge up to this tick, in time order
+        for (; e < nEdges && edges[e].time < now; e++)
+        {
+            uint8_t bit = (uint8_t)(1u << edges[e].button);
+            level = edges[e].level ? (uint8_t)(level | bit) : (uint8_t)(level & ~bit);
+            Debounce_Edge(edges[e].button, edges[e].time);
+        }
+        // SysTick
+        if (Debounce_Busy())
+        {
+            Debounce_Tick(level, now);
+        }
+        // Main loop
+        while (Debounce_GetEvent(&ev))
+        {
+            uint8_t b = ev.button;
+            if (b >= BUTTONS || nGot[b] >= nExpect[b])
+            {
+                unexpected++;
+                continue;
+            }
+            const ButtonEvent *x = &expect[b][nGot[b]++];
+            if (ev.type != x->type || ev.time != x->time)
+            {
+                if (wrong++ < 5u)
+                {
+                    printf("button %u event %u: type %u at %u us, expected type %u at %u us\n",
+                           b, nGot[b] - 1u, ev.type, ev.time, x->type, x->time);
+                }
+            }
+        }
+    }
+
+    uint32_t missing = 0;
+    for (uint8_t b = 0; b < BUTTONS; b++)
+    {
+        missing += nExpect[b] - nGot[b];
+    }
+    printf("%u presses, %u bounces, %u glitches, %u long presses, %u repeats, %.0f s\n",
+           PRESSES, bounces, glitches, longs, repeats, end / 1e6);
+    check(wrong == 0u, "events in order, stamped with the first edge");
+    check(missing == 0u && unexpected == 0u, "one event per press, release, long, repeat; none else");
+    check(Debounce_State() == 0u && !Debounce_Busy(), "all released and idle at the end");
+    check(Debounce_Overruns() == 0u, "no event queue overruns");
+
+    printf("%s\n", failures ? "FAILED" : "all passed");
+    return failures != 0;
+}
@@ -0,0 +1,191 @@
+#ifndef __MAIN_H__
+#define __MAIN_H__
+
+#include <stdint.h>
+
+/*
+ * Stand-in for the CubeMX main.h when firmware sources are built on a
+ * PC by the tools/ harnesses (-Itools/host). Only what those sources
+ * touch is here: peripherals are plain structs the harness owns and
+ * reads back, and the HAL calls are defined by the harness.
+ */
+
+typedef enum { HAL_OK = 0, HAL_ERROR = 1 } HAL_StatusTypeDef;
+
+typedef struct {
+    volatile uint32_t ODR;
+    volatile uint32_t BSRR;
+    volatile uint32_t BRR;
+} GPIO_TypeDef;
+
+typedef struct {
+    volatile uint32_t SR;
+    volatile uint32_t CNT;
+    volatile uint32_t CCR1;
+    volatile uint32_t CCMR1;
+} TIM_TypeDef;
+
+typedef struct {
+    uint32_t Pin;
+    uint32_t Mode;
+    uint32_t Pull;
+    uint32_t Speed;
+    uint32_t Alternate;
+} GPIO_InitTypeDef;
+
+typedef struct {
+    uint32_t Prescaler;
+    uint32_t CounterMode;
+    uint32_t Period;
+    uint32_t ClockDivision;
+    uint32_t AutoReloadPreload;
+} TIM_Base_InitTypeDef;
+
+typedef struct {
+    TIM_TypeDef         *Instance;
+    TIM_Base_InitTypeDef Init;
+} TIM_HandleTypeDef;
+
+typedef struct {
+    uint32_t OCMode;
+    uint32_t Pulse;
+    uint32_t OCPolarity;
+    uint32_t OCFastMode;
+} TIM_OC_InitTypeDef;
+
+/* CMAR and CPAR hold addresses: pointer-sized here, 32 bits on the M0 */
+typedef struct {
+    volatile uint32_t  CCR;
+    volatile uint32_t  CNDTR;
+    volatile uintptr_t CPAR;
+    volatile uintptr_t CMAR;
+} DMA_Channel_TypeDef;
+
+typedef struct {
+    uint32_t Direction;
+    uint32_t PeriphInc;
+    uint32_t MemInc;
+    uint32_t PeriphDataAlignment;
+    uint32_t MemDataAlignment;
+    uint32_t Mode;
+    uint32_t Priority;
+} DMA_InitTypeDef;
+
+typedef struct {
+    DMA_Channel_TypeDef *Instance;
+    DMA_InitTypeDef      Init;
+} DMA_HandleTypeDef;
+
+typedef struct {
+    volatile uint32_t CR2;
+    volatile uint32_t DR;
+} SPI_TypeDef;
+
+typedef struct {
+    uint32_t Mode;
+    uint32_t Direction;
+    uint32_t DataSize;
+    uint32_t CLKPolarity;
+    uint32_t CLKPhase;
+    uint32_t NSS;
+    uint32_t BaudRatePrescaler;
+    uint32_t FirstBit;
+    uint32_t TIMode;
+    uint32_t CRCCalculation;
+    uint32_t CRCPolynomial;
+    uint32_t CRCLength;
+    uint32_t NSSPMode;
+} SPI_InitTypeDef;
+
+typedef struct {
+    SPI_TypeDef       *Instance;
+    SPI_InitTypeDef    Init;
+    DMA_HandleTypeDef *hdmatx;
+} SPI_HandleTypeDef;
+
+extern GPIO_TypeDef host_GPIOA, host_GPIOB;
+extern TIM_TypeDef  host_TIM14;
+extern SPI_TypeDef  host_SPI1;
+extern DMA_Channel_TypeDef host_DMA1_Channel3;
+
+#define GPIOA                           (&host_GPIOA)
+#define GPIOB                           (&host_GPIOB)
+#define TIM14                           (&host_TIM14)
+#define SPI1                            (&host_SPI1)
+#define DMA1_Channel3                   (&host_DMA1_Channel3)
+#define TIM14_IRQn                      19
+
+#define GPIO_PIN_4                      0x0010u
+#define GPIO_PIN_5                      0x0020u
+#define GPIO_PIN_7                      0x0080u
+#define GPIO_PIN_8                      0x0100u
+#define GPIO_PIN_12                     0x1000u
+#define GPIO_MODE_OUTPUT_PP             0x01u
+#define GPIO_MODE_AF_PP                 0x02u
+#define GPIO_NOPULL                     0x00u
+#define GPIO_SPEED_FREQ_LOW             0x00u
+#define GPIO_SPEED_FREQ_HIGH            0x03u
+#define GPIO_AF0_SPI1                   0x00u
+#define GPIO_AF4_TIM14                  0x04u
+
+#define TIM_SR_UIF                      0x0001u
+#define TIM_SR_CC1IF                    0x0002u
+#define TIM_CCMR1_OC1PE                 0x0008u
+#define TIM_COUNTERMODE_UP              0x00u
+#define TIM_CLOCKDIVISION_DIV1          0x00u
+#define TIM_AUTORELOAD_PRELOAD_DISABLE  0x00u
+#define TIM_OCMODE_TIMING               0x00u
+#define TIM_OCMODE_PWM2                 0x70u
+#define TIM_OCPOLARITY_HIGH             0x00u
+#define TIM_OCPOLARITY_LOW              0x02u
+#define TIM_OCFAST_DISABLE              0x00u
+#define TIM_CHANNEL_1                   0x00u
+#define TIM_IT_UPDATE                   0x01u
+
+#define SPI_MODE_MASTER                 0x0104u
+#define SPI_DIRECTION_2LINES            0x00u
+#define SPI_DATASIZE_8BIT               0x0700u
+#define SPI_POLARITY_LOW                0x00u
+#define SPI_PHASE_1EDGE                 0x00u
+#define SPI_NSS_SOFT                    0x0200u
+#define SPI_BAUDRATEPRESCALER_2         0x00u
+#define SPI_FIRSTBIT_MSB                0x00u
+#define SPI_TIMODE_DISABLE              0x00u
+#define SPI_CRCCALCULATION_DISABLE      0x00u
+#define SPI_CRC_LENGTH_DATASIZE         0x00u
+#define SPI_NSS_PULSE_DISABLE           0x00u
+#define SPI_CR2_TXDMAEN                 0x0002u
+
+#define DMA_CCR_EN                      0x0001u
+#define DMA_MEMORY_TO_PERIPH            0x0010u
+#define DMA_PINC_DISABLE                0x00u
+#define DMA_MINC_ENABLE                 0x0080u
+#define DMA_PDATAALIGN_BYTE             0x00u
+#define DMA_MDATAALIGN_BYTE             0x00u
+#define DMA_NORMAL                      0x00u
+#define DMA_PRIORITY_LOW                0x00u
+
+#define __HAL_RCC_GPIOA_CLK_ENABLE()    do { } while (0)
+#define __HAL_RCC_GPIOB_CLK_ENABLE()    do { } while (0)
+#define __HAL_RCC_TIM14_CLK_ENABLE()    do { } while (0)
+#define __HAL_RCC_SPI1_CLK_ENABLE()     do { } while (0)
+#define __HAL_RCC_DMA1_CLK_ENABLE()     do { } while (0)
+#define __HAL_LINKDMA(h, field, dma)    do { (h)->field = &(dma); } while (0)
+#define __HAL_SPI_ENABLE(h)             do { (void)(h); } while (0)
+#define __HAL_TIM_ENABLE_IT(h, it)      do { (void)(h); (void)(it); } while (0)
+
+void HAL_GPIO_Init(GPIO_TypeDef *port, GPIO_InitTypeDef *init);
+HAL_StatusTypeDef HAL_TIM_OC_Init(TIM_HandleTypeDef *htim);
+HAL_StatusTypeDef HAL_TIM_OC_ConfigChannel(TIM_HandleTypeDef *htim, TIM_OC_InitTypeDef *cfg, uint32_t channel);
+HAL_StatusTypeDef HAL_TIM_OC_Start_IT(TIM_HandleTypeDef *htim, uint32_t channel);
+HAL_StatusTypeDef HAL_TIM_Base_Start_IT(TIM_HandleTypeDef *htim);
+HAL_StatusTypeDef HAL_TIM_PWM_Init(TIM_HandleTypeDef *htim);
+HAL_StatusTypeDef HAL_TIM_PWM_ConfigChannel(TIM_HandleTypeDef *htim, TIM_OC_InitTypeDef *cfg, uint32_t channel);
+HAL_StatusTypeDef HAL_TIM_PWM_Start(TIM_HandleTypeDef *htim, uint32_t channel);
+HAL_StatusTypeDef HAL_SPI_Init(SPI_HandleTypeDef *hspi);
+HAL_StatusTypeDef HAL_DMA_Init(DMA_HandleTypeDef *hdma);
+void HAL_NVIC_SetPriority(int irq, uint32_t pre, uint32_t sub);
+void HAL_NVIC_EnableIRQ(int irq);
+void Error_Handler(void);
+
+#endif /* __MAIN_H__ */
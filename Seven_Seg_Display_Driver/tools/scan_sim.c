@@ -0,0 +1,305 @@
+/*
+ * Run the display driver (SSEG.c with SSEGTransport_GPIO.c) against a
+ * simulated TIM14 and GPIOB on a PC, one 1 MHz timer tick at a time.
+ * TIM14 counts to SSEG_SLOT_TICKS, raises UIF on the update and CC1IF
+ * on the compare, with CCR1 preloaded (it takes effect at the update).
+ * The interrupt is entered a random 0..LATENCY_US after a flag is set
+ * and sees every flag set by then. An ISR runs in one instant; the
+ * port takes the last BSRR word it wrote, set bits winning.
+ *   - overlap: never two digits lit at once
+ *   - segments: a lit digit shows only its own segments, unchanged for
+ *     the whole on-time, while the main loop keeps rewriting digits
+ *   - duty: with no latency every digit is lit for exactly its
+ *     brightness table on-time; with latency, the mean stays within
+ *     DUTY_TOL_US and the dim levels only ever lose light. A digit
+ *     after a full-brightness one gains a few us: once the latency
+ *     passes SSEG_BLANK_US that digit's blanking and the next update
+ *     share one ISR entry, so the update is served early on average
+ *   - gap: the shortest dark time between two digits is reported
+ *
+ * Build from the project folder:
+ *   gcc -O2 -Wall -Wextra -Itools/host -I. -o scan_sim \
+ *       tools/scan_sim.c SSEG.c SSEGTransport_GPIO.c
+ *   ./scan_sim [seed]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "main.h"
+#include "SSEG.h"
+#include "SSEGTransport.h"
+
+#if SSEG_TRANSPORT != SSEG_TRANSPORT_GPIO
+#error "scan_sim models the GPIO transport"
+#endif
+
+#define LATENCY_US    30u
+#define RUN_SEC       4u
+#define DUTY_TOL_US   5.0         // see below
+
+GPIO_TypeDef host_GPIOB;
+TIM_TypeDef  host_TIM14;
+
+static uint32_t now;             // ticks since start
+static uint32_t cnt;             // TIM14 counter
+static uint32_t ccr1;            // active CCR1 (host_TIM14.CCR1 is the preload)
+static uint32_t pending;         // SR flags not yet serviced
+static uint32_t isrAt;           // tick the ISR will be entered ...
+static int      isrDue;          // ... if set
+static uint32_t latency;
+static uint8_t  given[SSEG_DIGITS];    // segments the main loop last set
+static uint8_t  latched[SSEG_DIGITS];  // ... as of the last update ISR
+static int      failures;
+
+void HAL_GPIO_Init(GPIO_TypeDef *port, GPIO_InitTypeDef *init)
+{
+    (void)port;
+    (void)init;
+}
+
+HAL_StatusTypeDef HAL_TIM_OC_Init(TIM_HandleTypeDef *htim)
+{
+    return htim->Init.Period == SSEG_SLOT_TICKS - 1u ? HAL_OK : HAL_ERROR;
+}
+
+HAL_StatusTypeDef HAL_TIM_OC_ConfigChannel(TIM_HandleTypeDef *htim, TIM_OC_InitTypeDef *cfg, uint32_t channel)
+{
+    (void)channel;
+    htim->Instance->CCR1 = cfg->Pulse;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_OC_Start_IT(TIM_HandleTypeDef *htim, uint32_t channel)
+{
+    (void)htim;
+    (void)channel;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Start_IT(TIM_HandleTypeDef *htim)
+{
+    (void)htim;
+    cnt = 0;
+    ccr1 = host_TIM14.CCR1;
+    return HAL_OK;
+}
+
+void HAL_NVIC_SetPriority(int irq, uint32_t pre, uint32_t sub)
+{
+    (void)irq;
+    (void)pre;
+    (void)sub;
+}
+
+void HAL_NVIC_EnableIRQ(int irq)
+{
+    (void)irq;
+}
+
+void Error_Handler(void)
+{
+    printf("Error_Handler\n");
+    exit(2);
+}
+
+static void check(int ok, const char *what)
+{
+    printf("%-58s %s\n", what, ok ? "ok" : "FAIL");
+    failures += !ok;
+}
+
+// The brightness table SSEG.h documents
+static uint32_t onTicks(uint32_t level)
+{
+    return level == 0u ? 0u : SSEG_ON_MIN + (SSEG_ON_MAX - SSEG_ON_MIN) * level * level /
+                                            (SSEG_BRIGHT_MAX * SSEG_BRIGHT_MAX);
+}
+
+// One timer tick: count, set flags, maybe enter the ISR
+static void tick(void)
+{
+    now++;
+    if (++cnt == SSEG_SLOT_TICKS)
+    {
+        cnt = 0;
+        pending |= TIM_SR_UIF;
+        ccr1 = host_TIM14.CCR1;
+    }
+    if (cnt == ccr1)
+    {
+        pending |= TIM_SR_CC1IF;
+    }
+    if (pending != 0u && !isrDue)
+    {
+        isrAt = now + (latency ? (uint32_t)rand() % (latency + 1u) : 0u);
+        isrDue = 1;
+    }
+    if (isrDue && now == isrAt)
+    {
+        host_TIM14.SR = pending;
+        host_TIM14.CNT = cnt;
+        host_GPIOB.BSRR = 0;
+        SSEG_TIM_IRQHandler();
+        // SSEG_TIM_IRQHandler clears every flag it read
+        if (pending & TIM_SR_UIF)
+        {
+            memcpy(latched, given, sizeof latched);
+        }
+        pending = 0;
+        isrDue = 0;
+        uint32_t w = host_GPIOB.BSRR;
+        host_GPIOB.ODR = (host_GPIOB.ODR & ~(w >> 16)) | (w & 0xFFFFu);
+    }
+}
+
+static uint8_t litDigits(void)
+{
+    uint32_t pins = SSEG_DIGIT_ON_HIGH ? host_GPIOB.ODR : ~host_GPIOB.ODR;
+    return (uint8_t)((pins >> 8) & 0x0Fu);
+}
+
+static uint8_t litSegments(void)
+{
+    uint32_t pins = SSEG_SEG_ON_HIGH ? host_GPIOB.ODR : ~host_GPIOB.ODR;
+    return (uint8_t)(pins & 0xFFu);
+}
+
+typedef struct {
+    int      overlap;
+    int      stray;
+    uint32_t litUs[SSEG_DIGITS];
+    uint32_t minGap;
+} Result;
+
+/*
+ * Run for RUN_SEC at the given levels. With 'rewrite' the main loop
+ * sets random segments on random digits every few hundred ticks; a lit
+ * digit must show what it had been given when its slot began.
+ */
+static void run(const uint8_t *levels, int rewrite, Result *r)
+{
+    int lastLit = -1, prevLit = -1;
+    uint8_t shown = 0;
+    uint32_t dark = 0;
+
+    for (uint8_t d = 0; d < SSEG_DIGITS; d++)
+    {
+        given[d] = (uint8_t)(0x11u << d);
+        SSEG_SetRaw(d, given[d]);
+        SSEG_SetBrightness(d, levels[d]);
+    }
+    // One frame to let the old settings drain out of the scan
+    for (uint32_t t = 0; t < SSEG_DIGITS * SSEG_SLOT_TICKS; t++)
+    {
+        tick();
+    }
+
+    *r = (Result){ .minGap = SSEG_SLOT_TICKS };
+    for (uint32_t t = 0; t < RUN_SEC * SSEG_TICK_HZ; t++)
+    {
+        if (rewrite && rand() % 300 == 0)
+        {
+            uint8_t d = (uint8_t)(rand() % SSEG_DIGITS);
+            given[d] = (uint8_t)rand();
+            SSEG_SetRaw(d, given[d]);
+        }
+        tick();
+
+        uint8_t lit = litDigits();
+        if (lit & (lit - 1u))
+        {
+            r->overlap = 1;
+            continue;
+        }
+        int d = lit ? __builtin_ctz(lit) : -1;
+        if (d >= 0)
+        {
+            uint8_t seg = litSegments();
+            if (d != lastLit)
+            {
+                shown = seg;
+                if (prevLit >= 0 && prevLit != d && dark < r->minGap)
+                {
+                    r->minGap = dark;
+                }
+            }
+            prevLit = d;
+            dark = 0;
+            r->stray |= (seg != shown) || (seg != latched[d]);
+            r->litUs[d]++;
+        }
+        else
+        {
+            dark++;
+        }
+        lastLit = d;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    unsigned seed = (argc > 1) ? (unsigned)atoi(argv[1]) : 1u;
+    const uint32_t slots = RUN_SEC * SSEG_REFRESH_HZ;
+    int overlap = 0, stray = 0, exact = 1, dimOk = 1;
+    uint32_t gap0 = SSEG_SLOT_TICKS, gap = SSEG_SLOT_TICKS;
+    double worst = 0.0;
+    Result r;
+
+    srand(seed);
+    SSEG_Init();
+    printf("%u us slots, on-time %u..%u us, interrupt latency 0..%u us\n",
+           (unsigned)SSEG_SLOT_TICKS, (unsigned)SSEG_ON_MIN, (unsigned)SSEG_ON_MAX, LATENCY_US);
+
+    // Every level on every digit, four digits at a time
+    for (uint8_t base = 0; base <= SSEG_BRIGHT_MAX; base++)
+    {
+        uint8_t levels[SSEG_DIGITS];
+        for (uint8_t d = 0; d < SSEG_DIGITS; d++)
+        {
+            levels[d] = (uint8_t)((base + 5u * d) % (SSEG_BRIGHT_MAX + 1u));
+        }
+
+        latency = 0;
+        run(levels, 0, &r);
+        gap0 = r.minGap < gap0 ? r.minGap : gap0;
+        overlap |= r.overlap;
+        stray |= r.stray;
+        for (uint8_t d = 0; d < SSEG_DIGITS; d++)
+        {
+            exact &= r.litUs[d] == onTicks(levels[d]) * slots;
+        }
+
+        latency = LATENCY_US;
+        run(levels, 1, &r);
+        gap = r.minGap < gap ? r.minGap : gap;
+        overlap |= r.overlap;
+        stray |= r.stray;
+        for (uint8_t d = 0; d < SSEG_DIGITS; d++)
+        {
+            double mean = (double)r.litUs[d] / slots, want = onTicks(levels[d]);
+            if (want > LATENCY_US)
+            {
+                worst = mean - want > worst ? mean - want : want - mean > worst ? want - mean : worst;
+            }
+            else
+            {
+                dimOk &= mean <= want + 0.5;
+            }
+        }
+    }
+
+    check(!overlap, "never two digits lit at once");
+    printf("shortest dark time between digits: %u us with no latency, %u us with\n",
+           (unsigned)gap0, (unsigned)gap);
+    // (0 us: a late blank and the next update in the same ISR entry)
+    check(gap0 >= SSEG_BLANK_US, "no latency: at least SSEG_BLANK_US dark between digits");
+    check(!stray, "a lit digit shows only its own segments");
+    check(exact, "no latency: on-time is exactly the brightness table");
+    printf("latency 0..%u us: worst mean on-time error %.2f us (levels above %u us)\n",
+           LATENCY_US, worst, LATENCY_US);
+    check(worst < DUTY_TOL_US, "with latency: mean on-time follows the table");
+    check(dimOk, "with latency: dim levels never gain on-time");
+
+    printf("%s\n", failures ? "FAILED" : "all passed");
+    return failures != 0;
+}
@@ -12,6 +12,10 @@
   *     SPI1 (Master): PA5 = SCK, PA7 = MOSI
   *     PB12 = RCLK (latch). OE' tied LOW, SRCLR' tied HIGH on your breadboard.
   *
+  *   24AA16 EEPROM (I2C1): PB8 = SCL, PB9 = SDA, for the dwell times
+  *
+  *   Telemetry: PB6 = USART1 TX (DMA1 channel 2), state changes and inputs
+  *
   *   Inputs:
   *     PA0 = Walk button (internal pulldown, pressed = 1)
   *     PA1 = North sensor (external pulldown)
@@ -37,6 +41,13 @@
 #include "main.h"
 #include <stdint.h>
 #include "LCD.h"   // your LCD driver (PA8/PA9 + PC0..PC3)
+#include "Settings.h"   // dwell times kept in the 24AA16 (PB8/PB9)
+#include "Telemetry.h"  // build with -DTELEMETRY_PORT=TELEMETRY_PORT_USART1_PB6
+
+/* PA2 is the walk button and PA9 the LCD enable: only PB6 is free */
+#if TELEMETRY_PORT != TELEMETRY_PORT_USART1_PB6
+#error "PA2 and PA9 are in use: build with -DTELEMETRY_PORT=TELEMETRY_PORT_USART1_PB6"
+#endif
 
 /* ================= HAL Handles ================= */
 SPI_HandleTypeDef hspi1;   // CubeMX provides the storage for SPI1
@@ -84,6 +95,14 @@ static inline void ApplyOutputs(uint8_t out_byte) {
   Shift595_WriteByte(out_byte);
 }
 
+/* ================== TELEMETRY ==================
+   Binary frames on PB6 (see ../Common/Telemetry.h): a TLM_STATE frame
+   for every state change, with the inputs that chose it and the new
+   dwell time, and a TLM_KEY frame whenever an input changes. */
+#define TLM_BAUD     115200u
+#define TLM_FSM      0u        // TLM_STATE machine id
+#define TLM_INPUTS   0u        // TLM_KEY source: key 0 = E, 1 = N, 2 = W
+
 /* ================== INPUTS ==================
    We always produce a 3-bit index: [W,N,E] (WALK, North, East).
    This gives 8 possible input codes and matches next[] per state.
@@ -99,11 +118,12 @@ static inline uint8_t ReadInputs3(void){
    Table-driven Moore machine, each state has:
      - a printable name (for LCD)
      - an 8-bit output for the 74HC595
-     - a dwell time in 10ms units (HAL_Delay(10) loops)
+     - a dwell time in 10ms units (HAL_Delay(10) loops), via dwell10ms[]
      - 8 next-state entries (for all 3-bit input patterns)
 */
 
-/* Timings (demo-friendly; tweak to taste) */
+/* Default timings (demo-friendly; tweak to taste). The ones in use are
+   in dwell10ms[] below, loaded from the settings EEPROM at reset. */
 #define T_G      300   // 3.0 s green
 #define T_Y      150   // 1.5 s yellow
 #define T_AR      50   // 0.5 s all-red (safety)
@@ -112,11 +132,18 @@ static inline uint8_t ReadInputs3(void){
 #define T_DONT   150   // 1.5 s solid DON'T WALK
 #define T_CF      30   // 0.3 s per confirm step (4 steps ≈ 1.2 s). Increase for longer hold.
 
+/* Which dwell time a state uses; same order as the SET_TL_T_... keys */
+enum { D_G=0, D_Y, D_AR, D_WALK, D_HURRY, D_DONT, D_CF, D__NUM };
+
+static uint16_t dwell10ms[D__NUM] = { T_G, T_Y, T_AR, T_WALK, T_HURRY, T_DONT, T_CF };
+
+#define DWELL_MAX   6000u   // 60 s; anything longer in the EEPROM is ignored
+
 /* State object layout */
 typedef struct {
   const char *name;     // shown on LCD line 1
   uint8_t     out;      // 74HC595 byte
-  uint16_t    t10ms;    // dwell (10ms ticks)
+  uint8_t     dwell;    // D_... : index into dwell10ms[] (10ms ticks)
   const uint8_t next[8];// 8 next-state indices for [W N E]
 } State;
 
@@ -147,7 +174,7 @@ enum {
 
 /* ================== FSM TABLE ==================
    Read left→right:
-     name, outputs (which LEDs), dwell (how long), then transitions:
+     name, outputs (which LEDs), dwell (which time), then transitions:
      next[ W=0,N=0,E=0 ], next[0,0,1], next[0,1,0], next[0,1,1],
      next[ W=1,N=0,E=0 ], next[1,0,1], next[1,1,0], next[1,1,1 ].
 */
@@ -156,7 +183,7 @@ static const State FSM[S__NUM] = {
 [S_N_G] = {
   .name="N_G",                    // North green, East red
   .out  = OUT_N_G | OUT_E_R,
-  .t10ms = T_G,
+  .dwell = D_G,
   .next = NEXT8(
     /*W=0*/ /*N E:00*/ S_N_G,   /*01*/ S_N_Y,   /*10*/ S_N_G,   /*11*/ S_N_Y,
     /*W=1*/ /*N E:00*/ S_ConfN1,/*01*/ S_ConfN1,/*10*/ S_ConfN1,/*11*/ S_ConfN1)
@@ -164,20 +191,20 @@ static const State FSM[S__NUM] = {
 [S_N_Y] = {
   .name="N_Y",                    // North yellow (East stays red)
   .out  = OUT_N_Y | OUT_E_R,
-  .t10ms = T_Y,
+  .dwell = D_Y,
   .next = NEXT8(S_AR_N2E,S_AR_N2E,S_AR_N2E,S_AR_N2E, S_AR_N2E,S_AR_N2E,S_AR_N2E,S_AR_N2E)
 },
 [S_AR_N2E] = {
   .name="AR_N2E",                 // All-red between N and E
   .out  = OUT_ALLRED,
-  .t10ms = T_AR,
+  .dwell = D_AR,
   .next = NEXT8(S_E_G,S_E_G,S_E_G,S_E_G, S_E_G,S_E_G,S_E_G,S_E_G)
 },
 
 [S_E_G] = {
   .name="E_G",                    // East green, North red
   .out  = OUT_E_G | OUT_N_R,
-  .t10ms = T_G,
+  .dwell = D_G,
   .next = NEXT8(
     /*W=0*/ /*N E:00*/ S_E_G,   /*01*/ S_E_G,   /*10*/ S_E_Y,   /*11*/ S_E_Y,
     /*W=1*/ /*N E:00*/ S_ConfE1,/*01*/ S_ConfE1,/*10*/ S_ConfE1,/*11*/ S_ConfE1)
@@ -185,13 +212,13 @@ static const State FSM[S__NUM] = {
 [S_E_Y] = {
   .name="E_Y",
   .out  = OUT_E_Y | OUT_N_R,
-  .t10ms = T_Y,
+  .dwell = D_Y,
   .next = NEXT8(S_AR_E2N,S_AR_E2N,S_AR_E2N,S_AR_E2N, S_AR_E2N,S_AR_E2N,S_AR_E2N,S_AR_E2N)
 },
 [S_AR_E2N] = {
   .name="AR_E2N",
   .out  = OUT_ALLRED,
-  .t10ms = T_AR,
+  .dwell = D_AR,
   .next = NEXT8(S_N_G,S_N_G,S_N_G,S_N_G, S_N_G,S_N_G,S_N_G,S_N_G)
 },
 
@@ -199,7 +226,7 @@ static const State FSM[S__NUM] = {
 [S_rN_G] = {
   .name="rN_G",
   .out  = OUT_N_G | OUT_E_R,
-  .t10ms = T_G,
+  .dwell = D_G,
   .next = NEXT8(
     /*W ignored*/ /*N E:00*/ S_rN_G, /*01*/ S_rN_Y, /*10*/ S_rN_G, /*11*/ S_rN_Y,
     /*W ignored*/ /*N E:00*/ S_rN_G, /*01*/ S_rN_Y, /*10*/ S_rN_G, /*11*/ S_rN_Y)
@@ -207,20 +234,20 @@ static const State FSM[S__NUM] = {
 [S_rN_Y] = {
   .name="rN_Y",
   .out  = OUT_N_Y | OUT_E_R,
-  .t10ms = T_Y,
+  .dwell = D_Y,
   .next = NEXT8(S_rAR_N2E,S_rAR_N2E,S_rAR_N2E,S_rAR_N2E, S_rAR_N2E,S_rAR_N2E,S_rAR_N2E,S_rAR_N2E)
 },
 [S_rAR_N2E] = {
   .name="rAR_N2E",
   .out  = OUT_ALLRED,
-  .t10ms = T_AR,
+  .dwell = D_AR,
   .next = NEXT8(S_WALK_N2E,S_WALK_N2E,S_WALK_N2E,S_WALK_N2E, S_WALK_N2E,S_WALK_N2E,S_WALK_N2E,S_WALK_N2E)
 },
 
 [S_rE_G] = {
   .name="rE_G",
   .out  = OUT_E_G | OUT_N_R,
-  .t10ms = T_G,
+  .dwell = D_G,
   .next = NEXT8(
     /*W ignored*/ /*N E:00*/ S_rE_G, /*01*/ S_rE_G, /*10*/ S_rE_Y, /*11*/ S_rE_Y,
     /*W ignored*/ /*N E:00*/ S_rE_G, /*01*/ S_rE_G, /*10*/ S_rE_Y, /*11*/ S_rE_Y)
@@ -228,13 +255,13 @@ static const State FSM[S__NUM] = {
 [S_rE_Y] = {
   .name="rE_Y",
   .out  = OUT_E_Y | OUT_N_R,
-  .t10ms = T_Y,
+  .dwell = D_Y,
   .next = NEXT8(S_rAR_E2N,S_rAR_E2N,S_rAR_E2N,S_rAR_E2N, S_rAR_E2N,S_rAR_E2N,S_rAR_E2N,S_rAR_E2N)
 },
 [S_rAR_E2N] = {
   .name="rAR_E2N",
   .out  = OUT_ALLRED,
-  .t10ms = T_AR,
+  .dwell = D_AR,
   .next = NEXT8(S_WALK_E2N,S_WALK_E2N,S_WALK_E2N,S_WALK_E2N, S_WALK_E2N,S_WALK_E2N,S_WALK_E2N,S_WALK_E2N)
 },
 
@@ -242,37 +269,37 @@ static const State FSM[S__NUM] = {
 [S_WALK_N2E] = {
   .name="WALK_N2E",               // show WALK steady
   .out  = OUT_ALLRED | OUT_WALK,
-  .t10ms = T_WALK,
+  .dwell = D_WALK,
   .next = NEXT8(S_HON1_N2E,S_HON1_N2E,S_HON1_N2E,S_HON1_N2E, S_HON1_N2E,S_HON1_N2E,S_HON1_N2E,S_HON1_N2E)
 },
 [S_HON1_N2E] = {
   .name="H1_ON_N2E",              // hurry: DON'T blinking (ON)
   .out  = OUT_ALLRED | OUT_DONT,
-  .t10ms = T_HURRY,
+  .dwell = D_HURRY,
   .next = NEXT8(S_HOFF1_N2E,S_HOFF1_N2E,S_HOFF1_N2E,S_HOFF1_N2E, S_HOFF1_N2E,S_HOFF1_N2E,S_HOFF1_N2E,S_HOFF1_N2E)
 },
 [S_HOFF1_N2E] = {
   .name="H1_OFF_N2E",             // hurry: DON'T blinking (OFF)
   .out  = OUT_ALLRED,
-  .t10ms = T_HURRY,
+  .dwell = D_HURRY,
   .next = NEXT8(S_HON2_N2E,S_HON2_N2E,S_HON2_N2E,S_HON2_N2E, S_HON2_N2E,S_HON2_N2E,S_HON2_N2E,S_HON2_N2E)
 },
 [S_HON2_N2E] = {
   .name="H2_ON_N2E",
   .out  = OUT_ALLRED | OUT_DONT,
-  .t10ms = T_HURRY,
+  .dwell = D_HURRY,
   .next = NEXT8(S_HOFF2_N2E,S_HOFF2_N2E,S_HOFF2_N2E,S_HOFF2_N2E, S_HOFF2_N2E,S_HOFF2_N2E,S_HOFF2_N2E,S_HOFF2_N2E)
 },
 [S_HOFF2_N2E] = {
   .name="H2_OFF_N2E",
   .out  = OUT_ALLRED,
-  .t10ms = T_HURRY,
+  .dwell = D_HURRY,
   .next = NEXT8(S_DONT_N2E,S_DONT_N2E,S_DONT_N2E,S_DONT_N2E, S_DONT_N2E,S_DONT_N2E,S_DONT_N2E,S_DONT_N2E)
 },
 [S_DONT_N2E] = {
   .name="DONT_N2E",               // solid DON'T before traffic resumes
   .out  = OUT_ALLRED | OUT_DONT,
-  .t10ms = T_DONT,
+  .dwell = D_DONT,
   .next = NEXT8(S_E_G,S_E_G,S_E_G,S_E_G, S_E_G,S_E_G,S_E_G,S_E_G) // resume East cycle
 },
 
@@ -280,37 +307,37 @@ static const State FSM[S__NUM] = {
 [S_WALK_E2N] = {
   .name="WALK_E2N",
   .out  = OUT_ALLRED | OUT_WALK,
-  .t10ms = T_WALK,
+  .dwell = D_WALK,
   .next = NEXT8(S_HON1_E2N,S_HON1_E2N,S_HON1_E2N,S_HON1_E2N, S_HON1_E2N,S_HON1_E2N,S_HON1_E2N,S_HON1_E2N)
 },
 [S_HON1_E2N] = {
   .name="H1_ON_E2N",
   .out  = OUT_ALLRED | OUT_DONT,
-  .t10ms = T_HURRY,
+  .dwell = D_HURRY,
   .next = NEXT8(S_HOFF1_E2N,S_HOFF1_E2N,S_HOFF1_E2N,S_HOFF1_E2N, S_HOFF1_E2N,S_HOFF1_E2N,S_HOFF1_E2N,S_HOFF1_E2N)
 },
 [S_HOFF1_E2N] = {
   .name="H1_OFF_E2N",
   .out  = OUT_ALLRED,
-  .t10ms = T_HURRY,
+  .dwell = D_HURRY,
   .next = NEXT8(S_HON2_E2N,S_HON2_E2N,S_HON2_E2N,S_HON2_E2N, S_HON2_E2N,S_HON2_E2N,S_HON2_E2N,S_HON2_E2N)
 },
 [S_HON2_E2N] = {
   .name="H2_ON_E2N",
   .out  = OUT_ALLRED | OUT_DONT,
-  .t10ms = T_HURRY,
+  .dwell = D_HURRY,
   .next = NEXT8(S_HOFF2_E2N,S_HOFF2_E2N,S_HOFF2_E2N,S_HOFF2_E2N, S_HOFF2_E2N,S_HOFF2_E2N,S_HOFF2_E2N,S_HOFF2_E2N)
 },
 [S_HOFF2_E2N] = {
   .name="H2_OFF_E2N",
   .out  = OUT_ALLRED,
-  .t10ms = T_HURRY,
+  .dwell = D_HURRY,
   .next = NEXT8(S_DONT_E2N,S_DONT_E2N,S_DONT_E2N,S_DONT_E2N, S_DONT_E2N,S_DONT_E2N,S_DONT_E2N,S_DONT_E2N)
 },
 [S_DONT_E2N] = {
   .name="DONT_E2N",
   .out  = OUT_ALLRED | OUT_DONT,
-  .t10ms = T_DONT,
+  .dwell = D_DONT,
   .next = NEXT8(S_N_G,S_N_G,S_N_G,S_N_G, S_N_G,S_N_G,S_N_G,S_N_G) // resume North cycle
 },
 
@@ -324,25 +351,25 @@ static const State FSM[S__NUM] = {
 [S_ConfN1] = {
   .name="ConfN1",
   .out  = OUT_N_G | OUT_E_R, // keep current outputs during confirm
-  .t10ms = T_CF,
+  .dwell = D_CF,
   .next = NEXT8(S_N_G,S_N_G,S_N_G,S_N_G,  S_ConfN2,S_ConfN2,S_ConfN2,S_ConfN2)
 },
 [S_ConfN2] = {
   .name="ConfN2",
   .out  = OUT_N_G | OUT_E_R,
-  .t10ms = T_CF,
+  .dwell = D_CF,
   .next = NEXT8(S_N_G,S_N_G,S_N_G,S_N_G,  S_ConfN3,S_ConfN3,S_ConfN3,S_ConfN3)
 },
 [S_ConfN3] = {
   .name="ConfN3",
   .out  = OUT_N_G | OUT_E_R,
-  .t10ms = T_CF,
+  .dwell = D_CF,
   .next = NEXT8(S_N_G,S_N_G,S_N_G,S_N_G,  S_ConfN4,S_ConfN4,S_ConfN4,S_ConfN4)
 },
 [S_ConfN4] = {
   .name="ConfN4",
   .out  = OUT_N_G | OUT_E_R,
-  .t10ms = T_CF,
+  .dwell = D_CF,
   // If W=0 (released) → abort back to N_G.
   // If W=1:
   //   - If no cars (N=0,E=0), jump to rN_Y so we WALK right away.
@@ -355,25 +382,25 @@ static const State FSM[S__NUM] = {
 [S_ConfE1] = {
   .name="ConfE1",
   .out  = OUT_E_G | OUT_N_R,
-  .t10ms = T_CF,
+  .dwell = D_CF,
   .next = NEXT8(S_E_G,S_E_G,S_E_G,S_E_G,  S_ConfE2,S_ConfE2,S_ConfE2,S_ConfE2)
 },
 [S_ConfE2] = {
   .name="ConfE2",
   .out  = OUT_E_G | OUT_N_R,
-  .t10ms = T_CF,
+  .dwell = D_CF,
   .next = NEXT8(S_E_G,S_E_G,S_E_G,S_E_G,  S_ConfE3,S_ConfE3,S_ConfE3,S_ConfE3)
 },
 [S_ConfE3] = {
   .name="ConfE3",
   .out  = OUT_E_G | OUT_N_R,
-  .t10ms = T_CF,
+  .dwell = D_CF,
   .next = NEXT8(S_E_G,S_E_G,S_E_G,S_E_G,  S_ConfE4,S_ConfE4,S_ConfE4,S_ConfE4)
 },
 [S_ConfE4] = {
   .name="ConfE4",
   .out  = OUT_E_G | OUT_N_R,
-  .t10ms = T_CF,
+  .dwell = D_CF,
   // If W=0 → abort back to E_G.
   // If W=1:
   //   - If no cars (N=0,E=0), jump to rE_Y so we WALK right away.
@@ -384,6 +411,19 @@ static const State FSM[S__NUM] = {
 },
 };
 
+/* ============== Dwell times from the settings EEPROM ==============
+   A time that was never stored (blank EEPROM) is stored with its
+   default, so the EEPROM always holds the full set in use. */
+static void LoadDwellTimes(void) {
+  for (uint8_t d = 0; d < D__NUM; d++) {
+    uint32_t t = Settings_GetOr((uint8_t)(SET_TL_T_G + d), dwell10ms[d]);
+    if (t != 0u && t <= DWELL_MAX) {
+      dwell10ms[d] = (uint16_t)t;
+    }
+    Settings_Set((uint8_t)(SET_TL_T_G + d), dwell10ms[d]);
+  }
+}
+
 /* ============== Small LCD helper so states print when they change ============== */
 static inline void LCD_ShowState(const char *name) {
   LCD_Clear();
@@ -407,6 +447,14 @@ int main(void)
   LCD_Clear();
   LCD_OutString("Traffic Ctrl");
 
+  /* Telemetry on PB6; the frames go out by DMA */
+  Telemetry_Init(TLM_APP_TRAFFIC, TLM_BAUD);
+
+  /* Dwell times: one read of the 24AA16, then they live in RAM */
+  Eeprom24_Init();
+  Settings_Init(0);
+  LoadDwellTimes();
+
   /* Boot policy:
      If East sensor is already 1 at startup, begin with East green;
      else default to North green. (You can change this policy easily.)
@@ -416,6 +464,7 @@ int main(void)
 
   /* Force LCD to update on first pass */
   uint8_t prev = 0xFF;
+  uint8_t inputs = boot;
 
   while (1) {
     /* ----- Set outputs (LEDs via shift register) ----- */
@@ -427,13 +476,28 @@ int main(void)
       prev = s;
     }
 
-    /* ----- Dwell in this state for t10ms * 10 ms ----- */
-    for (uint16_t t = FSM[s].t10ms; t > 0; --t) {
+    /* ----- Dwell in this state for dwell10ms * 10 ms; any settings
+             write runs from the I2C interrupt meanwhile, and input
+             changes are reported as they happen ----- */
+    for (uint16_t t = dwell10ms[FSM[s].dwell]; t > 0; --t) {
       HAL_Delay(10);
+      Settings_Poll(HAL_GetTick());
+      uint8_t in = ReadInputs3();
+      for (uint8_t k = 0; k < 3u; k++) {
+        if ((in ^ inputs) & (1u << k)) {
+          Telemetry_Key(TLM_INPUTS, k, (in >> k) & 1u, in);
+        }
+      }
+      inputs = in;
     }
 
     /* ----- Compute next state using current inputs [W,N,E] ----- */
-    s = FSM[s].next[ ReadInputs3() ];
+    uint8_t in = ReadInputs3();
+    uint8_t next = FSM[s].next[in];
+    if (next != s) {
+      Telemetry_State(TLM_FSM, s, next, in, dwell10ms[FSM[next].dwell]);
+    }
+    s = next;
   }
 }
 